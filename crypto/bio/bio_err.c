@@ -63,6 +63,8 @@ static const ERR_STRING_DATA BIO_str_reasons[] = {
     { ERR_PACK(ERR_LIB_BIO, 0, BIO_R_UNABLE_TO_NODELAY), "unable to nodelay" },
     { ERR_PACK(ERR_LIB_BIO, 0, BIO_R_UNABLE_TO_REUSEADDR),
         "unable to reuseaddr" },
+    { ERR_PACK(ERR_LIB_BIO, 0, BIO_R_UNABLE_TO_REUSEPORT),
+        "unable to reuseport" },
     { ERR_PACK(ERR_LIB_BIO, 0, BIO_R_UNABLE_TO_TFO), "unable to tfo" },
     { ERR_PACK(ERR_LIB_BIO, 0, BIO_R_UNAVAILABLE_IP_FAMILY),
         "unavailable ip family" },
@@ -186,6 +186,15 @@ typedef struct bio_dgram_data_st {
     OSSL_TIME socket_timeout;
     unsigned int peekmode;
     char local_addr_enabled;
+    char tx_segmentation_enabled;
+    char rx_coalescing_enabled;
+    /*
+     * When receive coalescing is enabled, a coalesced datagram read from the
+     * kernel is held here and handed out one segment per BIO_MSG.
+     */
+    unsigned char *rx_coalesce_buf;
+    size_t rx_coalesce_len, rx_coalesce_off, rx_coalesce_seg;
+    BIO_ADDR rx_coalesce_peer, rx_coalesce_local;
 } bio_dgram_data;
 #endif
 
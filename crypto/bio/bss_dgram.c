@@ -28,6 +28,10 @@
 #define IP_MTU 14 /* linux is lame */
 #endif
 
+#if defined(OPENSSL_SYS_LINUX)
+#include <netinet/udp.h>
+#endif
+
 #if OPENSSL_USE_IPV6 && !defined(IPPROTO_IPV6)
 #define IPPROTO_IPV6 41 /* windows is lame */
 #endif
@@ -146,8 +150,36 @@
 #endif
 #endif
 
+/*
+ * UDP segmentation offload (UDP_SEGMENT) and receive coalescing (UDP_GRO) are
+ * Linux-specific and are only used together with sendmmsg/recvmmsg. Older libc
+ * headers may not define the option values, so supply them here.
+ */
+#if M_METHOD == M_METHOD_RECVMMSG && defined(OPENSSL_SYS_LINUX)
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+#define SUPPORT_UDP_SEGMENTATION
+
+/* Kernel limits on the number of segments in a single segmented send. */
+#define BIO_SEGMENT_MAX_MSGS 64
+/* Largest UDP payload which can be handed to or received from the kernel. */
+#define BIO_SEGMENT_MAX_LEN 65507
+#define BIO_CMSG_TX_ALLOC_LEN \
+    (BIO_CMSG_ALLOC_LEN + BIO_CMSG_SPACE(sizeof(uint16_t)))
+#define BIO_CMSG_RX_ALLOC_LEN \
+    (BIO_CMSG_ALLOC_LEN + BIO_CMSG_SPACE(sizeof(int)))
+#endif
+
 #define BIO_MSG_N(array, stride, n) (*(BIO_MSG *)((char *)(array) + (n) * (stride)))
 
+#if M_METHOD == M_METHOD_RECVMMSG
+#define BIO_MAX_MSGS_PER_CALL 64
+#endif
+
 static int dgram_write(BIO *h, const char *buf, int num);
 static int dgram_read(BIO *h, char *buf, int size);
 static int dgram_puts(BIO *h, const char *str);
@@ -275,6 +307,7 @@ static int dgram_free(BIO *a)
         return 0;
 
     data = (bio_dgram_data *)a->ptr;
+    OPENSSL_free(data->rx_coalesce_buf);
     OPENSSL_free(data);
 
     return 1;
@@ -545,6 +578,47 @@ static int enable_local_addr(BIO *b, int enable)
 }
 #endif
 
+#if defined(SUPPORT_UDP_SEGMENTATION)
+/*
+ * Probes for kernel support of UDP segmentation offload. Segmentation is
+ * requested per send using a control message, so there is nothing to configure
+ * on the socket itself; setting a segment size of zero is a no-op which only
+ * succeeds on kernels which understand the option.
+ */
+static int enable_tx_segmentation(BIO *b, int enable)
+{
+    int seg = 0;
+
+    if (!enable)
+        return 1;
+
+    if (setsockopt(b->num, IPPROTO_UDP, UDP_SEGMENT, &seg, sizeof(seg)) < 0)
+        return 0;
+
+    return 1;
+}
+
+/* Enables or disables UDP receive coalescing (GRO) on the socket. */
+static int enable_rx_coalescing(BIO *b, int enable)
+{
+    bio_dgram_data *data = (bio_dgram_data *)b->ptr;
+
+    if (setsockopt(b->num, IPPROTO_UDP, UDP_GRO, &enable, sizeof(enable)) < 0)
+        return 0;
+
+    if (enable && data->rx_coalesce_buf == NULL) {
+        data->rx_coalesce_buf = OPENSSL_malloc(BIO_SEGMENT_MAX_LEN);
+        if (data->rx_coalesce_buf == NULL) {
+            enable = 0;
+            setsockopt(b->num, IPPROTO_UDP, UDP_GRO, &enable, sizeof(enable));
+            return 0;
+        }
+    }
+
+    return 1;
+}
+#endif
+
 static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
 {
     long ret = 1;
@@ -589,6 +663,13 @@ static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
             if (enable_local_addr(b, 1) < 1)
                 data->local_addr_enabled = 0;
         }
+#endif
+#if defined(SUPPORT_UDP_SEGMENTATION)
+        data->rx_coalesce_len = data->rx_coalesce_off = 0;
+        if (data->tx_segmentation_enabled && !enable_tx_segmentation(b, 1))
+            data->tx_segmentation_enabled = 0;
+        if (data->rx_coalescing_enabled && !enable_rx_coalescing(b, 1))
+            data->rx_coalescing_enabled = 0;
 #endif
         break;
     case BIO_C_GET_FD:
@@ -607,6 +688,9 @@ static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
         b->shutdown = (int)num;
         break;
     case BIO_CTRL_PENDING:
+        /* Segments of a coalesced datagram not yet handed out */
+        ret = (long)(data->rx_coalesce_len - data->rx_coalesce_off);
+        break;
     case BIO_CTRL_WPENDING:
         ret = 0;
         break;
@@ -1007,6 +1091,46 @@ static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
         *(int *)ptr = data->local_addr_enabled;
         break;
 
+    case BIO_CTRL_DGRAM_SET_TX_SEGMENTATION:
+#if defined(SUPPORT_UDP_SEGMENTATION)
+        num = num > 0;
+        if (num != data->tx_segmentation_enabled) {
+            if (!enable_tx_segmentation(b, num)) {
+                ret = 0;
+                break;
+            }
+
+            data->tx_segmentation_enabled = (char)num;
+        }
+#else
+        ret = 0;
+#endif
+        break;
+
+    case BIO_CTRL_DGRAM_GET_TX_SEGMENTATION:
+        ret = data->tx_segmentation_enabled;
+        break;
+
+    case BIO_CTRL_DGRAM_SET_RX_COALESCING:
+#if defined(SUPPORT_UDP_SEGMENTATION)
+        num = num > 0;
+        if (num != data->rx_coalescing_enabled) {
+            if (!enable_rx_coalescing(b, num)) {
+                ret = 0;
+                break;
+            }
+
+            data->rx_coalescing_enabled = (char)num;
+        }
+#else
+        ret = 0;
+#endif
+        break;
+
+    case BIO_CTRL_DGRAM_GET_RX_COALESCING:
+        ret = data->rx_coalescing_enabled;
+        break;
+
     case BIO_CTRL_DGRAM_GET_EFFECTIVE_CAPS:
         ret = (long)(BIO_DGRAM_CAP_HANDLES_DST_ADDR
             | BIO_DGRAM_CAP_HANDLES_SRC_ADDR
@@ -1319,6 +1443,231 @@ static int translate_flags(uint64_t flags)
 }
 #endif
 
+#if defined(SUPPORT_UDP_SEGMENTATION)
+static int msg_addr_eq(const BIO_ADDR *a, const BIO_ADDR *b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+
+    if (BIO_ADDR_family(a) != BIO_ADDR_family(b))
+        return 0;
+
+    switch (BIO_ADDR_family(a)) {
+    case AF_INET:
+        return a->s_in.sin_addr.s_addr == b->s_in.sin_addr.s_addr
+            && a->s_in.sin_port == b->s_in.sin_port;
+#if OPENSSL_USE_IPV6
+    case AF_INET6:
+        return memcmp(&a->s_in6.sin6_addr, &b->s_in6.sin6_addr,
+                   sizeof(a->s_in6.sin6_addr))
+            == 0
+            && a->s_in6.sin6_port == b->s_in6.sin6_port
+            && a->s_in6.sin6_scope_id == b->s_in6.sin6_scope_id;
+#endif
+    default:
+        return BIO_ADDR_family(a) == AF_UNSPEC;
+    }
+}
+
+/*
+ * Sends a batch of messages using UDP segmentation offload. Runs of
+ * consecutive messages with the same addressing, where every message but the
+ * last has the same length and the last is no longer than the others, are
+ * passed to the kernel as a single segmented send made up of one iovec per
+ * message. The kernel splits such a send back into individual datagrams, so
+ * the datagrams on the wire are exactly those which were passed in.
+ *
+ * Returns 1 on success, 0 on failure, and -1 if the kernel refused to segment
+ * (for example because the outgoing interface lacks checksum offload) before
+ * anything was sent, in which case the caller should retry without
+ * segmentation.
+ */
+static int dgram_sendmmsg_segmented(BIO *b, BIO_MSG *msg, size_t stride,
+    size_t num_msg, int sysflags,
+    size_t *num_processed)
+{
+    bio_dgram_data *data = (bio_dgram_data *)b->ptr;
+    struct mmsghdr mh[BIO_MAX_MSGS_PER_CALL];
+    struct iovec iov[BIO_MAX_MSGS_PER_CALL];
+    unsigned char control[BIO_MAX_MSGS_PER_CALL][BIO_CMSG_TX_ALLOC_LEN] = { { 0 } };
+    size_t grp_start[BIO_MAX_MSGS_PER_CALL + 1];
+    size_t i, j, n, seg_len, total, num_grp = 0;
+    struct msghdr *hdr;
+    struct cmsghdr *cmsg;
+    BIO_MSG *m, *mj;
+    int ret;
+
+    if (num_msg > BIO_MAX_MSGS_PER_CALL)
+        num_msg = BIO_MAX_MSGS_PER_CALL;
+
+    for (i = 0; i < num_msg; i = j) {
+        m = &BIO_MSG_N(msg, stride, i);
+        seg_len = m->data_len;
+        total = seg_len;
+
+        for (j = i + 1; j < num_msg && j - i < BIO_SEGMENT_MAX_MSGS; ++j) {
+            mj = &BIO_MSG_N(msg, stride, j);
+
+            /* A short segment can only come last. */
+            if (BIO_MSG_N(msg, stride, j - 1).data_len != seg_len
+                || mj->data_len == 0
+                || mj->data_len > seg_len
+                || total + mj->data_len > BIO_SEGMENT_MAX_LEN
+                || !msg_addr_eq(mj->peer, m->peer)
+                || !msg_addr_eq(mj->local, m->local))
+                break;
+
+            total += mj->data_len;
+        }
+
+        hdr = &mh[num_grp].msg_hdr;
+        translate_msg(b, hdr, &iov[i], control[num_grp], m);
+        for (n = i + 1; n < j; ++n) {
+            iov[n].iov_base = BIO_MSG_N(msg, stride, n).data;
+            iov[n].iov_len = BIO_MSG_N(msg, stride, n).data_len;
+        }
+        hdr->msg_iovlen = j - i;
+
+        if (m->local != NULL) {
+            if (!data->local_addr_enabled || pack_local(b, hdr, m->local) < 1) {
+                ERR_raise(ERR_LIB_BIO, BIO_R_LOCAL_ADDR_NOT_AVAILABLE);
+                *num_processed = 0;
+                return 0;
+            }
+        }
+
+        if (j - i > 1) {
+            /* Append the segment size after any packet info. */
+            n = m->local != NULL ? hdr->msg_controllen : 0;
+            cmsg = (struct cmsghdr *)(control[num_grp] + n);
+            cmsg->cmsg_len = BIO_CMSG_LEN(sizeof(uint16_t));
+            cmsg->cmsg_level = IPPROTO_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            *(uint16_t *)BIO_CMSG_DATA(cmsg) = (uint16_t)seg_len;
+            hdr->msg_control = control[num_grp];
+            hdr->msg_controllen = n + BIO_CMSG_SPACE(sizeof(uint16_t));
+        }
+
+        grp_start[num_grp++] = i;
+    }
+    grp_start[num_grp] = num_msg;
+
+    ret = sendmmsg(b->num, mh, (unsigned int)num_grp, sysflags);
+    if (ret < 0) {
+        if (get_last_socket_error() == EIO)
+            return -1;
+
+        ERR_raise(ERR_LIB_SYS, get_last_socket_error());
+        *num_processed = 0;
+        return 0;
+    }
+
+    for (i = 0; i < grp_start[ret]; ++i)
+        BIO_MSG_N(msg, stride, i).flags = 0;
+
+    *num_processed = grp_start[ret];
+    return 1;
+}
+
+/*
+ * Receives using UDP receive coalescing. The kernel may hand us several
+ * datagrams from the same sender concatenated into one buffer, along with the
+ * size of each segment. We hand these out one segment per BIO_MSG, holding any
+ * segments which do not fit in the caller's array for the next call.
+ */
+static int dgram_recvmmsg_coalesced(BIO *b, BIO_MSG *msg, size_t stride,
+    size_t num_msg, int sysflags,
+    size_t *num_processed)
+{
+    bio_dgram_data *data = (bio_dgram_data *)b->ptr;
+    struct msghdr mh;
+    struct iovec iov;
+    unsigned char control[BIO_CMSG_RX_ALLOC_LEN];
+    struct cmsghdr *cmsg;
+    BIO_MSG m = { 0 };
+    size_t i, len;
+    ossl_ssize_t l;
+
+    for (i = 0; i < num_msg; ++i)
+        /* If local address was requested, it must have been enabled */
+        if (BIO_MSG_N(msg, stride, i).local != NULL
+            && !data->local_addr_enabled) {
+            ERR_raise(ERR_LIB_BIO, BIO_R_LOCAL_ADDR_NOT_AVAILABLE);
+            *num_processed = 0;
+            return 0;
+        }
+
+    if (data->rx_coalesce_off >= data->rx_coalesce_len) {
+        BIO_ADDR_clear(&data->rx_coalesce_peer);
+        BIO_ADDR_clear(&data->rx_coalesce_local);
+        m.data = data->rx_coalesce_buf;
+        m.data_len = BIO_SEGMENT_MAX_LEN;
+        m.peer = &data->rx_coalesce_peer;
+        translate_msg(b, &mh, &iov, control, &m);
+        mh.msg_control = control;
+        mh.msg_controllen = sizeof(control);
+
+        l = recvmsg(b->num, &mh, sysflags);
+        if (l < 0) {
+            ERR_raise(ERR_LIB_SYS, get_last_socket_error());
+            *num_processed = 0;
+            return 0;
+        }
+
+        data->rx_coalesce_len = (size_t)l;
+        data->rx_coalesce_off = 0;
+        data->rx_coalesce_seg = (size_t)l;
+
+        for (cmsg = BIO_CMSG_FIRSTHDR(&mh); cmsg != NULL;
+            cmsg = BIO_CMSG_NXTHDR(&mh, cmsg))
+            if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO
+                && *(int *)BIO_CMSG_DATA(cmsg) > 0)
+                data->rx_coalesce_seg = (size_t)*(int *)BIO_CMSG_DATA(cmsg);
+
+        if (data->local_addr_enabled
+            && extract_local(b, &mh, &data->rx_coalesce_local) < 1)
+            BIO_ADDR_clear(&data->rx_coalesce_local);
+
+        if (l == 0) {
+            /* A zero-length datagram is still a datagram. */
+            m = BIO_MSG_N(msg, stride, 0);
+            BIO_MSG_N(msg, stride, 0).data_len = 0;
+            BIO_MSG_N(msg, stride, 0).flags = 0;
+            if (m.peer != NULL)
+                *m.peer = data->rx_coalesce_peer;
+            if (m.local != NULL)
+                *m.local = data->rx_coalesce_local;
+            *num_processed = 1;
+            return 1;
+        }
+    }
+
+    for (i = 0; i < num_msg && data->rx_coalesce_off < data->rx_coalesce_len;
+        ++i) {
+        BIO_MSG *out = &BIO_MSG_N(msg, stride, i);
+
+        len = data->rx_coalesce_len - data->rx_coalesce_off;
+        if (len > data->rx_coalesce_seg)
+            len = data->rx_coalesce_seg;
+
+        /* Truncate silently, as the kernel would for a short buffer. */
+        out->data_len = len < out->data_len ? len : out->data_len;
+        memcpy(out->data, data->rx_coalesce_buf + data->rx_coalesce_off,
+            out->data_len);
+        out->flags = 0;
+        if (out->peer != NULL)
+            *out->peer = data->rx_coalesce_peer;
+        if (out->local != NULL)
+            *out->local = data->rx_coalesce_local;
+
+        data->rx_coalesce_off += len;
+    }
+
+    *num_processed = i;
+    return 1;
+}
+#endif
+
 static int dgram_sendmmsg(BIO *b, BIO_MSG *msg, size_t stride,
     size_t num_msg, uint64_t flags, size_t *num_processed)
 {
@@ -1326,7 +1675,6 @@ static int dgram_sendmmsg(BIO *b, BIO_MSG *msg, size_t stride,
     int ret;
 #endif
 #if M_METHOD == M_METHOD_RECVMMSG
-#define BIO_MAX_MSGS_PER_CALL 64
     int sysflags;
     bio_dgram_data *data = (bio_dgram_data *)b->ptr;
     size_t i;
@@ -1377,6 +1725,21 @@ static int dgram_sendmmsg(BIO *b, BIO_MSG *msg, size_t stride,
     if (num_msg > BIO_MAX_MSGS_PER_CALL)
         num_msg = BIO_MAX_MSGS_PER_CALL;
 
+#if defined(SUPPORT_UDP_SEGMENTATION)
+    if (data->tx_segmentation_enabled) {
+        ret = dgram_sendmmsg_segmented(b, msg, stride, num_msg, sysflags,
+            num_processed);
+        if (ret >= 0)
+            return ret;
+
+        /*
+         * The route does not support segmentation offload. Stop using it and
+         * send the datagrams individually instead.
+         */
+        data->tx_segmentation_enabled = 0;
+    }
+#endif
+
     for (i = 0; i < num_msg; ++i) {
         translate_msg(b, &mh[i].msg_hdr, &iov[i],
             control[i], &BIO_MSG_N(msg, stride, i));
@@ -1580,6 +1943,14 @@ static int dgram_recvmmsg(BIO *b, BIO_MSG *msg,
     if (num_msg > BIO_MAX_MSGS_PER_CALL)
         num_msg = BIO_MAX_MSGS_PER_CALL;
 
+#if defined(SUPPORT_UDP_SEGMENTATION)
+    /* Drain any held segments even if coalescing has since been disabled. */
+    if (data->rx_coalescing_enabled
+        || data->rx_coalesce_off < data->rx_coalesce_len)
+        return dgram_recvmmsg_coalesced(b, msg, stride, num_msg, sysflags,
+            num_processed);
+#endif
+
     for (i = 0; i < num_msg; ++i) {
         translate_msg(b, &mh[i].msg_hdr, &iov[i],
             control[i], &BIO_MSG_N(msg, stride, i));
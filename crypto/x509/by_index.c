@@ -0,0 +1,522 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include "internal/e_os.h"
+#include "internal/cryptlib.h"
+#include "internal/packet.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(OPENSSL_SYS_UNIX) && !defined(OPENSSL_NO_POSIX_IO)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define BY_INDEX_USE_MMAP
+#endif
+
+#include <openssl/x509.h>
+#include "crypto/x509.h"
+#include "x509_local.h"
+
+/*
+ * A certificate index file is a precompiled trust store which can be mapped
+ * into memory and shared between processes.  All integers are in network
+ * byte order.
+ *
+ *     magic          "OSSLCAIX"
+ *     uint32 version 1
+ *     uint32 count
+ *     count entries of
+ *         uint32 subject name hash, see X509_NAME_hash_ex()
+ *         uint32 offset of the DER certificate from the start of the file
+ *         uint32 length of the DER certificate
+ *     DER certificates
+ *
+ * The entries are sorted by hash, so a lookup is a binary search followed by
+ * the parsing of the few certificates with a matching hash.
+ */
+#define INDEX_MAGIC "OSSLCAIX"
+#define INDEX_MAGIC_LEN 8
+#define INDEX_VERSION 1
+#define INDEX_HEADER_LEN (INDEX_MAGIC_LEN + 4 + 4)
+#define INDEX_ENTRY_LEN 12
+
+struct lookup_index_file_st {
+    unsigned char *data;
+    size_t len;
+    int mapped;
+    size_t count;
+    const unsigned char *entries;
+    /* Whether each entry has been added to the store, under BY_INDEX.lock */
+    unsigned char *loaded;
+};
+
+typedef struct lookup_index_st {
+    STACK_OF(BY_INDEX_FILE) *files;
+    CRYPTO_RWLOCK *lock;
+} BY_INDEX;
+
+static int index_ctrl(X509_LOOKUP *ctx, int cmd, const char *argp, long argl,
+    char **retp);
+static int new_index(X509_LOOKUP *lu);
+static void free_index(X509_LOOKUP *lu);
+static int get_cert_by_subject(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
+    const X509_NAME *name, X509_OBJECT *ret);
+static int get_cert_by_subject_ex(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
+    const X509_NAME *name, X509_OBJECT *ret,
+    OSSL_LIB_CTX *libctx, const char *propq);
+static X509_LOOKUP_METHOD x509_index_lookup = {
+    "Load certs from an indexed certificate file",
+    new_index, /* new_item */
+    free_index, /* free */
+    NULL, /* init */
+    NULL, /* shutdown */
+    index_ctrl, /* ctrl */
+    get_cert_by_subject, /* get_by_subject */
+    NULL, /* get_by_issuer_serial */
+    NULL, /* get_by_fingerprint */
+    NULL, /* get_by_alias */
+    get_cert_by_subject_ex, /* get_by_subject_ex */
+    NULL, /* ctrl_ex */
+};
+
+X509_LOOKUP_METHOD *X509_LOOKUP_index(void)
+{
+    return &x509_index_lookup;
+}
+
+static uint32_t load_u32(const unsigned char *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+        | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void index_file_free(BY_INDEX_FILE *f)
+{
+    if (f == NULL)
+        return;
+#ifdef BY_INDEX_USE_MMAP
+    if (f->mapped)
+        munmap(f->data, f->len);
+    else
+#endif
+        OPENSSL_free(f->data);
+    OPENSSL_free(f->loaded);
+    OPENSSL_free(f);
+}
+
+static int index_file_map(BY_INDEX_FILE *f, const char *file)
+{
+#ifdef BY_INDEX_USE_MMAP
+    struct stat st;
+    void *map;
+    int fd;
+
+    if ((fd = open(file, O_RDONLY)) < 0) {
+        ERR_raise_data(ERR_LIB_SYS, errno, "calling open(%s)", file);
+        return 0;
+    }
+    if (fstat(fd, &st) < 0) {
+        ERR_raise_data(ERR_LIB_SYS, errno, "calling fstat(%s)", file);
+        close(fd);
+        return 0;
+    }
+    if (st.st_size < INDEX_HEADER_LEN) {
+        ERR_raise_data(ERR_LIB_X509, X509_R_INVALID_CERT_INDEX, "%s", file);
+        close(fd);
+        return 0;
+    }
+    /*
+     * Map the file shared and read-only, so that all processes using the
+     * same index share its pages.
+     */
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        ERR_raise_data(ERR_LIB_SYS, errno, "calling mmap(%s)", file);
+        return 0;
+    }
+    f->data = map;
+    f->len = (size_t)st.st_size;
+    f->mapped = 1;
+    return 1;
+#else
+    BIO *in = BIO_new_file(file, "rb");
+    BUF_MEM *b = NULL;
+    char buf[4096];
+    int n, ok = 0;
+
+    if (in == NULL)
+        return 0;
+    if ((b = BUF_MEM_new()) == NULL)
+        goto err;
+    while ((n = BIO_read(in, buf, sizeof(buf))) > 0) {
+        size_t len = b->length;
+
+        if (!BUF_MEM_grow(b, len + n))
+            goto err;
+        memcpy(b->data + len, buf, n);
+    }
+    f->len = b->length;
+    f->data = (unsigned char *)b->data;
+    b->data = NULL;
+    f->mapped = 0;
+    ok = 1;
+err:
+    BUF_MEM_free(b);
+    BIO_free(in);
+    return ok;
+#endif
+}
+
+/*
+ * Check the header and that all entries are sorted and point into the file,
+ * so that lookups need no further bounds checks.
+ */
+static int index_file_check(BY_INDEX_FILE *f)
+{
+    PACKET pkt, magic;
+    unsigned long version, count, hash, prev = 0, off, len;
+    size_t i;
+
+    if (!PACKET_buf_init(&pkt, f->data, f->len)
+        || !PACKET_get_sub_packet(&pkt, &magic, INDEX_MAGIC_LEN)
+        || memcmp(PACKET_data(&magic), INDEX_MAGIC, INDEX_MAGIC_LEN) != 0
+        || !PACKET_get_net_4(&pkt, &version)
+        || version != INDEX_VERSION
+        || !PACKET_get_net_4(&pkt, &count)
+        || count > PACKET_remaining(&pkt) / INDEX_ENTRY_LEN)
+        return 0;
+
+    f->count = count;
+    f->entries = PACKET_data(&pkt);
+    for (i = 0; i < f->count; i++) {
+        if (!PACKET_get_net_4(&pkt, &hash)
+            || !PACKET_get_net_4(&pkt, &off)
+            || !PACKET_get_net_4(&pkt, &len))
+            return 0;
+        if ((i > 0 && hash < prev)
+            || len == 0
+            || off < INDEX_HEADER_LEN + f->count * INDEX_ENTRY_LEN
+            || off > f->len
+            || len > f->len - off)
+            return 0;
+        prev = hash;
+    }
+    return 1;
+}
+
+static int add_index_file(BY_INDEX *ctx, const char *file)
+{
+    BY_INDEX_FILE *f;
+
+    if (file == NULL) {
+        ERR_raise(ERR_LIB_X509, ERR_R_PASSED_NULL_PARAMETER);
+        return 0;
+    }
+    if ((f = OPENSSL_zalloc(sizeof(*f))) == NULL)
+        return 0;
+    if (!index_file_map(f, file))
+        goto err;
+    if (!index_file_check(f)) {
+        ERR_raise_data(ERR_LIB_X509, X509_R_INVALID_CERT_INDEX, "%s", file);
+        goto err;
+    }
+    if (f->count > 0 && (f->loaded = OPENSSL_zalloc(f->count)) == NULL)
+        goto err;
+
+    if (!CRYPTO_THREAD_write_lock(ctx->lock))
+        goto err;
+    if (!sk_BY_INDEX_FILE_push(ctx->files, f)) {
+        CRYPTO_THREAD_unlock(ctx->lock);
+        ERR_raise(ERR_LIB_X509, ERR_R_CRYPTO_LIB);
+        goto err;
+    }
+    CRYPTO_THREAD_unlock(ctx->lock);
+    return 1;
+
+err:
+    index_file_free(f);
+    return 0;
+}
+
+static int index_ctrl(X509_LOOKUP *ctx, int cmd, const char *argp, long argl,
+    char **retp)
+{
+    BY_INDEX *ld = (BY_INDEX *)ctx->method_data;
+
+    switch (cmd) {
+    case X509_L_LOAD_INDEX:
+        return add_index_file(ld, argp);
+    }
+    return 0;
+}
+
+static int new_index(X509_LOOKUP *lu)
+{
+    BY_INDEX *a = OPENSSL_zalloc(sizeof(*a));
+
+    if (a == NULL)
+        return 0;
+    if ((a->files = sk_BY_INDEX_FILE_new_null()) == NULL) {
+        ERR_raise(ERR_LIB_X509, ERR_R_CRYPTO_LIB);
+        goto err;
+    }
+    if ((a->lock = CRYPTO_THREAD_lock_new()) == NULL) {
+        ERR_raise(ERR_LIB_X509, ERR_R_CRYPTO_LIB);
+        goto err;
+    }
+    lu->method_data = a;
+    return 1;
+
+err:
+    sk_BY_INDEX_FILE_free(a->files);
+    OPENSSL_free(a);
+    return 0;
+}
+
+static void free_index(X509_LOOKUP *lu)
+{
+    BY_INDEX *a = (BY_INDEX *)lu->method_data;
+
+    sk_BY_INDEX_FILE_pop_free(a->files, index_file_free);
+    CRYPTO_THREAD_lock_free(a->lock);
+    OPENSSL_free(a);
+}
+
+/* Returns the first entry of |f| with hash |h| and sets |*end| past the last */
+static size_t index_file_find(const BY_INDEX_FILE *f, uint32_t h, size_t *end)
+{
+    size_t lo = 0, hi = f->count, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (load_u32(f->entries + mid * INDEX_ENTRY_LEN) < h)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (hi = lo; hi < f->count; hi++)
+        if (load_u32(f->entries + hi * INDEX_ENTRY_LEN) != h)
+            break;
+    *end = hi;
+    return lo;
+}
+
+/*
+ * Finds the entries with hash |h|.  Returns the number of matching entries,
+ * and sets |*pending| if some of them have not yet been added to the store.
+ */
+static size_t index_match(BY_INDEX *ctx, uint32_t h, int *pending)
+{
+    size_t i, j, end, matched = 0;
+
+    *pending = 0;
+    for (i = 0; i < (size_t)sk_BY_INDEX_FILE_num(ctx->files); i++) {
+        BY_INDEX_FILE *f = sk_BY_INDEX_FILE_value(ctx->files, (int)i);
+
+        for (j = index_file_find(f, h, &end); j < end; j++, matched++)
+            if (!f->loaded[j])
+                *pending = 1;
+    }
+    return matched;
+}
+
+/*
+ * Parses the entries with hash |h| which are not in the store yet and adds
+ * them.  Entries which fail to parse are skipped, as by_dir does with files.
+ * Must be called with the write lock held.
+ */
+static void index_load(BY_INDEX *ctx, X509_STORE *store, uint32_t h,
+    OSSL_LIB_CTX *libctx, const char *propq)
+{
+    size_t i, j, end;
+
+    for (i = 0; i < (size_t)sk_BY_INDEX_FILE_num(ctx->files); i++) {
+        BY_INDEX_FILE *f = sk_BY_INDEX_FILE_value(ctx->files, (int)i);
+
+        for (j = index_file_find(f, h, &end); j < end; j++) {
+            const unsigned char *ent = f->entries + j * INDEX_ENTRY_LEN;
+            const unsigned char *p = f->data + load_u32(ent + 4);
+            long len = (long)load_u32(ent + 8);
+            X509 *x;
+
+            if (f->loaded[j])
+                continue;
+            f->loaded[j] = 1;
+
+            ERR_set_mark();
+            x = X509_new_ex(libctx, propq);
+            if (x != NULL && d2i_X509(&x, &p, len) != NULL)
+                X509_STORE_add_cert(store, x);
+            X509_free(x);
+            ERR_pop_to_mark();
+        }
+    }
+}
+
+static int get_cert_by_subject_ex(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
+    const X509_NAME *name, X509_OBJECT *ret,
+    OSSL_LIB_CTX *libctx, const char *propq)
+{
+    BY_INDEX *ctx = (BY_INDEX *)xl->method_data;
+    X509 st_x509;
+    X509_OBJECT stmp, *tmp = NULL;
+    STACK_OF(X509_OBJECT) *objs;
+    size_t matched;
+    unsigned long h;
+    int pending, ok;
+
+    if (name == NULL)
+        return 0;
+    /* The index only holds certificates */
+    if (type != X509_LU_X509)
+        return 0;
+
+    h = X509_NAME_hash_ex(name, libctx, propq, &ok);
+    if (!ok)
+        return 0;
+
+    if (!CRYPTO_THREAD_read_lock(ctx->lock))
+        return 0;
+    matched = index_match(ctx, (uint32_t)h, &pending);
+    CRYPTO_THREAD_unlock(ctx->lock);
+    if (matched == 0)
+        return 0;
+
+    if (pending) {
+        if (!CRYPTO_THREAD_write_lock(ctx->lock))
+            return 0;
+        index_load(ctx, xl->store_ctx, (uint32_t)h, libctx, propq);
+        CRYPTO_THREAD_unlock(ctx->lock);
+    }
+
+    /* The matching certificates are in the store now, pull one out again */
+    st_x509.cert_info.subject = (X509_NAME *)name; /* won't modify it */
+    stmp.type = X509_LU_X509;
+    stmp.data.x509 = &st_x509;
+
+    if (!ossl_x509_store_read_lock(xl->store_ctx))
+        return 0;
+    if (xl->store_ctx->objs_ht)
+        objs = ossl_x509_store_ht_get_by_name(xl->store_ctx, name);
+    else
+        objs = xl->store_ctx->objs;
+    if (objs != NULL)
+        tmp = sk_X509_OBJECT_value(objs, sk_X509_OBJECT_find(objs, &stmp));
+    X509_STORE_unlock(xl->store_ctx);
+
+    if (tmp == NULL)
+        return 0;
+    ret->type = tmp->type;
+    memcpy(&ret->data, &tmp->data, sizeof(ret->data));
+    return 1;
+}
+
+static int get_cert_by_subject(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
+    const X509_NAME *name, X509_OBJECT *ret)
+{
+    return get_cert_by_subject_ex(xl, type, name, ret, NULL, NULL);
+}
+
+typedef struct {
+    uint32_t hash;
+    int idx;
+    size_t len;
+} INDEX_WRITE_ENTRY;
+
+static int index_write_entry_cmp(const void *a, const void *b)
+{
+    const INDEX_WRITE_ENTRY *ea = a, *eb = b;
+
+    if (ea->hash != eb->hash)
+        return ea->hash < eb->hash ? -1 : 1;
+    return ea->idx - eb->idx;
+}
+
+int X509_write_cert_index(BIO *out, const STACK_OF(X509) *certs)
+{
+    INDEX_WRITE_ENTRY *ents = NULL;
+    BUF_MEM *buf = NULL;
+    WPACKET pkt;
+    int n = sk_X509_num(certs), i, ok, ret = 0, pkt_init = 0;
+    size_t off, written;
+    unsigned char *der;
+
+    if (out == NULL || n < 0) {
+        ERR_raise(ERR_LIB_X509, ERR_R_PASSED_NULL_PARAMETER);
+        return 0;
+    }
+    if (n > 0 && (ents = OPENSSL_malloc_array(n, sizeof(*ents))) == NULL)
+        return 0;
+
+    off = INDEX_HEADER_LEN + (size_t)n * INDEX_ENTRY_LEN;
+    for (i = 0; i < n; i++) {
+        X509 *x = sk_X509_value(certs, i);
+        int len = i2d_X509(x, NULL);
+
+        if (len <= 0)
+            goto err;
+        ents[i].hash = (uint32_t)X509_NAME_hash_ex(X509_get_subject_name(x),
+            x->libctx, x->propq, &ok);
+        if (!ok)
+            goto err;
+        ents[i].idx = i;
+        ents[i].len = (size_t)len;
+        off += (size_t)len;
+        if (off > UINT32_MAX) {
+            ERR_raise(ERR_LIB_X509, X509_R_INVALID_CERT_INDEX);
+            goto err;
+        }
+    }
+    if (n > 1)
+        qsort(ents, n, sizeof(*ents), index_write_entry_cmp);
+
+    if ((buf = BUF_MEM_new()) == NULL || !WPACKET_init(&pkt, buf)) {
+        ERR_raise(ERR_LIB_X509, ERR_R_CRYPTO_LIB);
+        goto err;
+    }
+    pkt_init = 1;
+    if (!WPACKET_memcpy(&pkt, INDEX_MAGIC, INDEX_MAGIC_LEN)
+        || !WPACKET_put_bytes_u32(&pkt, INDEX_VERSION)
+        || !WPACKET_put_bytes_u32(&pkt, (uint32_t)n))
+        goto err;
+    /* Certificates are stored in index order, so that equal hashes are close */
+    off = INDEX_HEADER_LEN + (size_t)n * INDEX_ENTRY_LEN;
+    for (i = 0; i < n; i++) {
+        if (!WPACKET_put_bytes_u32(&pkt, ents[i].hash)
+            || !WPACKET_put_bytes_u32(&pkt, (uint32_t)off)
+            || !WPACKET_put_bytes_u32(&pkt, (uint32_t)ents[i].len))
+            goto err;
+        off += ents[i].len;
+    }
+    for (i = 0; i < n; i++) {
+        if (!WPACKET_allocate_bytes(&pkt, ents[i].len, &der)
+            || i2d_X509(sk_X509_value(certs, ents[i].idx), &der)
+                != (int)ents[i].len)
+            goto err;
+    }
+    if (!WPACKET_get_total_written(&pkt, &written)
+        || !WPACKET_finish(&pkt))
+        goto err;
+    pkt_init = 0;
+    if (BIO_write(out, buf->data, (int)written) != (int)written)
+        goto err;
+    ret = 1;
+
+err:
+    if (pkt_init)
+        WPACKET_cleanup(&pkt);
+    BUF_MEM_free(buf);
+    OPENSSL_free(ents);
+    return ret;
+}
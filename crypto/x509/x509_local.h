@@ -132,6 +132,13 @@ HT_DEF_KEY_FIELD(xn_canon, unsigned char *)
 HT_DEF_KEY_FIELD(xn_canon_enclen, int)
 HT_END_KEY_DEFN(OBJS_KEY)
 
+/* SHA-256 of the inputs of a verification, see x509_vfy.c */
+#define X509_VERIFY_CACHE_KEY_LEN 32
+
+HT_START_KEY_DEFN(verify_cache_key)
+HT_DEF_KEY_FIELD_UINT8T_ARRAY(digest, X509_VERIFY_CACHE_KEY_LEN)
+HT_END_KEY_DEFN(VERIFY_CACHE_KEY)
+
 /*
  * This is used to hold everything.  It is used for all certificate
  * validation.  Once we have a certificate chain, the 'verify' function is
@@ -177,12 +184,19 @@ struct x509_store_st {
     CRYPTO_EX_DATA ex_data;
     CRYPTO_REF_COUNT references;
     CRYPTO_RWLOCK *lock;
+    /* Maps verification inputs -> verified chain, NULL if not enabled */
+    HT *verify_cache;
+    size_t verify_cache_size;
+    uint64_t verify_cache_hits;
+    uint64_t verify_cache_misses;
 };
 
 typedef struct lookup_dir_hashes_st BY_DIR_HASH;
 typedef struct lookup_dir_entry_st BY_DIR_ENTRY;
 DEFINE_STACK_OF(BY_DIR_HASH)
 DEFINE_STACK_OF(BY_DIR_ENTRY)
+typedef struct lookup_index_file_st BY_INDEX_FILE;
+DEFINE_STACK_OF(BY_INDEX_FILE)
 typedef STACK_OF(X509_NAME_ENTRY) STACK_OF_X509_NAME_ENTRY;
 DEFINE_STACK_OF(STACK_OF_X509_NAME_ENTRY)
 
@@ -194,6 +208,11 @@ int ossl_x509_store_ctx_get_by_subject(const X509_STORE_CTX *ctx, X509_LOOKUP_TY
 __owur int ossl_x509_store_read_lock(X509_STORE *xs);
 STACK_OF(X509_OBJECT) *ossl_x509_store_ht_get_by_name(const X509_STORE *store,
     const X509_NAME *xn);
+int ossl_x509_store_verify_cache_get(X509_STORE *xs, const unsigned char *key,
+    int64_t now, STACK_OF(X509) **chain, int *num_untrusted);
+void ossl_x509_store_verify_cache_add(X509_STORE *xs, const unsigned char *key,
+    int64_t expiry, STACK_OF(X509) *chain, int num_untrusted);
+int ossl_x509_crl_decode_revoked(X509_CRL *crl, int drop_index);
 int ossl_x509_check_rfc822(X509 *x, const char *chk, size_t chklen,
     unsigned int flags);
 int ossl_x509_check_smtputf8(X509 *x, const char *chk, size_t chklen,
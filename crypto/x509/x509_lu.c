@@ -18,6 +18,14 @@
 #include "x509_local.h"
 
 #define X509_OBJS_HT_BUCKETS 8
+#define X509_VERIFY_CACHE_HT_BUCKETS 64
+
+/* A chain which was successfully verified, see x509_vfy.c */
+typedef struct verify_cache_entry_st {
+    STACK_OF(X509) *chain;
+    int num_untrusted;
+    int64_t expiry;
+} VERIFY_CACHE_ENTRY;
 
 X509_LOOKUP *X509_LOOKUP_new(X509_LOOKUP_METHOD *method)
 {
@@ -280,6 +288,7 @@ void X509_STORE_free(X509_STORE *xs)
     CRYPTO_THREAD_lock_free(xs->lock);
     CRYPTO_FREE_REF(&xs->references);
     ossl_ht_free(xs->objs_ht);
+    ossl_ht_free(xs->verify_cache);
     OPENSSL_free(xs);
 }
 
@@ -405,6 +414,167 @@ static int x509_name_objs_ht_insert(const X509_STORE *store, const X509_NAME *xn
     return 1;
 }
 
+static void verify_cache_free(HT_VALUE *v)
+{
+    VERIFY_CACHE_ENTRY *e = v->value;
+
+    OSSL_STACK_OF_X509_free(e->chain);
+    OPENSSL_free(e);
+}
+
+static uint64_t verify_cache_hash(HT_KEY *key)
+{
+    VERIFY_CACHE_KEY *k = (VERIFY_CACHE_KEY *)key;
+    uint64_t hash;
+
+    /* The key is a digest already */
+    memcpy(&hash, k->keyfields.digest, sizeof(hash));
+    return hash;
+}
+
+int X509_STORE_set_verify_cache_size(X509_STORE *xs, size_t size)
+{
+    HT_CONFIG htconf = {
+        .ht_free_fn = verify_cache_free,
+        .ht_hash_fn = verify_cache_hash,
+        .init_neighborhoods = X509_VERIFY_CACHE_HT_BUCKETS,
+        .collision_check = 1,
+    };
+
+    if (size == 0) {
+        ossl_ht_free(xs->verify_cache);
+        xs->verify_cache = NULL;
+        xs->verify_cache_size = 0;
+        return 1;
+    }
+    if (xs->verify_cache == NULL) {
+        if ((xs->verify_cache = ossl_ht_new(&htconf)) == NULL) {
+            ERR_raise(ERR_LIB_X509, ERR_R_CRYPTO_LIB);
+            return 0;
+        }
+    }
+    ossl_ht_write_lock(xs->verify_cache);
+    xs->verify_cache_size = size;
+    if (ossl_ht_count(xs->verify_cache) > size)
+        ossl_ht_flush(xs->verify_cache);
+    ossl_ht_write_unlock(xs->verify_cache);
+    return 1;
+}
+
+int X509_STORE_flush_verify_cache(X509_STORE *xs)
+{
+    int ret;
+
+    if (xs->verify_cache == NULL)
+        return 1;
+    ossl_ht_write_lock(xs->verify_cache);
+    ret = ossl_ht_flush(xs->verify_cache);
+    ossl_ht_write_unlock(xs->verify_cache);
+    return ret;
+}
+
+int X509_STORE_get_verify_cache_stats(X509_STORE *xs, uint64_t *hits,
+    uint64_t *misses, size_t *entries)
+{
+    if (hits != NULL
+        && !CRYPTO_atomic_load(&xs->verify_cache_hits, hits, xs->lock))
+        return 0;
+    if (misses != NULL
+        && !CRYPTO_atomic_load(&xs->verify_cache_misses, misses, xs->lock))
+        return 0;
+    if (entries != NULL) {
+        *entries = 0;
+        if (xs->verify_cache != NULL) {
+            if (!ossl_ht_read_lock(xs->verify_cache))
+                return 0;
+            *entries = ossl_ht_count(xs->verify_cache);
+            ossl_ht_read_unlock(xs->verify_cache);
+        }
+    }
+    return 1;
+}
+
+/*
+ * Looks up the result of an earlier verification with the inputs |key|.
+ * On a hit returns 1 with a copy of the verified chain in |*chain|.
+ * Lookups only take the RCU read lock, so they do not block each other.
+ */
+int ossl_x509_store_verify_cache_get(X509_STORE *xs, const unsigned char *key,
+    int64_t now, STACK_OF(X509) **chain, int *num_untrusted)
+{
+    VERIFY_CACHE_KEY vkey;
+    VERIFY_CACHE_ENTRY *e;
+    HT_VALUE *v;
+    uint64_t tmp;
+    int expired = 0;
+
+    *chain = NULL;
+    HT_INIT_KEY(&vkey);
+    HT_SET_KEY_BLOB(&vkey, digest, key, X509_VERIFY_CACHE_KEY_LEN);
+
+    if (!ossl_ht_read_lock(xs->verify_cache))
+        return 0;
+    v = ossl_ht_get(xs->verify_cache, TO_HT_KEY(&vkey));
+    if (v != NULL) {
+        v = ossl_ht_deref_value(xs->verify_cache, &v);
+        e = v->value;
+        if (now >= e->expiry)
+            expired = 1;
+        else if ((*chain = X509_chain_up_ref(e->chain)) != NULL)
+            *num_untrusted = e->num_untrusted;
+    }
+    ossl_ht_read_unlock(xs->verify_cache);
+
+    if (expired) {
+        ossl_ht_write_lock(xs->verify_cache);
+        ossl_ht_delete(xs->verify_cache, TO_HT_KEY(&vkey));
+        ossl_ht_write_unlock(xs->verify_cache);
+    }
+
+    if (*chain == NULL) {
+        CRYPTO_atomic_add64(&xs->verify_cache_misses, 1, &tmp, xs->lock);
+        return 0;
+    }
+    CRYPTO_atomic_add64(&xs->verify_cache_hits, 1, &tmp, xs->lock);
+    return 1;
+}
+
+/*
+ * Remembers that the verification with the inputs |key| succeeded with
+ * the chain |chain| and that this result holds until |expiry|.  When the
+ * cache is full it is emptied, so that it follows changes of the working set.
+ */
+void ossl_x509_store_verify_cache_add(X509_STORE *xs, const unsigned char *key,
+    int64_t expiry, STACK_OF(X509) *chain, int num_untrusted)
+{
+    VERIFY_CACHE_KEY vkey;
+    VERIFY_CACHE_ENTRY *e;
+    HT_VALUE val = { 0 };
+
+    if ((e = OPENSSL_zalloc(sizeof(*e))) == NULL)
+        return;
+    if ((e->chain = X509_chain_up_ref(chain)) == NULL) {
+        OPENSSL_free(e);
+        return;
+    }
+    e->num_untrusted = num_untrusted;
+    e->expiry = expiry;
+
+    HT_INIT_KEY(&vkey);
+    HT_SET_KEY_BLOB(&vkey, digest, key, X509_VERIFY_CACHE_KEY_LEN);
+    val.value = e;
+
+    ossl_ht_write_lock(xs->verify_cache);
+    if (ossl_ht_count(xs->verify_cache) >= xs->verify_cache_size)
+        ossl_ht_flush(xs->verify_cache);
+    if (ossl_ht_insert(xs->verify_cache, TO_HT_KEY(&vkey), &val, NULL) != 1) {
+        /* Most likely added by another thread in the meantime */
+        OSSL_STACK_OF_X509_free(e->chain);
+        OPENSSL_free(e);
+    }
+    ossl_ht_write_unlock(xs->verify_cache);
+}
+
 static int obj_ht_foreach_certs(HT_VALUE *v, void *arg)
 {
     STACK_OF(X509) **sk = arg;
@@ -542,6 +712,9 @@ static int x509_store_add_obj(X509_STORE *store, X509_OBJECT *obj)
 
     if (added == 0) /* obj not pushed */
         X509_OBJECT_free(obj);
+    else if (store->verify_cache != NULL)
+        /* A new certificate or CRL can change the result of a verification */
+        X509_STORE_flush_verify_cache(store);
 
     return ret;
 }
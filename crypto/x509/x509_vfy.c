@@ -48,6 +48,7 @@ static int x509_verify_x509(X509_STORE_CTX *ctx);
 static int x509_verify_rpk(X509_STORE_CTX *ctx);
 static int build_chain(X509_STORE_CTX *ctx);
 static int verify_chain(X509_STORE_CTX *ctx);
+static int verify_chain_cached(X509_STORE_CTX *ctx);
 static int verify_rpk(X509_STORE_CTX *ctx);
 static int dane_verify(X509_STORE_CTX *ctx);
 static int dane_verify_rpk(X509_STORE_CTX *ctx);
@@ -378,7 +379,8 @@ static int x509_verify_x509(X509_STORE_CTX *ctx)
     CB_FAIL_IF(!check_cert_key_level(ctx, ctx->cert),
         ctx, ctx->cert, 0, X509_V_ERR_EE_KEY_TOO_SMALL);
 
-    ret = DANETLS_ENABLED(ctx->dane) ? dane_verify(ctx) : verify_chain(ctx);
+    ret = DANETLS_ENABLED(ctx->dane) ? dane_verify(ctx)
+                                     : verify_chain_cached(ctx);
 
     /*
      * Safety-net.  If we are returning an error, we must also set ctx->error,
@@ -1077,6 +1079,23 @@ static int certificate_time_to_posix(const ASN1_TIME *ctm, int64_t *out_time)
     return 1;
 }
 
+/*
+ * A successful verification may only be cached until |tm|, which is the next
+ * update time of a CRL or OCSP response that was used.  A NULL |tm| means it
+ * must not be cached at all.
+ */
+static void limit_verify_cache_expiry(X509_STORE_CTX *ctx, const ASN1_TIME *tm)
+{
+    int64_t t = 0;
+
+    if (tm != NULL && !certificate_time_to_posix(tm, &t))
+        t = 0;
+    /* CRLs checked while validating a CRL path limit the outer result too */
+    for (; ctx != NULL; ctx = ctx->parent)
+        if (t < ctx->verify_cache_expiry)
+            ctx->verify_cache_expiry = t;
+}
+
 /* Returns -1 on internal error */
 static int check_trust(X509_STORE_CTX *ctx, int num_untrusted)
 {
@@ -1393,10 +1412,12 @@ static int check_cert_ocsp_resp(X509_STORE_CTX *ctx)
          * A OCSP stapling result will be accepted up to 5 minutes
          * after it expired!
          */
-        if (!OCSP_check_validity(thisupd, nextupd, 300L, -1L))
+        if (!OCSP_check_validity(thisupd, nextupd, 300L, -1L)) {
             ret = X509_V_ERR_OCSP_HAS_EXPIRED;
-        else
+        } else {
+            limit_verify_cache_expiry(ctx, nextupd);
             ret = V_OCSP_CERTSTATUS_GOOD;
+        }
     } else {
         ret = cert_status;
     }
@@ -1473,6 +1494,11 @@ static int check_cert_crl(X509_STORE_CTX *ctx)
                 goto done;
         }
 
+        if (X509_CRL_get0_nextUpdate(crl) != NULL)
+            limit_verify_cache_expiry(ctx, X509_CRL_get0_nextUpdate(crl));
+        if (dcrl != NULL && X509_CRL_get0_nextUpdate(dcrl) != NULL)
+            limit_verify_cache_expiry(ctx, X509_CRL_get0_nextUpdate(dcrl));
+
         ctx->current_crl = NULL;
         X509_CRL_free(crl);
         X509_CRL_free(dcrl);
@@ -2212,6 +2238,152 @@ memerr:
     return -1;
 }
 
+/*
+ * Returns 1 if the result of the verification with |ctx| depends only on the
+ * certificates, the verification parameters and the contents of the store, so
+ * that it can be taken from or added to the verified-chain cache of the store.
+ * Callbacks set by the application might see or change intermediate results.
+ */
+static int verify_cache_usable(const X509_STORE_CTX *ctx)
+{
+    unsigned long flags = ctx->param->flags;
+
+    if (ctx->store == NULL || ctx->store->verify_cache == NULL
+        || ctx->parent != NULL || ctx->crls != NULL)
+        return 0;
+    if ((flags & (X509_V_FLAG_USE_CHECK_TIME | X509_V_FLAG_NO_CHECK_TIME)) != 0)
+        return 0;
+    /* The policy tree is not cached */
+    if ((flags & X509_V_FLAG_POLICY_CHECK) != 0)
+        return 0;
+
+    return ctx->verify_cb == null_callback
+        && ctx->verify == internal_verify
+        && ctx->get_issuer == X509_STORE_CTX_get1_issuer
+        && ctx->check_issued == check_issued
+        && ctx->check_revocation == check_revocation
+        && ctx->get_crl == NULL
+        && ctx->check_crl == check_crl
+        && ctx->cert_crl == cert_crl
+        && ctx->lookup_certs == X509_STORE_CTX_get1_certs
+        && ctx->lookup_crls == X509_STORE_CTX_get1_crls;
+}
+
+/*
+ * Computes the cache key of the verification with |ctx|: a digest of the
+ * target and untrusted certificates, of the stapled OCSP responses if they
+ * are checked, and of the verification parameters the result depends on.
+ * The peer identity is not part of it, see verify_chain_cached().
+ */
+static int verify_cache_key(X509_STORE_CTX *ctx, unsigned char *key)
+{
+    const X509_VERIFY_PARAM *vpm = ctx->param;
+    EVP_MD *md = NULL;
+    EVP_MD_CTX *mdctx = NULL;
+    unsigned char dgst[EVP_MAX_MD_SIZE];
+    unsigned int dgstlen;
+    int64_t params[6];
+    int i, num = sk_X509_num(ctx->untrusted), ret = 0;
+
+    ERR_set_mark();
+    md = EVP_MD_fetch(ctx->libctx, "SHA2-256", ctx->propq);
+    if (md == NULL || EVP_MD_get_size(md) != X509_VERIFY_CACHE_KEY_LEN
+        || (mdctx = EVP_MD_CTX_new()) == NULL
+        || !EVP_DigestInit_ex(mdctx, md, NULL))
+        goto end;
+
+    params[0] = (int64_t)vpm->flags;
+    params[1] = vpm->purpose;
+    params[2] = vpm->trust;
+    params[3] = vpm->depth;
+    params[4] = vpm->auth_level;
+    params[5] = num;
+    if (!EVP_DigestUpdate(mdctx, params, sizeof(params)))
+        goto end;
+
+    for (i = -1; i < num; i++) {
+        X509 *x = i < 0 ? ctx->cert : sk_X509_value(ctx->untrusted, i);
+
+        if (!X509_digest(x, md, dgst, &dgstlen)
+            || !EVP_DigestUpdate(mdctx, dgst, dgstlen))
+            goto end;
+    }
+
+#ifndef OPENSSL_NO_OCSP
+    if ((vpm->flags & X509_V_FLAG_OCSP_RESP_CHECK) != 0) {
+        for (i = 0; i < sk_OCSP_RESPONSE_num(ctx->ocsp_resp); i++) {
+            OCSP_RESPONSE *resp = sk_OCSP_RESPONSE_value(ctx->ocsp_resp, i);
+
+            if (!ASN1_item_digest(ASN1_ITEM_rptr(OCSP_RESPONSE), md, resp,
+                    dgst, &dgstlen)
+                || !EVP_DigestUpdate(mdctx, dgst, dgstlen))
+                goto end;
+        }
+    }
+#endif
+
+    ret = EVP_DigestFinal_ex(mdctx, key, NULL);
+
+end:
+    EVP_MD_CTX_free(mdctx);
+    EVP_MD_free(md);
+    ERR_pop_to_mark();
+    return ret;
+}
+
+/*-
+ * verify_chain() with the verified-chain cache of the store, if enabled, see
+ * X509_STORE_set_verify_cache_size().  On a hit the chain is taken from the
+ * cache and only the peer identity checks are repeated.
+ *
+ * Returns -1 on internal error.
+ * Sadly, returns 0 also on internal error in ctx->verify_cb().
+ */
+static int verify_chain_cached(X509_STORE_CTX *ctx)
+{
+    unsigned char key[X509_VERIFY_CACHE_KEY_LEN];
+    STACK_OF(X509) *chain = NULL;
+    int64_t now = (int64_t)time(NULL), expiry, not_after;
+    int i, num_untrusted, ret;
+
+    if (!verify_cache_usable(ctx) || !verify_cache_key(ctx, key))
+        return verify_chain(ctx);
+
+    if (ossl_x509_store_verify_cache_get(ctx->store, key, now, &chain,
+            &num_untrusted)) {
+        /* Keep the target certificate of the caller at the bottom */
+        if (!X509_up_ref(ctx->cert)) {
+            OSSL_STACK_OF_X509_free(chain);
+            ctx->error = X509_V_ERR_UNSPECIFIED;
+            return -1;
+        }
+        X509_free(sk_X509_set(chain, 0, ctx->cert));
+        OSSL_STACK_OF_X509_free(ctx->chain);
+        ctx->chain = chain;
+        ctx->num_untrusted = num_untrusted;
+        return check_id(ctx);
+    }
+
+    ctx->verify_cache_expiry = INT64_MAX;
+    ret = verify_chain(ctx);
+    if (ret <= 0 || ctx->error != X509_V_OK)
+        return ret;
+
+    expiry = ctx->verify_cache_expiry;
+    for (i = 0; i < sk_X509_num(ctx->chain); i++) {
+        X509 *x = sk_X509_value(ctx->chain, i);
+
+        if (!certificate_time_to_posix(X509_get0_notAfter(x), &not_after))
+            return ret;
+        if (not_after < expiry)
+            expiry = not_after;
+    }
+    if (expiry > now)
+        ossl_x509_store_verify_cache_add(ctx->store, key, expiry, ctx->chain,
+            ctx->num_untrusted);
+    return ret;
+}
+
 /*-
  * Check certificate validity times.
  *
@@ -15,6 +15,7 @@
 #include <openssl/evp.h>
 #include <openssl/x509.h>
 #include "crypto/x509.h"
+#include "x509_local.h"
 
 int X509_CRL_set_version(X509_CRL *x, long version)
 {
@@ -59,6 +60,8 @@ int X509_CRL_sort(X509_CRL *c)
     int i;
     X509_REVOKED *r;
 
+    if (!ossl_x509_crl_decode_revoked(c, 1))
+        return 0;
     /*
      * sort the data so it will be written in serial number order
      */
@@ -122,6 +125,9 @@ const STACK_OF(X509_EXTENSION) *X509_CRL_get0_extensions(const X509_CRL *crl)
 
 STACK_OF(X509_REVOKED) *X509_CRL_get_REVOKED(const X509_CRL *crl)
 {
+    /* The entries of an indexed CRL are decoded on first use */
+    if (!ossl_x509_crl_decode_revoked((X509_CRL *)crl, 0))
+        return NULL;
     return crl->crl.revoked;
 }
 
@@ -129,14 +129,68 @@ static int i2d_ECPrivateKey_thunk(const void *a, unsigned char **out)
 }
 #endif
 
+/*
+ * The issuer key of a successful signature verification is remembered on the
+ * certificate, so that the signature of a certificate shared by many chain
+ * verifications, like an intermediate CA certificate in a trust store, is
+ * checked only once.  This is done only for certificates which have not been
+ * modified since they were decoded, and which have no distinguishing ID as
+ * that is an input to the verification which may change.
+ */
+static int x509_sig_cacheable(const X509 *a)
+{
+    return !a->cert_info.enc.modified && a->distinguishing_id == NULL;
+}
+
+static int x509_sig_verified(const X509 *a, EVP_PKEY *r)
+{
+    int ret = 0;
+
+    if (!x509_sig_cacheable(a) || !CRYPTO_THREAD_read_lock(a->lock))
+        return 0;
+    if (a->sig_verified_key == r) {
+        ret = 1;
+    } else if (a->sig_verified_key != NULL) {
+        ERR_set_mark();
+        ret = EVP_PKEY_eq(a->sig_verified_key, r) == 1;
+        ERR_pop_to_mark();
+    }
+    CRYPTO_THREAD_unlock(a->lock);
+    return ret;
+}
+
+static void x509_set_sig_verified(const X509 *a, EVP_PKEY *r)
+{
+    EVP_PKEY *old;
+
+    if (!x509_sig_cacheable(a) || !EVP_PKEY_up_ref(r))
+        return;
+    if (!CRYPTO_THREAD_write_lock(a->lock)) {
+        EVP_PKEY_free(r);
+        return;
+    }
+    old = a->sig_verified_key;
+    ((X509 *)a)->sig_verified_key = r;
+    CRYPTO_THREAD_unlock(a->lock);
+    EVP_PKEY_free(old);
+}
+
 int X509_verify(const X509 *a, EVP_PKEY *r)
 {
+    int ret;
+
     if (X509_ALGOR_cmp(&a->sig_alg, &a->cert_info.signature) != 0)
         return 0;
 
-    return ASN1_item_verify_ex(ASN1_ITEM_rptr(X509_CINF), &a->sig_alg,
+    if (r != NULL && x509_sig_verified(a, r))
+        return 1;
+
+    ret = ASN1_item_verify_ex(ASN1_ITEM_rptr(X509_CINF), &a->sig_alg,
         &a->signature, &a->cert_info,
         a->distinguishing_id, r, a->libctx, a->propq);
+    if (ret > 0)
+        x509_set_sig_verified(a, r);
+    return ret;
 }
 
 int X509_REQ_verify_ex(X509_REQ *a, EVP_PKEY *r, OSSL_LIB_CTX *libctx,
@@ -374,7 +428,7 @@ int i2d_X509_bio(BIO *bp, const X509 *x509)
 #ifndef OPENSSL_NO_STDIO
 X509_CRL *d2i_X509_CRL_fp(FILE *fp, X509_CRL **crl)
 {
-    return ASN1_item_d2i_fp(ASN1_ITEM_rptr(X509_CRL), fp, crl);
+    return ASN1_d2i_fp_of(X509_CRL, X509_CRL_new, d2i_X509_CRL, fp, crl);
 }
 
 int i2d_X509_CRL_fp(FILE *fp, const X509_CRL *crl)
@@ -385,7 +439,7 @@ int i2d_X509_CRL_fp(FILE *fp, const X509_CRL *crl)
 
 X509_CRL *d2i_X509_CRL_bio(BIO *bp, X509_CRL **crl)
 {
-    return ASN1_item_d2i_bio(ASN1_ITEM_rptr(X509_CRL), bp, crl);
+    return ASN1_d2i_bio_of(X509_CRL, X509_CRL_new, d2i_X509_CRL, bp, crl);
 }
 
 int i2d_X509_CRL_bio(BIO *bp, const X509_CRL *crl)
@@ -8,15 +8,22 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <openssl/asn1t.h>
 #include <openssl/x509.h>
 #include "crypto/x509.h"
 #include <openssl/x509v3.h>
 #include "x509_local.h"
 
+typedef struct x509_crl_revoked_index_st X509_CRL_REVOKED_INDEX;
+
 static int X509_REVOKED_cmp(const X509_REVOKED *const *a,
     const X509_REVOKED *const *b);
 static int setup_idp(X509_CRL *crl, ISSUING_DIST_POINT *idp);
+static int crl_revoked_set_reason(X509_REVOKED *rev);
+static void crl_revoked_index_free(X509_CRL_REVOKED_INDEX *ri);
+static int crl_info_decode_revoked(X509_CRL_INFO *inf, int drop_index);
 
 ASN1_SEQUENCE(X509_REVOKED) = {
     ASN1_EMBED(X509_REVOKED, serialNumber, ASN1_INTEGER),
@@ -48,16 +55,31 @@ static int crl_inf_cb(int operation, ASN1_VALUE **pval, const ASN1_ITEM *it,
 {
     X509_CRL_INFO *a = (X509_CRL_INFO *)*pval;
 
-    if (!a || !a->revoked)
+    if (!a)
         return 1;
     switch (operation) {
+    case ASN1_OP_D2I_PRE:
+    case ASN1_OP_FREE_POST:
+        crl_revoked_index_free(a->revoked_index);
+        a->revoked_index = NULL;
+        break;
         /*
          * Just set cmp function here. We don't sort because that would
          * affect the output of X509_CRL_print().
          */
     case ASN1_OP_D2I_POST:
-        (void)sk_X509_REVOKED_set_cmp_func(a->revoked, X509_REVOKED_cmp);
+        if (a->revoked != NULL)
+            (void)sk_X509_REVOKED_set_cmp_func(a->revoked, X509_REVOKED_cmp);
         break;
+        /*
+         * The revoked entries of an indexed CRL must be decoded before it is
+         * encoded from its fields, which happens after it has been modified,
+         * or printed.
+         */
+    case ASN1_OP_I2D_PRE:
+        return crl_info_decode_revoked(a, 1);
+    case ASN1_OP_PRINT_PRE:
+        return crl_info_decode_revoked(a, 0);
     }
     return 1;
 }
@@ -108,7 +130,6 @@ static int crl_set_issuers(X509_CRL *crl)
     for (i = 0; i < sk_X509_REVOKED_num(revoked); i++) {
         X509_REVOKED *rev = sk_X509_REVOKED_value(revoked, i);
         STACK_OF(X509_EXTENSION) *exts;
-        ASN1_ENUMERATED *reason;
         X509_EXTENSION *ext;
         const ASN1_TIME *rev_date;
         ASN1_GENERALIZEDTIME *inv_date;
@@ -162,18 +183,11 @@ static int crl_set_issuers(X509_CRL *crl)
         }
         rev->issuer = most_recent_issuer;
 
-        reason = X509_REVOKED_get_ext_d2i(rev, NID_crl_reason, &j, NULL);
-        if (reason == NULL && j != -1) {
+        if (!crl_revoked_set_reason(rev)) {
             crl->flags |= EXFLAG_INVALID;
             return 1;
         }
 
-        if (reason != NULL) {
-            rev->reason = ASN1_ENUMERATED_get(reason);
-            ASN1_ENUMERATED_free(reason);
-        } else
-            rev->reason = CRL_REASON_NONE;
-
         /* Check for critical CRL entry extensions and validate time. */
         exts = rev->extensions;
 
@@ -206,6 +220,24 @@ static int crl_set_issuers(X509_CRL *crl)
     return 1;
 }
 
+/* Set the revocation reason of a CRL entry from its reason code extension */
+static int crl_revoked_set_reason(X509_REVOKED *rev)
+{
+    ASN1_ENUMERATED *reason;
+    int j;
+
+    reason = X509_REVOKED_get_ext_d2i(rev, NID_crl_reason, &j, NULL);
+    if (reason == NULL && j != -1)
+        return 0;
+
+    if (reason != NULL) {
+        rev->reason = ASN1_ENUMERATED_get(reason);
+        ASN1_ENUMERATED_free(reason);
+    } else
+        rev->reason = CRL_REASON_NONE;
+    return 1;
+}
+
 /*
  * The X509_CRL structure needs a bit of customisation. Cache some extensions
  * and hash of the whole CRL or set EXFLAG_NO_FINGERPRINT if this fails.
@@ -402,7 +434,7 @@ IMPLEMENT_ASN1_DUP_FUNCTION(X509_REVOKED)
 
 IMPLEMENT_ASN1_FUNCTIONS(X509_CRL_INFO)
 
-IMPLEMENT_ASN1_FUNCTIONS(X509_CRL)
+IMPLEMENT_ASN1_ALLOC_FUNCTIONS(X509_CRL)
 
 IMPLEMENT_ASN1_DUP_FUNCTION(X509_CRL)
 
@@ -413,6 +445,436 @@ static int X509_REVOKED_cmp(const X509_REVOKED *const *a,
         (ASN1_STRING *)&(*b)->serialNumber));
 }
 
+/*
+ * Large CRLs are decoded with an index of their revoked entries instead of
+ * the entries themselves. The entries stay in the cached encoding of the
+ * X509_CRL_INFO and are decoded one at a time when they are looked up, or
+ * all at once when the application asks for them or modifies the CRL.
+ */
+typedef struct {
+    const unsigned char *serial; /* contents of the serial number */
+    uint32_t serial_len;
+    uint32_t entry; /* offset of the entry in the encoding */
+} CRL_REVOKED_ENTRY;
+
+struct x509_crl_revoked_index_st {
+    CRL_REVOKED_ENTRY *entries; /* in serial number order */
+    size_t num;
+    size_t revoked_off; /* contents of revokedCertificates */
+    size_t revoked_len;
+    STACK_OF(X509_REVOKED) *decoded; /* entries decoded by lookups */
+};
+
+static void crl_revoked_index_free(X509_CRL_REVOKED_INDEX *ri)
+{
+    if (ri == NULL)
+        return;
+    OPENSSL_free(ri->entries);
+    sk_X509_REVOKED_pop_free(ri->decoded, X509_REVOKED_free);
+    OPENSSL_free(ri);
+}
+
+/*
+ * Reads the header of the next element between |*pp| and |end|, which must
+ * be a universal element of definite length. Returns its tag or -1.
+ */
+static int crl_der_get(const unsigned char **pp, const unsigned char *end,
+    int *constructed, long *plen)
+{
+    int inf, tag, xclass;
+
+    if (*pp >= end)
+        return -1;
+    inf = ASN1_get_object(pp, plen, &tag, &xclass, end - *pp);
+    if ((inf & 0x80) != 0 || inf == (V_ASN1_CONSTRUCTED | 1)
+        || xclass != V_ASN1_UNIVERSAL)
+        return -1;
+    *constructed = inf & V_ASN1_CONSTRUCTED;
+    return tag;
+}
+
+/* Checks the contents of an INTEGER or ENUMERATED as c2i_ASN1_INTEGER does */
+static int crl_der_integer_ok(const unsigned char *p, long len)
+{
+    long i;
+
+    if (len <= 0)
+        return 0;
+    if (len == 1)
+        return 1;
+    if (p[0] == 0)
+        return (p[1] & 0x80) != 0;
+    if (p[0] == 0xFF) {
+        for (i = 1; i < len && p[i] == 0; i++)
+            continue;
+        return i == len || (p[1] & 0x80) == 0;
+    }
+    return 1;
+}
+
+/* Checks the contents of an OBJECT IDENTIFIER as c2i_ASN1_OBJECT does */
+static int crl_der_oid_ok(const unsigned char *p, long len)
+{
+    long i;
+
+    if (len <= 0 || (p[len - 1] & 0x80) != 0)
+        return 0;
+    for (i = 0; i < len; i++)
+        if (p[i] == 0x80 && (i == 0 || (p[i - 1] & 0x80) == 0))
+            return 0;
+    return 1;
+}
+
+static int crl_der_time_ok(int tag, int constructed, long len)
+{
+    if (constructed)
+        return 0;
+    return (tag == V_ASN1_UTCTIME && len >= 13)
+        || (tag == V_ASN1_GENERALIZEDTIME && len >= 15);
+}
+
+/* Is the OBJECT IDENTIFIER |p| of length |len| id-ce-|ce|? */
+static int crl_der_is_id_ce(const unsigned char *p, long len, unsigned char ce)
+{
+    return len == 3 && p[0] == 0x55 && p[1] == 0x1D && p[2] == ce;
+}
+
+/*
+ * Checks the extensions of a CRL entry between |p| and |end|. Returns 0 for
+ * anything the index cannot represent like the full decoding does: entries
+ * of indirect CRLs, which have a certificate issuer, and extensions that
+ * would fail to decode when the entry is looked up.
+ */
+static int crl_scan_entry_extensions(const unsigned char *p,
+    const unsigned char *end, int *flags)
+{
+    const unsigned char *oid, *val, *xend, *q;
+    long len, oidlen, vallen;
+    int cons, tag, critical, reasons = 0;
+    ASN1_GENERALIZEDTIME *gt;
+
+    while (p < end) {
+        if (crl_der_get(&p, end, &cons, &len) != V_ASN1_SEQUENCE || !cons)
+            return 0;
+        xend = p + len;
+        if (crl_der_get(&p, xend, &cons, &len) != V_ASN1_OBJECT || cons
+            || !crl_der_oid_ok(p, len))
+            return 0;
+        oid = p;
+        oidlen = len;
+        p += len;
+        critical = 0;
+        tag = crl_der_get(&p, xend, &cons, &len);
+        if (tag == V_ASN1_BOOLEAN) {
+            if (cons || len != 1)
+                return 0;
+            critical = p[0] != 0;
+            p += len;
+            tag = crl_der_get(&p, xend, &cons, &len);
+        }
+        if (tag != V_ASN1_OCTET_STRING || cons || p + len != xend)
+            return 0;
+        val = p;
+        vallen = len;
+        p = xend;
+
+        if (crl_der_is_id_ce(oid, oidlen, 0x1D)) /* certificateIssuer */
+            return 0;
+        if (crl_der_is_id_ce(oid, oidlen, 0x15)) { /* reasonCode */
+            q = val;
+            if (++reasons > 1
+                || crl_der_get(&q, val + vallen, &cons, &len) != V_ASN1_ENUMERATED
+                || cons || !crl_der_integer_ok(q, len))
+                return 0;
+        }
+        if (crl_der_is_id_ce(oid, oidlen, 0x18)) { /* invalidityDate */
+            q = val;
+            if ((gt = d2i_ASN1_GENERALIZEDTIME(NULL, &q, vallen)) == NULL)
+                return 0;
+            ASN1_GENERALIZEDTIME_free(gt);
+        }
+        if (critical)
+            *flags |= EXFLAG_CRITICAL;
+    }
+    return 1;
+}
+
+static int crl_revoked_entry_cmp(const void *a, const void *b)
+{
+    const CRL_REVOKED_ENTRY *ea = a, *eb = b;
+    int ret;
+
+    if (ea->serial_len != eb->serial_len)
+        return ea->serial_len < eb->serial_len ? -1 : 1;
+    if ((ret = memcmp(ea->serial, eb->serial, ea->serial_len)) != 0)
+        return ret;
+    return ea->entry < eb->entry ? -1 : ea->entry > eb->entry;
+}
+
+/*
+ * Builds the index of the revokedCertificates field at offset |off| of
+ * |enc|, with its contents between |cont| and |end|. Returns NULL if an entry
+ * is not suitable for an index, or on error.
+ */
+static X509_CRL_REVOKED_INDEX *crl_revoked_index_new(const unsigned char *enc,
+    size_t cont, size_t end, int *flags)
+{
+    X509_CRL_REVOKED_INDEX *ri = OPENSSL_zalloc(sizeof(*ri));
+    const unsigned char *p = enc + cont, *pend = enc + end, *entry, *eend;
+    CRL_REVOKED_ENTRY *tmp;
+    size_t alloc = 0;
+    long len;
+    int cons;
+
+    if (ri == NULL
+        || (ri->decoded = sk_X509_REVOKED_new(X509_REVOKED_cmp)) == NULL)
+        goto err;
+    ri->revoked_off = cont;
+    ri->revoked_len = end - cont;
+    while (p < pend) {
+        entry = p;
+        if (crl_der_get(&p, pend, &cons, &len) != V_ASN1_SEQUENCE || !cons)
+            goto err;
+        eend = p + len;
+        if (crl_der_get(&p, eend, &cons, &len) != V_ASN1_INTEGER || cons
+            || !crl_der_integer_ok(p, len))
+            goto err;
+        if (ri->num == alloc) {
+            alloc = alloc == 0 ? 64 : alloc * 2;
+            tmp = OPENSSL_realloc_array(ri->entries, alloc, sizeof(*tmp));
+            if (tmp == NULL)
+                goto err;
+            ri->entries = tmp;
+        }
+        ri->entries[ri->num].serial = p;
+        ri->entries[ri->num].serial_len = (uint32_t)len;
+        ri->entries[ri->num].entry = (uint32_t)(entry - enc);
+        ri->num++;
+        p += len;
+        if (!crl_der_time_ok(crl_der_get(&p, eend, &cons, &len), cons, len))
+            goto err;
+        p += len;
+        if (p < eend
+            && (crl_der_get(&p, eend, &cons, &len) != V_ASN1_SEQUENCE || !cons
+                || p + len != eend
+                || !crl_scan_entry_extensions(p, eend, flags)))
+            goto err;
+        p = eend;
+    }
+    if (ri->num > 1)
+        qsort(ri->entries, ri->num, sizeof(*ri->entries),
+            crl_revoked_entry_cmp);
+    return ri;
+
+err:
+    crl_revoked_index_free(ri);
+    return NULL;
+}
+
+/*
+ * Locates the TBSCertList and its revokedCertificates field in the DER
+ * encoding of a CRL.
+ */
+typedef struct {
+    const unsigned char *tbs, *tbs_cont, *tbs_end;
+    const unsigned char *revoked, *revoked_cont, *revoked_end;
+    const unsigned char *end;
+} CRL_DER_LAYOUT;
+
+static int crl_der_layout(const unsigned char *in, long inlen,
+    CRL_DER_LAYOUT *l)
+{
+    const unsigned char *p = in, *end = in + inlen, *q;
+    long len;
+    int cons, tag;
+
+    if (crl_der_get(&p, end, &cons, &len) != V_ASN1_SEQUENCE || !cons)
+        return 0;
+    l->end = end = p + len;
+    l->tbs = p;
+    if (crl_der_get(&p, end, &cons, &len) != V_ASN1_SEQUENCE || !cons)
+        return 0;
+    l->tbs_cont = p;
+    l->tbs_end = end = p + len;
+
+    /* version, signature, issuer, thisUpdate and nextUpdate */
+    q = p;
+    if (crl_der_get(&q, end, &cons, &len) == V_ASN1_INTEGER)
+        p = q + len;
+    if (crl_der_get(&p, end, &cons, &len) != V_ASN1_SEQUENCE)
+        return 0;
+    p += len;
+    if (crl_der_get(&p, end, &cons, &len) != V_ASN1_SEQUENCE)
+        return 0;
+    p += len;
+    tag = crl_der_get(&p, end, &cons, &len);
+    if (!crl_der_time_ok(tag, cons, len))
+        return 0;
+    p += len;
+    q = p;
+    tag = crl_der_get(&q, end, &cons, &len);
+    if (crl_der_time_ok(tag, cons, len)) {
+        p = q + len;
+        q = p;
+        tag = crl_der_get(&q, end, &cons, &len);
+    }
+    if (tag != V_ASN1_SEQUENCE || !cons)
+        return 0;
+    l->revoked = p;
+    l->revoked_cont = q;
+    l->revoked_end = q + len;
+    return 1;
+}
+
+/*
+ * Decodes the CRL in |*in| without its revoked entries, and attaches an
+ * index of them. Returns NULL if the CRL has no entries, cannot be indexed
+ * or fails to decode, in which case the caller decodes it in full.
+ */
+static X509_CRL *crl_d2i_indexed(X509_CRL **a, const unsigned char **in,
+    long inlen)
+{
+    CRL_DER_LAYOUT l;
+    X509_CRL *crl = NULL;
+    X509_CRL_REVOKED_INDEX *ri;
+    unsigned char *der = NULL, *q;
+    const unsigned char *p;
+    long tbslen, crllen;
+    int derlen, flags = 0;
+
+    if (!crl_der_layout(*in, inlen, &l)
+        || l.end - *in > UINT32_MAX)
+        return NULL;
+
+    /* Re-encode the CRL without the revokedCertificates field */
+    tbslen = (l.tbs_end - l.tbs_cont) - (l.revoked_end - l.revoked);
+    crllen = ASN1_object_size(1, tbslen, V_ASN1_SEQUENCE) + (l.end - l.tbs_end);
+    if ((derlen = ASN1_object_size(1, crllen, V_ASN1_SEQUENCE)) <= 0
+        || (der = OPENSSL_malloc(derlen)) == NULL)
+        return NULL;
+    q = der;
+    ASN1_put_object(&q, 1, crllen, V_ASN1_SEQUENCE, V_ASN1_UNIVERSAL);
+    ASN1_put_object(&q, 1, tbslen, V_ASN1_SEQUENCE, V_ASN1_UNIVERSAL);
+    memcpy(q, l.tbs_cont, l.revoked - l.tbs_cont);
+    q += l.revoked - l.tbs_cont;
+    memcpy(q, l.revoked_end, l.end - l.revoked_end);
+
+    if (a != NULL && *a != NULL)
+        crl = X509_CRL_new_ex((*a)->libctx, (*a)->propq);
+    else
+        crl = X509_CRL_new();
+    p = der;
+    if (crl == NULL
+        || ASN1_item_d2i((ASN1_VALUE **)&crl, &p, derlen,
+               ASN1_ITEM_rptr(X509_CRL))
+            == NULL)
+        goto err;
+
+    /* Keep the original encoding, which is what the signature covers */
+    OPENSSL_free(crl->crl.enc.enc);
+    crl->crl.enc.len = 0;
+    if ((crl->crl.enc.enc = OPENSSL_memdup(l.tbs, l.tbs_end - l.tbs)) == NULL)
+        goto err;
+    crl->crl.enc.len = l.tbs_end - l.tbs;
+    crl->crl.enc.modified = 0;
+    ri = crl_revoked_index_new(crl->crl.enc.enc, l.revoked_cont - l.tbs,
+        l.revoked_end - l.tbs, &flags);
+    if (ri == NULL)
+        goto err;
+    crl->crl.revoked_index = ri;
+    crl->flags |= flags;
+
+    /* The fingerprint was computed over the CRL without its entries */
+    crl->flags &= ~(EXFLAG_SET | EXFLAG_NO_FINGERPRINT);
+    if (!X509_CRL_digest(crl, EVP_sha1(), crl->sha1_hash, NULL))
+        crl->flags |= EXFLAG_NO_FINGERPRINT;
+    crl->flags |= EXFLAG_SET;
+
+    OPENSSL_free(der);
+    if (a != NULL) {
+        X509_CRL_free(*a);
+        *a = crl;
+    }
+    *in = l.end;
+    return crl;
+
+err:
+    OPENSSL_free(der);
+    X509_CRL_free(crl);
+    return NULL;
+}
+
+X509_CRL *d2i_X509_CRL(X509_CRL **a, const unsigned char **in, long len)
+{
+    X509_CRL *crl;
+
+    if (default_crl_method == &int_crl_meth) {
+        ERR_set_mark();
+        crl = crl_d2i_indexed(a, in, len);
+        ERR_pop_to_mark();
+        if (crl != NULL)
+            return crl;
+    }
+    return (X509_CRL *)ASN1_item_d2i((ASN1_VALUE **)a, in, len,
+        ASN1_ITEM_rptr(X509_CRL));
+}
+
+int i2d_X509_CRL(const X509_CRL *a, unsigned char **out)
+{
+    return ASN1_item_i2d((const ASN1_VALUE *)a, out, ASN1_ITEM_rptr(X509_CRL));
+}
+
+/*
+ * Decodes all revoked entries of an indexed CRL into |inf->revoked|, and
+ * frees the index if |drop_index| is set.
+ */
+static int crl_info_decode_revoked(X509_CRL_INFO *inf, int drop_index)
+{
+    X509_CRL_REVOKED_INDEX *ri = inf->revoked_index;
+    STACK_OF(X509_REVOKED) *revoked;
+    X509_REVOKED *rev;
+    const unsigned char *p, *end;
+
+    if (ri == NULL)
+        return 1;
+    if (inf->revoked == NULL) {
+        if ((revoked = sk_X509_REVOKED_new_reserve(X509_REVOKED_cmp,
+                 (int)ri->num))
+            == NULL)
+            return 0;
+        p = inf->enc.enc + ri->revoked_off;
+        end = p + ri->revoked_len;
+        while (p < end) {
+            if ((rev = d2i_X509_REVOKED(NULL, &p, end - p)) == NULL
+                || !crl_revoked_set_reason(rev)
+                || !sk_X509_REVOKED_push(revoked, rev)) {
+                X509_REVOKED_free(rev);
+                sk_X509_REVOKED_pop_free(revoked, X509_REVOKED_free);
+                return 0;
+            }
+        }
+        inf->revoked = revoked;
+    }
+    if (drop_index) {
+        crl_revoked_index_free(ri);
+        inf->revoked_index = NULL;
+    }
+    return 1;
+}
+
+int ossl_x509_crl_decode_revoked(X509_CRL *crl, int drop_index)
+{
+    int ret;
+
+    if (crl->crl.revoked_index == NULL)
+        return 1;
+    if (!CRYPTO_THREAD_write_lock(crl->lock))
+        return 0;
+    ret = crl_info_decode_revoked(&crl->crl, drop_index);
+    CRYPTO_THREAD_unlock(crl->lock);
+    return ret;
+}
+
 X509_CRL *X509_CRL_new_ex(OSSL_LIB_CTX *libctx, const char *propq)
 {
     X509_CRL *crl = NULL;
@@ -429,6 +891,8 @@ int X509_CRL_add0_revoked(X509_CRL *crl, X509_REVOKED *rev)
 {
     X509_CRL_INFO *inf;
 
+    if (!ossl_x509_crl_decode_revoked(crl, 1))
+        return 0;
     inf = &crl->crl;
     if (inf->revoked == NULL)
         inf->revoked = sk_X509_REVOKED_new(X509_REVOKED_cmp);
@@ -501,6 +965,103 @@ static int crl_revoked_issuer_match(X509_CRL *crl, const X509_NAME *nm,
     return 0;
 }
 
+/*
+ * Returns the entry |i| of the index of |crl|, which has serial number
+ * |serial|, decoding it on first use.
+ */
+static X509_REVOKED *crl_index_get(X509_CRL *crl, size_t i,
+    const ASN1_INTEGER *serial)
+{
+    X509_CRL_REVOKED_INDEX *ri = crl->crl.revoked_index;
+    X509_REVOKED rtmp, *rev;
+    const unsigned char *p;
+    int idx;
+
+    rtmp.serialNumber = *serial;
+    if (!CRYPTO_THREAD_read_lock(crl->lock))
+        return NULL;
+    idx = sk_X509_REVOKED_find(ri->decoded, &rtmp);
+    rev = sk_X509_REVOKED_value(ri->decoded, idx);
+    CRYPTO_THREAD_unlock(crl->lock);
+    if (rev != NULL)
+        return rev;
+
+    p = crl->crl.enc.enc + ri->entries[i].entry;
+    rev = d2i_X509_REVOKED(NULL, &p, crl->crl.enc.len - ri->entries[i].entry);
+    if (rev == NULL || !crl_revoked_set_reason(rev)) {
+        X509_REVOKED_free(rev);
+        return NULL;
+    }
+    if (!CRYPTO_THREAD_write_lock(crl->lock)) {
+        X509_REVOKED_free(rev);
+        return NULL;
+    }
+    /* Another thread may have decoded the entry in the meantime */
+    if ((idx = sk_X509_REVOKED_find(ri->decoded, &rtmp)) >= 0) {
+        X509_REVOKED_free(rev);
+        rev = sk_X509_REVOKED_value(ri->decoded, idx);
+    } else if (sk_X509_REVOKED_push(ri->decoded, rev)) {
+        sk_X509_REVOKED_sort(ri->decoded);
+    } else {
+        X509_REVOKED_free(rev);
+        rev = NULL;
+    }
+    CRYPTO_THREAD_unlock(crl->lock);
+    return rev;
+}
+
+static int crl_index_lookup(X509_CRL *crl, X509_REVOKED **ret,
+    const ASN1_INTEGER *serial, const X509_NAME *issuer)
+{
+    X509_CRL_REVOKED_INDEX *ri = crl->crl.revoked_index;
+    CRL_REVOKED_ENTRY key;
+    unsigned char buf[64], *der = buf, *q;
+    const unsigned char *p;
+    X509_REVOKED *rev;
+    size_t lo = 0, hi = ri->num, mid;
+    long len;
+    int derlen, cons, ok = 0;
+
+    /* The index is sorted by the encoded contents of the serial numbers */
+    if ((derlen = i2d_ASN1_INTEGER(serial, NULL)) <= 0)
+        return 0;
+    if (derlen > (int)sizeof(buf) && (der = OPENSSL_malloc(derlen)) == NULL)
+        return 0;
+    q = der;
+    p = der;
+    if (i2d_ASN1_INTEGER(serial, &q) != derlen
+        || crl_der_get(&p, der + derlen, &cons, &len) != V_ASN1_INTEGER)
+        goto end;
+    key.serial = p;
+    key.serial_len = (uint32_t)len;
+    key.entry = 0;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (crl_revoked_entry_cmp(&ri->entries[mid], &key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    /* Need to look for matching name */
+    for (; lo < ri->num; lo++) {
+        if (ri->entries[lo].serial_len != key.serial_len
+            || memcmp(ri->entries[lo].serial, key.serial, key.serial_len) != 0)
+            break;
+        if ((rev = crl_index_get(crl, lo, serial)) == NULL)
+            break;
+        if (crl_revoked_issuer_match(crl, issuer, rev)) {
+            if (ret)
+                *ret = rev;
+            ok = rev->reason == CRL_REASON_REMOVE_FROM_CRL ? 2 : 1;
+            break;
+        }
+    }
+end:
+    if (der != buf)
+        OPENSSL_free(der);
+    return ok;
+}
+
 static int def_crl_lookup(X509_CRL *crl,
     X509_REVOKED **ret, const ASN1_INTEGER *serial,
     const X509_NAME *issuer)
@@ -508,6 +1069,8 @@ static int def_crl_lookup(X509_CRL *crl,
     X509_REVOKED rtmp, *rev;
     int idx, num;
 
+    if (crl->crl.revoked_index != NULL)
+        return crl_index_lookup(crl, ret, serial, issuer);
     if (crl->crl.revoked == NULL)
         return 0;
 
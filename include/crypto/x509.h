@@ -98,6 +98,8 @@ struct X509_crl_info_st {
     STACK_OF(X509_REVOKED) *revoked; /* revoked entries: optional */
     STACK_OF(X509_EXTENSION) *extensions; /* extensions: optional */
     ASN1_ENCODING enc; /* encoding of signed portion of CRL */
+    /* index of the revoked entries in |enc| while |revoked| is not decoded */
+    struct x509_crl_revoked_index_st *revoked_index;
 };
 
 struct X509_crl_st {
@@ -202,6 +204,8 @@ struct x509_st {
     X509_CERT_AUX *aux;
     CRYPTO_RWLOCK *lock;
     volatile int ex_cached;
+    /* Issuer key the signature was successfully verified with */
+    EVP_PKEY *sig_verified_key;
 
     /* Set on live certificates for authentication purposes */
     ASN1_OCTET_STRING *distinguishing_id;
@@ -284,6 +288,8 @@ struct x509_store_ctx_st { /* X509_STORE_CTX */
     int bare_ta_signed;
     /* Raw Public Key */
     EVP_PKEY *rpk;
+    /* Time until which a successful result may be cached */
+    int64_t verify_cache_expiry;
 
     OSSL_LIB_CTX *libctx;
     char *propq;
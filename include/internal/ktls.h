@@ -207,6 +207,18 @@ static ossl_inline int ktls_sendfile(int s, int fd, off_t off, size_t size,
     return sendfile(fd, s, off, size, NULL, sbytes, flags);
 }
 
+/*
+ * Received records cannot be spliced to another file descriptor, the data
+ * has to be read with ktls_read_record().
+ */
+static ossl_inline int ktls_splice_read(int s, int fd, off_t *off, size_t size,
+    ossl_ssize_t *rbytes)
+{
+    *rbytes = 0;
+    errno = EOPNOTSUPP;
+    return -1;
+}
+
 #endif /* __FreeBSD__ */
 
 #if defined(OPENSSL_SYS_LINUX)
@@ -239,8 +251,19 @@ static ossl_inline int ktls_sendfile(int s, int fd, off_t off, size_t size,
 #endif
 #endif
 #endif
+/*
+ * Since Linux 6.14 the keys of a TLSv1.3 connection can be changed after a
+ * KeyUpdate by setting TLS_TX or TLS_RX again.
+ */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 14, 0)
+#define OPENSSL_KTLS_TLS13_KEY_UPDATE
+#endif
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <netinet/tcp.h>
 #include <linux/socket.h>
 #include <openssl/ssl3.h>
@@ -259,6 +282,14 @@ static ossl_inline int ktls_sendfile(int s, int fd, off_t off, size_t size,
 #define TLS_RX 2
 #endif
 
+#ifndef SPLICE_F_MOVE
+#define SPLICE_F_MOVE 1
+#endif
+
+#ifndef SPLICE_F_NONBLOCK
+#define SPLICE_F_NONBLOCK 2
+#endif
+
 struct tls_crypto_info_all {
     union {
 #ifdef OPENSSL_KTLS_AES_GCM_128
@@ -389,6 +420,14 @@ static ossl_inline int ktls_read_record(int fd, void *data, size_t length)
     return -1;
 }
 
+static ossl_inline int ktls_splice_read(int s, int fd, off_t *off, size_t size,
+    ossl_ssize_t *rbytes)
+{
+    *rbytes = 0;
+    errno = EOPNOTSUPP;
+    return -1;
+}
+
 #else /* !defined(OPENSSL_NO_KTLS_RX) */
 
 /*
@@ -454,6 +493,94 @@ static ossl_inline int ktls_read_record(int fd, void *data, size_t length)
     return ret;
 }
 
+/*
+ * splice() is only declared with _GNU_SOURCE, which is not defined for the
+ * files including this header, so it is called through syscall().
+ */
+static ossl_inline ossl_ssize_t ktls_splice(int fd_in, off_t *off_in,
+    int fd_out, off_t *off_out,
+    size_t len, unsigned int flags)
+{
+    return syscall(SYS_splice, fd_in, off_in, fd_out, off_out, len, flags);
+}
+
+/*
+ * Move the decrypted data of the next application data record on the KTLS
+ * socket |s| to |fd| with splice(), without copying it to user space. At most
+ * |size| bytes are moved. If |off| is not NULL the data is written at offset
+ * |*off| in |fd|, which is advanced, otherwise at the current position.
+ *
+ * splice() needs a pipe on one side, so unless |fd| is a pipe the data passes
+ * through a temporary one.
+ *
+ * Returns 0 on success with the number of bytes moved, or 0 at end of file,
+ * in |*rbytes|. Returns -1 with errno set if nothing was read from |s|, where
+ * EINVAL means that the next record is not application data or that |fd|
+ * cannot be spliced to, and the record has to be read with ktls_read_record()
+ * instead. Returns -2 with errno set if the data was read from |s| but could
+ * not be written to |fd|, in which case it is lost.
+ */
+static ossl_inline int ktls_splice_read(int s, int fd, off_t *off, size_t size,
+    ossl_ssize_t *rbytes)
+{
+    struct stat st;
+    unsigned int flags = SPLICE_F_MOVE;
+    int fl, p[2], ret = 0;
+    ossl_ssize_t n, r;
+
+    *rbytes = 0;
+
+    if (fstat(fd, &st) != 0)
+        return -1;
+    if ((fl = fcntl(fd, F_GETFL)) == -1)
+        return -1;
+    /* splice() cannot append to a file */
+    if ((fl & O_APPEND) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((fl = fcntl(s, F_GETFL)) == -1)
+        return -1;
+    if ((fl & O_NONBLOCK) != 0)
+        flags |= SPLICE_F_NONBLOCK;
+
+    /* A record is never larger than the default pipe capacity */
+    if (size > SSL3_RT_MAX_PLAIN_LENGTH)
+        size = SSL3_RT_MAX_PLAIN_LENGTH;
+
+    if (S_ISFIFO(st.st_mode)) {
+        if ((n = ktls_splice(s, NULL, fd, NULL, size, flags)) < 0)
+            return -1;
+        *rbytes = n;
+        return 0;
+    }
+
+    if (pipe(p) != 0)
+        return -1;
+
+    if ((n = ktls_splice(s, NULL, p[1], NULL, size, flags)) < 0) {
+        ret = -1;
+        goto end;
+    }
+    while (*rbytes < n) {
+        r = ktls_splice(p[0], NULL, fd, off, n - *rbytes, SPLICE_F_MOVE);
+        if (r <= 0) {
+            if (r == 0)
+                errno = EIO;
+            ret = -2;
+            goto end;
+        }
+        *rbytes += r;
+    }
+
+end:
+    fl = errno;
+    close(p[0]);
+    close(p[1]);
+    errno = fl;
+    return ret;
+}
+
 #endif /* OPENSSL_NO_KTLS_RX */
 
 #endif /* OPENSSL_SYS_LINUX */
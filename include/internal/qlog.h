@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -16,6 +16,7 @@
 #include "internal/time.h"
 
 typedef struct qlog_st QLOG;
+typedef struct qlog_writer_st QLOG_WRITER;
 
 #ifndef OPENSSL_NO_QLOG
 
@@ -38,6 +39,9 @@ typedef struct qlog_trace_info_st {
     void *now_cb_arg;
     uint64_t override_process_id;
     const char *override_impl_name;
+    /* Gets the background writer to use for binary output; optional. */
+    QLOG_WRITER *(*get_writer_cb)(void *arg);
+    void *get_writer_cb_arg;
 } QLOG_TRACE_INFO;
 
 QLOG *ossl_qlog_new(const QLOG_TRACE_INFO *info);
@@ -45,7 +49,23 @@ QLOG *ossl_qlog_new_from_env(const QLOG_TRACE_INFO *info);
 
 void ossl_qlog_free(QLOG *qlog);
 
+/*
+ * Background writer which writes out binary qlog output for any number of QLOG
+ * instances. It must outlive all QLOG instances using it.
+ */
+QLOG_WRITER *ossl_qlog_writer_new(void);
+void ossl_qlog_writer_free(QLOG_WRITER *writer);
+
+/* Converts binary qlog output to JSON-SEQ. */
+int ossl_qlog_bin_to_json(BIO *in, BIO *out);
+
 /* Configuration */
+#define QLOG_FORMAT_JSON_SEQ 0
+#define QLOG_FORMAT_BINARY 1
+
+/* Must be called before any event is logged. */
+int ossl_qlog_set_format(QLOG *qlog, int format);
+
 int ossl_qlog_set_event_type_enabled(QLOG *qlog, uint32_t event_type,
     int enable);
 int ossl_qlog_set_filter(QLOG *qlog, const char *filter);
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_QLOG_BIN_H
+#define OSSL_QLOG_BIN_H
+
+#include <openssl/bio.h>
+#include "internal/qlog.h"
+#include "internal/list.h"
+#include "internal/thread_arch.h"
+
+#ifndef OPENSSL_NO_QLOG
+
+/*
+ * Binary qlog Encoding
+ * ====================
+ *
+ * The binary qlog format is a compact encoding of the same event data which is
+ * otherwise written as JSON-SEQ. It is cheap enough to generate that qlog can
+ * be left enabled on production systems, and is converted to the standard
+ * JSON-SEQ form offline using ossl_qlog_bin_to_json().
+ *
+ * A binary qlog file consists of the magic bytes QLOG_BIN_MAGIC followed by a
+ * sequence of records. All integers are big-endian unless noted otherwise.
+ * Every record starts with a fixed header:
+ *
+ *   u32 length      length of the record, excluding this field
+ *   u8  type        one of QLOG_BIN_REC_*
+ *
+ * QLOG_BIN_REC_HEADER records describe the trace and come first:
+ *
+ *   u8  is_server
+ *   u64 process_id
+ *   vlint-prefixed strings: odcid, title, description, group_id, impl_name;
+ *   the title, description and group_id lengths are offset by one, with 0
+ *   meaning absent.
+ *
+ * QLOG_BIN_REC_EVENT_DEF records name an event type before its first use:
+ *
+ *   vlint event_type
+ *   bytes combined event name (e.g. "transport:packet_sent")
+ *
+ * QLOG_BIN_REC_EVENT records contain a single event:
+ *
+ *   u64 time        event time in OSSL_TIME ticks
+ *   vlint event_type
+ *   tokens          the fields of the event
+ *
+ * Each token is a byte holding one of QLOG_BIN_TOK_* in its low bits,
+ * optionally followed by a field name and then by the value of the token.
+ * Field names are interned: the first use of a name in a file is written
+ * in full (QLOG_BIN_TOK_KEY_DEF, followed by a vlint-prefixed string) and
+ * assigned the next free index, and later uses refer to it by index
+ * (QLOG_BIN_TOK_KEY_REF, followed by a vlint index). A QLOG_BIN_REC_KEY_RESET
+ * record, which has no payload, clears the table of interned names.
+ */
+#define QLOG_BIN_MAGIC "OQLB\x01"
+#define QLOG_BIN_MAGIC_LEN 5
+
+#define QLOG_BIN_REC_HEADER 0
+#define QLOG_BIN_REC_EVENT_DEF 1
+#define QLOG_BIN_REC_EVENT 2
+#define QLOG_BIN_REC_KEY_RESET 3
+
+#define QLOG_BIN_REC_HDR_LEN 5 /* u32 length, u8 type */
+
+#define QLOG_BIN_TOK_OBJ_BEGIN 1
+#define QLOG_BIN_TOK_OBJ_END 2
+#define QLOG_BIN_TOK_ARR_BEGIN 3
+#define QLOG_BIN_TOK_ARR_END 4
+#define QLOG_BIN_TOK_STR 5 /* vlint length, bytes */
+#define QLOG_BIN_TOK_U64 6 /* u64 */
+#define QLOG_BIN_TOK_I64 7 /* u64, two's complement */
+#define QLOG_BIN_TOK_FALSE 8
+#define QLOG_BIN_TOK_TRUE 9
+#define QLOG_BIN_TOK_BIN 10 /* vlint length, bytes */
+#define QLOG_BIN_TOK_TYPE_MASK 0x3f
+#define QLOG_BIN_TOK_KEY_DEF 0x40
+#define QLOG_BIN_TOK_KEY_REF 0x80
+
+/*
+ * Size of the ring buffer of each binary qlog sink. Must be a power of two.
+ * Records larger than this are dropped.
+ */
+#define QLOG_BIN_RING_SIZE (64 * 1024)
+
+/*
+ * Binary qlog Sink
+ * ================
+ *
+ * Records are constructed in a ring buffer by the thread logging events (the
+ * producer), which is the thread holding the lock of the QUIC object the QLOG
+ * belongs to. Completed records are published by advancing head and written to
+ * the sink BIO either by the background writer (see QLOG_WRITER) or, if there
+ * is none or the ring is full, by the producer itself. Writing to the BIO is
+ * serialised by io_lock, but the producer never takes that lock except when
+ * the ring is full or on an explicit flush.
+ */
+typedef struct ossl_qlog_bin_key_st OSSL_QLOG_BIN_KEY;
+
+typedef struct ossl_qlog_bin_st OSSL_QLOG_BIN;
+
+struct ossl_qlog_bin_st {
+    OSSL_LIST_MEMBER(qlog_bin, OSSL_QLOG_BIN);
+
+    /* Background writer this sink is registered with, if any. */
+    QLOG_WRITER *writer;
+
+    /* Protected by io_lock. */
+    BIO *bio;
+
+    unsigned char *ring;
+    size_t ring_mask;
+
+    /*
+     * head is the end of the published records and only advanced by the
+     * producer. tail is the end of the records written to the BIO and only
+     * advanced by whoever holds io_lock. Both are accessed atomically.
+     */
+    uint64_t head, tail;
+
+#if defined(OPENSSL_THREADS)
+    CRYPTO_MUTEX *io_lock;
+#endif
+    CRYPTO_RWLOCK *atomic_lock;
+
+    /* Producer state. */
+    uint64_t wpos; /* write position within the unpublished record */
+    uint64_t rec_start; /* start of the unpublished record */
+    uint64_t tail_cache; /* last value of tail seen by the producer */
+    uint64_t num_dropped; /* number of records dropped */
+
+    /* Table of interned field names, open addressed. */
+    OSSL_QLOG_BIN_KEY *keys;
+    size_t num_key_slots, num_keys, rec_num_keys;
+
+    unsigned int in_record : 1;
+    unsigned int overflow : 1;
+    unsigned int need_key_reset : 1;
+};
+
+int ossl_qlog_bin_init(OSSL_QLOG_BIN *b, QLOG_WRITER *writer);
+void ossl_qlog_bin_cleanup(OSSL_QLOG_BIN *b);
+
+/*
+ * Changes the sink BIO, writing out any published records to the old one
+ * first. Does not take ownership of the BIO.
+ */
+void ossl_qlog_bin_set0_sink(OSSL_QLOG_BIN *b, BIO *bio);
+
+/* Writes all published records to the BIO and flushes it. */
+int ossl_qlog_bin_flush(OSSL_QLOG_BIN *b);
+
+/*
+ * Starts a new record of the given type. Records cannot be nested. If the
+ * record does not fit in the ring, it is dropped when it is ended.
+ */
+void ossl_qlog_bin_record_begin(OSSL_QLOG_BIN *b, uint32_t rec_type);
+
+/*
+ * Ends and publishes the current record. Returns 1 on success or 0 if it was
+ * dropped.
+ */
+int ossl_qlog_bin_record_end(OSSL_QLOG_BIN *b);
+
+/*
+ * Overwrites the u64 at the given offset from the start of the payload of the
+ * current record.
+ */
+void ossl_qlog_bin_patch_u64(OSSL_QLOG_BIN *b, size_t offset, uint64_t v);
+
+void ossl_qlog_bin_u8(OSSL_QLOG_BIN *b, uint8_t v);
+void ossl_qlog_bin_u64(OSSL_QLOG_BIN *b, uint64_t v);
+void ossl_qlog_bin_vlint(OSSL_QLOG_BIN *b, uint64_t v);
+void ossl_qlog_bin_bytes(OSSL_QLOG_BIN *b, const void *p, size_t len);
+
+/* Writes a vlint-prefixed byte string. */
+void ossl_qlog_bin_str(OSSL_QLOG_BIN *b, const void *p, size_t len);
+
+/* Writes a token byte followed by the (possibly interned) field name. */
+void ossl_qlog_bin_token(OSSL_QLOG_BIN *b, uint32_t tok, const char *key);
+
+#endif
+
+#endif
@@ -142,6 +142,9 @@ typedef struct quic_channel_args_st {
     uint64_t active_conn_id_limit;
     unsigned char ack_delay_exponent;
     unsigned char disable_active_migration;
+
+    /* Congestion control algorithm (SSL_VALUE_QUIC_CC_ALGORITHM_*). */
+    uint64_t cc_algorithm;
 } QUIC_CHANNEL_ARGS;
 
 /* Represents the cause for a connection's termination. */
@@ -538,6 +541,34 @@ uint64_t ossl_quic_channel_get_active_conn_id_limit_request(const QUIC_CHANNEL *
 /* Gets the active connection ID limit advertised by the peer. */
 uint64_t ossl_quic_channel_get_active_conn_id_limit_peer_request(const QUIC_CHANNEL *ch);
 
+/*
+ * Selects the congestion control algorithm (SSL_VALUE_QUIC_CC_ALGORITHM_*).
+ * Fails if the value is not known or the channel has already been started.
+ */
+int ossl_quic_channel_set_cc_algorithm(QUIC_CHANNEL *ch, uint64_t algorithm);
+/* Gets the congestion control algorithm in use. */
+uint64_t ossl_quic_channel_get_cc_algorithm(const QUIC_CHANNEL *ch);
+/* Gets the current pacing rate in bytes per second, or 0 if not pacing. */
+uint64_t ossl_quic_channel_get_pacing_rate(const QUIC_CHANNEL *ch);
+/* Gets the number of times transmission was deferred by the pacer. */
+uint64_t ossl_quic_channel_get_pacing_deferrals(const QUIC_CHANNEL *ch);
+
+/*
+ * Handshake offload. If allowed, and the port has a worker thread to spare
+ * (see ossl_quic_port_set_max_handshake_threads()), a server channel runs
+ * the steps of its handshake which consume received handshake data on a worker
+ * thread. The channel is not ticked while a step is running. The port allows
+ * offload only while the channel is in its accept queue and must not hand out
+ * a channel for which ossl_quic_channel_has_tls_job() returns 1.
+ *
+ * ossl_quic_channel_cancel_tls_job() waits for any running step to finish and
+ * discards its results. It must be called before the handshake layer SSL object
+ * of a channel which is about to be freed is freed.
+ */
+void ossl_quic_channel_set_tls_offload(QUIC_CHANNEL *ch, int allowed);
+int ossl_quic_channel_has_tls_job(const QUIC_CHANNEL *ch);
+void ossl_quic_channel_cancel_tls_job(QUIC_CHANNEL *ch);
+
 int ossl_quic_bind_channel(QUIC_CHANNEL *ch, const BIO_ADDR *peer,
     const QUIC_CONN_ID *dcid, const QUIC_CONN_ID *odcid);
 
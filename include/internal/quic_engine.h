@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -14,6 +14,7 @@
 #include "internal/quic_predef.h"
 #include "internal/quic_port.h"
 #include "internal/thread_arch.h"
+#include "internal/qlog.h"
 
 #ifndef OPENSSL_NO_QUIC
 
@@ -91,6 +92,12 @@ void ossl_quic_engine_set_inhibit_tick(QUIC_ENGINE *qeng, int inhibit);
 /* Gets the reactor which can be used to tick/poll on the port. */
 QUIC_REACTOR *ossl_quic_engine_get0_reactor(QUIC_ENGINE *qeng);
 
+/*
+ * Gets the background writer shared by the binary qlog output of all channels
+ * in the engine, creating it if needed. Returns NULL on failure.
+ */
+QLOG_WRITER *ossl_quic_engine_get0_qlog_writer(QUIC_ENGINE *qeng);
+
 OSSL_LIB_CTX *ossl_quic_engine_get0_libctx(QUIC_ENGINE *qeng);
 const char *ossl_quic_engine_get0_propq(QUIC_ENGINE *qeng);
 
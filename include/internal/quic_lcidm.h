@@ -95,6 +95,19 @@
  *
  * An ODCID has no sequence number associated with it. It is the only CID to
  * lack one.
+ *
+ *
+ * CID Sharding
+ * ------------
+ *
+ * When several ports share one UDP address (SO_REUSEPORT) and each is driven
+ * by its own thread, the packets for a connection must always be delivered to
+ * the port which owns it. To make this possible without any shared state, an
+ * LCIDM can be assigned a shard number. Every LCID it subsequently generates
+ * then carries that number in its first byte, and the remaining bytes are
+ * random. Something outside of the LCIDM (for example a kernel reuseport
+ * program) can then route a packet to its owning port by looking at the first
+ * byte of its DCID. The ODCID, which is chosen by the peer, carries no shard.
  */
 
 /*
@@ -111,6 +124,18 @@ void ossl_quic_lcidm_free(QUIC_LCIDM *lcidm);
 /* Gets the local CID length this LCIDM was configured to use. */
 size_t ossl_quic_lcidm_get_lcid_len(const QUIC_LCIDM *lcidm);
 
+/*
+ * Sets the shard number to encode in the first byte of subsequently generated
+ * LCIDs. shard must be in the range [0, 255], or -1 to disable sharding (the
+ * default). Sharding cannot be enabled if the LCID length is zero.
+ *
+ * Returns 1 on success or 0 on failure.
+ */
+int ossl_quic_lcidm_set_shard(QUIC_LCIDM *lcidm, int shard);
+
+/* Gets the shard number set by ossl_quic_lcidm_set_shard(), or -1. */
+int ossl_quic_lcidm_get_shard(const QUIC_LCIDM *lcidm);
+
 /*
  * Determines the number of active LCIDs (i.e,. LCIDs which can be used for
  * reception) currently associated with the given opaque pointer.
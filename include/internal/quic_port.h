@@ -245,6 +245,46 @@ uint64_t ossl_quic_port_get_max_pending_channels(const QUIC_PORT *port);
 
 void ossl_quic_port_set_max_pending_channels(QUIC_PORT *port, uint64_t max_pending_channels);
 
+/*
+ * CID sharding. A port can be one of cid_shard_count ports (each usually
+ * driven by its own thread and engine) sharing one UDP address via
+ * SO_REUSEPORT. The shard ID is encoded into every LCID the port generates
+ * (see quic_lcidm.h) so that the kernel can steer the packets of a connection
+ * to the socket of the port which owns it.
+ */
+uint64_t ossl_quic_port_get_cid_shard_id(const QUIC_PORT *port);
+void ossl_quic_port_set_cid_shard_id(QUIC_PORT *port, uint64_t id);
+uint64_t ossl_quic_port_get_cid_shard_count(const QUIC_PORT *port);
+void ossl_quic_port_set_cid_shard_count(QUIC_PORT *port, uint64_t count);
+
+/*
+ * Applies the CID sharding configuration. If the shard count is greater than
+ * one, the port starts encoding its shard ID into LCIDs, and a program which
+ * routes datagrams by the first DCID byte is attached to the SO_REUSEPORT
+ * group of the network read BIO's socket. Otherwise sharding is disabled.
+ * Must be called before any connection is accepted.
+ *
+ * Returns 1 on success or 0 on failure, including if the platform does not
+ * support steering.
+ */
+int ossl_quic_port_apply_cid_sharding(QUIC_PORT *port);
+
+/*
+ * The congestion control algorithm (one of SSL_VALUE_QUIC_CC_ALGORITHM_*) used
+ * by channels subsequently created on the port. The caller must validate the
+ * value.
+ */
+uint64_t ossl_quic_port_get_cc_algorithm(const QUIC_PORT *port);
+void ossl_quic_port_set_cc_algorithm(QUIC_PORT *port, uint64_t algorithm);
+
+/*
+ * The maximum number of worker threads which incoming connections on the port
+ * may use to run handshake steps at any one time. 0 (the default) runs all
+ * handshakes on the thread ticking the port.
+ */
+uint64_t ossl_quic_port_get_max_handshake_threads(const QUIC_PORT *port);
+void ossl_quic_port_set_max_handshake_threads(QUIC_PORT *port, uint64_t max);
+
 #endif
 
 #endif
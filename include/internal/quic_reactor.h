@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -14,6 +14,7 @@
 #include "internal/quic_predef.h"
 #include "internal/thread_arch.h"
 #include "internal/rio_notifier.h"
+#include "internal/rio_poll_set.h"
 #include <openssl/bio.h>
 
 #ifndef OPENSSL_NO_QUIC
@@ -120,6 +121,12 @@ struct quic_reactor_st {
      */
     size_t cur_blocking_waiters;
 
+    /*
+     * Persistent OS poll set holding poll_r, poll_w and the notifier with the
+     * events currently desired. Valid only if have_poll_set is set.
+     */
+    RIO_POLL_SET poll_set;
+
     /*
      * These are true if we would like to know when we can read or write from
      * the network respectively.
@@ -139,11 +146,24 @@ struct quic_reactor_st {
 
     /* 1 if a block_until_pred call has put the notifier in the signalled state. */
     unsigned int signalled_notifier : 1;
+
+    /* 1 if poll_set is present and initialised. */
+    unsigned int have_poll_set : 1;
+
+    /* 1 if the last update of poll_set succeeded, so that it can be waited on. */
+    unsigned int poll_set_synced : 1;
 };
 
 /* Create an OS notifier? */
 #define QUIC_REACTOR_FLAG_USE_NOTIFIER (1U << 0)
 
+/*
+ * Keep the descriptors to be waited on registered in a persistent OS poll set
+ * (see rio_poll_set.h), updated as the poll descriptors and the desired events
+ * change, instead of describing them to the OS again on every wait.
+ */
+#define QUIC_REACTOR_FLAG_USE_POLL_SET (1U << 1)
+
 int ossl_quic_reactor_init(QUIC_REACTOR *rtor,
     void (*tick_cb)(QUIC_TICK_RESULT *res, void *arg,
         uint32_t flags),
@@ -188,6 +208,13 @@ int ossl_quic_reactor_tick(QUIC_REACTOR *rtor, uint32_t flags);
 
 RIO_NOTIFIER *ossl_quic_reactor_get0_notifier(QUIC_REACTOR *rtor);
 
+/*
+ * Returns an FD which becomes readable whenever the reactor has work to do
+ * (i.e., a poll descriptor is ready for a desired event, or the notifier is
+ * signalled), or -1 if the reactor does not use a poll set.
+ */
+int ossl_quic_reactor_get_poll_set_fd(QUIC_REACTOR *rtor);
+
 /*
  * Blocking I/O Adaptation Layer
  * =============================
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -59,6 +59,13 @@ __owur int ossl_quic_peek(SSL *s, void *buf, size_t len, size_t *readbytes);
 __owur int ossl_quic_write_flags(SSL *s, const void *buf, size_t len,
     uint64_t flags, size_t *written);
 __owur int ossl_quic_write(SSL *s, const void *buf, size_t len, size_t *written);
+__owur int ossl_quic_read_ref(SSL *s, const unsigned char **buf,
+    size_t *readbytes);
+__owur int ossl_quic_read_ref_release(SSL *s, size_t num);
+__owur int ossl_quic_write_ref(SSL *s, const void *buf, size_t len,
+    uint64_t flags,
+    SSL_write_ref_release_cb_fn release_cb,
+    void *release_cb_arg, size_t *written);
 __owur long ossl_quic_ctrl(SSL *s, int cmd, long larg, void *parg);
 __owur long ossl_quic_ctx_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg);
 __owur long ossl_quic_callback_ctrl(SSL *s, int cmd, void (*fp)(void));
@@ -177,6 +184,13 @@ int ossl_quic_set_diag_title(SSL_CTX *ctx, const char *title);
 int ossl_quic_conn_poll_events(SSL *ssl, uint64_t events, int do_tick,
     uint64_t *revents);
 int ossl_quic_get_notifier_fd(SSL *ssl);
+/*
+ * Returns the FD of the poll set of the reactor ssl belongs to, or -1 if it
+ * does not use one. rfd and wfd are the FDs of the network BIOs the caller is
+ * interested in (or -1); the reactor's descriptors are refreshed if they do not
+ * match.
+ */
+int ossl_quic_get_poll_set_fd(SSL *ssl, int rfd, int wfd);
 void ossl_quic_enter_blocking_section(SSL *ssl, QUIC_REACTOR_WAIT_CTX *wctx);
 void ossl_quic_leave_blocking_section(SSL *ssl, QUIC_REACTOR_WAIT_CTX *wctx);
 QUIC_PORT *ossl_quic_listener_get_port(SSL *s);
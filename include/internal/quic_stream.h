@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -241,6 +241,25 @@ int ossl_quic_sstream_append(QUIC_SSTREAM *qss,
     size_t buf_len,
     size_t *consumed);
 
+typedef void(ossl_quic_sstream_ref_free_fn)(const void *buf, size_t buf_len,
+    void *arg);
+
+/*
+ * (Front end use.) Appends user data to the stream by reference. The data is
+ * not copied and does not use any of the internal ring buffer; instead the
+ * stream refers to buf until all of its bytes have been acknowledged by the
+ * peer or the QUIC_SSTREAM is freed, at which point free_cb is called with buf,
+ * buf_len and free_cb_arg. The caller must keep the buffer valid and unchanged
+ * until then. The whole buffer is always appended.
+ *
+ * Returns 1 on success or 0 on failure, in which case free_cb is not called.
+ */
+int ossl_quic_sstream_append_ref(QUIC_SSTREAM *qss,
+    const unsigned char *buf,
+    size_t buf_len,
+    ossl_quic_sstream_ref_free_fn *free_cb,
+    void *free_cb_arg);
+
 /*
  * Marks a stream as finished. ossl_quic_sstream_append() may not be called anymore
  * after calling this.
@@ -399,6 +418,13 @@ int ossl_quic_rstream_get_record(QUIC_RSTREAM *qrs,
  */
 int ossl_quic_rstream_release_record(QUIC_RSTREAM *qrs, size_t read_len);
 
+/*
+ * Returns 1 if a record returned by ossl_quic_rstream_get_record() has not yet
+ * been released. The data of such a record remains valid even if further
+ * stream data is queued, as long as the QUIC_RSTREAM is not freed.
+ */
+int ossl_quic_rstream_is_record_held(QUIC_RSTREAM *qrs);
+
 /*
  * Moves received frame data from decrypted packets to ring buffer.
  * This should be called when there are too many decrypted packets allocated.
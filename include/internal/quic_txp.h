@@ -120,6 +120,18 @@ int ossl_quic_tx_packetiser_generate(OSSL_QUIC_TX_PACKETISER *txp,
  */
 OSSL_TIME ossl_quic_tx_packetiser_get_deadline(OSSL_QUIC_TX_PACKETISER *txp);
 
+/*
+ * Returns the rate in bytes per second at which the TXP is pacing packets, as
+ * provided by the congestion controller, or 0 if pacing is not in use.
+ */
+uint64_t ossl_quic_tx_packetiser_get_pacing_rate(const OSSL_QUIC_TX_PACKETISER *txp);
+
+/*
+ * Returns the number of times the pacer has held back a packet which CC would
+ * otherwise have allowed us to send.
+ */
+uint64_t ossl_quic_tx_packetiser_get_pacing_deferrals(const OSSL_QUIC_TX_PACKETISER *txp);
+
 /*
  * Set the token used in Initial packets. The callback is called when the buffer
  * is no longer needed; for example, when the TXP is freed or when this function
@@ -159,6 +171,11 @@ int ossl_quic_tx_packetiser_set_peer(OSSL_QUIC_TX_PACKETISER *txp,
 int ossl_quic_tx_packetiser_set_ack_delay_exponent(OSSL_QUIC_TX_PACKETISER *txp,
     uint32_t exp);
 
+/* Change the congestion controller the TXP consults. */
+void ossl_quic_tx_packetiser_set_cc(OSSL_QUIC_TX_PACKETISER *txp,
+    const OSSL_CC_METHOD *cc_method,
+    OSSL_CC_DATA *cc_data);
+
 /*
  * Change the QLOG instance retrieval function in use after instantiation.
  */
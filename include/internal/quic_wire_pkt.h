@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -263,6 +263,48 @@ int ossl_quic_hdr_protector_encrypt_fields(QUIC_HDR_PROTECTOR *hpr,
     unsigned char *first_byte,
     unsigned char *pn_bytes);
 
+/*
+ * Batched Header Protection
+ * -------------------------
+ *
+ * Describes the fields of one packet for batched header protection. The
+ * fields have the same meaning as the arguments to
+ * ossl_quic_hdr_protector_decrypt_fields().
+ */
+typedef struct quic_hdr_prot_op_st {
+    const unsigned char *sample;
+    size_t sample_len;
+    unsigned char *first_byte;
+    unsigned char *pn_bytes;
+} QUIC_HDR_PROT_OP;
+
+/* Maximum number of packets which may be passed in a single batch. */
+#define QUIC_HDR_PROT_BATCH_MAX 32
+
+/*
+ * Removes header protection from num_ops packets protected with the same
+ * header protection key. This is equivalent to calling
+ * ossl_quic_hdr_protector_decrypt_fields() for each packet in turn, but the
+ * masks for all packets are generated together, which for AES is a single
+ * cipher operation over all samples.
+ *
+ * num_ops must not exceed QUIC_HDR_PROT_BATCH_MAX. If this function fails, no
+ * data is modified.
+ *
+ * Returns 1 on success and 0 on failure.
+ */
+int ossl_quic_hdr_protector_decrypt_batch(QUIC_HDR_PROTECTOR *hpr,
+    const QUIC_HDR_PROT_OP *ops,
+    size_t num_ops);
+
+/*
+ * Works analogously to ossl_quic_hdr_protector_decrypt_batch, but applies
+ * header protection instead of removing it.
+ */
+int ossl_quic_hdr_protector_encrypt_batch(QUIC_HDR_PROTECTOR *hpr,
+    const QUIC_HDR_PROT_OP *ops,
+    size_t num_ops);
+
 /*
  * QUIC Packet Header
  * ==================
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -58,6 +58,14 @@ struct ossl_record_template_st {
     unsigned int version;
     const unsigned char *buf;
     size_t buflen;
+    /*
+     * If iov is not NULL then buf is unused and the buflen bytes of the record
+     * are gathered from the iovcnt elements of iov instead, skipping the first
+     * iovoff bytes of their combined data.
+     */
+    const SSL_IOVEC *iov;
+    size_t iovcnt;
+    size_t iovoff;
 };
 
 typedef struct ossl_record_template_st OSSL_RECORD_TEMPLATE;
@@ -315,6 +323,16 @@ struct ossl_record_method_st {
      * data. Buffers are automatically reallocated on next read/write.
      */
     int (*free_buffers)(OSSL_RECORD_LAYER *rl);
+
+    /*
+     * Offer a buffer of |len| bytes that the plaintext of the next record may
+     * be decrypted into directly, instead of into the read buffer. This is
+     * only done if the whole record fits and the record layer supports it,
+     * in which case the |data| returned by read_record() points into |buf|.
+     * A NULL |buf| withdraws the offer. May be NULL if not supported.
+     */
+    void (*set_read_dest)(OSSL_RECORD_LAYER *rl, unsigned char *buf,
+        size_t len);
 };
 
 /* Standard built-in record methods */
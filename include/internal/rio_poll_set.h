@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+#ifndef OSSL_RIO_POLL_SET_H
+#define OSSL_RIO_POLL_SET_H
+
+#include "internal/common.h"
+#include "internal/sockets.h"
+#include "internal/time.h"
+
+/*
+ * Persistent Poll Set
+ * ===================
+ *
+ * RIO_POLL_SET wraps an OS facility which keeps a set of FD registrations in
+ * the kernel between calls (currently epoll(7)), so that the cost of waiting
+ * does not depend on re-describing every FD on every wait. The set is itself
+ * represented by a single FD which becomes readable when any registered FD is
+ * ready, so it can be plugged into poll(2)-style APIs in place of the FDs it
+ * contains.
+ *
+ * A poll set holds a small fixed number of slots, each of which refers to at
+ * most one FD. Registrations are only changed in the kernel when the contents
+ * of a slot change. Several slots may refer to the same FD, in which case the
+ * FD is registered once with the union of the requested events. Readiness is
+ * level-triggered.
+ */
+#if defined(OPENSSL_SYS_LINUX)
+#define RIO_POLL_SET_METHOD_EPOLL 1
+#endif
+
+#define RIO_POLL_SET_NUM_SLOTS 3
+
+typedef struct rio_poll_set_slot_st {
+    int fd;
+    unsigned int want_read : 1;
+    unsigned int want_write : 1;
+} RIO_POLL_SET_SLOT;
+
+typedef struct rio_poll_set_st {
+    int fd;
+    /* Requested state. */
+    RIO_POLL_SET_SLOT slot[RIO_POLL_SET_NUM_SLOTS];
+    /* State currently registered with the kernel. */
+    RIO_POLL_SET_SLOT reg[RIO_POLL_SET_NUM_SLOTS];
+    size_t num_reg;
+} RIO_POLL_SET;
+
+/*
+ * Returns 1 if persistent poll sets are supported on this platform.
+ */
+int ossl_rio_poll_set_is_supported(void);
+
+/*
+ * Initialises a RIO_POLL_SET with all slots empty. Returns 1 on success or 0
+ * on failure.
+ */
+int ossl_rio_poll_set_init(RIO_POLL_SET *ps);
+
+/*
+ * Cleans up a RIO_POLL_SET, tearing down any allocated resources.
+ */
+void ossl_rio_poll_set_cleanup(RIO_POLL_SET *ps);
+
+/*
+ * Sets the FD and wanted events for a slot. fd may be -1 to empty the slot.
+ * Takes effect on the next call to ossl_rio_poll_set_sync().
+ */
+void ossl_rio_poll_set_set_slot(RIO_POLL_SET *ps, size_t slot, int fd,
+    int want_read, int want_write);
+
+/*
+ * Drops any kernel registration for fd so that the next call to
+ * ossl_rio_poll_set_sync() registers it afresh. This must be used when an FD
+ * in a slot may have been closed and its number reused for a new file.
+ */
+void ossl_rio_poll_set_forget_fd(RIO_POLL_SET *ps, int fd);
+
+/*
+ * Brings the kernel registrations in line with the slots, issuing only the
+ * operations needed to do so. Returns 1 on success or 0 on failure.
+ */
+int ossl_rio_poll_set_sync(RIO_POLL_SET *ps);
+
+/*
+ * Waits until a registered FD is ready or the deadline, which is based on the
+ * ossl_time_now() clock, expires. Returns 1 on success (including timeout) or
+ * 0 on failure.
+ */
+int ossl_rio_poll_set_wait(RIO_POLL_SET *ps, OSSL_TIME deadline);
+
+/*
+ * Returns an FD which can be polled for readability to determine when any FD
+ * registered in the poll set is ready.
+ */
+static ossl_inline ossl_unused int ossl_rio_poll_set_as_fd(const RIO_POLL_SET *ps)
+{
+    return ps->fd;
+}
+
+#endif
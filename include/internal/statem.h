@@ -76,6 +76,7 @@ typedef enum {
 typedef enum {
     WRITE_STATE_TRANSITION,
     WRITE_STATE_PRE_WORK,
+    WRITE_STATE_CONSTRUCT,
     WRITE_STATE_SEND,
     WRITE_STATE_POST_WORK
 } WRITE_STATE;
@@ -83,7 +84,8 @@ typedef enum {
 typedef enum {
     CON_FUNC_ERROR = 0,
     CON_FUNC_SUCCESS,
-    CON_FUNC_DONT_SEND
+    CON_FUNC_DONT_SEND,
+    CON_FUNC_RETRY
 } CON_FUNC_RETURN;
 
 typedef enum {
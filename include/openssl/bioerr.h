@@ -55,6 +55,7 @@
 #define BIO_R_UNABLE_TO_LISTEN_SOCKET 119
 #define BIO_R_UNABLE_TO_NODELAY 138
 #define BIO_R_UNABLE_TO_REUSEADDR 139
+#define BIO_R_UNABLE_TO_REUSEPORT 152
 #define BIO_R_UNABLE_TO_TFO 109
 #define BIO_R_UNAVAILABLE_IP_FAMILY 145
 #define BIO_R_UNINITIALIZED 120
@@ -0,0 +1,750 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include "internal/quic_cc.h"
+#include "internal/quic_types.h"
+#include "internal/safe_math.h"
+#include "cc_local.h"
+
+OSSL_SAFE_MATH_UNSIGNED(u64, uint64_t)
+
+/*
+ * BBR Congestion Control
+ * ======================
+ *
+ * A model-based congestion controller in the style of BBR. Rather than reacting
+ * to loss, we estimate the bottleneck bandwidth (the maximum delivery rate seen
+ * over the last few rounds) and the round trip propagation time (the minimum
+ * RTT seen over the last ten seconds), and use their product, the BDP, to size
+ * the congestion window. The sender is expected to pace packets at the rate
+ * exposed via the OSSL_CC_OPTION_CUR_PACING_RATE diagnostic.
+ *
+ * The controller works in rounds. A round ends when a packet sent after the
+ * start of the round is acknowledged, at which point we take a delivery rate
+ * sample for the round as a whole. This is coarser than per-packet delivery
+ * rate sampling but only needs the information the ACK manager already gives
+ * us.
+ *
+ * Loss handling follows BBRv2 in spirit: random loss below a threshold is
+ * ignored, but once more than 2% of the data sent in a round is lost (or an
+ * ECN congestion mark is seen) we bound the amount of data in flight, at most
+ * once per round, and leave STARTUP if still there. The bound is slowly raised
+ * again in rounds without loss.
+ */
+
+/* Gains are fixed point, with BBR_UNIT representing 1.0. */
+#define BBR_UNIT 256
+#define BBR_HIGH_GAIN 739 /* 2/ln(2) */
+#define BBR_DRAIN_GAIN 88 /* ln(2)/2 */
+#define BBR_CWND_GAIN 512
+
+/* Number of rounds over which the maximum bandwidth is taken. */
+#define BBR_BW_FILTER_LEN 10
+
+/* Minimum RTT filter window and time spent in PROBE_RTT. */
+#define BBR_MIN_RTT_WINDOW_MS 10000
+#define BBR_PROBE_RTT_MS 200
+
+/* Minimum congestion window, in datagrams. */
+#define BBR_MIN_CWND_DGRAMS 4
+
+/* Extra room in the window to absorb ACK aggregation, in datagrams. */
+#define BBR_EXTRA_CWND_DGRAMS 3
+
+/* STARTUP ends after this many rounds without 25% bandwidth growth. */
+#define BBR_FULL_BW_THRESH 320
+#define BBR_FULL_BW_ROUNDS 3
+
+/* Tolerated loss per round (2%) and the response to exceeding it. */
+#define BBR_LOSS_THRESH_NUM 2
+#define BBR_LOSS_THRESH_DEN 100
+#define BBR_BETA_NUM 7
+#define BBR_BETA_DEN 10
+
+#define BBR_CYCLE_LEN 8
+
+static const uint32_t bbr_pacing_gain_cycle[BBR_CYCLE_LEN] = {
+    320, 192, 256, 256, 256, 256, 256, 256
+};
+
+enum {
+    BBR_MODE_STARTUP,
+    BBR_MODE_DRAIN,
+    BBR_MODE_PROBE_BW,
+    BBR_MODE_PROBE_RTT
+};
+
+typedef struct ossl_cc_bbr_st {
+    /* Dependencies. */
+    OSSL_TIME (*now_cb)(void *arg);
+    void *now_cb_arg;
+
+    /* 'Constants'. */
+    uint64_t k_init_wnd, k_min_wnd;
+
+    /* State. */
+    size_t max_dgram_size;
+    uint64_t bytes_in_flight, cong_wnd, inflight_hi;
+    uint64_t pacing_rate;
+    uint32_t mode, pacing_gain, cwnd_gain;
+
+    /* Round tracking and delivery rate estimation. */
+    uint64_t delivered, round_count;
+    uint64_t round_start_delivered, round_lost, round_max_inflight;
+    OSSL_TIME round_start;
+    int round_loss_seen;
+    uint64_t bw_filter[BBR_BW_FILTER_LEN];
+    size_t bw_filter_idx;
+    uint64_t btl_bw;
+
+    /* Minimum RTT estimation. */
+    OSSL_TIME min_rtt, min_rtt_stamp;
+
+    /* STARTUP. */
+    uint64_t full_bw;
+    uint32_t full_bw_count;
+    int filled_pipe;
+
+    /* PROBE_BW. */
+    uint32_t cycle_idx;
+    OSSL_TIME cycle_stamp;
+
+    /* PROBE_RTT. */
+    OSSL_TIME probe_rtt_done_stamp;
+    int probe_rtt_round_done;
+    uint64_t prior_cwnd;
+
+    /* Unflushed state during multiple on-loss calls. */
+    int processing_loss;
+
+    /* Diagnostic output locations. */
+    size_t *p_diag_max_dgram_payload_len;
+    uint64_t *p_diag_cur_cwnd_size;
+    uint64_t *p_diag_min_cwnd_size;
+    uint64_t *p_diag_cur_bytes_in_flight;
+    uint32_t *p_diag_cur_state;
+    uint64_t *p_diag_cur_pacing_rate;
+} OSSL_CC_BBR;
+
+static void bbr_set_max_dgram_size(OSSL_CC_BBR *cc, size_t max_dgram_size);
+static void bbr_update_diag(OSSL_CC_BBR *cc);
+static void bbr_reset(OSSL_CC_DATA *cc);
+
+static OSSL_CC_DATA *bbr_new(OSSL_TIME (*now_cb)(void *arg),
+    void *now_cb_arg)
+{
+    OSSL_CC_BBR *cc;
+
+    if ((cc = OPENSSL_zalloc(sizeof(*cc))) == NULL)
+        return NULL;
+
+    cc->now_cb = now_cb;
+    cc->now_cb_arg = now_cb_arg;
+
+    bbr_set_max_dgram_size(cc, QUIC_MIN_INITIAL_DGRAM_LEN);
+    bbr_reset((OSSL_CC_DATA *)cc);
+
+    return (OSSL_CC_DATA *)cc;
+}
+
+static void bbr_free(OSSL_CC_DATA *cc)
+{
+    OPENSSL_free(cc);
+}
+
+static void bbr_set_max_dgram_size(OSSL_CC_BBR *cc, size_t max_dgram_size)
+{
+    int is_reduced = (max_dgram_size < cc->max_dgram_size);
+
+    cc->max_dgram_size = max_dgram_size;
+    cc->k_init_wnd = ossl_cc_get_init_wnd(max_dgram_size);
+    cc->k_min_wnd = BBR_MIN_CWND_DGRAMS * max_dgram_size;
+
+    if (is_reduced)
+        cc->cong_wnd = cc->k_init_wnd;
+
+    bbr_update_diag(cc);
+}
+
+static void bbr_enter_startup(OSSL_CC_BBR *cc)
+{
+    cc->mode = BBR_MODE_STARTUP;
+    cc->pacing_gain = BBR_HIGH_GAIN;
+    cc->cwnd_gain = BBR_HIGH_GAIN;
+}
+
+static void bbr_reset(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+    size_t i;
+
+    cc->cong_wnd = cc->k_init_wnd;
+    cc->bytes_in_flight = 0;
+    cc->inflight_hi = UINT64_MAX;
+    cc->pacing_rate = 0;
+
+    cc->delivered = 0;
+    cc->round_count = 0;
+    cc->round_start_delivered = 0;
+    cc->round_lost = 0;
+    cc->round_max_inflight = 0;
+    cc->round_start = ossl_time_zero();
+    cc->round_loss_seen = 0;
+    for (i = 0; i < BBR_BW_FILTER_LEN; ++i)
+        cc->bw_filter[i] = 0;
+    cc->bw_filter_idx = 0;
+    cc->btl_bw = 0;
+
+    cc->min_rtt = ossl_time_infinite();
+    cc->min_rtt_stamp = ossl_time_zero();
+
+    cc->full_bw = 0;
+    cc->full_bw_count = 0;
+    cc->filled_pipe = 0;
+
+    cc->cycle_idx = 0;
+    cc->cycle_stamp = ossl_time_zero();
+
+    cc->probe_rtt_done_stamp = ossl_time_zero();
+    cc->probe_rtt_round_done = 0;
+    cc->prior_cwnd = 0;
+
+    cc->processing_loss = 0;
+
+    bbr_enter_startup(cc);
+}
+
+static int bbr_set_input_params(OSSL_CC_DATA *ccdata, const OSSL_PARAM *params)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+    const OSSL_PARAM *p;
+    size_t value;
+
+    p = OSSL_PARAM_locate_const(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN);
+    if (p != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &value))
+            return 0;
+        if (value < QUIC_MIN_INITIAL_DGRAM_LEN)
+            return 0;
+
+        bbr_set_max_dgram_size(cc, value);
+    }
+
+    return 1;
+}
+
+static int bbr_bind_diagnostic(OSSL_CC_DATA *ccdata, OSSL_PARAM *params)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+    size_t *new_p_max_dgram_payload_len;
+    uint64_t *new_p_cur_cwnd_size;
+    uint64_t *new_p_min_cwnd_size;
+    uint64_t *new_p_cur_bytes_in_flight;
+    uint32_t *new_p_cur_state;
+    uint64_t *new_p_cur_pacing_rate;
+
+    if (!ossl_cc_bind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+            sizeof(size_t), (void **)&new_p_max_dgram_payload_len)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+            sizeof(uint64_t), (void **)&new_p_cur_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+            sizeof(uint64_t), (void **)&new_p_min_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+            sizeof(uint64_t), (void **)&new_p_cur_bytes_in_flight)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+            sizeof(uint32_t), (void **)&new_p_cur_state)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_PACING_RATE,
+            sizeof(uint64_t), (void **)&new_p_cur_pacing_rate))
+        return 0;
+
+    if (new_p_max_dgram_payload_len != NULL)
+        cc->p_diag_max_dgram_payload_len = new_p_max_dgram_payload_len;
+
+    if (new_p_cur_cwnd_size != NULL)
+        cc->p_diag_cur_cwnd_size = new_p_cur_cwnd_size;
+
+    if (new_p_min_cwnd_size != NULL)
+        cc->p_diag_min_cwnd_size = new_p_min_cwnd_size;
+
+    if (new_p_cur_bytes_in_flight != NULL)
+        cc->p_diag_cur_bytes_in_flight = new_p_cur_bytes_in_flight;
+
+    if (new_p_cur_state != NULL)
+        cc->p_diag_cur_state = new_p_cur_state;
+
+    if (new_p_cur_pacing_rate != NULL)
+        cc->p_diag_cur_pacing_rate = new_p_cur_pacing_rate;
+
+    bbr_update_diag(cc);
+    return 1;
+}
+
+static int bbr_unbind_diagnostic(OSSL_CC_DATA *ccdata, OSSL_PARAM *params)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+        (void **)&cc->p_diag_max_dgram_payload_len);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+        (void **)&cc->p_diag_cur_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+        (void **)&cc->p_diag_min_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+        (void **)&cc->p_diag_cur_bytes_in_flight);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+        (void **)&cc->p_diag_cur_state);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_PACING_RATE,
+        (void **)&cc->p_diag_cur_pacing_rate);
+    return 1;
+}
+
+static void bbr_update_diag(OSSL_CC_BBR *cc)
+{
+    static const uint32_t mode_chars[] = { 'S', 'D', 'B', 'T' };
+
+    if (cc->p_diag_max_dgram_payload_len != NULL)
+        *cc->p_diag_max_dgram_payload_len = cc->max_dgram_size;
+
+    if (cc->p_diag_cur_cwnd_size != NULL)
+        *cc->p_diag_cur_cwnd_size = cc->cong_wnd;
+
+    if (cc->p_diag_min_cwnd_size != NULL)
+        *cc->p_diag_min_cwnd_size = cc->k_min_wnd;
+
+    if (cc->p_diag_cur_bytes_in_flight != NULL)
+        *cc->p_diag_cur_bytes_in_flight = cc->bytes_in_flight;
+
+    if (cc->p_diag_cur_state != NULL)
+        *cc->p_diag_cur_state = mode_chars[cc->mode];
+
+    if (cc->p_diag_cur_pacing_rate != NULL)
+        *cc->p_diag_cur_pacing_rate = cc->pacing_rate;
+}
+
+/* Returns gain * BDP, or UINT64_MAX if we do not have a model yet. */
+static uint64_t bbr_bdp(OSSL_CC_BBR *cc, uint32_t gain)
+{
+    uint64_t bdp;
+    int err = 0;
+
+    if (cc->btl_bw == 0 || ossl_time_is_infinite(cc->min_rtt))
+        return UINT64_MAX;
+
+    bdp = safe_muldiv_u64(cc->btl_bw, ossl_time2us(cc->min_rtt), 1000000,
+        &err);
+    bdp = safe_muldiv_u64(bdp, gain, BBR_UNIT, &err);
+    return err ? UINT64_MAX : bdp;
+}
+
+static void bbr_enter_probe_bw(OSSL_CC_BBR *cc, OSSL_TIME now)
+{
+    uint32_t idx;
+
+    cc->mode = BBR_MODE_PROBE_BW;
+    cc->cwnd_gain = BBR_CWND_GAIN;
+
+    /*
+     * Start at a random phase other than the draining one, so that competing
+     * flows do not probe in lockstep.
+     */
+    idx = (uint32_t)(ossl_time2ticks(now) % (BBR_CYCLE_LEN - 1));
+    cc->cycle_idx = idx >= 1 ? idx + 1 : idx;
+    cc->cycle_stamp = now;
+    cc->pacing_gain = bbr_pacing_gain_cycle[cc->cycle_idx];
+}
+
+static void bbr_enter_drain(OSSL_CC_BBR *cc)
+{
+    cc->mode = BBR_MODE_DRAIN;
+    cc->pacing_gain = BBR_DRAIN_GAIN;
+    cc->cwnd_gain = BBR_HIGH_GAIN;
+}
+
+static void bbr_enter_probe_rtt(OSSL_CC_BBR *cc)
+{
+    cc->mode = BBR_MODE_PROBE_RTT;
+    cc->pacing_gain = BBR_UNIT;
+    cc->cwnd_gain = BBR_UNIT;
+    cc->prior_cwnd = cc->cong_wnd;
+    cc->probe_rtt_done_stamp = ossl_time_zero();
+    cc->probe_rtt_round_done = 0;
+}
+
+static void bbr_exit_probe_rtt(OSSL_CC_BBR *cc, OSSL_TIME now)
+{
+    cc->min_rtt_stamp = now;
+    if (cc->cong_wnd < cc->prior_cwnd)
+        cc->cong_wnd = cc->prior_cwnd;
+
+    if (cc->filled_pipe) {
+        bbr_enter_probe_bw(cc, now);
+    } else {
+        bbr_enter_startup(cc);
+    }
+}
+
+static void bbr_update_bw(OSSL_CC_BBR *cc, OSSL_TIME now)
+{
+    uint64_t interval_us, sample, bdp;
+    int err = 0, app_limited;
+    size_t i;
+
+    if (ossl_time_is_zero(cc->round_start))
+        return;
+
+    interval_us = ossl_time2us(ossl_time_subtract(now, cc->round_start));
+    if (interval_us == 0)
+        return;
+
+    sample = safe_muldiv_u64(cc->delivered - cc->round_start_delivered,
+        1000000, interval_us, &err);
+    if (err)
+        return;
+
+    /*
+     * A round in which we never had much data in flight says more about the
+     * application than the path. Do not let it age out better samples.
+     */
+    bdp = bbr_bdp(cc, BBR_UNIT);
+    app_limited = (bdp != UINT64_MAX && cc->round_max_inflight < bdp / 2);
+    if (app_limited && sample < cc->btl_bw)
+        return;
+
+    cc->bw_filter[cc->bw_filter_idx] = sample;
+    cc->bw_filter_idx = (cc->bw_filter_idx + 1) % BBR_BW_FILTER_LEN;
+
+    cc->btl_bw = 0;
+    for (i = 0; i < BBR_BW_FILTER_LEN; ++i)
+        if (cc->bw_filter[i] > cc->btl_bw)
+            cc->btl_bw = cc->bw_filter[i];
+}
+
+/* Responds to excessive loss or ECN marking in the current round. */
+static void bbr_on_congestion(OSSL_CC_BBR *cc)
+{
+    uint64_t bound;
+    int err = 0;
+
+    if (cc->round_loss_seen)
+        return;
+
+    cc->round_loss_seen = 1;
+
+    bound = safe_muldiv_u64(cc->cong_wnd, BBR_BETA_NUM, BBR_BETA_DEN, &err);
+    if (bound < cc->k_min_wnd)
+        bound = cc->k_min_wnd;
+    if (bound < cc->inflight_hi)
+        cc->inflight_hi = bound;
+    if (cc->cong_wnd > cc->inflight_hi)
+        cc->cong_wnd = cc->inflight_hi;
+
+    cc->filled_pipe = 1;
+    if (cc->mode == BBR_MODE_STARTUP)
+        bbr_enter_drain(cc);
+}
+
+static void bbr_check_loss(OSSL_CC_BBR *cc)
+{
+    uint64_t sent;
+
+    /*
+     * Compare the loss against all data belonging to the round, i.e. that
+     * delivered or lost so far plus that still in flight.
+     */
+    sent = cc->delivered - cc->round_start_delivered + cc->round_lost
+        + cc->bytes_in_flight;
+
+    if (cc->round_lost * BBR_LOSS_THRESH_DEN > sent * BBR_LOSS_THRESH_NUM)
+        bbr_on_congestion(cc);
+}
+
+static void bbr_probe_inflight_hi(OSSL_CC_BBR *cc)
+{
+    if (cc->round_loss_seen || cc->inflight_hi == UINT64_MAX
+        || cc->mode != BBR_MODE_PROBE_BW)
+        return;
+
+    /* A round without loss: raise the bound again. */
+    cc->inflight_hi += cc->inflight_hi / 16 + cc->max_dgram_size;
+    if (cc->inflight_hi / 2 > bbr_bdp(cc, cc->cwnd_gain))
+        cc->inflight_hi = UINT64_MAX;
+}
+
+static void bbr_check_full_pipe(OSSL_CC_BBR *cc)
+{
+    uint64_t thresh;
+    int err = 0;
+
+    if (cc->filled_pipe || cc->btl_bw == 0)
+        return;
+
+    thresh = safe_muldiv_u64(cc->full_bw, BBR_FULL_BW_THRESH, BBR_UNIT, &err);
+    if (cc->btl_bw >= thresh) {
+        cc->full_bw = cc->btl_bw;
+        cc->full_bw_count = 0;
+        return;
+    }
+
+    if (++cc->full_bw_count >= BBR_FULL_BW_ROUNDS)
+        cc->filled_pipe = 1;
+}
+
+static void bbr_on_round_end(OSSL_CC_BBR *cc, OSSL_TIME now)
+{
+    bbr_update_bw(cc, now);
+    bbr_probe_inflight_hi(cc);
+    bbr_check_full_pipe(cc);
+
+    if (cc->mode == BBR_MODE_STARTUP && cc->filled_pipe)
+        bbr_enter_drain(cc);
+
+    if (cc->mode == BBR_MODE_PROBE_RTT
+        && !ossl_time_is_zero(cc->probe_rtt_done_stamp))
+        cc->probe_rtt_round_done = 1;
+
+    ++cc->round_count;
+    cc->round_start = now;
+    cc->round_start_delivered = cc->delivered;
+    cc->round_lost = 0;
+    cc->round_loss_seen = 0;
+    cc->round_max_inflight = cc->bytes_in_flight;
+}
+
+static void bbr_update_min_rtt(OSSL_CC_BBR *cc, OSSL_TIME now,
+    OSSL_TIME tx_time)
+{
+    OSSL_TIME rtt;
+    int expired;
+
+    if (ossl_time_compare(now, tx_time) <= 0)
+        return;
+
+    rtt = ossl_time_subtract(now, tx_time);
+    expired = !ossl_time_is_zero(cc->min_rtt_stamp)
+        && ossl_time_compare(now,
+               ossl_time_add(cc->min_rtt_stamp,
+                   ossl_ms2time(BBR_MIN_RTT_WINDOW_MS)))
+            > 0;
+
+    if (ossl_time_compare(rtt, cc->min_rtt) <= 0 || expired) {
+        cc->min_rtt = rtt;
+        cc->min_rtt_stamp = now;
+    }
+
+    if (expired && cc->mode != BBR_MODE_PROBE_RTT)
+        bbr_enter_probe_rtt(cc);
+}
+
+static void bbr_update_mode(OSSL_CC_BBR *cc, OSSL_TIME now)
+{
+    uint32_t gain;
+
+    switch (cc->mode) {
+    case BBR_MODE_DRAIN:
+        if (cc->bytes_in_flight <= bbr_bdp(cc, BBR_UNIT))
+            bbr_enter_probe_bw(cc, now);
+        break;
+
+    case BBR_MODE_PROBE_BW:
+        gain = bbr_pacing_gain_cycle[cc->cycle_idx];
+        if (ossl_time_compare(ossl_time_subtract(now, cc->cycle_stamp),
+                cc->min_rtt)
+                > 0
+            || (gain < BBR_UNIT
+                && cc->bytes_in_flight <= bbr_bdp(cc, BBR_UNIT))) {
+            cc->cycle_idx = (cc->cycle_idx + 1) % BBR_CYCLE_LEN;
+            cc->cycle_stamp = now;
+            cc->pacing_gain = bbr_pacing_gain_cycle[cc->cycle_idx];
+        }
+        break;
+
+    case BBR_MODE_PROBE_RTT:
+        if (ossl_time_is_zero(cc->probe_rtt_done_stamp)) {
+            if (cc->bytes_in_flight <= cc->k_min_wnd)
+                cc->probe_rtt_done_stamp
+                    = ossl_time_add(now, ossl_ms2time(BBR_PROBE_RTT_MS));
+        } else if (cc->probe_rtt_round_done
+            && ossl_time_compare(now, cc->probe_rtt_done_stamp) >= 0) {
+            bbr_exit_probe_rtt(cc, now);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void bbr_update_cwnd(OSSL_CC_BBR *cc, uint64_t acked)
+{
+    uint64_t target = bbr_bdp(cc, cc->cwnd_gain);
+
+    if (target != UINT64_MAX)
+        target += BBR_EXTRA_CWND_DGRAMS * cc->max_dgram_size;
+
+    if (cc->filled_pipe) {
+        cc->cong_wnd += acked;
+        if (cc->cong_wnd > target)
+            cc->cong_wnd = target;
+    } else if ((cc->cong_wnd < target || cc->delivered < cc->k_init_wnd)
+        && cc->round_max_inflight >= cc->cong_wnd / 2) {
+        /* Grow while searching for the bottleneck, if we use the window. */
+        cc->cong_wnd += acked;
+    }
+
+    if (cc->cong_wnd > cc->inflight_hi)
+        cc->cong_wnd = cc->inflight_hi;
+
+    if (cc->cong_wnd < cc->k_min_wnd
+        || (cc->mode == BBR_MODE_PROBE_RTT && cc->cong_wnd > cc->k_min_wnd))
+        cc->cong_wnd = cc->k_min_wnd;
+}
+
+static void bbr_update_pacing_rate(OSSL_CC_BBR *cc)
+{
+    uint64_t rate;
+    int err = 0;
+
+    if (cc->btl_bw == 0)
+        return;
+
+    rate = safe_muldiv_u64(cc->btl_bw, cc->pacing_gain, BBR_UNIT, &err);
+    if (err)
+        return;
+
+    /* Never slow down while still looking for the bottleneck. */
+    if (cc->filled_pipe || rate > cc->pacing_rate)
+        cc->pacing_rate = rate;
+}
+
+static uint64_t bbr_get_tx_allowance(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    if (cc->bytes_in_flight >= cc->cong_wnd)
+        return 0;
+
+    return cc->cong_wnd - cc->bytes_in_flight;
+}
+
+static OSSL_TIME bbr_get_wakeup_deadline(OSSL_CC_DATA *ccdata)
+{
+    if (bbr_get_tx_allowance(ccdata) > 0)
+        return ossl_time_zero();
+
+    /* Pacing is left to the caller, so we only change state on stimulus. */
+    return ossl_time_infinite();
+}
+
+static int bbr_on_data_sent(OSSL_CC_DATA *ccdata, uint64_t num_bytes)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    cc->bytes_in_flight += num_bytes;
+    if (cc->bytes_in_flight > cc->round_max_inflight)
+        cc->round_max_inflight = cc->bytes_in_flight;
+
+    bbr_update_diag(cc);
+    return 1;
+}
+
+static int bbr_on_data_acked(OSSL_CC_DATA *ccdata,
+    const OSSL_CC_ACK_INFO *info)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+    OSSL_TIME now = cc->now_cb(cc->now_cb_arg);
+
+    cc->bytes_in_flight -= info->tx_size;
+    cc->delivered += info->tx_size;
+
+    bbr_update_min_rtt(cc, now, info->tx_time);
+
+    if (ossl_time_compare(info->tx_time, cc->round_start) >= 0)
+        bbr_on_round_end(cc, now);
+
+    bbr_update_mode(cc, now);
+    bbr_update_cwnd(cc, info->tx_size);
+    bbr_update_pacing_rate(cc);
+    bbr_update_diag(cc);
+    return 1;
+}
+
+static int bbr_on_data_lost(OSSL_CC_DATA *ccdata,
+    const OSSL_CC_LOSS_INFO *info)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    if (info->tx_size > cc->bytes_in_flight)
+        return 0;
+
+    cc->bytes_in_flight -= info->tx_size;
+    cc->round_lost += info->tx_size;
+    cc->processing_loss = 1;
+
+    bbr_update_diag(cc);
+    return 1;
+}
+
+static int bbr_on_data_lost_finished(OSSL_CC_DATA *ccdata, uint32_t flags)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    if (!cc->processing_loss)
+        return 1;
+
+    bbr_check_loss(cc);
+
+    /*
+     * Persistent congestion means our model is wrong, so start again from a
+     * minimal window.
+     */
+    if ((flags & OSSL_CC_LOST_FLAG_PERSISTENT_CONGESTION) != 0)
+        cc->cong_wnd = cc->k_min_wnd;
+
+    cc->processing_loss = 0;
+    bbr_update_diag(cc);
+    return 1;
+}
+
+static int bbr_on_data_invalidated(OSSL_CC_DATA *ccdata,
+    uint64_t num_bytes)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    cc->bytes_in_flight -= num_bytes;
+    bbr_update_diag(cc);
+    return 1;
+}
+
+static int bbr_on_ecn(OSSL_CC_DATA *ccdata,
+    const OSSL_CC_ECN_INFO *info)
+{
+    OSSL_CC_BBR *cc = (OSSL_CC_BBR *)ccdata;
+
+    /* Treated like excessive loss. */
+    bbr_on_congestion(cc);
+    bbr_update_diag(cc);
+    return 1;
+}
+
+const OSSL_CC_METHOD ossl_cc_bbr_method = {
+    bbr_new,
+    bbr_free,
+    bbr_reset,
+    bbr_set_input_params,
+    bbr_bind_diagnostic,
+    bbr_unbind_diagnostic,
+    bbr_get_tx_allowance,
+    bbr_get_wakeup_deadline,
+    bbr_on_data_sent,
+    bbr_on_data_acked,
+    bbr_on_data_lost,
+    bbr_on_data_lost_finished,
+    bbr_on_data_invalidated,
+    bbr_on_ecn,
+};
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/ssl.h>
+#include "cc_local.h"
+
+#define MIN_MAX_INIT_WND_SIZE 14720 /* RFC 9002 s. 7.2 */
+
+const OSSL_CC_METHOD *ossl_cc_method_by_algorithm(uint64_t algorithm)
+{
+    switch (algorithm) {
+    case SSL_VALUE_QUIC_CC_ALGORITHM_NEWRENO:
+        return &ossl_cc_newreno_method;
+    case SSL_VALUE_QUIC_CC_ALGORITHM_CUBIC:
+        return &ossl_cc_cubic_method;
+    case SSL_VALUE_QUIC_CC_ALGORITHM_BBR:
+        return &ossl_cc_bbr_method;
+    default:
+        return NULL;
+    }
+}
+
+int ossl_cc_bind_diag(OSSL_PARAM *params, const char *param_name, size_t len,
+    void **pp)
+{
+    const OSSL_PARAM *p = OSSL_PARAM_locate_const(params, param_name);
+
+    *pp = NULL;
+
+    if (p == NULL)
+        return 1;
+
+    if (p->data_type != OSSL_PARAM_UNSIGNED_INTEGER
+        || p->data_size != len)
+        return 0;
+
+    *pp = p->data;
+    return 1;
+}
+
+void ossl_cc_unbind_diag(OSSL_PARAM *params, const char *param_name,
+    void **pp)
+{
+    const OSSL_PARAM *p = OSSL_PARAM_locate_const(params, param_name);
+
+    if (p != NULL)
+        *pp = NULL;
+}
+
+uint64_t ossl_cc_get_init_wnd(size_t max_dgram_size)
+{
+    uint64_t max_init_wnd, init_wnd;
+
+    max_init_wnd = 2 * (uint64_t)max_dgram_size;
+    if (max_init_wnd < MIN_MAX_INIT_WND_SIZE)
+        max_init_wnd = MIN_MAX_INIT_WND_SIZE;
+
+    init_wnd = 10 * (uint64_t)max_dgram_size;
+    if (init_wnd > max_init_wnd)
+        init_wnd = max_init_wnd;
+
+    return init_wnd;
+}
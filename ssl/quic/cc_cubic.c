@@ -0,0 +1,569 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include "internal/quic_cc.h"
+#include "internal/quic_types.h"
+#include "internal/safe_math.h"
+#include "cc_local.h"
+
+OSSL_SAFE_MATH_UNSIGNED(u64, uint64_t)
+
+/*
+ * CUBIC Congestion Control (RFC 9438)
+ * ===================================
+ *
+ * Slow start, recovery periods and the handling of loss events are the same as
+ * for NewReno. In congestion avoidance, the window follows the cubic function
+ *
+ *   W(t) = C * (t - K)^3 + W_max
+ *
+ * where W_max is the window before the last congestion event and K is the time
+ * it takes to grow back to W_max. All arithmetic is done in integers, with
+ * windows in bytes and times in milliseconds.
+ */
+
+/* C = 0.4 segments/s^3, expressed per ms^3. */
+#define CUBIC_C_NUM 4
+#define CUBIC_C_DEN 10000000000ULL
+
+/* Multiplicative decrease factor, beta = 0.7. */
+#define CUBIC_BETA_NUM 7
+#define CUBIC_BETA_DEN 10
+
+/* Additive increase factor for the Reno-friendly region, 3(1-beta)/(1+beta). */
+#define CUBIC_ALPHA_NUM 9
+#define CUBIC_ALPHA_DEN 17
+
+/* Cap on (t - K) to keep the cube within range. */
+#define CUBIC_MAX_DELTA_MS 100000
+
+/* RTT to assume until we have a sample. */
+#define CUBIC_DEFAULT_RTT_MS 100
+
+typedef struct ossl_cc_cubic_st {
+    /* Dependencies. */
+    OSSL_TIME (*now_cb)(void *arg);
+    void *now_cb_arg;
+
+    /* 'Constants'. */
+    uint64_t k_init_wnd, k_min_wnd;
+
+    /* State. */
+    size_t max_dgram_size;
+    uint64_t bytes_in_flight, cong_wnd, slow_start_thresh;
+    OSSL_TIME cong_recovery_start_time;
+
+    /* Cubic state. */
+    uint64_t w_max; /* window before the last reduction */
+    uint64_t w_est; /* Reno-friendly window estimate */
+    uint64_t k_ms; /* time to grow back to w_max */
+    uint64_t est_bytes_acked; /* accumulator for w_est growth */
+    uint64_t cwnd_bytes_acked; /* accumulator for growth past the target */
+    OSSL_TIME epoch_start; /* zero if no epoch in progress */
+    OSSL_TIME min_rtt; /* infinite until we have a sample */
+
+    /* Unflushed state during multiple on-loss calls. */
+    int processing_loss; /* 1 if not flushed */
+    OSSL_TIME tx_time_of_last_loss;
+
+    /* Diagnostic state. */
+    int in_congestion_recovery;
+
+    /* Diagnostic output locations. */
+    size_t *p_diag_max_dgram_payload_len;
+    uint64_t *p_diag_cur_cwnd_size;
+    uint64_t *p_diag_min_cwnd_size;
+    uint64_t *p_diag_cur_bytes_in_flight;
+    uint32_t *p_diag_cur_state;
+} OSSL_CC_CUBIC;
+
+static void cubic_set_max_dgram_size(OSSL_CC_CUBIC *cc, size_t max_dgram_size);
+static void cubic_update_diag(OSSL_CC_CUBIC *cc);
+static void cubic_reset(OSSL_CC_DATA *cc);
+
+static OSSL_CC_DATA *cubic_new(OSSL_TIME (*now_cb)(void *arg),
+    void *now_cb_arg)
+{
+    OSSL_CC_CUBIC *cc;
+
+    if ((cc = OPENSSL_zalloc(sizeof(*cc))) == NULL)
+        return NULL;
+
+    cc->now_cb = now_cb;
+    cc->now_cb_arg = now_cb_arg;
+
+    cubic_set_max_dgram_size(cc, QUIC_MIN_INITIAL_DGRAM_LEN);
+    cubic_reset((OSSL_CC_DATA *)cc);
+
+    return (OSSL_CC_DATA *)cc;
+}
+
+static void cubic_free(OSSL_CC_DATA *cc)
+{
+    OPENSSL_free(cc);
+}
+
+static void cubic_set_max_dgram_size(OSSL_CC_CUBIC *cc, size_t max_dgram_size)
+{
+    int is_reduced = (max_dgram_size < cc->max_dgram_size);
+
+    cc->max_dgram_size = max_dgram_size;
+    cc->k_init_wnd = ossl_cc_get_init_wnd(max_dgram_size);
+    cc->k_min_wnd = 2 * max_dgram_size;
+
+    if (is_reduced)
+        cc->cong_wnd = cc->k_init_wnd;
+
+    cubic_update_diag(cc);
+}
+
+static void cubic_reset(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->cong_wnd = cc->k_init_wnd;
+    cc->bytes_in_flight = 0;
+    cc->slow_start_thresh = UINT64_MAX;
+    cc->cong_recovery_start_time = ossl_time_zero();
+
+    cc->w_max = 0;
+    cc->w_est = 0;
+    cc->k_ms = 0;
+    cc->est_bytes_acked = 0;
+    cc->cwnd_bytes_acked = 0;
+    cc->epoch_start = ossl_time_zero();
+    cc->min_rtt = ossl_time_infinite();
+
+    cc->processing_loss = 0;
+    cc->tx_time_of_last_loss = ossl_time_zero();
+    cc->in_congestion_recovery = 0;
+}
+
+static int cubic_set_input_params(OSSL_CC_DATA *ccdata,
+    const OSSL_PARAM *params)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+    const OSSL_PARAM *p;
+    size_t value;
+
+    p = OSSL_PARAM_locate_const(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN);
+    if (p != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &value))
+            return 0;
+        if (value < QUIC_MIN_INITIAL_DGRAM_LEN)
+            return 0;
+
+        cubic_set_max_dgram_size(cc, value);
+    }
+
+    return 1;
+}
+
+static int cubic_bind_diagnostic(OSSL_CC_DATA *ccdata, OSSL_PARAM *params)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+    size_t *new_p_max_dgram_payload_len;
+    uint64_t *new_p_cur_cwnd_size;
+    uint64_t *new_p_min_cwnd_size;
+    uint64_t *new_p_cur_bytes_in_flight;
+    uint32_t *new_p_cur_state;
+
+    if (!ossl_cc_bind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+            sizeof(size_t), (void **)&new_p_max_dgram_payload_len)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+            sizeof(uint64_t), (void **)&new_p_cur_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+            sizeof(uint64_t), (void **)&new_p_min_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+            sizeof(uint64_t), (void **)&new_p_cur_bytes_in_flight)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+            sizeof(uint32_t), (void **)&new_p_cur_state))
+        return 0;
+
+    if (new_p_max_dgram_payload_len != NULL)
+        cc->p_diag_max_dgram_payload_len = new_p_max_dgram_payload_len;
+
+    if (new_p_cur_cwnd_size != NULL)
+        cc->p_diag_cur_cwnd_size = new_p_cur_cwnd_size;
+
+    if (new_p_min_cwnd_size != NULL)
+        cc->p_diag_min_cwnd_size = new_p_min_cwnd_size;
+
+    if (new_p_cur_bytes_in_flight != NULL)
+        cc->p_diag_cur_bytes_in_flight = new_p_cur_bytes_in_flight;
+
+    if (new_p_cur_state != NULL)
+        cc->p_diag_cur_state = new_p_cur_state;
+
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_unbind_diagnostic(OSSL_CC_DATA *ccdata, OSSL_PARAM *params)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+        (void **)&cc->p_diag_max_dgram_payload_len);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+        (void **)&cc->p_diag_cur_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+        (void **)&cc->p_diag_min_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+        (void **)&cc->p_diag_cur_bytes_in_flight);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+        (void **)&cc->p_diag_cur_state);
+    return 1;
+}
+
+static void cubic_update_diag(OSSL_CC_CUBIC *cc)
+{
+    if (cc->p_diag_max_dgram_payload_len != NULL)
+        *cc->p_diag_max_dgram_payload_len = cc->max_dgram_size;
+
+    if (cc->p_diag_cur_cwnd_size != NULL)
+        *cc->p_diag_cur_cwnd_size = cc->cong_wnd;
+
+    if (cc->p_diag_min_cwnd_size != NULL)
+        *cc->p_diag_min_cwnd_size = cc->k_min_wnd;
+
+    if (cc->p_diag_cur_bytes_in_flight != NULL)
+        *cc->p_diag_cur_bytes_in_flight = cc->bytes_in_flight;
+
+    if (cc->p_diag_cur_state != NULL) {
+        if (cc->in_congestion_recovery)
+            *cc->p_diag_cur_state = 'R';
+        else if (cc->cong_wnd < cc->slow_start_thresh)
+            *cc->p_diag_cur_state = 'S';
+        else
+            *cc->p_diag_cur_state = 'A';
+    }
+}
+
+/* Integer cube root, rounded down. */
+static uint64_t cubic_cbrt(uint64_t x)
+{
+    uint64_t y = 0, b;
+    int s;
+
+    for (s = 63; s >= 0; s -= 3) {
+        y += y;
+        b = 3 * y * (y + 1) + 1;
+        if ((x >> s) >= b) {
+            x -= b << s;
+            ++y;
+        }
+    }
+
+    return y;
+}
+
+static int cubic_in_cong_recovery(OSSL_CC_CUBIC *cc, OSSL_TIME tx_time)
+{
+    return ossl_time_compare(tx_time, cc->cong_recovery_start_time) <= 0;
+}
+
+static void cubic_cong(OSSL_CC_CUBIC *cc, OSSL_TIME tx_time)
+{
+    int err = 0;
+
+    /* No reaction if already in a recovery period. */
+    if (cubic_in_cong_recovery(cc, tx_time))
+        return;
+
+    /* Start a new recovery period. */
+    cc->in_congestion_recovery = 1;
+    cc->cong_recovery_start_time = cc->now_cb(cc->now_cb_arg);
+
+    /*
+     * Fast convergence (RFC 9438 s. 4.7): if we are reducing before getting
+     * back to the previous W_max, release bandwidth for other flows.
+     */
+    if (cc->cong_wnd < cc->w_max)
+        cc->w_max = safe_muldiv_u64(cc->cong_wnd,
+            CUBIC_BETA_DEN + CUBIC_BETA_NUM,
+            2 * CUBIC_BETA_DEN, &err);
+    else
+        cc->w_max = cc->cong_wnd;
+
+    cc->slow_start_thresh = safe_muldiv_u64(cc->cong_wnd, CUBIC_BETA_NUM,
+        CUBIC_BETA_DEN, &err);
+    if (err)
+        cc->slow_start_thresh = UINT64_MAX;
+
+    cc->cong_wnd = cc->slow_start_thresh;
+    if (cc->cong_wnd < cc->k_min_wnd)
+        cc->cong_wnd = cc->k_min_wnd;
+
+    /* The next acknowledgement in congestion avoidance starts a new epoch. */
+    cc->epoch_start = ossl_time_zero();
+}
+
+static void cubic_flush(OSSL_CC_CUBIC *cc, uint32_t flags)
+{
+    if (!cc->processing_loss)
+        return;
+
+    cubic_cong(cc, cc->tx_time_of_last_loss);
+
+    if ((flags & OSSL_CC_LOST_FLAG_PERSISTENT_CONGESTION) != 0) {
+        cc->cong_wnd = cc->k_min_wnd;
+        cc->cong_recovery_start_time = ossl_time_zero();
+        cc->w_max = 0;
+        cc->epoch_start = ossl_time_zero();
+    }
+
+    cc->processing_loss = 0;
+    cubic_update_diag(cc);
+}
+
+static uint64_t cubic_get_tx_allowance(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    if (cc->bytes_in_flight >= cc->cong_wnd)
+        return 0;
+
+    return cc->cong_wnd - cc->bytes_in_flight;
+}
+
+static OSSL_TIME cubic_get_wakeup_deadline(OSSL_CC_DATA *ccdata)
+{
+    if (cubic_get_tx_allowance(ccdata) > 0)
+        return ossl_time_zero();
+
+    /* Like NewReno, we only change state in response to stimulus. */
+    return ossl_time_infinite();
+}
+
+static int cubic_on_data_sent(OSSL_CC_DATA *ccdata, uint64_t num_bytes)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->bytes_in_flight += num_bytes;
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_is_cong_limited(OSSL_CC_CUBIC *cc)
+{
+    uint64_t wnd_rem;
+
+    if (cc->bytes_in_flight >= cc->cong_wnd)
+        return 1;
+
+    wnd_rem = cc->cong_wnd - cc->bytes_in_flight;
+
+    /* Same criteria as for NewReno. */
+    return (cc->cong_wnd < cc->slow_start_thresh && wnd_rem <= cc->cong_wnd / 2)
+        || wnd_rem <= 3 * cc->max_dgram_size;
+}
+
+/* Starts a new congestion avoidance epoch at time now. */
+static void cubic_start_epoch(OSSL_CC_CUBIC *cc, OSSL_TIME now)
+{
+    int err = 0;
+    uint64_t v;
+
+    cc->epoch_start = now;
+    cc->est_bytes_acked = 0;
+    cc->cwnd_bytes_acked = 0;
+    cc->w_est = cc->cong_wnd;
+
+    if (cc->cong_wnd >= cc->w_max) {
+        cc->w_max = cc->cong_wnd;
+        cc->k_ms = 0;
+        return;
+    }
+
+    /* K = cbrt((W_max - cwnd) / C), converted to bytes and ms. */
+    v = safe_muldiv_u64(cc->w_max - cc->cong_wnd, CUBIC_C_DEN,
+        CUBIC_C_NUM * (uint64_t)cc->max_dgram_size, &err);
+    cc->k_ms = err ? CUBIC_MAX_DELTA_MS : cubic_cbrt(v);
+}
+
+/* Returns W_cubic(t) in bytes, where t is in ms since the epoch start. */
+static uint64_t cubic_window(OSSL_CC_CUBIC *cc, uint64_t t_ms)
+{
+    int err = 0, neg = (t_ms < cc->k_ms);
+    uint64_t d, delta;
+
+    d = neg ? cc->k_ms - t_ms : t_ms - cc->k_ms;
+    if (d > CUBIC_MAX_DELTA_MS)
+        d = CUBIC_MAX_DELTA_MS;
+
+    delta = safe_muldiv_u64(d * d * d,
+        CUBIC_C_NUM * (uint64_t)cc->max_dgram_size,
+        CUBIC_C_DEN, &err);
+    if (err)
+        delta = UINT64_MAX / 2;
+
+    if (neg)
+        return delta >= cc->w_max ? 0 : cc->w_max - delta;
+
+    return cc->w_max > UINT64_MAX / 2 - delta ? UINT64_MAX / 2
+                                              : cc->w_max + delta;
+}
+
+static void cubic_on_ack_ca(OSSL_CC_CUBIC *cc, uint64_t acked)
+{
+    OSSL_TIME now = cc->now_cb(cc->now_cb_arg);
+    uint64_t t_ms, rtt_ms, target, max_target, inc;
+    int err = 0;
+
+    if (ossl_time_is_zero(cc->epoch_start))
+        cubic_start_epoch(cc, now);
+
+    rtt_ms = ossl_time_is_infinite(cc->min_rtt)
+        ? CUBIC_DEFAULT_RTT_MS
+        : ossl_time2ms(cc->min_rtt);
+
+    /* Target the window we should have one RTT from now. */
+    t_ms = ossl_time2ms(ossl_time_subtract(now, cc->epoch_start)) + rtt_ms;
+    target = cubic_window(cc, t_ms);
+
+    /* Limit growth to 1.5 * cwnd per RTT (RFC 9438 s. 4.2). */
+    max_target = cc->cong_wnd + cc->cong_wnd / 2;
+    if (target > max_target)
+        target = max_target;
+
+    if (target > cc->cong_wnd) {
+        inc = safe_muldiv_u64(target - cc->cong_wnd, acked, cc->cong_wnd, &err);
+        cc->cong_wnd += err ? target - cc->cong_wnd : inc;
+    } else {
+        /* Keep probing slowly: one datagram per 100 windows acknowledged. */
+        cc->cwnd_bytes_acked += acked;
+        if (cc->cwnd_bytes_acked >= 100 * cc->cong_wnd) {
+            cc->cwnd_bytes_acked = 0;
+            cc->cong_wnd += cc->max_dgram_size;
+        }
+    }
+
+    /*
+     * Reno-friendly region (RFC 9438 s. 4.3): grow w_est as Reno would with
+     * the CUBIC alpha (or 1 once past the previous W_max) and never do worse
+     * than it.
+     */
+    cc->est_bytes_acked += acked;
+    if (cc->est_bytes_acked >= cc->w_est) {
+        cc->est_bytes_acked -= cc->w_est;
+        cc->w_est += cc->w_est < cc->w_max
+            ? cc->max_dgram_size * CUBIC_ALPHA_NUM / CUBIC_ALPHA_DEN
+            : cc->max_dgram_size;
+    }
+
+    if (cc->w_est > cc->cong_wnd)
+        cc->cong_wnd = cc->w_est;
+}
+
+static int cubic_on_data_acked(OSSL_CC_DATA *ccdata,
+    const OSSL_CC_ACK_INFO *info)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+    OSSL_TIME now = cc->now_cb(cc->now_cb_arg), rtt;
+
+    cc->bytes_in_flight -= info->tx_size;
+
+    /* Track the minimum RTT, which is used as the lookahead for the target. */
+    if (ossl_time_compare(now, info->tx_time) > 0) {
+        rtt = ossl_time_subtract(now, info->tx_time);
+        if (ossl_time_compare(rtt, cc->min_rtt) < 0)
+            cc->min_rtt = rtt;
+    }
+
+    if (!cubic_is_cong_limited(cc))
+        goto out;
+
+    if (cubic_in_cong_recovery(cc, info->tx_time)) {
+        /* Congestion recovery, do nothing. */
+    } else if (cc->cong_wnd < cc->slow_start_thresh) {
+        /* Slow start. */
+        cc->cong_wnd += info->tx_size;
+        cc->in_congestion_recovery = 0;
+    } else {
+        cubic_on_ack_ca(cc, info->tx_size);
+        cc->in_congestion_recovery = 0;
+    }
+
+out:
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_on_data_lost(OSSL_CC_DATA *ccdata,
+    const OSSL_CC_LOSS_INFO *info)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    if (info->tx_size > cc->bytes_in_flight)
+        return 0;
+
+    cc->bytes_in_flight -= info->tx_size;
+
+    if (!cc->processing_loss) {
+        if (ossl_time_compare(info->tx_time, cc->tx_time_of_last_loss) <= 0)
+            /* See newreno_on_data_lost(). */
+            goto out;
+
+        cc->processing_loss = 1;
+    }
+
+    cc->tx_time_of_last_loss
+        = ossl_time_max(cc->tx_time_of_last_loss, info->tx_time);
+
+out:
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_on_data_lost_finished(OSSL_CC_DATA *ccdata, uint32_t flags)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cubic_flush(cc, flags);
+    return 1;
+}
+
+static int cubic_on_data_invalidated(OSSL_CC_DATA *ccdata,
+    uint64_t num_bytes)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->bytes_in_flight -= num_bytes;
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_on_ecn(OSSL_CC_DATA *ccdata,
+    const OSSL_CC_ECN_INFO *info)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->processing_loss = 1;
+    cc->tx_time_of_last_loss = info->largest_acked_time;
+    cubic_flush(cc, 0);
+    return 1;
+}
+
+const OSSL_CC_METHOD ossl_cc_cubic_method = {
+    cubic_new,
+    cubic_free,
+    cubic_reset,
+    cubic_set_input_params,
+    cubic_bind_diagnostic,
+    cubic_unbind_diagnostic,
+    cubic_get_tx_allowance,
+    cubic_get_wakeup_deadline,
+    cubic_on_data_sent,
+    cubic_on_data_acked,
+    cubic_on_data_lost,
+    cubic_on_data_lost_finished,
+    cubic_on_data_invalidated,
+    cubic_on_ecn,
+};
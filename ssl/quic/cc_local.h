@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_CC_LOCAL_H
+#define OSSL_CC_LOCAL_H
+
+#include "internal/quic_cc.h"
+
+/*
+ * Utilities shared by congestion controller implementations.
+ */
+
+/*
+ * Finds the parameter param_name in params and, if it is present, checks that
+ * it is an unsigned integer of len bytes and sets *pp to its storage location.
+ * *pp is set to NULL if the parameter is not present. Returns 1 on success or
+ * 0 if the parameter has the wrong type.
+ */
+int ossl_cc_bind_diag(OSSL_PARAM *params, const char *param_name, size_t len,
+    void **pp);
+
+/* Sets *pp to NULL if the parameter param_name is present in params. */
+void ossl_cc_unbind_diag(OSSL_PARAM *params, const char *param_name,
+    void **pp);
+
+/*
+ * Returns the initial congestion window for a given maximum datagram size, as
+ * per RFC 9002 s. 7.2.
+ */
+uint64_t ossl_cc_get_init_wnd(size_t max_dgram_size);
+
+#endif
@@ -1,6 +1,7 @@
 #include "internal/quic_cc.h"
 #include "internal/quic_types.h"
 #include "internal/safe_math.h"
+#include "cc_local.h"
 
 OSSL_SAFE_MATH_UNSIGNED(u64, uint64_t)
 
@@ -34,8 +35,6 @@ typedef struct ossl_cc_newreno_st {
     uint32_t *p_diag_cur_state;
 } OSSL_CC_NEWRENO;
 
-#define MIN_MAX_INIT_WND_SIZE 14720 /* RFC 9002 s. 7.2 */
-
 /* TODO(QUIC FUTURE): Pacing support. */
 
 static void newreno_set_max_dgram_size(OSSL_CC_NEWRENO *nr,
@@ -69,19 +68,10 @@ static void newreno_free(OSSL_CC_DATA *cc)
 static void newreno_set_max_dgram_size(OSSL_CC_NEWRENO *nr,
     size_t max_dgram_size)
 {
-    size_t max_init_wnd;
     int is_reduced = (max_dgram_size < nr->max_dgram_size);
 
     nr->max_dgram_size = max_dgram_size;
-
-    max_init_wnd = 2 * max_dgram_size;
-    if (max_init_wnd < MIN_MAX_INIT_WND_SIZE)
-        max_init_wnd = MIN_MAX_INIT_WND_SIZE;
-
-    nr->k_init_wnd = 10 * max_dgram_size;
-    if (nr->k_init_wnd > max_init_wnd)
-        nr->k_init_wnd = max_init_wnd;
-
+    nr->k_init_wnd = ossl_cc_get_init_wnd(max_dgram_size);
     nr->k_min_wnd = 2 * max_dgram_size;
 
     if (is_reduced)
@@ -128,24 +118,6 @@ static int newreno_set_input_params(OSSL_CC_DATA *cc, const OSSL_PARAM *params)
     return 1;
 }
 
-static int bind_diag(OSSL_PARAM *params, const char *param_name, size_t len,
-    void **pp)
-{
-    const OSSL_PARAM *p = OSSL_PARAM_locate_const(params, param_name);
-
-    *pp = NULL;
-
-    if (p == NULL)
-        return 1;
-
-    if (p->data_type != OSSL_PARAM_UNSIGNED_INTEGER
-        || p->data_size != len)
-        return 0;
-
-    *pp = p->data;
-    return 1;
-}
-
 static int newreno_bind_diagnostic(OSSL_CC_DATA *cc, OSSL_PARAM *params)
 {
     OSSL_CC_NEWRENO *nr = (OSSL_CC_NEWRENO *)cc;
@@ -155,15 +127,15 @@ static int newreno_bind_diagnostic(OSSL_CC_DATA *cc, OSSL_PARAM *params)
     uint64_t *new_p_cur_bytes_in_flight;
     uint32_t *new_p_cur_state;
 
-    if (!bind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+    if (!ossl_cc_bind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
             sizeof(size_t), (void **)&new_p_max_dgram_payload_len)
-        || !bind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
             sizeof(uint64_t), (void **)&new_p_cur_cwnd_size)
-        || !bind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
             sizeof(uint64_t), (void **)&new_p_min_cwnd_size)
-        || !bind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
             sizeof(uint64_t), (void **)&new_p_cur_bytes_in_flight)
-        || !bind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_STATE,
             sizeof(uint32_t), (void **)&new_p_cur_state))
         return 0;
 
@@ -186,28 +158,19 @@ static int newreno_bind_diagnostic(OSSL_CC_DATA *cc, OSSL_PARAM *params)
     return 1;
 }
 
-static void unbind_diag(OSSL_PARAM *params, const char *param_name,
-    void **pp)
-{
-    const OSSL_PARAM *p = OSSL_PARAM_locate_const(params, param_name);
-
-    if (p != NULL)
-        *pp = NULL;
-}
-
 static int newreno_unbind_diagnostic(OSSL_CC_DATA *cc, OSSL_PARAM *params)
 {
     OSSL_CC_NEWRENO *nr = (OSSL_CC_NEWRENO *)cc;
 
-    unbind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
         (void **)&nr->p_diag_max_dgram_payload_len);
-    unbind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
         (void **)&nr->p_diag_cur_cwnd_size);
-    unbind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
         (void **)&nr->p_diag_min_cwnd_size);
-    unbind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
         (void **)&nr->p_diag_cur_bytes_in_flight);
-    unbind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_STATE,
         (void **)&nr->p_diag_cur_state);
     return 1;
 }
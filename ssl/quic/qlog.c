@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -10,6 +10,8 @@
 #include <stdbool.h>
 #include "internal/qlog.h"
 #include "internal/json_enc.h"
+#include "internal/qlog_bin.h"
+#include "internal/packet_quic.h"
 #include "internal/common.h"
 #include "internal/cryptlib.h"
 #include "crypto/ctype.h"
@@ -42,6 +44,11 @@ struct qlog_st {
     OSSL_TIME event_time, prev_event_time;
     OSSL_JSON_ENC json;
     int header_done, first_event_done;
+
+    /* Binary output, used instead of json if binary is set. */
+    int binary;
+    OSSL_QLOG_BIN bin;
+    size_t bin_defined[NUM_ENABLED_W]; /* event types named in output */
 };
 
 static OSSL_TIME default_now(void *arg)
@@ -65,6 +72,8 @@ QLOG *ossl_qlog_new(const QLOG_TRACE_INFO *info)
     qlog->info.now_cb = info->now_cb;
     qlog->info.now_cb_arg = info->now_cb_arg;
     qlog->info.override_process_id = info->override_process_id;
+    qlog->info.get_writer_cb = info->get_writer_cb;
+    qlog->info.get_writer_cb_arg = info->get_writer_cb_arg;
 
     if (info->title != NULL
         && (qlog->info.title = OPENSSL_strdup(info->title)) == NULL)
@@ -109,6 +118,9 @@ QLOG *ossl_qlog_new_from_env(const QLOG_TRACE_INFO *info)
     QLOG *qlog = NULL;
     const char *qlogdir = ossl_safe_getenv("QLOGDIR");
     const char *qfilter = ossl_safe_getenv("OSSL_QFILTER");
+    const char *qformat = ossl_safe_getenv("OSSL_QLOG_FORMAT");
+    const char *ext = "sqlog";
+    int format = QLOG_FORMAT_JSON_SEQ;
     char qlogdir_sep, *filename = NULL;
     size_t i, l, strl;
 
@@ -119,6 +131,11 @@ QLOG *ossl_qlog_new_from_env(const QLOG_TRACE_INFO *info)
     if (l == 0)
         return NULL;
 
+    if (qformat != NULL && OPENSSL_strcasecmp(qformat, "binary") == 0) {
+        format = QLOG_FORMAT_BINARY;
+        ext = "bqlog";
+    }
+
     qlogdir_sep = ossl_determine_dirsep(qlogdir);
 
     /* dir; [sep]; ODCID; _; strlen("client" / "server"); strlen(".sqlog"); NUL */
@@ -134,13 +151,16 @@ QLOG *ossl_qlog_new_from_env(const QLOG_TRACE_INFO *info)
     for (i = 0; i < info->odcid.id_len; ++i)
         l += BIO_snprintf(filename + l, strl - l, "%02x", info->odcid.id[i]);
 
-    l += BIO_snprintf(filename + l, strl - l, "_%s.sqlog",
-        info->is_server ? "server" : "client");
+    l += BIO_snprintf(filename + l, strl - l, "_%s.%s",
+        info->is_server ? "server" : "client", ext);
 
     qlog = ossl_qlog_new(info);
     if (qlog == NULL)
         goto err;
 
+    if (!ossl_qlog_set_format(qlog, format))
+        goto err;
+
     if (!ossl_qlog_set_sink_filename(qlog, filename))
         goto err;
 
@@ -165,6 +185,8 @@ void ossl_qlog_free(QLOG *qlog)
         return;
 
     ossl_json_flush_cleanup(&qlog->json);
+    if (qlog->binary)
+        ossl_qlog_bin_cleanup(&qlog->bin);
     BIO_free_all(qlog->bio);
     OPENSSL_free((char *)qlog->info.title);
     OPENSSL_free((char *)qlog->info.description);
@@ -177,12 +199,48 @@ void ossl_qlog_free(QLOG *qlog)
  * Configuration
  * =============
  */
+int ossl_qlog_set_format(QLOG *qlog, int format)
+{
+    QLOG_WRITER *writer = NULL;
+
+    if (qlog == NULL || qlog->header_done)
+        return 0;
+
+    switch (format) {
+    case QLOG_FORMAT_JSON_SEQ:
+        if (qlog->binary) {
+            ossl_qlog_bin_cleanup(&qlog->bin);
+            qlog->binary = 0;
+        }
+        return 1;
+
+    case QLOG_FORMAT_BINARY:
+        if (qlog->binary)
+            return 1;
+
+        if (qlog->info.get_writer_cb != NULL)
+            writer = qlog->info.get_writer_cb(qlog->info.get_writer_cb_arg);
+
+        if (!ossl_qlog_bin_init(&qlog->bin, writer))
+            return 0;
+
+        ossl_qlog_bin_set0_sink(&qlog->bin, qlog->bio);
+        qlog->binary = 1;
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
 int ossl_qlog_set_sink_bio(QLOG *qlog, BIO *bio)
 {
     if (qlog == NULL)
         return 0;
 
     ossl_qlog_flush(qlog); /* best effort */
+    if (qlog->binary)
+        ossl_qlog_bin_set0_sink(&qlog->bin, bio);
     BIO_free_all(qlog->bio);
     qlog->bio = bio;
     ossl_json_set0_sink(&qlog->json, bio);
@@ -240,6 +298,9 @@ int ossl_qlog_flush(QLOG *qlog)
     if (qlog == NULL)
         return 1;
 
+    if (qlog->binary)
+        return ossl_qlog_bin_flush(&qlog->bin);
+
     return ossl_json_flush(&qlog->json);
 }
 
@@ -277,6 +338,32 @@ static void write_str_once(QLOG *qlog, const char *key, char **p)
     *p = NULL;
 }
 
+/* Returns the process ID to report, or 0 if there is none. */
+static uint64_t qlog_process_id(QLOG *qlog)
+{
+    if (qlog->info.override_process_id != 0)
+        return qlog->info.override_process_id;
+
+#if defined(OPENSSL_SYS_UNIX)
+    return (uint64_t)getpid();
+#elif defined(OPENSSL_SYS_WINDOWS)
+    return (uint64_t)GetCurrentProcessId();
+#else
+    return 0;
+#endif
+}
+
+static const char *qlog_impl_name(QLOG *qlog, char *buf, size_t buf_len)
+{
+    if (qlog->info.override_impl_name != NULL)
+        return qlog->info.override_impl_name;
+
+    BIO_snprintf(buf, buf_len, "OpenSSL/%s (%s)",
+        OpenSSL_version(OPENSSL_FULL_VERSION_STRING),
+        OpenSSL_version(OPENSSL_PLATFORM) + 10);
+    return buf;
+}
+
 static void qlog_event_seq_header(QLOG *qlog)
 {
     if (qlog->header_done)
@@ -314,17 +401,11 @@ static void qlog_event_seq_header(QLOG *qlog)
                 ossl_json_key(&qlog->json, "system_info");
                 ossl_json_object_begin(&qlog->json);
                 {
-                    if (qlog->info.override_process_id != 0) {
-                        ossl_json_key(&qlog->json, "process_id");
-                        ossl_json_u64(&qlog->json, qlog->info.override_process_id);
-                    } else {
-#if defined(OPENSSL_SYS_UNIX)
-                        ossl_json_key(&qlog->json, "process_id");
-                        ossl_json_u64(&qlog->json, (uint64_t)getpid());
-#elif defined(OPENSSL_SYS_WINDOWS)
+                    uint64_t process_id = qlog_process_id(qlog);
+
+                    if (process_id != 0) {
                         ossl_json_key(&qlog->json, "process_id");
-                        ossl_json_u64(&qlog->json, (uint64_t)GetCurrentProcessId());
-#endif
+                        ossl_json_u64(&qlog->json, process_id);
                     }
                 } /* system_info */
                 ossl_json_object_end(&qlog->json);
@@ -335,15 +416,7 @@ static void qlog_event_seq_header(QLOG *qlog)
             ossl_json_object_begin(&qlog->json);
             {
                 char buf[128];
-                const char *p = buf;
-
-                if (qlog->info.override_impl_name != NULL) {
-                    p = qlog->info.override_impl_name;
-                } else {
-                    BIO_snprintf(buf, sizeof(buf), "OpenSSL/%s (%s)",
-                        OpenSSL_version(OPENSSL_FULL_VERSION_STRING),
-                        OpenSSL_version(OPENSSL_PLATFORM) + 10);
-                }
+                const char *p = qlog_impl_name(qlog, buf, sizeof(buf));
 
                 ossl_json_key(&qlog->json, "type");
                 ossl_json_str(&qlog->json,
@@ -394,6 +467,78 @@ static void qlog_event_epilogue(QLOG *qlog)
     ossl_json_object_end(&qlog->json);
 }
 
+static void qlog_bin_opt_str(OSSL_QLOG_BIN *b, const char *s)
+{
+    size_t l;
+
+    if (s == NULL) {
+        ossl_qlog_bin_vlint(b, 0);
+        return;
+    }
+
+    l = strlen(s);
+    ossl_qlog_bin_vlint(b, l + 1);
+    ossl_qlog_bin_bytes(b, s, l);
+}
+
+static void qlog_bin_header(QLOG *qlog)
+{
+    OSSL_QLOG_BIN *b = &qlog->bin;
+    char buf[128];
+    const char *impl_name;
+
+    if (qlog->header_done)
+        return;
+
+    impl_name = qlog_impl_name(qlog, buf, sizeof(buf));
+
+    ossl_qlog_bin_record_begin(b, QLOG_BIN_REC_HEADER);
+    ossl_qlog_bin_u8(b, qlog->info.is_server != 0);
+    ossl_qlog_bin_u64(b, qlog_process_id(qlog));
+    ossl_qlog_bin_str(b, qlog->info.odcid.id, qlog->info.odcid.id_len);
+    qlog_bin_opt_str(b, qlog->info.title);
+    qlog_bin_opt_str(b, qlog->info.description);
+    qlog_bin_opt_str(b, qlog->info.group_id);
+    ossl_qlog_bin_str(b, impl_name, strlen(impl_name));
+    ossl_qlog_bin_record_end(b);
+
+    /* As for JSON output, these are only needed once. */
+    OPENSSL_free((char *)qlog->info.title);
+    OPENSSL_free((char *)qlog->info.description);
+    OPENSSL_free((char *)qlog->info.group_id);
+    qlog->info.title = qlog->info.description = qlog->info.group_id = NULL;
+    qlog->header_done = 1;
+}
+
+static void qlog_bin_event_prologue(QLOG *qlog)
+{
+    OSSL_QLOG_BIN *b = &qlog->bin;
+
+    qlog_bin_header(qlog);
+
+    if (!bit_get(qlog->bin_defined, qlog->event_type)) {
+        ossl_qlog_bin_record_begin(b, QLOG_BIN_REC_EVENT_DEF);
+        ossl_qlog_bin_vlint(b, qlog->event_type);
+        ossl_qlog_bin_bytes(b, qlog->event_combined_name,
+            strlen(qlog->event_combined_name));
+        if (ossl_qlog_bin_record_end(b))
+            bit_set(qlog->bin_defined, qlog->event_type, 1);
+    }
+
+    ossl_qlog_bin_record_begin(b, QLOG_BIN_REC_EVENT);
+    ossl_qlog_bin_u64(b, 0); /* time, filled in by the epilogue */
+    ossl_qlog_bin_vlint(b, qlog->event_type);
+}
+
+static void qlog_bin_event_epilogue(QLOG *qlog)
+{
+    OSSL_QLOG_BIN *b = &qlog->bin;
+
+    /* The event time may have been overridden since the prologue. */
+    ossl_qlog_bin_patch_u64(b, 0, ossl_time2ticks(qlog->event_time));
+    ossl_qlog_bin_record_end(b);
+}
+
 int ossl_qlog_event_try_begin(QLOG *qlog,
     uint32_t event_type,
     const char *event_cat,
@@ -413,7 +558,10 @@ int ossl_qlog_event_try_begin(QLOG *qlog,
     qlog->event_combined_name = event_combined_name;
     qlog->event_time = qlog->info.now_cb(qlog->info.now_cb_arg);
 
-    qlog_event_prologue(qlog);
+    if (qlog->binary)
+        qlog_bin_event_prologue(qlog);
+    else
+        qlog_event_prologue(qlog);
     return 1;
 }
 
@@ -422,7 +570,10 @@ void ossl_qlog_event_end(QLOG *qlog)
     if (!ossl_assert(qlog != NULL && qlog->event_type != QLOG_EVENT_TYPE_NONE))
         return;
 
-    qlog_event_epilogue(qlog);
+    if (qlog->binary)
+        qlog_bin_event_epilogue(qlog);
+    else
+        qlog_event_epilogue(qlog);
     qlog->event_type = QLOG_EVENT_TYPE_NONE;
 }
 
@@ -432,6 +583,11 @@ void ossl_qlog_event_end(QLOG *qlog)
  */
 void ossl_qlog_group_begin(QLOG *qlog, const char *name)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_OBJ_BEGIN, name);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -440,11 +596,21 @@ void ossl_qlog_group_begin(QLOG *qlog, const char *name)
 
 void ossl_qlog_group_end(QLOG *qlog)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_OBJ_END, NULL);
+        return;
+    }
+
     ossl_json_object_end(&qlog->json);
 }
 
 void ossl_qlog_array_begin(QLOG *qlog, const char *name)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_ARR_BEGIN, name);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -453,6 +619,11 @@ void ossl_qlog_array_begin(QLOG *qlog, const char *name)
 
 void ossl_qlog_array_end(QLOG *qlog)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_ARR_END, NULL);
+        return;
+    }
+
     ossl_json_array_end(&qlog->json);
 }
 
@@ -463,6 +634,12 @@ void ossl_qlog_override_time(QLOG *qlog, OSSL_TIME event_time)
 
 void ossl_qlog_str(QLOG *qlog, const char *name, const char *value)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_STR, name);
+        ossl_qlog_bin_str(&qlog->bin, value, value != NULL ? strlen(value) : 0);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -472,6 +649,12 @@ void ossl_qlog_str(QLOG *qlog, const char *name, const char *value)
 void ossl_qlog_str_len(QLOG *qlog, const char *name,
     const char *value, size_t value_len)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_STR, name);
+        ossl_qlog_bin_str(&qlog->bin, value, value_len);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -480,6 +663,12 @@ void ossl_qlog_str_len(QLOG *qlog, const char *name,
 
 void ossl_qlog_u64(QLOG *qlog, const char *name, uint64_t value)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_U64, name);
+        ossl_qlog_bin_u64(&qlog->bin, value);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -488,6 +677,12 @@ void ossl_qlog_u64(QLOG *qlog, const char *name, uint64_t value)
 
 void ossl_qlog_i64(QLOG *qlog, const char *name, int64_t value)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_I64, name);
+        ossl_qlog_bin_u64(&qlog->bin, (uint64_t)value);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -496,6 +691,12 @@ void ossl_qlog_i64(QLOG *qlog, const char *name, int64_t value)
 
 void ossl_qlog_bool(QLOG *qlog, const char *name, bool value)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin,
+            value ? QLOG_BIN_TOK_TRUE : QLOG_BIN_TOK_FALSE, name);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -505,6 +706,12 @@ void ossl_qlog_bool(QLOG *qlog, const char *name, bool value)
 void ossl_qlog_bin(QLOG *qlog, const char *name,
     const void *value, size_t value_len)
 {
+    if (qlog->binary) {
+        ossl_qlog_bin_token(&qlog->bin, QLOG_BIN_TOK_BIN, name);
+        ossl_qlog_bin_str(&qlog->bin, value, value_len);
+        return;
+    }
+
     if (name != NULL)
         ossl_json_key(&qlog->json, name);
 
@@ -732,3 +939,324 @@ int ossl_qlog_set_filter(QLOG *qlog, const char *filter)
     memcpy(qlog->enabled, enabled, sizeof(enabled));
     return 1;
 }
+
+/*
+ * Binary Conversion
+ * =================
+ *
+ * Binary qlog output is converted to JSON-SEQ by replaying it into a QLOG
+ * instance using JSON-SEQ output, so the result is identical to what would
+ * have been written directly.
+ */
+struct qlog_conv {
+    QLOG *qlog;
+    BIO *out;
+    char **keys, **events;
+    size_t num_keys, keys_alloc, num_events;
+};
+
+/* Upper bound on the event type numbers accepted. */
+#define QLOG_CONV_MAX_EVENTS 1024
+
+static void conv_keys_reset(struct qlog_conv *c)
+{
+    size_t i;
+
+    for (i = 0; i < c->num_keys; ++i)
+        OPENSSL_free(c->keys[i]);
+
+    c->num_keys = 0;
+}
+
+static int conv_opt_str(PACKET *pkt, const char **str)
+{
+    uint64_t len;
+    PACKET s;
+
+    if (!PACKET_get_quic_vlint(pkt, &len))
+        return 0;
+
+    if (len == 0)
+        return 1;
+
+    if (!PACKET_get_sub_packet(pkt, &s, (size_t)len - 1)
+        || !PACKET_strndup(&s, (char **)str))
+        return 0;
+
+    return 1;
+}
+
+static int conv_header(struct qlog_conv *c, PACKET *pkt)
+{
+    QLOG_TRACE_INFO info = { 0 };
+    unsigned int is_server;
+    uint64_t process_id;
+    PACKET odcid, impl_name;
+    int ok = 0;
+
+    if (c->qlog != NULL
+        || !PACKET_get_1(pkt, &is_server)
+        || !PACKET_get_net_8(pkt, &process_id)
+        || !PACKET_get_quic_length_prefixed(pkt, &odcid)
+        || PACKET_remaining(&odcid) > QUIC_MAX_CONN_ID_LEN
+        || !conv_opt_str(pkt, &info.title)
+        || !conv_opt_str(pkt, &info.description)
+        || !conv_opt_str(pkt, &info.group_id)
+        || !PACKET_get_quic_length_prefixed(pkt, &impl_name)
+        || !PACKET_strndup(&impl_name, (char **)&info.override_impl_name))
+        goto err;
+
+    info.is_server = is_server;
+    info.override_process_id = process_id;
+    info.odcid.id_len = (unsigned char)PACKET_remaining(&odcid);
+    memcpy(info.odcid.id, PACKET_data(&odcid), info.odcid.id_len);
+
+    if ((c->qlog = ossl_qlog_new(&info)) == NULL)
+        goto err;
+
+    if (!BIO_up_ref(c->out))
+        goto err;
+
+    if (!ossl_qlog_set_sink_bio(c->qlog, c->out)) {
+        BIO_free(c->out);
+        goto err;
+    }
+
+    ok = 1;
+err:
+    OPENSSL_free((char *)info.title);
+    OPENSSL_free((char *)info.description);
+    OPENSSL_free((char *)info.group_id);
+    OPENSSL_free((char *)info.override_impl_name);
+    return ok;
+}
+
+static int conv_event_def(struct qlog_conv *c, PACKET *pkt)
+{
+    uint64_t event_type;
+    char **events;
+    size_t i;
+
+    if (!PACKET_get_quic_vlint(pkt, &event_type)
+        || event_type >= QLOG_CONV_MAX_EVENTS)
+        return 0;
+
+    if (event_type >= c->num_events) {
+        events = OPENSSL_realloc(c->events,
+            ((size_t)event_type + 1) * sizeof(*events));
+        if (events == NULL)
+            return 0;
+
+        for (i = c->num_events; i <= event_type; ++i)
+            events[i] = NULL;
+
+        c->events = events;
+        c->num_events = (size_t)event_type + 1;
+    }
+
+    OPENSSL_free(c->events[event_type]);
+    c->events[event_type] = NULL;
+    return PACKET_strndup(pkt, &c->events[event_type]);
+}
+
+static int conv_key(struct qlog_conv *c, PACKET *pkt, unsigned int tok,
+    const char **key)
+{
+    uint64_t idx;
+    PACKET name;
+    char **keys;
+
+    *key = NULL;
+
+    if ((tok & QLOG_BIN_TOK_KEY_DEF) != 0) {
+        if (!PACKET_get_quic_length_prefixed(pkt, &name))
+            return 0;
+
+        if (c->num_keys == c->keys_alloc) {
+            keys = OPENSSL_realloc(c->keys,
+                (c->keys_alloc * 2 + 16) * sizeof(*keys));
+            if (keys == NULL)
+                return 0;
+
+            c->keys = keys;
+            c->keys_alloc = c->keys_alloc * 2 + 16;
+        }
+
+        c->keys[c->num_keys] = NULL;
+        if (!PACKET_strndup(&name, &c->keys[c->num_keys]))
+            return 0;
+
+        *key = c->keys[c->num_keys++];
+    } else if ((tok & QLOG_BIN_TOK_KEY_REF) != 0) {
+        if (!PACKET_get_quic_vlint(pkt, &idx) || idx >= c->num_keys)
+            return 0;
+
+        *key = c->keys[idx];
+    }
+
+    return 1;
+}
+
+static int conv_event(struct qlog_conv *c, PACKET *pkt)
+{
+    QLOG *qlog = c->qlog;
+    uint64_t ev_time, event_type, v;
+    unsigned int tok;
+    const char *key;
+    size_t depth = 0;
+    PACKET data;
+
+    if (qlog == NULL
+        || !PACKET_get_net_8(pkt, &ev_time)
+        || !PACKET_get_quic_vlint(pkt, &event_type)
+        || event_type >= c->num_events
+        || c->events[event_type] == NULL)
+        return 0;
+
+    qlog->event_combined_name = c->events[event_type];
+    qlog->event_time = ossl_ticks2time(ev_time);
+    qlog_event_prologue(qlog);
+
+    while (PACKET_remaining(pkt) > 0) {
+        if (!PACKET_get_1(pkt, &tok)
+            || !conv_key(c, pkt, tok, &key))
+            return 0;
+
+        switch (tok & QLOG_BIN_TOK_TYPE_MASK) {
+        case QLOG_BIN_TOK_OBJ_BEGIN:
+            ossl_qlog_group_begin(qlog, key);
+            ++depth;
+            break;
+        case QLOG_BIN_TOK_ARR_BEGIN:
+            ossl_qlog_array_begin(qlog, key);
+            ++depth;
+            break;
+        case QLOG_BIN_TOK_OBJ_END:
+        case QLOG_BIN_TOK_ARR_END:
+            if (depth == 0)
+                return 0;
+
+            if ((tok & QLOG_BIN_TOK_TYPE_MASK) == QLOG_BIN_TOK_OBJ_END)
+                ossl_qlog_group_end(qlog);
+            else
+                ossl_qlog_array_end(qlog);
+            --depth;
+            break;
+        case QLOG_BIN_TOK_STR:
+        case QLOG_BIN_TOK_BIN:
+            if (!PACKET_get_quic_length_prefixed(pkt, &data))
+                return 0;
+
+            if ((tok & QLOG_BIN_TOK_TYPE_MASK) == QLOG_BIN_TOK_STR)
+                ossl_qlog_str_len(qlog, key, (const char *)PACKET_data(&data),
+                    PACKET_remaining(&data));
+            else
+                ossl_qlog_bin(qlog, key, PACKET_data(&data),
+                    PACKET_remaining(&data));
+            break;
+        case QLOG_BIN_TOK_U64:
+        case QLOG_BIN_TOK_I64:
+            if (!PACKET_get_net_8(pkt, &v))
+                return 0;
+
+            if ((tok & QLOG_BIN_TOK_TYPE_MASK) == QLOG_BIN_TOK_U64)
+                ossl_qlog_u64(qlog, key, v);
+            else
+                ossl_qlog_i64(qlog, key, (int64_t)v);
+            break;
+        case QLOG_BIN_TOK_FALSE:
+        case QLOG_BIN_TOK_TRUE:
+            ossl_qlog_bool(qlog, key,
+                (tok & QLOG_BIN_TOK_TYPE_MASK) == QLOG_BIN_TOK_TRUE);
+            break;
+        default:
+            return 0;
+        }
+    }
+
+    if (depth != 0)
+        return 0;
+
+    qlog_event_epilogue(qlog);
+    return !ossl_json_in_error(&qlog->json);
+}
+
+/* Returns 1 on success, 0 at the end of input and -1 on error. */
+static int conv_read(BIO *in, unsigned char *buf, size_t len)
+{
+    size_t done = 0, n;
+
+    if (len == 0)
+        return 1;
+
+    while (done < len) {
+        if (!BIO_read_ex(in, buf + done, len - done, &n))
+            return done == 0 ? 0 : -1;
+
+        done += n;
+    }
+
+    return 1;
+}
+
+int ossl_qlog_bin_to_json(BIO *in, BIO *out)
+{
+    struct qlog_conv c = { 0 };
+    unsigned char hdr[QLOG_BIN_REC_HDR_LEN], *rec = NULL;
+    unsigned long rec_len;
+    size_t i;
+    PACKET pkt;
+    int r, ok = 0;
+
+    c.out = out;
+
+    if (conv_read(in, hdr, QLOG_BIN_MAGIC_LEN) != 1
+        || memcmp(hdr, QLOG_BIN_MAGIC, QLOG_BIN_MAGIC_LEN) != 0)
+        goto err;
+
+    /* No record can be larger than the ring it was constructed in. */
+    if ((rec = OPENSSL_malloc(QLOG_BIN_RING_SIZE)) == NULL)
+        goto err;
+
+    while ((r = conv_read(in, hdr, sizeof(hdr))) == 1) {
+        if (!PACKET_buf_init(&pkt, hdr, sizeof(hdr))
+            || !PACKET_get_net_4(&pkt, &rec_len)
+            || rec_len < 1
+            || rec_len > QLOG_BIN_RING_SIZE - QLOG_BIN_REC_HDR_LEN + 1
+            || conv_read(in, rec, rec_len - 1) != 1
+            || !PACKET_buf_init(&pkt, rec, rec_len - 1))
+            goto err;
+
+        switch (hdr[4]) {
+        case QLOG_BIN_REC_HEADER:
+            if (!conv_header(&c, &pkt))
+                goto err;
+            break;
+        case QLOG_BIN_REC_EVENT_DEF:
+            if (!conv_event_def(&c, &pkt))
+                goto err;
+            break;
+        case QLOG_BIN_REC_EVENT:
+            if (!conv_event(&c, &pkt))
+                goto err;
+            break;
+        case QLOG_BIN_REC_KEY_RESET:
+            conv_keys_reset(&c);
+            break;
+        default:
+            /* Unknown record types are skipped. */
+            break;
+        }
+    }
+
+    ok = (r == 0) && ossl_qlog_flush(c.qlog);
+err:
+    conv_keys_reset(&c);
+    OPENSSL_free(c.keys);
+    for (i = 0; i < c.num_events; ++i)
+        OPENSSL_free(c.events[i]);
+    OPENSSL_free(c.events);
+    OPENSSL_free(rec);
+    ossl_qlog_free(c.qlog);
+    return ok;
+}
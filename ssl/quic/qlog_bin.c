@@ -0,0 +1,582 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <assert.h>
+#include <openssl/crypto.h>
+#include "internal/qlog_bin.h"
+#include "internal/quic_vlint.h"
+#include "internal/hashfunc.h"
+#include "internal/common.h"
+#include "internal/time.h"
+
+/* Initial number of slots in the table of interned field names. */
+#define QLOG_BIN_INIT_KEY_SLOTS 64
+
+/* How often the background writer writes out records if not woken up. */
+#define QLOG_WRITER_PERIOD ossl_ms2time(100)
+
+struct ossl_qlog_bin_key_st {
+    char *name; /* NULL if slot is empty */
+    size_t idx;
+};
+
+DEFINE_LIST_OF(qlog_bin, OSSL_QLOG_BIN);
+
+struct qlog_writer_st {
+#if defined(OPENSSL_THREADS)
+    CRYPTO_MUTEX *mutex;
+    CRYPTO_CONDVAR *cv;
+    CRYPTO_THREAD *thread;
+
+    /* All sinks registered with the writer. Protected by mutex. */
+    OSSL_LIST(qlog_bin) sinks;
+
+    unsigned int kick : 1;
+    unsigned int stop : 1;
+#else
+    int dummy;
+#endif
+};
+
+static void qlog_bin_io_lock(OSSL_QLOG_BIN *b)
+{
+#if defined(OPENSSL_THREADS)
+    ossl_crypto_mutex_lock(b->io_lock);
+#endif
+}
+
+static void qlog_bin_io_unlock(OSSL_QLOG_BIN *b)
+{
+#if defined(OPENSSL_THREADS)
+    ossl_crypto_mutex_unlock(b->io_lock);
+#endif
+}
+
+/*
+ * Writes out all published records. Must be called with io_lock held.
+ */
+static void qlog_bin_drain(OSSL_QLOG_BIN *b)
+{
+    uint64_t head, tail = b->tail;
+    size_t off, len, ring_size = b->ring_mask + 1;
+
+    /*
+     * Records are held until there is a sink, so the first sink receives the
+     * magic and header. If the ring fills up first, new records are dropped.
+     */
+    if (b->bio == NULL
+        || !CRYPTO_atomic_load(&b->head, &head, b->atomic_lock))
+        return;
+
+    while (tail != head) {
+        off = (size_t)tail & b->ring_mask;
+        len = (size_t)(head - tail);
+        if (len > ring_size - off)
+            len = ring_size - off;
+
+        (void)BIO_write_ex(b->bio, b->ring + off, len, NULL); /* best effort */
+
+        tail += len;
+    }
+
+    CRYPTO_atomic_store(&b->tail, tail, b->atomic_lock);
+}
+
+/*
+ * Background Writer
+ * =================
+ */
+#if defined(OPENSSL_THREADS)
+
+static CRYPTO_THREAD_RETVAL qlog_writer_main(void *arg)
+{
+    QLOG_WRITER *w = arg;
+    OSSL_QLOG_BIN *b;
+
+    ossl_crypto_mutex_lock(w->mutex);
+    while (!w->stop) {
+        if (!w->kick)
+            ossl_crypto_condvar_wait_timeout(w->cv, w->mutex,
+                ossl_time_add(ossl_time_now(), QLOG_WRITER_PERIOD));
+
+        w->kick = 0;
+        for (b = ossl_list_qlog_bin_head(&w->sinks); b != NULL;
+            b = ossl_list_qlog_bin_next(b)) {
+            qlog_bin_io_lock(b);
+            qlog_bin_drain(b);
+            qlog_bin_io_unlock(b);
+        }
+    }
+    ossl_crypto_mutex_unlock(w->mutex);
+    return 1;
+}
+
+static int qlog_writer_add(QLOG_WRITER *w, OSSL_QLOG_BIN *b)
+{
+    int ok;
+
+    ossl_crypto_mutex_lock(w->mutex);
+
+    /* The thread is only started once there is something to write. */
+    if (w->thread == NULL)
+        w->thread = ossl_crypto_thread_native_start(qlog_writer_main, w,
+            /*joinable=*/1);
+
+    ok = (w->thread != NULL);
+    if (ok)
+        ossl_list_qlog_bin_insert_tail(&w->sinks, b);
+
+    ossl_crypto_mutex_unlock(w->mutex);
+    return ok;
+}
+
+static void qlog_writer_remove(QLOG_WRITER *w, OSSL_QLOG_BIN *b)
+{
+    ossl_crypto_mutex_lock(w->mutex);
+    ossl_list_qlog_bin_remove(&w->sinks, b);
+    ossl_crypto_mutex_unlock(w->mutex);
+}
+
+static void qlog_writer_kick(QLOG_WRITER *w)
+{
+    /*
+     * Never block the logging thread; if the writer is busy, it is about to
+     * write out our records anyway.
+     */
+    if (!ossl_crypto_mutex_try_lock(w->mutex))
+        return;
+
+    w->kick = 1;
+    ossl_crypto_condvar_signal(w->cv);
+    ossl_crypto_mutex_unlock(w->mutex);
+}
+
+#else
+
+static int qlog_writer_add(QLOG_WRITER *w, OSSL_QLOG_BIN *b)
+{
+    /* Records are written synchronously. */
+    return 0;
+}
+
+static void qlog_writer_remove(QLOG_WRITER *w, OSSL_QLOG_BIN *b)
+{
+}
+
+static void qlog_writer_kick(QLOG_WRITER *w)
+{
+}
+
+#endif
+
+QLOG_WRITER *ossl_qlog_writer_new(void)
+{
+    QLOG_WRITER *w = OPENSSL_zalloc(sizeof(*w));
+
+    if (w == NULL)
+        return NULL;
+
+#if defined(OPENSSL_THREADS)
+    if ((w->mutex = ossl_crypto_mutex_new()) == NULL
+        || (w->cv = ossl_crypto_condvar_new()) == NULL) {
+        ossl_crypto_mutex_free(&w->mutex);
+        OPENSSL_free(w);
+        return NULL;
+    }
+#endif
+
+    return w;
+}
+
+void ossl_qlog_writer_free(QLOG_WRITER *w)
+{
+#if defined(OPENSSL_THREADS)
+    CRYPTO_THREAD_RETVAL rv;
+#endif
+
+    if (w == NULL)
+        return;
+
+#if defined(OPENSSL_THREADS)
+    assert(ossl_list_qlog_bin_is_empty(&w->sinks));
+
+    if (w->thread != NULL) {
+        ossl_crypto_mutex_lock(w->mutex);
+        w->stop = 1;
+        ossl_crypto_condvar_signal(w->cv);
+        ossl_crypto_mutex_unlock(w->mutex);
+
+        ossl_crypto_thread_native_join(w->thread, &rv);
+        ossl_crypto_thread_native_clean(w->thread);
+    }
+
+    ossl_crypto_condvar_free(&w->cv);
+    ossl_crypto_mutex_free(&w->mutex);
+#endif
+    OPENSSL_free(w);
+}
+
+/*
+ * Sink Lifecycle
+ * ==============
+ */
+int ossl_qlog_bin_init(OSSL_QLOG_BIN *b, QLOG_WRITER *writer)
+{
+    memset(b, 0, sizeof(*b));
+
+    if ((b->ring = OPENSSL_malloc(QLOG_BIN_RING_SIZE)) == NULL)
+        goto err;
+
+    b->ring_mask = QLOG_BIN_RING_SIZE - 1;
+
+    b->num_key_slots = QLOG_BIN_INIT_KEY_SLOTS;
+    if ((b->keys = OPENSSL_zalloc(b->num_key_slots * sizeof(*b->keys))) == NULL)
+        goto err;
+
+    if ((b->atomic_lock = CRYPTO_THREAD_lock_new()) == NULL)
+        goto err;
+
+#if defined(OPENSSL_THREADS)
+    if ((b->io_lock = ossl_crypto_mutex_new()) == NULL)
+        goto err;
+#endif
+
+    /* Nothing else can see the ring yet. */
+    memcpy(b->ring, QLOG_BIN_MAGIC, QLOG_BIN_MAGIC_LEN);
+    b->head = b->wpos = QLOG_BIN_MAGIC_LEN;
+
+    if (writer != NULL && qlog_writer_add(writer, b))
+        b->writer = writer;
+
+    return 1;
+
+err:
+    ossl_qlog_bin_cleanup(b);
+    return 0;
+}
+
+static void qlog_bin_keys_reset(OSSL_QLOG_BIN *b)
+{
+    size_t i;
+
+    for (i = 0; i < b->num_key_slots; ++i) {
+        OPENSSL_free(b->keys[i].name);
+        b->keys[i].name = NULL;
+    }
+
+    b->num_keys = 0;
+}
+
+void ossl_qlog_bin_cleanup(OSSL_QLOG_BIN *b)
+{
+    if (b->writer != NULL) {
+        qlog_writer_remove(b->writer, b);
+        b->writer = NULL;
+    }
+
+    if (b->ring != NULL && b->atomic_lock != NULL) {
+        qlog_bin_drain(b);
+        if (b->bio != NULL)
+            (void)BIO_flush(b->bio);
+    }
+
+    if (b->keys != NULL)
+        qlog_bin_keys_reset(b);
+
+    OPENSSL_free(b->keys);
+    b->keys = NULL;
+    OPENSSL_free(b->ring);
+    b->ring = NULL;
+#if defined(OPENSSL_THREADS)
+    ossl_crypto_mutex_free(&b->io_lock);
+#endif
+    CRYPTO_THREAD_lock_free(b->atomic_lock);
+    b->atomic_lock = NULL;
+    b->bio = NULL;
+}
+
+void ossl_qlog_bin_set0_sink(OSSL_QLOG_BIN *b, BIO *bio)
+{
+    qlog_bin_io_lock(b);
+    qlog_bin_drain(b);
+    b->bio = bio;
+    qlog_bin_io_unlock(b);
+}
+
+int ossl_qlog_bin_flush(OSSL_QLOG_BIN *b)
+{
+    int ok = 1;
+
+    qlog_bin_io_lock(b);
+    qlog_bin_drain(b);
+    if (b->bio != NULL)
+        ok = BIO_flush(b->bio) > 0;
+    qlog_bin_io_unlock(b);
+    return ok;
+}
+
+/*
+ * Record Construction
+ * ===================
+ */
+
+/*
+ * Ensures there is room for another len bytes in the ring. If there is not,
+ * the current record is marked as overflowed and later dropped.
+ */
+static int qlog_bin_reserve(OSSL_QLOG_BIN *b, size_t len)
+{
+    size_t ring_size = b->ring_mask + 1;
+
+    if (b->overflow)
+        return 0;
+
+    if (b->wpos + len - b->tail_cache <= ring_size)
+        return 1;
+
+    if (!CRYPTO_atomic_load(&b->tail, &b->tail_cache, b->atomic_lock))
+        goto overflow;
+
+    if (b->wpos + len - b->tail_cache <= ring_size)
+        return 1;
+
+    /* The writer is behind; write out the published records ourselves. */
+    qlog_bin_io_lock(b);
+    qlog_bin_drain(b);
+    qlog_bin_io_unlock(b);
+
+    if (!CRYPTO_atomic_load(&b->tail, &b->tail_cache, b->atomic_lock))
+        goto overflow;
+
+    if (b->wpos + len - b->tail_cache <= ring_size)
+        return 1;
+
+overflow:
+    b->overflow = 1;
+    return 0;
+}
+
+static void qlog_bin_put(OSSL_QLOG_BIN *b, uint64_t pos,
+    const unsigned char *p, size_t len)
+{
+    size_t off = (size_t)pos & b->ring_mask;
+    size_t n = b->ring_mask + 1 - off;
+
+    if (n > len)
+        n = len;
+
+    memcpy(b->ring + off, p, n);
+    memcpy(b->ring, p + n, len - n);
+}
+
+void ossl_qlog_bin_bytes(OSSL_QLOG_BIN *b, const void *p, size_t len)
+{
+    if (!b->in_record || !qlog_bin_reserve(b, len))
+        return;
+
+    qlog_bin_put(b, b->wpos, p, len);
+    b->wpos += len;
+}
+
+void ossl_qlog_bin_u8(OSSL_QLOG_BIN *b, uint8_t v)
+{
+    ossl_qlog_bin_bytes(b, &v, 1);
+}
+
+static void put_u64(unsigned char *buf, uint64_t v)
+{
+    size_t i;
+
+    for (i = 0; i < 8; ++i)
+        buf[i] = (unsigned char)(v >> (56 - i * 8));
+}
+
+void ossl_qlog_bin_u64(OSSL_QLOG_BIN *b, uint64_t v)
+{
+    unsigned char buf[8];
+
+    put_u64(buf, v);
+    ossl_qlog_bin_bytes(b, buf, sizeof(buf));
+}
+
+void ossl_qlog_bin_vlint(OSSL_QLOG_BIN *b, uint64_t v)
+{
+    unsigned char buf[8]; /* longest vlint encoding */
+    size_t len = ossl_quic_vlint_encode_len(v);
+
+    if (len == 0) {
+        b->overflow = 1;
+        return;
+    }
+
+    ossl_quic_vlint_encode(buf, v);
+    ossl_qlog_bin_bytes(b, buf, len);
+}
+
+void ossl_qlog_bin_str(OSSL_QLOG_BIN *b, const void *p, size_t len)
+{
+    ossl_qlog_bin_vlint(b, len);
+    ossl_qlog_bin_bytes(b, p, len);
+}
+
+void ossl_qlog_bin_patch_u64(OSSL_QLOG_BIN *b, size_t offset, uint64_t v)
+{
+    unsigned char buf[8];
+    uint64_t pos = b->rec_start + QLOG_BIN_REC_HDR_LEN + offset;
+
+    if (!b->in_record || b->overflow || pos + sizeof(buf) > b->wpos)
+        return;
+
+    put_u64(buf, v);
+    qlog_bin_put(b, pos, buf, sizeof(buf));
+}
+
+void ossl_qlog_bin_record_begin(OSSL_QLOG_BIN *b, uint32_t rec_type)
+{
+    unsigned char hdr[QLOG_BIN_REC_HDR_LEN] = { 0 };
+
+    if (!ossl_assert(!b->in_record))
+        return;
+
+    if (b->need_key_reset) {
+        /* Interned names were lost with a dropped record; start over. */
+        b->need_key_reset = 0;
+        ossl_qlog_bin_record_begin(b, QLOG_BIN_REC_KEY_RESET);
+        if (!ossl_qlog_bin_record_end(b))
+            b->need_key_reset = 1;
+    }
+
+    b->in_record = 1;
+    b->overflow = 0;
+    b->rec_start = b->wpos;
+    b->rec_num_keys = b->num_keys;
+
+    hdr[4] = (unsigned char)rec_type;
+    ossl_qlog_bin_bytes(b, hdr, sizeof(hdr));
+}
+
+int ossl_qlog_bin_record_end(OSSL_QLOG_BIN *b)
+{
+    unsigned char len_buf[4];
+    uint64_t len, half = (b->ring_mask + 1) / 2;
+
+    if (!ossl_assert(b->in_record))
+        return 0;
+
+    b->in_record = 0;
+
+    if (b->overflow) {
+        b->wpos = b->rec_start;
+        ++b->num_dropped;
+        if (b->num_keys != b->rec_num_keys) {
+            qlog_bin_keys_reset(b);
+            b->need_key_reset = 1;
+        }
+        return 0;
+    }
+
+    len = b->wpos - b->rec_start - sizeof(len_buf);
+    len_buf[0] = (unsigned char)(len >> 24);
+    len_buf[1] = (unsigned char)(len >> 16);
+    len_buf[2] = (unsigned char)(len >> 8);
+    len_buf[3] = (unsigned char)len;
+    qlog_bin_put(b, b->rec_start, len_buf, sizeof(len_buf));
+
+    if (!CRYPTO_atomic_store(&b->head, b->wpos, b->atomic_lock))
+        return 0;
+
+    /* Wake up the writer each time another half of the ring has been filled. */
+    if (b->writer != NULL && b->rec_start / half != b->wpos / half)
+        qlog_writer_kick(b->writer);
+
+    return 1;
+}
+
+/*
+ * Field Names
+ * ===========
+ */
+static OSSL_QLOG_BIN_KEY *key_slot(OSSL_QLOG_BIN_KEY *keys, size_t num_slots,
+    const char *name, size_t name_len)
+{
+    size_t mask = num_slots - 1;
+    size_t i = (size_t)ossl_fnv1a_hash((uint8_t *)name, name_len) & mask;
+
+    /* The table is never full, so this terminates. */
+    for (;; i = (i + 1) & mask)
+        if (keys[i].name == NULL
+            || (strncmp(keys[i].name, name, name_len) == 0
+                && keys[i].name[name_len] == '\0'))
+            return &keys[i];
+}
+
+static int keys_grow(OSSL_QLOG_BIN *b)
+{
+    OSSL_QLOG_BIN_KEY *keys, *k;
+    size_t i, num_slots = b->num_key_slots * 2;
+
+    if ((keys = OPENSSL_zalloc(num_slots * sizeof(*keys))) == NULL)
+        return 0;
+
+    for (i = 0; i < b->num_key_slots; ++i) {
+        if (b->keys[i].name == NULL)
+            continue;
+
+        k = key_slot(keys, num_slots, b->keys[i].name,
+            strlen(b->keys[i].name));
+        *k = b->keys[i];
+    }
+
+    OPENSSL_free(b->keys);
+    b->keys = keys;
+    b->num_key_slots = num_slots;
+    return 1;
+}
+
+void ossl_qlog_bin_token(OSSL_QLOG_BIN *b, uint32_t tok, const char *key)
+{
+    OSSL_QLOG_BIN_KEY *k;
+    size_t key_len;
+
+    if (!b->in_record)
+        return;
+
+    if (key == NULL) {
+        ossl_qlog_bin_u8(b, (uint8_t)tok);
+        return;
+    }
+
+    key_len = strlen(key);
+    k = key_slot(b->keys, b->num_key_slots, key, key_len);
+    if (k->name != NULL) {
+        ossl_qlog_bin_u8(b, (uint8_t)(tok | QLOG_BIN_TOK_KEY_REF));
+        ossl_qlog_bin_vlint(b, k->idx);
+        return;
+    }
+
+    /* Keep the load factor at or below 3/4. */
+    if ((b->num_keys + 1) * 4 > b->num_key_slots * 3) {
+        if (!keys_grow(b)) {
+            b->overflow = 1;
+            return;
+        }
+
+        k = key_slot(b->keys, b->num_key_slots, key, key_len);
+    }
+
+    if ((k->name = OPENSSL_strndup(key, key_len)) == NULL) {
+        b->overflow = 1;
+        return;
+    }
+
+    k->idx = b->num_keys++;
+    ossl_qlog_bin_u8(b, (uint8_t)(tok | QLOG_BIN_TOK_KEY_DEF));
+    ossl_qlog_bin_str(b, key, key_len);
+}
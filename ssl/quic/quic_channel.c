@@ -41,6 +41,11 @@ static void ch_save_err_state(QUIC_CHANNEL *ch);
 static int ch_rx(QUIC_CHANNEL *ch, int channel_only, int *notify_other_threads);
 static int ch_tx(QUIC_CHANNEL *ch, int *notify_other_threads);
 static int ch_tick_tls(QUIC_CHANNEL *ch, int channel_only, int *notify_other_threads);
+static int ch_check_tls_error(QUIC_CHANNEL *ch, int *notify_other_threads);
+static int ch_tls_job_wanted(QUIC_CHANNEL *ch);
+static int ch_tls_job_start(QUIC_CHANNEL *ch, int channel_only);
+static int ch_tls_job_reap(QUIC_CHANNEL *ch, int wait, int discard);
+static void ch_tls_job_park(QUIC_CHANNEL *ch, QUIC_TICK_RESULT *res);
 static void ch_rx_handle_packet(QUIC_CHANNEL *ch, int channel_only);
 static OSSL_TIME ch_determine_next_tick_deadline(QUIC_CHANNEL *ch);
 static int ch_retry(QUIC_CHANNEL *ch,
@@ -93,6 +98,16 @@ static void ch_record_state_transition(QUIC_CHANNEL *ch, uint32_t new_state);
 
 DEFINE_LHASH_OF_EX(QUIC_SRT_ELEM);
 
+#ifndef OPENSSL_NO_QLOG
+QUIC_NEEDS_LOCK
+static QLOG_WRITER *ch_get_qlog_writer_cb(void *arg)
+{
+    QUIC_CHANNEL *ch = arg;
+
+    return ossl_quic_engine_get0_qlog_writer(ch->port->engine);
+}
+#endif
+
 QUIC_NEEDS_LOCK
 static QLOG *ch_get_qlog(QUIC_CHANNEL *ch)
 {
@@ -115,6 +130,8 @@ static QLOG *ch_get_qlog(QUIC_CHANNEL *ch)
     qti.is_server = ch->is_server;
     qti.now_cb = get_time;
     qti.now_cb_arg = ch;
+    qti.get_writer_cb = ch_get_qlog_writer_cb;
+    qti.get_writer_cb_arg = ch;
     if ((ch->qlog = ossl_qlog_new_from_env(&qti)) == NULL) {
         ch->use_qlog = 0; /* don't try again */
         return NULL;
@@ -208,7 +225,8 @@ static int ch_init(QUIC_CHANNEL *ch)
         goto err;
 
     ch->have_statm = 1;
-    ch->cc_method = &ossl_cc_newreno_method;
+    if ((ch->cc_method = ossl_cc_method_by_algorithm(ch->cc_algorithm)) == NULL)
+        goto err;
     if ((ch->cc_data = ch->cc_method->new(get_time, ch)) == NULL)
         goto err;
 
@@ -366,6 +384,8 @@ static void ch_cleanup(QUIC_CHANNEL *ch)
 {
     uint32_t pn_space;
 
+    ch_tls_job_reap(ch, /*wait=*/1, /*discard=*/1);
+
     if (ch->ackm != NULL)
         for (pn_space = QUIC_PN_SPACE_INITIAL;
             pn_space < QUIC_PN_SPACE_NUM;
@@ -494,6 +514,7 @@ QUIC_CHANNEL *ossl_quic_channel_alloc(const QUIC_CHANNEL_ARGS *args)
     ch->tx_max_ack_delay = args->max_ack_delay;
     ch->tx_disable_active_migration = args->disable_active_migration;
     ch->tx_active_conn_id_limit = args->active_conn_id_limit;
+    ch->cc_algorithm = args->cc_algorithm;
 
     if (!ossl_quic_rxfc_init(&ch->conn_rxfc, NULL,
             ch->tx_init_max_data,
@@ -1194,6 +1215,26 @@ static int ch_on_handshake_yield_secret(uint32_t prot_level, int direction,
                 return 0;
             }
 
+#if defined(OPENSSL_THREADS)
+        if (ch->tls_job_active) {
+            QUIC_CH_DEFERRED_SECRET *ds = &ch->tls_job_rx_secret[enc_level];
+
+            /*
+             * The port may be injecting datagrams into the QRX concurrently,
+             * so keep the secret until the handshake job is reaped.
+             */
+            if (secret_len > sizeof(ds->secret))
+                return 0;
+
+            ds->md = md;
+            ds->suite_id = suite_id;
+            ds->secret_len = secret_len;
+            memcpy(ds->secret, secret, secret_len);
+            ch->rx_enc_level = enc_level;
+            return 1;
+        }
+#endif
+
         if (!ossl_qrx_provide_secret(ch->qrx, enc_level,
                 suite_id, md,
                 secret, secret_len))
@@ -1210,6 +1251,14 @@ static int ch_on_handshake_complete(void *arg)
 {
     QUIC_CHANNEL *ch = arg;
 
+#if defined(OPENSSL_THREADS)
+    if (ch->tls_job_active) {
+        /* Touches the QRX; wait until the handshake job is reaped. */
+        ch->tls_job_complete = 1;
+        return 1;
+    }
+#endif
+
     if (!ossl_assert(!ch->handshake_complete))
         return 0; /* this should not happen twice */
 
@@ -2140,6 +2189,16 @@ void ossl_quic_channel_subtick(QUIC_CHANNEL *ch, QUIC_TICK_RESULT *res,
         return;
     }
 
+    /*
+     * If the handshake layer is running on a worker thread, the channel is
+     * parked until it has finished.
+     */
+    if (!ch_tls_job_reap(ch, /*wait=*/0, /*discard=*/0)) {
+        res->notify_other_threads = 0;
+        ch_tls_job_park(ch, res);
+        return;
+    }
+
     /*
      * If we are in the TERMINATING state, check if the terminating timer has
      * expired.
@@ -2169,11 +2228,18 @@ void ossl_quic_channel_subtick(QUIC_CHANNEL *ch, QUIC_TICK_RESULT *res,
 
             /*
              * Allow the handshake layer to check for any new incoming data and
-             * generate new outgoing data.
+             * generate new outgoing data. If we can, do this on a worker thread
+             * and park the channel meanwhile.
              */
-            if (!ch->did_tls_tick)
+            if (!ch->did_tls_tick && !ch_tls_job_start(ch, channel_only))
                 ch_tick_tls(ch, channel_only, &notify_other_threads);
 
+            if (ossl_quic_channel_has_tls_job(ch)) {
+                res->notify_other_threads = notify_other_threads;
+                ch_tls_job_park(ch, res);
+                return;
+            }
+
             /*
              * If the handshake layer gave us a new secret, we need to do RX
              * again because packets that were not previously processable and
@@ -2256,16 +2322,21 @@ void ossl_quic_channel_subtick(QUIC_CHANNEL *ch, QUIC_TICK_RESULT *res,
 
 static int ch_tick_tls(QUIC_CHANNEL *ch, int channel_only, int *notify_other_threads)
 {
-    uint64_t error_code;
-    const char *error_msg;
-    ERR_STATE *error_state = NULL;
-
     if (channel_only)
         return 1;
 
     ch->did_tls_tick = 1;
     ossl_quic_tls_tick(ch->qtls);
 
+    return ch_check_tls_error(ch, notify_other_threads);
+}
+
+static int ch_check_tls_error(QUIC_CHANNEL *ch, int *notify_other_threads)
+{
+    uint64_t error_code;
+    const char *error_msg;
+    ERR_STATE *error_state = NULL;
+
     if (ossl_quic_tls_get_error(ch->qtls, &error_code, &error_msg,
             &error_state)) {
         ossl_quic_channel_raise_protocol_error_state(ch, error_code, 0,
@@ -2279,6 +2350,211 @@ static int ch_tick_tls(QUIC_CHANNEL *ch, int channel_only, int *notify_other_thr
     return 1;
 }
 
+/*
+ * QUIC Channel: Handshake Offload
+ * ===============================
+ *
+ * A server channel waiting in the accept queue can run the steps of its
+ * handshake which consume received handshake data on a worker thread, so that
+ * the expensive parts of the handshake (key exchange, signing, certificate
+ * verification) do not hold up the other channels ticked by the same thread.
+ * See the description of tls_job in quic_channel_local.h.
+ */
+#if defined(OPENSSL_THREADS)
+
+/* How often a parked channel checks whether its handshake job has finished. */
+#define TLS_JOB_POLL_PERIOD ossl_ms2time(1)
+
+static unsigned int ch_tls_job_main(void *arg)
+{
+    QUIC_CHANNEL *ch = arg;
+
+    ossl_quic_tls_tick(ch->qtls);
+    return 1;
+}
+
+/* Returns 1 if the next tick of the handshake layer should be offloaded. */
+static int ch_tls_job_wanted(QUIC_CHANNEL *ch)
+{
+    QUIC_RSTREAM *rstream;
+    size_t avail = 0;
+    int is_fin = 0;
+
+    if (!ch->tls_offload_allowed
+        || ch->handshake_complete
+        || ch->tls_job != NULL
+        || ch->port->num_handshake_threads >= ch->port->max_handshake_threads)
+        return 0;
+
+    /*
+     * Ticking the handshake layer without new handshake data to process is
+     * cheap and not worth a thread.
+     */
+    rstream = ch->crypto_recv[ossl_quic_enc_level_to_pn_space(ch->rx_enc_level)];
+    if (rstream == NULL
+        || !ossl_quic_rstream_available(rstream, &avail, &is_fin))
+        return 0;
+
+    return avail > 0;
+}
+
+static int ch_tls_job_start(QUIC_CHANNEL *ch, int channel_only)
+{
+    if (channel_only || !ch_tls_job_wanted(ch))
+        return 0;
+
+    ch->did_tls_tick = 1;
+    ch->tls_job_active = 1;
+    ch->tls_job = ossl_crypto_thread_native_start(ch_tls_job_main, ch,
+        /*joinable=*/1);
+    if (ch->tls_job == NULL) {
+        /* Not fatal; the caller ticks the handshake layer itself instead. */
+        ch->did_tls_tick = 0;
+        ch->tls_job_active = 0;
+        return 0;
+    }
+
+    ++ch->port->num_handshake_threads;
+    return 1;
+}
+
+/*
+ * Applies the results of a handshake job which had to be deferred, or just
+ * frees them if discard is set.
+ */
+static void ch_tls_job_apply(QUIC_CHANNEL *ch, int discard)
+{
+    QUIC_CH_DEFERRED_SECRET *ds;
+    uint32_t enc_level;
+
+    for (enc_level = QUIC_ENC_LEVEL_INITIAL;
+        enc_level < QUIC_ENC_LEVEL_NUM;
+        ++enc_level) {
+        ds = &ch->tls_job_rx_secret[enc_level];
+        if (ds->md == NULL)
+            continue;
+
+        if (!discard
+            && ossl_qrx_provide_secret(ch->qrx, enc_level, ds->suite_id,
+                ds->md, ds->secret, ds->secret_len)) {
+            ch->have_new_rx_secret = 1;
+        } else {
+            EVP_MD_free(ds->md);
+            if (!discard)
+                ossl_quic_channel_raise_protocol_error(ch,
+                    OSSL_QUIC_ERR_INTERNAL_ERROR, 0,
+                    "cannot provide RX secret");
+        }
+
+        OPENSSL_cleanse(ds->secret, ds->secret_len);
+        ds->md = NULL;
+        ds->secret_len = 0;
+    }
+
+    if (!discard) {
+        if (ch->tls_job_err)
+            ossl_quic_channel_raise_protocol_error_loc(ch,
+                ch->tls_job_err_code,
+                ch->tls_job_err_frame_type,
+                ch->tls_job_err_reason,
+                NULL,
+                ch->tls_job_err_file,
+                ch->tls_job_err_line,
+                ch->tls_job_err_func);
+        else if (ch->tls_job_complete)
+            ch_on_handshake_complete(ch);
+
+        ch_check_tls_error(ch, NULL);
+    }
+
+    ch->tls_job_err = 0;
+    ch->tls_job_complete = 0;
+}
+
+/*
+ * Reaps the handshake job of the channel if it has finished, or after waiting
+ * for it to finish if wait is set. Returns 1 if the channel no longer has a
+ * handshake job.
+ */
+static int ch_tls_job_reap(QUIC_CHANNEL *ch, int wait, int discard)
+{
+    CRYPTO_THREAD_RETVAL rv;
+    int finished;
+
+    if (ch->tls_job == NULL)
+        return 1;
+
+    if (!wait) {
+        ossl_crypto_mutex_lock(ch->tls_job->statelock);
+        finished = CRYPTO_THREAD_GET_STATE(ch->tls_job, CRYPTO_THREAD_FINISHED);
+        ossl_crypto_mutex_unlock(ch->tls_job->statelock);
+
+        if (!finished)
+            return 0;
+    }
+
+    if (!ossl_crypto_thread_native_join(ch->tls_job, &rv))
+        return 0;
+
+    ossl_crypto_thread_native_clean(ch->tls_job);
+    ch->tls_job = NULL;
+    ch->tls_job_active = 0;
+    --ch->port->num_handshake_threads;
+
+    ch_tls_job_apply(ch, discard);
+    return 1;
+}
+
+/* Fills in the tick result for a parked channel. */
+static void ch_tls_job_park(QUIC_CHANNEL *ch, QUIC_TICK_RESULT *res)
+{
+    res->net_read_desired = 1;
+    res->net_write_desired = 0;
+    res->tick_deadline = ossl_time_add(get_time(ch), TLS_JOB_POLL_PERIOD);
+}
+
+#else
+
+static int ch_tls_job_wanted(QUIC_CHANNEL *ch)
+{
+    return 0;
+}
+
+static int ch_tls_job_start(QUIC_CHANNEL *ch, int channel_only)
+{
+    return 0;
+}
+
+static int ch_tls_job_reap(QUIC_CHANNEL *ch, int wait, int discard)
+{
+    return 1;
+}
+
+static void ch_tls_job_park(QUIC_CHANNEL *ch, QUIC_TICK_RESULT *res)
+{
+}
+
+#endif
+
+void ossl_quic_channel_set_tls_offload(QUIC_CHANNEL *ch, int allowed)
+{
+    ch->tls_offload_allowed = (allowed != 0);
+}
+
+int ossl_quic_channel_has_tls_job(const QUIC_CHANNEL *ch)
+{
+#if defined(OPENSSL_THREADS)
+    return ch->tls_job != NULL;
+#else
+    return 0;
+#endif
+}
+
+void ossl_quic_channel_cancel_tls_job(QUIC_CHANNEL *ch)
+{
+    ch_tls_job_reap(ch, /*wait=*/1, /*discard=*/1);
+}
+
 /* Check incoming forged packet limit and terminate connection if needed. */
 static void ch_rx_check_forged_pkt_limit(QUIC_CHANNEL *ch)
 {
@@ -2690,7 +2966,12 @@ static void ch_rx_handle_packet(QUIC_CHANNEL *ch, int channel_only)
         /* This packet contains frames, pass to the RXDP. */
         ossl_quic_handle_frames(ch, ch->qrx_pkt); /* best effort */
 
-        if (ch->did_crypto_frame)
+        /*
+         * Handshake data which is going to be processed on a worker thread is
+         * left until all received packets have been handled, as the channel
+         * must not be touched once the worker has been started.
+         */
+        if (ch->did_crypto_frame && !ch_tls_job_wanted(ch))
             ch_tick_tls(ch, channel_only, NULL);
 
         break;
@@ -3498,6 +3779,8 @@ void ossl_quic_channel_on_stateless_reset(QUIC_CHANNEL *ch)
 {
     QUIC_TERMINATE_CAUSE tcause = { 0 };
 
+    ch_tls_job_reap(ch, /*wait=*/1, /*discard=*/0);
+
     tcause.error_code = OSSL_QUIC_ERR_NO_ERROR;
     tcause.remote = 1;
     ch_start_terminating(ch, &tcause, 0);
@@ -3507,6 +3790,8 @@ void ossl_quic_channel_raise_net_error(QUIC_CHANNEL *ch)
 {
     QUIC_TERMINATE_CAUSE tcause = { 0 };
 
+    ch_tls_job_reap(ch, /*wait=*/1, /*discard=*/0);
+
     if (ch->net_error)
         return;
 
@@ -3561,6 +3846,26 @@ void ossl_quic_channel_raise_protocol_error_loc(QUIC_CHANNEL *ch,
         /* Only the first call to this function matters. */
         return;
 
+#if defined(OPENSSL_THREADS)
+    if (ch->tls_job_active) {
+        /*
+         * Called from the handshake layer on a worker thread. Terminating the
+         * connection touches state shared with the reactor thread, so do it
+         * when the handshake job is reaped.
+         */
+        if (!ch->tls_job_err) {
+            ch->tls_job_err = 1;
+            ch->tls_job_err_code = error_code;
+            ch->tls_job_err_frame_type = frame_type;
+            ch->tls_job_err_reason = reason;
+            ch->tls_job_err_file = src_file;
+            ch->tls_job_err_line = src_line;
+            ch->tls_job_err_func = src_func;
+        }
+        return;
+    }
+#endif
+
     if (err_str == NULL) {
         err_str = "";
         err_str_pfx = "";
@@ -4358,6 +4663,48 @@ uint64_t ossl_quic_channel_get_active_conn_id_limit_request(const QUIC_CHANNEL *
     return ch->tx_active_conn_id_limit;
 }
 
+int ossl_quic_channel_set_cc_algorithm(QUIC_CHANNEL *ch, uint64_t algorithm)
+{
+    const OSSL_CC_METHOD *method;
+    OSSL_CC_DATA *data;
+
+    if (ch->state != QUIC_CHANNEL_STATE_IDLE)
+        return 0;
+
+    if ((method = ossl_cc_method_by_algorithm(algorithm)) == NULL)
+        return 0;
+
+    if (method != ch->cc_method) {
+        if ((data = method->new(get_time, ch)) == NULL)
+            return 0;
+
+        /* Nothing has been sent yet, so the old instance holds no state. */
+        ossl_ackm_set_cc(ch->ackm, method, data);
+        ossl_quic_tx_packetiser_set_cc(ch->txp, method, data);
+        ch->cc_method->free(ch->cc_data);
+        ch->cc_method = method;
+        ch->cc_data = data;
+    }
+
+    ch->cc_algorithm = algorithm;
+    return 1;
+}
+
+uint64_t ossl_quic_channel_get_cc_algorithm(const QUIC_CHANNEL *ch)
+{
+    return ch->cc_algorithm;
+}
+
+uint64_t ossl_quic_channel_get_pacing_rate(const QUIC_CHANNEL *ch)
+{
+    return ossl_quic_tx_packetiser_get_pacing_rate(ch->txp);
+}
+
+uint64_t ossl_quic_channel_get_pacing_deferrals(const QUIC_CHANNEL *ch)
+{
+    return ossl_quic_tx_packetiser_get_pacing_deferrals(ch->txp);
+}
+
 uint64_t ossl_quic_channel_get_active_conn_id_limit_peer_request(const QUIC_CHANNEL *ch)
 {
     return ch->rx_active_conn_id_limit;
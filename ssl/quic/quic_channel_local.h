@@ -15,11 +15,13 @@
 #ifndef OPENSSL_NO_QUIC
 
 #include <openssl/lhash.h>
+#include <openssl/evp.h>
 #include "internal/list.h"
 #include "internal/quic_predef.h"
 #include "internal/quic_fc.h"
 #include "internal/quic_stream_map.h"
 #include "internal/quic_tls.h"
+#include "internal/thread_arch.h"
 
 /*
  * This is a part of PATH_CHALLENGE flood [1] mitigation. This limits the
@@ -43,6 +45,17 @@
  */
 #define QUIC_PATH_RESPONSE_QLEN 32
 
+/*
+ * An RX secret yielded by the handshake layer while it was running on a worker
+ * thread, held until it can be provided to the QRX. We own a reference to md.
+ */
+typedef struct quic_ch_deferred_secret_st {
+    EVP_MD *md;
+    uint32_t suite_id;
+    size_t secret_len;
+    unsigned char secret[EVP_MAX_MD_SIZE];
+} QUIC_CH_DEFERRED_SECRET;
+
 /*
  * QUIC Channel Structure
  * ======================
@@ -121,6 +134,7 @@ struct quic_channel_st {
     OSSL_STATM statm;
     OSSL_CC_DATA *cc_data;
     const OSSL_CC_METHOD *cc_method;
+    uint64_t cc_algorithm; /* SSL_VALUE_QUIC_CC_ALGORITHM_* */
     OSSL_ACKM *ackm;
 
     /* Record layers in the TX and RX directions. */
@@ -503,6 +517,19 @@ struct quic_channel_st {
 
     /* Has qlog been requested? */
     unsigned int is_tserver_ch : 1;
+
+    /*
+     * May handshake layer steps be run on a worker thread? Set while the
+     * channel is waiting in the accept queue of a port which allows it.
+     */
+    unsigned int tls_offload_allowed : 1;
+
+    /* Set while the handshake layer is running on a worker thread. */
+    unsigned int tls_job_active : 1;
+
+    /* Handshake layer events deferred until the worker is reaped. */
+    unsigned int tls_job_err : 1;
+    unsigned int tls_job_complete : 1;
     /*
      * RFC 9000 Section 9.2.1 says:
      *      However, an endpoint SHOULD NOT send multiple
@@ -534,6 +561,28 @@ struct quic_channel_st {
     unsigned int path_challenge_rx;
     /* number of path response frames sent */
     unsigned int path_response_tx;
+
+#if defined(OPENSSL_THREADS)
+    /*
+     * Handshake offload. While tls_job is non-NULL, a worker thread is running
+     * a step of the handshake layer and the channel is parked: it is not
+     * ticked and the port does not hand it out to the application. The
+     * handshake layer callbacks running on the worker may only touch state
+     * which is private to the channel; anything shared with the reactor thread
+     * (the QRX, which the port injects datagrams into, and connection
+     * termination) is recorded here and applied once the job has been reaped.
+     */
+    CRYPTO_THREAD *tls_job;
+    QUIC_CH_DEFERRED_SECRET tls_job_rx_secret[QUIC_ENC_LEVEL_NUM];
+
+    /* The first protocol error raised while the job was running. */
+    uint64_t tls_job_err_code;
+    uint64_t tls_job_err_frame_type;
+    const char *tls_job_err_reason;
+    const char *tls_job_err_file;
+    const char *tls_job_err_func;
+    int tls_job_err_line;
+#endif
 };
 
 #endif
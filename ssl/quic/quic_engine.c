@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -62,6 +62,10 @@ static void qeng_cleanup(QUIC_ENGINE *qeng)
 {
     assert(ossl_list_port_num(&qeng->port_list) == 0);
     ossl_quic_reactor_cleanup(&qeng->rtor);
+#ifndef OPENSSL_NO_QLOG
+    ossl_qlog_writer_free(qeng->qlog_writer);
+    qeng->qlog_writer = NULL;
+#endif
 }
 
 QUIC_REACTOR *ossl_quic_engine_get0_reactor(QUIC_ENGINE *qeng)
@@ -112,6 +116,18 @@ void ossl_quic_engine_set_inhibit_tick(QUIC_ENGINE *qeng, int inhibit)
     qeng->inhibit_tick = (inhibit != 0);
 }
 
+QLOG_WRITER *ossl_quic_engine_get0_qlog_writer(QUIC_ENGINE *qeng)
+{
+#ifndef OPENSSL_NO_QLOG
+    if (qeng->qlog_writer == NULL)
+        qeng->qlog_writer = ossl_qlog_writer_new();
+
+    return qeng->qlog_writer;
+#else
+    return NULL;
+#endif
+}
+
 OSSL_LIB_CTX *ossl_quic_engine_get0_libctx(QUIC_ENGINE *qeng)
 {
     return qeng->libctx;
@@ -1,5 +1,5 @@
 /*
- * Copyright 2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -51,6 +51,11 @@ struct quic_engine_st {
     OSSL_LIST(port)
     port_list;
 
+#ifndef OPENSSL_NO_QLOG
+    /* Background writer for binary qlog output. Created on demand. */
+    QLOG_WRITER *qlog_writer;
+#endif
+
     /* Inhibit tick for testing purposes? */
     unsigned int inhibit_tick : 1;
 };
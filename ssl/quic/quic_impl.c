@@ -704,6 +704,9 @@ static void quic_unref_port_bios(QUIC_PORT *port)
 QUIC_NEEDS_LOCK
 static void qc_cleanup(QUIC_CONNECTION *qc, int have_lock)
 {
+    if (qc->ch != NULL)
+        ossl_quic_channel_cancel_tls_job(qc->ch);
+
     SSL_free(qc->tls);
     qc->tls = NULL;
 
@@ -1809,7 +1812,8 @@ static int tls_wants_non_io_retry(QUIC_CONNECTION *qc)
 
     if (want == SSL_X509_LOOKUP
         || want == SSL_CLIENT_HELLO_CB
-        || want == SSL_RETRY_VERIFY)
+        || want == SSL_RETRY_VERIFY
+        || want == SSL_PRIVATE_KEY_OPERATION)
         return 1;
 
     return 0;
@@ -1862,6 +1866,8 @@ static int create_channel(QUIC_CONNECTION *qc, SSL_CTX *ctx)
 
     if (need_notifier_for_domain_flags(ctx->domain_flags))
         engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_NOTIFIER;
+    if ((ctx->domain_flags & SSL_DOMAIN_FLAG_EPOLL) != 0)
+        engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_POLL_SET;
 
     qc->engine = ossl_quic_engine_new(&engine_args);
     if (qc->engine == NULL) {
@@ -2468,6 +2474,9 @@ static int error_to_want(int error)
     case SSL_ERROR_WANT_RETRY_VERIFY:
         return SSL_RETRY_VERIFY;
 
+    case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
+        return SSL_PRIVATE_KEY_OPERATION;
+
     case SSL_ERROR_WANT_CLIENT_HELLO_CB:
         return SSL_CLIENT_HELLO_CB;
 
@@ -2946,6 +2955,67 @@ int ossl_quic_write(SSL *s, const void *buf, size_t len, size_t *written)
     return ossl_quic_write_flags(s, buf, len, 0, written);
 }
 
+/*
+ * SSL_write_ref_ex
+ * ----------------
+ *
+ * The caller's buffer is queued on the send stream by reference instead of
+ * being copied into the stream's ring buffer. Since the buffer does not
+ * consume ring buffer space the whole buffer is always accepted at once and
+ * this call never blocks; the data is sent as flow control permits. The
+ * release callback is called once the peer has acknowledged all of the data, or
+ * the send part of the stream is discarded.
+ */
+QUIC_TAKES_LOCK
+int ossl_quic_write_ref(SSL *s, const void *buf, size_t len, uint64_t flags,
+    SSL_write_ref_release_cb_fn release_cb,
+    void *release_cb_arg, size_t *written)
+{
+    int ret = 0, err;
+    QCTX ctx;
+
+    *written = 0;
+
+    if (len == 0 || release_cb == NULL) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+
+    if (!expect_quic_with_stream_lock(s, /*remote_init=*/0, /*io=*/1, &ctx))
+        return 0;
+
+    if ((flags & ~SSL_WRITE_FLAG_CONCLUDE) != 0) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, SSL_R_UNSUPPORTED_WRITE_FLAG, NULL);
+        goto out;
+    }
+
+    if (!quic_mutation_allowed(ctx.qc, /*req_active=*/0)) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, SSL_R_PROTOCOL_IS_SHUTDOWN, NULL);
+        goto out;
+    }
+
+    if (quic_do_handshake(&ctx) < 1)
+        goto out;
+
+    if (!quic_validate_for_write(ctx.xso, &err)) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, err, NULL);
+        goto out;
+    }
+
+    if (!ossl_quic_sstream_append_ref(ctx.xso->stream->sstream, buf, len,
+            release_cb, release_cb_arg)) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+        goto out;
+    }
+
+    quic_post_write(ctx.xso, 1, 1, flags, qctx_should_autotick(&ctx));
+    *written = len;
+    ret = 1;
+out:
+    qctx_unlock(&ctx);
+    return ret;
+}
+
 /*
  * SSL_read
  * --------
@@ -2956,6 +3026,7 @@ struct quic_read_again_args {
     void *buf;
     size_t len;
     size_t *bytes_read;
+    const unsigned char **ref;
     int peek;
 };
 
@@ -3002,11 +3073,17 @@ static int quic_read_actual(QCTX *ctx,
     QUIC_STREAM *stream,
     void *buf, size_t buf_len,
     size_t *bytes_read,
+    const unsigned char **ref,
     int peek)
 {
     int is_fin = 0, err, eos;
     QUIC_CONNECTION *qc = ctx->qc;
 
+    /* No reads are permitted until a held reference has been released. */
+    if (ctx->xso->read_ref_held)
+        return QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED,
+            NULL);
+
     if (!quic_validate_for_read(ctx->xso, &err, &eos)) {
         if (eos) {
             ctx->xso->retired_fin = 1;
@@ -3016,7 +3093,29 @@ static int quic_read_actual(QCTX *ctx,
         }
     }
 
-    if (peek) {
+    if (ref != NULL) {
+        /*
+         * Lock the head record of the stream in place and hand it to the
+         * application. The bytes are retired (and RXFC credit released) in
+         * ossl_quic_read_ref_release().
+         */
+        if (!ossl_quic_rstream_get_record(stream->rstream, ref, bytes_read,
+                &is_fin))
+            return QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_INTERNAL_ERROR, NULL);
+
+        if (*bytes_read > 0) {
+            ctx->xso->read_ref_held = 1;
+            ctx->xso->read_ref_fin = is_fin;
+            ctx->xso->read_ref_len = *bytes_read;
+            return 1;
+        }
+
+        if (is_fin) {
+            QUIC_STREAM_MAP *qsm = ossl_quic_channel_get_qsm(ctx->qc->ch);
+
+            ossl_quic_stream_map_notify_totally_read(qsm, ctx->xso->stream);
+        }
+    } else if (peek) {
         if (!ossl_quic_rstream_peek(stream->rstream, buf, buf_len,
                 bytes_read, &is_fin))
             return QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_INTERNAL_ERROR, NULL);
@@ -3027,7 +3126,7 @@ static int quic_read_actual(QCTX *ctx,
             return QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_INTERNAL_ERROR, NULL);
     }
 
-    if (!peek) {
+    if (!peek && ref == NULL) {
         if (*bytes_read > 0) {
             /*
              * We have read at least one byte from the stream. Inform stream-level
@@ -3076,7 +3175,7 @@ static int quic_read_again(void *arg)
 
     if (!quic_read_actual(args->ctx, args->stream,
             args->buf, args->len, args->bytes_read,
-            args->peek))
+            args->ref, args->peek))
         return -1;
 
     if (*args->bytes_read > 0)
@@ -3087,7 +3186,8 @@ static int quic_read_again(void *arg)
 }
 
 QUIC_TAKES_LOCK
-static int quic_read(SSL *s, void *buf, size_t len, size_t *bytes_read, int peek)
+static int quic_read(SSL *s, void *buf, size_t len, size_t *bytes_read,
+    const unsigned char **ref, int peek)
 {
     int ret, res;
     QCTX ctx;
@@ -3121,7 +3221,8 @@ static int quic_read(SSL *s, void *buf, size_t len, size_t *bytes_read, int peek
         ctx.xso = ctx.qc->default_xso;
     }
 
-    if (!quic_read_actual(&ctx, ctx.xso->stream, buf, len, bytes_read, peek)) {
+    if (!quic_read_actual(&ctx, ctx.xso->stream, buf, len, bytes_read, ref,
+                peek)) {
         ret = 0; /* quic_read_actual raised error here */
         goto out;
     }
@@ -3149,6 +3250,7 @@ static int quic_read(SSL *s, void *buf, size_t len, size_t *bytes_read, int peek
         args.buf = buf;
         args.len = len;
         args.bytes_read = bytes_read;
+        args.ref = ref;
         args.peek = peek;
 
         res = block_until_pred(&ctx, quic_read_again, &args, 0);
@@ -3169,7 +3271,8 @@ static int quic_read(SSL *s, void *buf, size_t len, size_t *bytes_read, int peek
         qctx_maybe_autotick(&ctx);
 
         /* Try the read again. */
-        if (!quic_read_actual(&ctx, ctx.xso->stream, buf, len, bytes_read, peek)) {
+        if (!quic_read_actual(&ctx, ctx.xso->stream, buf, len, bytes_read, ref,
+                peek)) {
             ret = 0; /* quic_read_actual raised error here */
             goto out;
         }
@@ -3187,12 +3290,86 @@ out:
 
 int ossl_quic_read(SSL *s, void *buf, size_t len, size_t *bytes_read)
 {
-    return quic_read(s, buf, len, bytes_read, 0);
+    return quic_read(s, buf, len, bytes_read, NULL, 0);
 }
 
 int ossl_quic_peek(SSL *s, void *buf, size_t len, size_t *bytes_read)
 {
-    return quic_read(s, buf, len, bytes_read, 1);
+    return quic_read(s, buf, len, bytes_read, NULL, 1);
+}
+
+/*
+ * SSL_read_ref_ex
+ * ---------------
+ */
+int ossl_quic_read_ref(SSL *s, const unsigned char **buf, size_t *bytes_read)
+{
+    *buf = NULL;
+    return quic_read(s, NULL, 0, bytes_read, buf, 0);
+}
+
+QUIC_TAKES_LOCK
+int ossl_quic_read_ref_release(SSL *s, size_t num)
+{
+    int ret = 0;
+    QCTX ctx;
+    QUIC_XSO *xso;
+    QUIC_STREAM *qs;
+    QUIC_STREAM_MAP *qsm;
+    OSSL_RTT_INFO rtt_info;
+
+    if (!expect_quic_with_stream_lock(s, /*remote_init=*/-1, /*io=*/1, &ctx))
+        return 0;
+
+    xso = ctx.xso;
+    qs = xso->stream;
+    qsm = ossl_quic_channel_get_qsm(ctx.qc->ch);
+
+    if (!xso->read_ref_held || num > xso->read_ref_len) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_PASSED_INVALID_ARGUMENT, NULL);
+        goto out;
+    }
+
+    if (!ossl_assert(qs->rstream != NULL)
+        || !ossl_quic_rstream_release_record(qs->rstream, num)) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+        goto out;
+    }
+
+    xso->read_ref_held = 0;
+
+    if (qs->recv_state == QUIC_RSTREAM_STATE_RESET_RECVD
+        || qs->recv_state == QUIC_RSTREAM_STATE_RESET_READ) {
+        /*
+         * The stream was reset while the reference was held; the QUIC_RSTREAM
+         * was kept alive only for the benefit of the application.
+         */
+        ossl_quic_rstream_free(qs->rstream);
+        qs->rstream = NULL;
+        ret = 1;
+        goto out;
+    }
+
+    if (num > 0) {
+        ossl_statm_get_rtt_info(ossl_quic_channel_get_statm(ctx.qc->ch),
+            &rtt_info);
+
+        if (!ossl_quic_rxfc_on_retire(&qs->rxfc, num, rtt_info.smoothed_rtt)) {
+            QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+            goto out;
+        }
+    }
+
+    if (xso->read_ref_fin && num == xso->read_ref_len)
+        ossl_quic_stream_map_notify_totally_read(qsm, qs);
+
+    if (num > 0)
+        ossl_quic_stream_map_update_state(qsm, qs);
+
+    ret = 1;
+out:
+    qctx_unlock(&ctx);
+    return ret;
 }
 
 /*
@@ -4026,6 +4203,153 @@ static int qc_getset_max_pending_channels(QCTX *ctx, uint32_t class_,
     return ret;
 }
 
+QUIC_TAKES_LOCK
+static int qc_getset_handshake_threads(QCTX *ctx, uint32_t class_,
+    uint64_t *p_value_out, uint64_t *p_value_in)
+{
+    int ret = 0;
+    uint64_t value_out = 0;
+
+    qctx_lock(ctx);
+
+    if (class_ != SSL_VALUE_CLASS_GENERIC || !ctx->is_listener) {
+        QUIC_RAISE_NON_NORMAL_ERROR(ctx, SSL_R_UNSUPPORTED_CONFIG_VALUE_CLASS,
+            NULL);
+        goto err;
+    }
+
+#if !defined(OPENSSL_THREADS)
+    if (p_value_in != NULL && *p_value_in != 0) {
+        QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_UNSUPPORTED, NULL);
+        goto err;
+    }
+#endif
+
+    value_out = ossl_quic_port_get_max_handshake_threads(ctx->ql->port);
+    if (p_value_in != NULL)
+        ossl_quic_port_set_max_handshake_threads(ctx->ql->port, *p_value_in);
+
+    ret = 1;
+err:
+    qctx_unlock(ctx);
+    if (ret && p_value_out != NULL)
+        *p_value_out = value_out;
+
+    return ret;
+}
+
+QUIC_TAKES_LOCK
+static int qc_getset_cid_shard(QCTX *ctx, uint32_t class_, int is_count,
+    uint64_t *p_value_out, uint64_t *p_value_in)
+{
+    int ret = 0;
+    uint64_t value_out = 0;
+
+    qctx_lock(ctx);
+
+    if (class_ != SSL_VALUE_CLASS_GENERIC || !ctx->is_listener) {
+        QUIC_RAISE_NON_NORMAL_ERROR(ctx, SSL_R_UNSUPPORTED_CONFIG_VALUE_CLASS,
+            NULL);
+        goto err;
+    }
+
+    value_out = is_count
+        ? ossl_quic_port_get_cid_shard_count(ctx->ql->port)
+        : ossl_quic_port_get_cid_shard_id(ctx->ql->port);
+
+    if (p_value_in != NULL) {
+        if (ctx->ql->listening) {
+            QUIC_RAISE_NON_NORMAL_ERROR(ctx, SSL_R_FEATURE_NOT_RENEGOTIABLE,
+                NULL);
+            goto err;
+        }
+
+        if (*p_value_in > (is_count ? 256 : 255)) {
+            QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_PASSED_INVALID_ARGUMENT,
+                NULL);
+            goto err;
+        }
+
+        if (is_count)
+            ossl_quic_port_set_cid_shard_count(ctx->ql->port, *p_value_in);
+        else
+            ossl_quic_port_set_cid_shard_id(ctx->ql->port, *p_value_in);
+    }
+
+    ret = 1;
+err:
+    qctx_unlock(ctx);
+    if (ret && p_value_out != NULL)
+        *p_value_out = value_out;
+
+    return ret;
+}
+
+QUIC_TAKES_LOCK
+static int qc_getset_cc_algorithm(QCTX *ctx, uint32_t class_,
+    uint64_t *p_value_out, uint64_t *p_value_in)
+{
+    int ret = 0;
+    uint64_t value_out = 0;
+
+    qctx_lock(ctx);
+
+    if (class_ != SSL_VALUE_CLASS_GENERIC) {
+        QUIC_RAISE_NON_NORMAL_ERROR(ctx, SSL_R_UNSUPPORTED_CONFIG_VALUE_CLASS,
+            NULL);
+        goto err;
+    }
+
+    value_out = ctx->is_listener
+        ? ossl_quic_port_get_cc_algorithm(ctx->ql->port)
+        : ossl_quic_channel_get_cc_algorithm(ctx->qc->ch);
+
+    if (p_value_in != NULL) {
+        if (ossl_cc_method_by_algorithm(*p_value_in) == NULL) {
+            QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_PASSED_INVALID_ARGUMENT,
+                NULL);
+            goto err;
+        }
+
+        if (ctx->is_listener) {
+            ossl_quic_port_set_cc_algorithm(ctx->ql->port, *p_value_in);
+        } else if (!ossl_quic_channel_set_cc_algorithm(ctx->qc->ch,
+                       *p_value_in)) {
+            QUIC_RAISE_NON_NORMAL_ERROR(ctx, SSL_R_FEATURE_NOT_RENEGOTIABLE,
+                NULL);
+            goto err;
+        }
+    }
+
+    ret = 1;
+err:
+    qctx_unlock(ctx);
+    if (ret && p_value_out != NULL)
+        *p_value_out = value_out;
+
+    return ret;
+}
+
+QUIC_TAKES_LOCK
+static int qc_get_pacing_stat(QCTX *ctx, uint32_t class_,
+    int is_deferrals, uint64_t *value)
+{
+    if (class_ != SSL_VALUE_CLASS_GENERIC) {
+        QUIC_RAISE_NON_NORMAL_ERROR(ctx, SSL_R_UNSUPPORTED_CONFIG_VALUE_CLASS,
+            NULL);
+        return 0;
+    }
+
+    qctx_lock(ctx);
+
+    *value = is_deferrals
+        ? ossl_quic_channel_get_pacing_deferrals(ctx->qc->ch)
+        : ossl_quic_channel_get_pacing_rate(ctx->qc->ch);
+
+    qctx_unlock(ctx);
+    return 1;
+}
+
 QUIC_TAKES_LOCK
 static int qc_get_stream_avail(QCTX *ctx, uint32_t class_,
     int is_uni, int is_remote,
@@ -4169,6 +4493,10 @@ static int expect_quic_for_value(SSL *s, QCTX *ctx, uint32_t id)
     case SSL_VALUE_QUIC_ACK_DELAY_EXPONENT:
     case SSL_VALUE_QUIC_ACK_DELAY_MAX:
     case SSL_VALUE_QUIC_MAX_PENDING_CONNS:
+    case SSL_VALUE_QUIC_CID_SHARD_ID:
+    case SSL_VALUE_QUIC_CID_SHARD_COUNT:
+    case SSL_VALUE_QUIC_CC_ALGORITHM:
+    case SSL_VALUE_QUIC_HANDSHAKE_THREADS:
         return expect_quic_cl(s, ctx);
     default:
         return expect_quic_conn_only(s, ctx);
@@ -4205,6 +4533,18 @@ int ossl_quic_get_value_uint(SSL *s, uint32_t class_, uint32_t id,
         return qc_getset_max_ack_delay(&ctx, class_, value, NULL);
     case SSL_VALUE_QUIC_MAX_PENDING_CONNS:
         return qc_getset_max_pending_channels(&ctx, class_, value, NULL);
+    case SSL_VALUE_QUIC_CID_SHARD_ID:
+        return qc_getset_cid_shard(&ctx, class_, /*is_count=*/0, value, NULL);
+    case SSL_VALUE_QUIC_CID_SHARD_COUNT:
+        return qc_getset_cid_shard(&ctx, class_, /*is_count=*/1, value, NULL);
+    case SSL_VALUE_QUIC_CC_ALGORITHM:
+        return qc_getset_cc_algorithm(&ctx, class_, value, NULL);
+    case SSL_VALUE_QUIC_PACING_RATE:
+        return qc_get_pacing_stat(&ctx, class_, /*is_deferrals=*/0, value);
+    case SSL_VALUE_QUIC_PACING_DEFERRALS:
+        return qc_get_pacing_stat(&ctx, class_, /*is_deferrals=*/1, value);
+    case SSL_VALUE_QUIC_HANDSHAKE_THREADS:
+        return qc_getset_handshake_threads(&ctx, class_, value, NULL);
 
     case SSL_VALUE_QUIC_STREAM_BIDI_LOCAL_AVAIL:
         return qc_get_stream_avail(&ctx, class_, /*uni=*/0, /*remote=*/0, value);
@@ -4265,6 +4605,14 @@ int ossl_quic_set_value_uint(SSL *s, uint32_t class_, uint32_t id,
         return qc_getset_max_ack_delay(&ctx, class_, NULL, &value);
     case SSL_VALUE_QUIC_MAX_PENDING_CONNS:
         return qc_getset_max_pending_channels(&ctx, class_, NULL, &value);
+    case SSL_VALUE_QUIC_CID_SHARD_ID:
+        return qc_getset_cid_shard(&ctx, class_, /*is_count=*/0, NULL, &value);
+    case SSL_VALUE_QUIC_CID_SHARD_COUNT:
+        return qc_getset_cid_shard(&ctx, class_, /*is_count=*/1, NULL, &value);
+    case SSL_VALUE_QUIC_CC_ALGORITHM:
+        return qc_getset_cc_algorithm(&ctx, class_, NULL, &value);
+    case SSL_VALUE_QUIC_HANDSHAKE_THREADS:
+        return qc_getset_handshake_threads(&ctx, class_, NULL, &value);
 
     default:
         return QUIC_RAISE_NON_NORMAL_ERROR(&ctx,
@@ -4743,6 +5091,8 @@ SSL *ossl_quic_new_listener(SSL_CTX *ctx, uint64_t flags)
 
     if (need_notifier_for_domain_flags(ctx->domain_flags))
         engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_NOTIFIER;
+    if ((ctx->domain_flags & SSL_DOMAIN_FLAG_EPOLL) != 0)
+        engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_POLL_SET;
 
     if ((ql->engine = ossl_quic_engine_new(&engine_args)) == NULL) {
         QUIC_RAISE_NON_NORMAL_ERROR(NULL, ERR_R_INTERNAL_ERROR, NULL);
@@ -4992,6 +5342,9 @@ static int ql_listen(QUIC_LISTENER *ql)
     if (ql->listening)
         return 1;
 
+    if (!ossl_quic_port_apply_cid_sharding(ql->port))
+        return 0;
+
     ossl_quic_port_set_allow_incoming(ql->port, 1);
     ql->listening = 1;
     return 1;
@@ -5578,6 +5931,8 @@ SSL *ossl_quic_new_domain(SSL_CTX *ctx, uint64_t flags)
 
     if (need_notifier_for_domain_flags(domain_flags))
         engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_NOTIFIER;
+    if ((domain_flags & SSL_DOMAIN_FLAG_EPOLL) != 0)
+        engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_POLL_SET;
 
     if ((qd->engine = ossl_quic_engine_new(&engine_args)) == NULL) {
         QUIC_RAISE_NON_NORMAL_ERROR(NULL, ERR_R_INTERNAL_ERROR, NULL);
@@ -5911,6 +6266,45 @@ end:
     return nfd;
 }
 
+QUIC_TAKES_LOCK
+int ossl_quic_get_poll_set_fd(SSL *ssl, int rfd, int wfd)
+{
+    QCTX ctx;
+    QUIC_ENGINE *engine;
+    QUIC_REACTOR *rtor;
+    const BIO_POLL_DESCRIPTOR *r, *w;
+    int fd = -1;
+
+    if (!expect_quic_any(ssl, &ctx))
+        return -1;
+
+    qctx_lock(&ctx);
+    rtor = ossl_quic_obj_get0_reactor(ctx.obj);
+    if (ossl_quic_reactor_get_poll_set_fd(rtor) == -1)
+        goto end;
+
+    /*
+     * The poll set follows the descriptors known to the reactor, which can lag
+     * behind the network BIOs (e.g. BIO_s_connect creates its socket late).
+     */
+    engine = ossl_quic_obj_get0_engine(ctx.obj);
+    ossl_quic_engine_update_poll_descriptors(engine, /*force=*/0);
+
+    r = ossl_quic_reactor_get_poll_r(rtor);
+    w = ossl_quic_reactor_get_poll_w(rtor);
+    if ((rfd != -1
+            && (r->type != BIO_POLL_DESCRIPTOR_TYPE_SOCK_FD || r->value.fd != rfd))
+        || (wfd != -1
+            && (w->type != BIO_POLL_DESCRIPTOR_TYPE_SOCK_FD || w->value.fd != wfd)))
+        ossl_quic_engine_update_poll_descriptors(engine, /*force=*/1);
+
+    fd = ossl_quic_reactor_get_poll_set_fd(rtor);
+
+end:
+    qctx_unlock(&ctx);
+    return fd;
+}
+
 QUIC_TAKES_LOCK
 void ossl_quic_enter_blocking_section(SSL *ssl, QUIC_REACTOR_WAIT_CTX *wctx)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -33,12 +33,15 @@ typedef struct quic_lcid_st {
     QUIC_CONN_ID cid;
     uint64_t seq_num;
 
-    /* copy of the hash key from lcidm */
-    uint64_t *hash_key;
+    /* Keyed hash of cid, computed once on creation */
+    uint64_t hash;
 
     /* Back-pointer to the owning QUIC_LCIDM_CONN structure. */
     QUIC_LCIDM_CONN *conn;
 
+    /* Copy of conn->opaque, saving a dereference on lookup */
+    void *opaque;
+
     /* LCID_TYPE_* */
     unsigned int type : 2;
 } QUIC_LCID;
@@ -57,42 +60,62 @@ struct quic_lcidm_conn_st {
     unsigned int done_odcid : 1;
 };
 
+/*
+ * The LCIDs of all connections are indexed in a single open-addressed table
+ * with linear probing, consulted to route every incoming datagram. Each slot
+ * holds the full hash of the LCID next to the pointer to it, so that a lookup
+ * normally touches one slot and the matching QUIC_LCID only, instead of
+ * walking LHASH bucket nodes. The table is kept at most half full.
+ */
+typedef struct lcid_slot_st {
+    uint64_t hash;
+    QUIC_LCID *lcid_obj; /* NULL if slot is empty */
+} LCID_SLOT;
+
+#define LCID_INDEX_MIN_SLOTS 16
+
 struct quic_lcidm_st {
     OSSL_LIB_CTX *libctx;
     uint64_t hash_key[2]; /* random key for siphash */
-    LHASH_OF(QUIC_LCID) *lcids; /* (QUIC_CONN_ID) -> (QUIC_LCID *)  */
+    LCID_SLOT *index; /* (QUIC_CONN_ID) -> (QUIC_LCID *) */
+    size_t index_mask; /* number of slots - 1 */
+    size_t index_used; /* number of occupied slots */
     LHASH_OF(QUIC_LCIDM_CONN) *conns; /* (void *opaque) -> (QUIC_LCIDM_CONN *) */
     size_t lcid_len; /* Length in bytes for all LCIDs */
+    int shard; /* Value of first LCID byte, or -1 */
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
     QUIC_CONN_ID next_lcid;
 #endif
 };
 
-static unsigned long lcid_hash(const QUIC_LCID *lcid_obj)
+static uint64_t lcidm_hash_cid(const QUIC_LCIDM *lcidm,
+    const QUIC_CONN_ID *cid)
 {
     SIPHASH siphash = {
         0,
     };
-    unsigned long hashval = 0;
+    uint64_t hashval = 0;
     unsigned char digest[SIPHASH_MIN_DIGEST_SIZE];
 
     /* Use a supported SipHash digest size (8 or 16); 8 is sufficient here. */
     if (!SipHash_set_hash_size(&siphash, SIPHASH_MIN_DIGEST_SIZE))
         goto out;
-    if (!SipHash_Init(&siphash, (uint8_t *)lcid_obj->hash_key, 0, 0))
+    if (!SipHash_Init(&siphash, (const uint8_t *)lcidm->hash_key, 0, 0))
         goto out;
-    SipHash_Update(&siphash, lcid_obj->cid.id, lcid_obj->cid.id_len);
+    SipHash_Update(&siphash, cid->id, cid->id_len);
     if (!SipHash_Final(&siphash, digest, SIPHASH_MIN_DIGEST_SIZE))
         goto out;
 
-    /*
-     * Truncate the 64-bit SipHash digest into an unsigned long.
-     */
-    memcpy(&hashval, digest, sizeof(hashval) < sizeof(digest) ? sizeof(hashval) : sizeof(digest));
+    memcpy(&hashval, digest, sizeof(hashval));
 out:
     return hashval;
 }
 
+static unsigned long lcid_hash(const QUIC_LCID *lcid_obj)
+{
+    return (unsigned long)lcid_obj->hash;
+}
+
 static int lcid_comp(const QUIC_LCID *a, const QUIC_LCID *b)
 {
     return !ossl_quic_conn_id_eq(&a->cid, &b->cid);
@@ -123,9 +146,12 @@ QUIC_LCIDM *ossl_quic_lcidm_new(OSSL_LIB_CTX *libctx, size_t lcid_len)
             sizeof(uint64_t) * 2, 0))
         goto err;
 
-    if ((lcidm->lcids = lh_QUIC_LCID_new(lcid_hash, lcid_comp)) == NULL)
+    lcidm->index = OPENSSL_calloc(LCID_INDEX_MIN_SLOTS, sizeof(*lcidm->index));
+    if (lcidm->index == NULL)
         goto err;
 
+    lcidm->index_mask = LCID_INDEX_MIN_SLOTS - 1;
+
     if ((lcidm->conns = lh_QUIC_LCIDM_CONN_new(lcidm_conn_hash,
              lcidm_conn_comp))
         == NULL)
@@ -133,11 +159,12 @@ QUIC_LCIDM *ossl_quic_lcidm_new(OSSL_LIB_CTX *libctx, size_t lcid_len)
 
     lcidm->libctx = libctx;
     lcidm->lcid_len = lcid_len;
+    lcidm->shard = -1;
     return lcidm;
 
 err:
     if (lcidm != NULL) {
-        lh_QUIC_LCID_free(lcidm->lcids);
+        OPENSSL_free(lcidm->index);
         lh_QUIC_LCIDM_CONN_free(lcidm->conns);
         OPENSSL_free(lcidm);
     }
@@ -177,22 +204,120 @@ void ossl_quic_lcidm_free(QUIC_LCIDM *lcidm)
 
     lh_QUIC_LCIDM_CONN_doall_arg(lcidm->conns, lcidm_delete_conn_, lcidm);
 
-    lh_QUIC_LCID_free(lcidm->lcids);
+    OPENSSL_free(lcidm->index);
     lh_QUIC_LCIDM_CONN_free(lcidm->conns);
     OPENSSL_free(lcidm);
 }
 
-static QUIC_LCID *lcidm_get0_lcid(const QUIC_LCIDM *lcidm, const QUIC_CONN_ID *lcid)
+/*
+ * Places lcid_obj in the first free slot of its probe sequence. The caller
+ * ensures there is a free slot.
+ */
+static void lcidm_index_place(LCID_SLOT *index, size_t mask,
+    QUIC_LCID *lcid_obj)
+{
+    size_t i = (size_t)lcid_obj->hash & mask;
+
+    while (index[i].lcid_obj != NULL)
+        i = (i + 1) & mask;
+
+    index[i].hash = lcid_obj->hash;
+    index[i].lcid_obj = lcid_obj;
+}
+
+static int lcidm_index_resize(QUIC_LCIDM *lcidm, size_t num_slots)
+{
+    LCID_SLOT *index;
+    size_t i;
+
+    if ((index = OPENSSL_calloc(num_slots, sizeof(*index))) == NULL)
+        return 0;
+
+    for (i = 0; i <= lcidm->index_mask; ++i)
+        if (lcidm->index[i].lcid_obj != NULL)
+            lcidm_index_place(index, num_slots - 1, lcidm->index[i].lcid_obj);
+
+    OPENSSL_free(lcidm->index);
+    lcidm->index = index;
+    lcidm->index_mask = num_slots - 1;
+    return 1;
+}
+
+static QUIC_LCID *lcidm_index_find(const QUIC_LCIDM *lcidm,
+    const QUIC_CONN_ID *cid, uint64_t hash)
+{
+    const LCID_SLOT *slot;
+    size_t i = (size_t)hash & lcidm->index_mask;
+
+    for (;; i = (i + 1) & lcidm->index_mask) {
+        slot = &lcidm->index[i];
+        if (slot->lcid_obj == NULL)
+            return NULL;
+
+        if (slot->hash == hash && ossl_quic_conn_id_eq(&slot->lcid_obj->cid, cid))
+            return slot->lcid_obj;
+    }
+}
+
+static int lcidm_index_insert(QUIC_LCIDM *lcidm, QUIC_LCID *lcid_obj)
+{
+    size_t num_slots = lcidm->index_mask + 1;
+
+    if ((lcidm->index_used + 1) * 2 > num_slots
+        && !lcidm_index_resize(lcidm, num_slots * 2))
+        return 0;
+
+    lcidm_index_place(lcidm->index, lcidm->index_mask, lcid_obj);
+    ++lcidm->index_used;
+    return 1;
+}
+
+static void lcidm_index_delete(QUIC_LCIDM *lcidm, QUIC_LCID *lcid_obj)
 {
-    QUIC_LCID key;
+    size_t mask = lcidm->index_mask, i, j, home;
+
+    for (i = (size_t)lcid_obj->hash & mask; lcidm->index[i].lcid_obj != lcid_obj;
+        i = (i + 1) & mask)
+        if (!ossl_assert(lcidm->index[i].lcid_obj != NULL))
+            return;
+
+    /*
+     * Backward-shift deletion: move later members of the probe cluster into
+     * the vacated slot where their probe sequence allows it, so that lookups
+     * never need tombstones.
+     */
+    for (j = i;;) {
+        lcidm->index[i].lcid_obj = NULL;
+
+        for (;;) {
+            j = (j + 1) & mask;
+            if (lcidm->index[j].lcid_obj == NULL)
+                goto done;
 
-    key.cid = *lcid;
-    key.hash_key = (uint64_t *)lcidm->hash_key;
+            home = (size_t)lcidm->index[j].hash & mask;
+            if (((j - home) & mask) >= ((j - i) & mask))
+                break;
+        }
 
-    if (key.cid.id_len > QUIC_MAX_CONN_ID_LEN)
+        lcidm->index[i] = lcidm->index[j];
+        i = j;
+    }
+
+done:
+    --lcidm->index_used;
+
+    /* Shrinking is best effort. */
+    if (lcidm->index_mask + 1 > LCID_INDEX_MIN_SLOTS
+        && lcidm->index_used * 8 < lcidm->index_mask + 1)
+        lcidm_index_resize(lcidm, (lcidm->index_mask + 1) / 2);
+}
+
+static QUIC_LCID *lcidm_get0_lcid(const QUIC_LCIDM *lcidm, const QUIC_CONN_ID *lcid)
+{
+    if (lcid->id_len > QUIC_MAX_CONN_ID_LEN)
         return NULL;
 
-    return lh_QUIC_LCID_retrieve(lcidm->lcids, &key);
+    return lcidm_index_find(lcidm, lcid, lcidm_hash_cid(lcidm, lcid));
 }
 
 static QUIC_LCIDM_CONN *lcidm_get0_conn(const QUIC_LCIDM *lcidm, void *opaque)
@@ -235,7 +360,7 @@ err:
 
 static void lcidm_delete_conn_lcid(QUIC_LCIDM *lcidm, QUIC_LCID *lcid_obj)
 {
-    lh_QUIC_LCID_delete(lcidm->lcids, lcid_obj);
+    lcidm_index_delete(lcidm, lcid_obj);
     lh_QUIC_LCID_delete(lcid_obj->conn->lcids, lcid_obj);
     assert(lcid_obj->conn->num_active_lcid > 0);
     --lcid_obj->conn->num_active_lcid;
@@ -272,14 +397,14 @@ static QUIC_LCID *lcidm_conn_new_lcid(QUIC_LCIDM *lcidm, QUIC_LCIDM_CONN *conn,
 
     lcid_obj->cid = *lcid;
     lcid_obj->conn = conn;
-    lcid_obj->hash_key = lcidm->hash_key;
+    lcid_obj->opaque = conn->opaque;
+    lcid_obj->hash = lcidm_hash_cid(lcidm, lcid);
 
     lh_QUIC_LCID_insert(conn->lcids, lcid_obj);
     if (lh_QUIC_LCID_error(conn->lcids))
         goto err;
 
-    lh_QUIC_LCID_insert(lcidm->lcids, lcid_obj);
-    if (lh_QUIC_LCID_error(lcidm->lcids)) {
+    if (!lcidm_index_insert(lcidm, lcid_obj)) {
         lh_QUIC_LCID_delete(conn->lcids, lcid_obj);
         goto err;
     }
@@ -297,6 +422,20 @@ size_t ossl_quic_lcidm_get_lcid_len(const QUIC_LCIDM *lcidm)
     return lcidm->lcid_len;
 }
 
+int ossl_quic_lcidm_set_shard(QUIC_LCIDM *lcidm, int shard)
+{
+    if (shard < -1 || shard > 255 || (shard >= 0 && lcidm->lcid_len == 0))
+        return 0;
+
+    lcidm->shard = shard;
+    return 1;
+}
+
+int ossl_quic_lcidm_get_shard(const QUIC_LCIDM *lcidm)
+{
+    return lcidm->shard;
+}
+
 size_t ossl_quic_lcidm_get_num_active_lcid(const QUIC_LCIDM *lcidm,
     void *opaque)
 {
@@ -321,11 +460,15 @@ static int lcidm_generate_cid(QUIC_LCIDM *lcidm,
     for (i = lcidm->lcid_len - 1; i >= 0; --i)
         if (++lcidm->next_lcid.id[i] != 0)
             break;
-
-    return 1;
 #else
-    return ossl_quic_gen_rand_conn_id(lcidm->libctx, lcidm->lcid_len, cid);
+    if (!ossl_quic_gen_rand_conn_id(lcidm->libctx, lcidm->lcid_len, cid))
+        return 0;
 #endif
+
+    if (lcidm->shard >= 0)
+        cid->id[0] = (unsigned char)lcidm->shard;
+
+    return 1;
 }
 
 static int lcidm_generate(QUIC_LCIDM *lcidm,
@@ -335,7 +478,7 @@ static int lcidm_generate(QUIC_LCIDM *lcidm,
     uint64_t *seq_num)
 {
     QUIC_LCIDM_CONN *conn;
-    QUIC_LCID key, *lcid_obj;
+    QUIC_LCID *lcid_obj;
     size_t i;
 #define MAX_RETRIES 8
 
@@ -358,11 +501,8 @@ static int lcidm_generate(QUIC_LCIDM *lcidm,
         if (!lcidm_generate_cid(lcidm, lcid_out))
             return 0;
 
-        key.cid = *lcid_out;
-        key.hash_key = lcidm->hash_key;
-
         /* If a collision occurs, retry. */
-    } while (lh_QUIC_LCID_retrieve(lcidm->lcids, &key) != NULL);
+    } while (lcidm_get0_lcid(lcidm, lcid_out) != NULL);
 
     if ((lcid_obj = lcidm_conn_new_lcid(lcidm, conn, lcid_out)) == NULL)
         return 0;
@@ -382,7 +522,7 @@ int ossl_quic_lcidm_enrol_odcid(QUIC_LCIDM *lcidm,
     const QUIC_CONN_ID *initial_odcid)
 {
     QUIC_LCIDM_CONN *conn;
-    QUIC_LCID key, *lcid_obj;
+    QUIC_LCID *lcid_obj;
 
     if (initial_odcid == NULL || initial_odcid->id_len < QUIC_MIN_ODCID_LEN
         || initial_odcid->id_len > QUIC_MAX_CONN_ID_LEN)
@@ -394,9 +534,7 @@ int ossl_quic_lcidm_enrol_odcid(QUIC_LCIDM *lcidm,
     if (conn->done_odcid)
         return 0;
 
-    key.cid = *initial_odcid;
-    key.hash_key = lcidm->hash_key;
-    if (lh_QUIC_LCID_retrieve(lcidm->lcids, &key) != NULL)
+    if (lcidm_get0_lcid(lcidm, initial_odcid) != NULL)
         return 0;
 
     if ((lcid_obj = lcidm_conn_new_lcid(lcidm, conn, initial_odcid)) == NULL)
@@ -567,7 +705,7 @@ int ossl_quic_lcidm_lookup(QUIC_LCIDM *lcidm,
         *seq_num = lcid_obj->seq_num;
 
     if (opaque != NULL)
-        *opaque = lcid_obj->conn->opaque;
+        *opaque = lcid_obj->opaque;
 
     return 1;
 }
@@ -575,11 +713,9 @@ int ossl_quic_lcidm_lookup(QUIC_LCIDM *lcidm,
 int ossl_quic_lcidm_debug_remove(QUIC_LCIDM *lcidm,
     const QUIC_CONN_ID *lcid)
 {
-    QUIC_LCID key, *lcid_obj;
+    QUIC_LCID *lcid_obj;
 
-    key.cid = *lcid;
-    key.hash_key = lcidm->hash_key;
-    if ((lcid_obj = lh_QUIC_LCID_retrieve(lcidm->lcids, &key)) == NULL)
+    if ((lcid_obj = lcidm_get0_lcid(lcidm, lcid)) == NULL)
         return 0;
 
     lcidm_delete_conn_lcid(lcidm, lcid_obj);
@@ -591,7 +727,7 @@ int ossl_quic_lcidm_debug_add(QUIC_LCIDM *lcidm, void *opaque,
     uint64_t seq_num)
 {
     QUIC_LCIDM_CONN *conn;
-    QUIC_LCID key, *lcid_obj;
+    QUIC_LCID *lcid_obj;
 
     if (lcid == NULL || lcid->id_len > QUIC_MAX_CONN_ID_LEN)
         return 0;
@@ -599,9 +735,7 @@ int ossl_quic_lcidm_debug_add(QUIC_LCIDM *lcidm, void *opaque,
     if ((conn = lcidm_upsert_conn(lcidm, opaque)) == NULL)
         return 0;
 
-    key.cid = *lcid;
-    key.hash_key = lcidm->hash_key;
-    if (lh_QUIC_LCID_retrieve(lcidm->lcids, &key) != NULL)
+    if (lcidm_get0_lcid(lcidm, lcid) != NULL)
         return 0;
 
     if ((lcid_obj = lcidm_conn_new_lcid(lcidm, conn, lcid)) == NULL)
@@ -51,6 +51,16 @@ struct quic_xso_st {
      */
     unsigned int requested_reset : 1;
 
+    /*
+     * The application holds a reference to received stream data obtained via
+     * SSL_read_ref_ex() which has not yet been returned with
+     * SSL_read_ref_release(). read_ref_fin is set if the referenced record
+     * ends at the final size of the stream.
+     */
+    unsigned int read_ref_held : 1;
+    unsigned int read_ref_fin : 1;
+    size_t read_ref_len;
+
     /*
      * This state tracks SSL_write all-or-nothing (AON) write semantics
      * emulation.
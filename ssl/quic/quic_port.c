@@ -7,6 +7,7 @@
  * https://www.openssl.org/source/license.html
  */
 
+#include "internal/sockets.h"
 #include "internal/quic_port.h"
 #include "internal/quic_channel.h"
 #include "internal/quic_lcidm.h"
@@ -19,6 +20,10 @@
 #include "quic_local.h"
 #include "../ssl_local.h"
 #include <openssl/rand.h>
+#if defined(OPENSSL_SYS_LINUX) && defined(SO_ATTACH_REUSEPORT_CBPF)
+#include <linux/filter.h>
+#define SUPPORT_CID_STEERING
+#endif
 
 /*
  * QUIC Port Structure
@@ -464,6 +469,13 @@ int ossl_quic_port_set_net_rbio(QUIC_PORT *port, BIO *net_rbio)
     ossl_quic_demux_set_bio(port->demux, net_rbio);
     port->net_rbio = net_rbio;
     port_update_addressing_mode(port);
+
+    /*
+     * Best effort: have the network BIO coalesce incoming datagrams so that a
+     * single receive syscall can return many of them.
+     */
+    port->rx_coalescing = net_rbio != NULL
+        && BIO_dgram_set_rx_coalescing(net_rbio, 1) > 0;
     return 1;
 }
 
@@ -482,6 +494,13 @@ int ossl_quic_port_set_net_wbio(QUIC_PORT *port, BIO *net_wbio)
 
     port->net_wbio = net_wbio;
     port_update_addressing_mode(port);
+
+    /*
+     * Best effort: let the network BIO hand runs of equally sized datagrams to
+     * the OS as a single segmented send.
+     */
+    if (net_wbio != NULL)
+        (void)BIO_dgram_set_tx_segmentation(net_wbio, 1);
     return 1;
 }
 
@@ -611,6 +630,7 @@ static QUIC_CHANNEL *port_make_channel(QUIC_PORT *port, SSL *tls, OSSL_QRX *qrx,
     args.max_ack_delay = port->max_ack_delay;
     args.disable_active_migration = port->disable_active_migration;
     args.active_conn_id_limit = port->active_conn_id_limit;
+    args.cc_algorithm = port->cc_algorithm;
 
     /*
      * Creating a new channel is made a bit tricky here as there is a
@@ -699,21 +719,40 @@ QUIC_CHANNEL *ossl_quic_port_create_incoming(QUIC_PORT *port, SSL *tls)
     return ch;
 }
 
+/*
+ * Returns the first channel in the accept queue which can be handed out, which
+ * excludes channels with a handshake step running on a worker thread.
+ */
+static QUIC_CHANNEL *port_peek_incoming(QUIC_PORT *port)
+{
+    QUIC_CHANNEL *ch;
+
+    for (ch = ossl_list_incoming_ch_head(&port->incoming_channel_list);
+        ch != NULL && ossl_quic_channel_has_tls_job(ch);
+        ch = ossl_list_incoming_ch_next(ch))
+        ;
+
+    return ch;
+}
+
 QUIC_CHANNEL *ossl_quic_port_pop_incoming(QUIC_PORT *port)
 {
     QUIC_CHANNEL *ch;
 
-    ch = ossl_list_incoming_ch_head(&port->incoming_channel_list);
+    ch = port_peek_incoming(port);
     if (ch == NULL)
         return NULL;
 
     ossl_list_incoming_ch_remove(&port->incoming_channel_list, ch);
+
+    /* The application may now use the channel; keep its handshake here. */
+    ossl_quic_channel_set_tls_offload(ch, 0);
     return ch;
 }
 
 int ossl_quic_port_have_incoming(QUIC_PORT *port)
 {
-    return ossl_list_incoming_ch_head(&port->incoming_channel_list) != NULL;
+    return port_peek_incoming(port) != NULL;
 }
 
 void ossl_quic_port_drop_incoming(QUIC_PORT *port)
@@ -724,10 +763,12 @@ void ossl_quic_port_drop_incoming(QUIC_PORT *port)
     SSL_CONNECTION *sc;
 
     for (;;) {
-        ch = ossl_quic_port_pop_incoming(port);
+        ch = ossl_list_incoming_ch_head(&port->incoming_channel_list);
         if (ch == NULL)
             break;
 
+        ossl_list_incoming_ch_remove(&port->incoming_channel_list, ch);
+
         tls = ossl_quic_channel_get0_tls(ch);
         /*
          * The user ssl may or may not have been created via the
@@ -841,6 +882,16 @@ static void port_rx_pre(QUIC_PORT *port)
      * to the appropriate QRX instances.
      */
     ret = ossl_quic_demux_pump(port->demux);
+
+    /*
+     * A coalescing network BIO may be holding segments of a datagram it has
+     * already read from the socket. These will not make the socket readable
+     * again, so drain them now rather than waiting for the next tick.
+     */
+    while (ret == QUIC_DEMUX_PUMP_RES_OK && port->rx_coalescing
+        && BIO_ctrl_pending(port->net_rbio) > 0)
+        ret = ossl_quic_demux_pump(port->demux);
+
     if (ret == QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL)
         /*
          * We don't care about transient failure, but permanent failure means we
@@ -925,6 +976,7 @@ static void port_bind_channel(QUIC_PORT *port, const BIO_ADDR *peer,
     }
 
     ossl_list_incoming_ch_insert_tail(&port->incoming_channel_list, ch);
+    ossl_quic_channel_set_tls_offload(ch, 1);
     *new_ch = ch;
 }
 
@@ -2007,3 +2059,125 @@ void ossl_quic_port_set_max_pending_channels(QUIC_PORT *port, uint64_t max_pendi
 {
     port->max_pending_channels = max_pending_channels;
 }
+
+uint64_t ossl_quic_port_get_cid_shard_id(const QUIC_PORT *port)
+{
+    return port->cid_shard_id;
+}
+
+void ossl_quic_port_set_cid_shard_id(QUIC_PORT *port, uint64_t id)
+{
+    port->cid_shard_id = id;
+}
+
+uint64_t ossl_quic_port_get_cid_shard_count(const QUIC_PORT *port)
+{
+    return port->cid_shard_count;
+}
+
+void ossl_quic_port_set_cid_shard_count(QUIC_PORT *port, uint64_t count)
+{
+    port->cid_shard_count = count;
+}
+
+uint64_t ossl_quic_port_get_cc_algorithm(const QUIC_PORT *port)
+{
+    return port->cc_algorithm;
+}
+
+void ossl_quic_port_set_cc_algorithm(QUIC_PORT *port, uint64_t algorithm)
+{
+    port->cc_algorithm = algorithm;
+}
+
+uint64_t ossl_quic_port_get_max_handshake_threads(const QUIC_PORT *port)
+{
+    return port->max_handshake_threads;
+}
+
+void ossl_quic_port_set_max_handshake_threads(QUIC_PORT *port, uint64_t max)
+{
+    port->max_handshake_threads = max;
+}
+
+#ifdef SUPPORT_CID_STEERING
+/*
+ * Attaches a classic BPF program to the SO_REUSEPORT group of fd which selects
+ * the socket with index (first DCID byte % count). Offsets are relative to the
+ * start of the UDP payload. Sockets are indexed in the order in which they
+ * joined the group, so shard N must be the Nth socket bound to the address.
+ * Long header packets with a zero-length DCID are delivered using the kernel's
+ * default hash; packets too short to carry a DCID at all go to the first socket.
+ */
+static int port_attach_cid_steering(int fd, uint32_t count)
+{
+    struct sock_filter code[] = {
+        /* A = first header byte */
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+        /* Long header? */
+        BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x80, 2, 0),
+        /* Short header: DCID starts at offset 1 */
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 1),
+        BPF_STMT(BPF_JMP | BPF_JA, 3),
+        /* Long header: DCID length at offset 5, DCID at offset 6 */
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 5),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0, 3, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, count),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+        /* Out of range index: let the kernel choose */
+        BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+    };
+    struct sock_fprog prog;
+
+    prog.len = OSSL_NELEM(code);
+    prog.filter = code;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+            (const void *)&prog, sizeof(prog))
+        != 0) {
+        ERR_raise_data(ERR_LIB_SYS, get_last_socket_error(),
+            "calling setsockopt()");
+        return 0;
+    }
+
+    return 1;
+}
+#endif
+
+int ossl_quic_port_apply_cid_sharding(QUIC_PORT *port)
+{
+#ifdef SUPPORT_CID_STEERING
+    int fd = -1;
+#endif
+
+    if (port->cid_shard_count <= 1)
+        return ossl_quic_lcidm_set_shard(port->lcidm, -1);
+
+    if (port->cid_shard_count > 256
+        || port->cid_shard_id >= port->cid_shard_count) {
+        ERR_raise_data(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT,
+            "CID shard ID must be less than the CID shard count");
+        return 0;
+    }
+
+#ifdef SUPPORT_CID_STEERING
+    if (port->net_rbio == NULL || BIO_get_fd(port->net_rbio, &fd) < 0
+        || fd < 0) {
+        ERR_raise_data(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT,
+            "CID sharding requires a socket network BIO");
+        return 0;
+    }
+
+    if (!port_attach_cid_steering(fd, (uint32_t)port->cid_shard_count)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_SYS_LIB);
+        return 0;
+    }
+
+    return ossl_quic_lcidm_set_shard(port->lcidm, (int)port->cid_shard_id);
+#else
+    ERR_raise_data(ERR_LIB_SSL, ERR_R_UNSUPPORTED,
+        "CID steering is not supported on this platform");
+    return 0;
+#endif
+}
@@ -116,6 +116,9 @@ struct quic_port_st {
     /* Has the BIO been changed since we last updated reactor pollability? */
     unsigned int bio_changed : 1;
 
+    /* Is the network read BIO coalescing received datagrams? */
+    unsigned int rx_coalescing : 1;
+
     /* Are we using SSL_listen_ex to peeloff connections */
     int peeloff_mode;
 
@@ -136,6 +139,23 @@ struct quic_port_st {
     unsigned char ack_delay_exponent;
     unsigned char disable_active_migration;
     uint64_t max_pending_channels;
+
+    /*
+     * CID sharding configuration. If cid_shard_count is greater than one, this
+     * port is shard cid_shard_id of a SO_REUSEPORT group of that many ports.
+     */
+    uint64_t cid_shard_id;
+    uint64_t cid_shard_count;
+
+    /* Congestion control algorithm (SSL_VALUE_QUIC_CC_ALGORITHM_*). */
+    uint64_t cc_algorithm;
+
+    /*
+     * Maximum number of incoming handshake steps which may run on worker
+     * threads at once (0 disables handshake offload), and the number running.
+     */
+    uint64_t max_handshake_threads;
+    uint64_t num_handshake_threads;
 };
 
 #endif
@@ -22,6 +22,12 @@
  * ==========================
  */
 static void rtor_notify_other_threads(QUIC_REACTOR *rtor);
+static void rtor_update_poll_set(QUIC_REACTOR *rtor);
+
+/* Poll set slot assignments. */
+#define RTOR_POLL_SET_SLOT_R 0
+#define RTOR_POLL_SET_SLOT_W 1
+#define RTOR_POLL_SET_SLOT_NOTIFIER 2
 
 int ossl_quic_reactor_init(QUIC_REACTOR *rtor,
     void (*tick_cb)(QUIC_TICK_RESULT *res, void *arg,
@@ -59,6 +65,24 @@ int ossl_quic_reactor_init(QUIC_REACTOR *rtor,
         rtor->have_notifier = 0;
     }
 
+    rtor->have_poll_set = 0;
+    rtor->poll_set_synced = 0;
+    if ((flags & QUIC_REACTOR_FLAG_USE_POLL_SET) != 0) {
+        if (!ossl_rio_poll_set_init(&rtor->poll_set)) {
+            ossl_quic_reactor_cleanup(rtor);
+            return 0;
+        }
+
+        rtor->have_poll_set = 1;
+        if (rtor->have_notifier)
+            ossl_rio_poll_set_set_slot(&rtor->poll_set,
+                RTOR_POLL_SET_SLOT_NOTIFIER,
+                ossl_rio_notifier_as_fd(&rtor->notifier),
+                /*want_read=*/1, /*want_write=*/0);
+
+        rtor_update_poll_set(rtor);
+    }
+
     return 1;
 }
 
@@ -73,6 +97,50 @@ void ossl_quic_reactor_cleanup(QUIC_REACTOR *rtor)
 
         ossl_crypto_condvar_free(&rtor->notifier_cv);
     }
+
+    if (rtor->have_poll_set) {
+        ossl_rio_poll_set_cleanup(&rtor->poll_set);
+        rtor->have_poll_set = 0;
+        rtor->poll_set_synced = 0;
+    }
+}
+
+/*
+ * Brings the poll set in line with the current poll descriptors and desired
+ * events. Only changes are passed on to the OS, so this is cheap to call after
+ * every tick.
+ */
+static void rtor_update_poll_set(QUIC_REACTOR *rtor)
+{
+    if (!rtor->have_poll_set)
+        return;
+
+    ossl_rio_poll_set_set_slot(&rtor->poll_set, RTOR_POLL_SET_SLOT_R,
+        rtor->can_poll_r ? rtor->poll_r.value.fd : -1,
+        rtor->net_read_desired, /*want_write=*/0);
+    ossl_rio_poll_set_set_slot(&rtor->poll_set, RTOR_POLL_SET_SLOT_W,
+        rtor->can_poll_w ? rtor->poll_w.value.fd : -1,
+        /*want_read=*/0, rtor->net_write_desired);
+
+    rtor->poll_set_synced = ossl_rio_poll_set_sync(&rtor->poll_set);
+}
+
+/*
+ * Called when a poll descriptor is replaced. The old FD may have been closed
+ * and its number reused by the new one, so the registrations of both must be
+ * rebuilt.
+ */
+static void rtor_replace_poll_set_fd(QUIC_REACTOR *rtor,
+    const BIO_POLL_DESCRIPTOR *old_d,
+    const BIO_POLL_DESCRIPTOR *new_d)
+{
+    if (!rtor->have_poll_set)
+        return;
+
+    if (old_d->type == BIO_POLL_DESCRIPTOR_TYPE_SOCK_FD)
+        ossl_rio_poll_set_forget_fd(&rtor->poll_set, old_d->value.fd);
+    if (new_d->type == BIO_POLL_DESCRIPTOR_TYPE_SOCK_FD)
+        ossl_rio_poll_set_forget_fd(&rtor->poll_set, new_d->value.fd);
 }
 
 #if defined(OPENSSL_SYS_WINDOWS)
@@ -105,6 +173,8 @@ static void rtor_configure_winsock(BIO_POLL_DESCRIPTOR *bpd)
 
 void ossl_quic_reactor_set_poll_r(QUIC_REACTOR *rtor, const BIO_POLL_DESCRIPTOR *r)
 {
+    BIO_POLL_DESCRIPTOR old_r = rtor->poll_r;
+
     if (r == NULL)
         rtor->poll_r.type = BIO_POLL_DESCRIPTOR_TYPE_NONE;
     else
@@ -116,10 +186,15 @@ void ossl_quic_reactor_set_poll_r(QUIC_REACTOR *rtor, const BIO_POLL_DESCRIPTOR
 
     rtor->can_poll_r
         = ossl_quic_reactor_can_support_poll_descriptor(rtor, &rtor->poll_r);
+
+    rtor_replace_poll_set_fd(rtor, &old_r, &rtor->poll_r);
+    rtor_update_poll_set(rtor);
 }
 
 void ossl_quic_reactor_set_poll_w(QUIC_REACTOR *rtor, const BIO_POLL_DESCRIPTOR *w)
 {
+    BIO_POLL_DESCRIPTOR old_w = rtor->poll_w;
+
     if (w == NULL)
         rtor->poll_w.type = BIO_POLL_DESCRIPTOR_TYPE_NONE;
     else
@@ -131,6 +206,9 @@ void ossl_quic_reactor_set_poll_w(QUIC_REACTOR *rtor, const BIO_POLL_DESCRIPTOR
 
     rtor->can_poll_w
         = ossl_quic_reactor_can_support_poll_descriptor(rtor, &rtor->poll_w);
+
+    rtor_replace_poll_set_fd(rtor, &old_w, &rtor->poll_w);
+    rtor_update_poll_set(rtor);
 }
 
 const BIO_POLL_DESCRIPTOR *ossl_quic_reactor_get_poll_r(const QUIC_REACTOR *rtor)
@@ -190,6 +268,7 @@ int ossl_quic_reactor_tick(QUIC_REACTOR *rtor, uint32_t flags)
     rtor->net_read_desired = res.net_read_desired;
     rtor->net_write_desired = res.net_write_desired;
     rtor->tick_deadline = res.tick_deadline;
+    rtor_update_poll_set(rtor);
     if (res.notify_other_threads)
         rtor_notify_other_threads(rtor);
 
@@ -201,6 +280,14 @@ RIO_NOTIFIER *ossl_quic_reactor_get0_notifier(QUIC_REACTOR *rtor)
     return rtor->have_notifier ? &rtor->notifier : NULL;
 }
 
+int ossl_quic_reactor_get_poll_set_fd(QUIC_REACTOR *rtor)
+{
+    if (!rtor->have_poll_set || !rtor->poll_set_synced)
+        return -1;
+
+    return ossl_rio_poll_set_as_fd(&rtor->poll_set);
+}
+
 /*
  * Blocking I/O Adaptation Layer
  * =============================
@@ -442,6 +529,33 @@ static int poll_two_descriptors(const BIO_POLL_DESCRIPTOR *r, int r_want_read,
         notify_rfd, deadline, mutex);
 }
 
+/*
+ * Wait on the reactor's poll set, which already holds the descriptors and
+ * events poll_two_descriptors() would otherwise be given.
+ *
+ * If mutex is non-NULL, it is assumed be a lock currently held for write and is
+ * unlocked for the duration of any wait.
+ */
+static int poll_poll_set(RIO_POLL_SET *ps, OSSL_TIME deadline,
+    CRYPTO_MUTEX *mutex)
+{
+    int res;
+
+#if defined(OPENSSL_THREADS)
+    if (mutex != NULL)
+        ossl_crypto_mutex_unlock(mutex);
+#endif
+
+    res = ossl_rio_poll_set_wait(ps, deadline);
+
+#if defined(OPENSSL_THREADS)
+    if (mutex != NULL)
+        ossl_crypto_mutex_lock(mutex);
+#endif
+
+    return res;
+}
+
 /*
  * Notify other threads currently blocking in
  * ossl_quic_reactor_block_until_pred() calls that a predicate they are using
@@ -531,13 +645,16 @@ int ossl_quic_reactor_block_until_pred(QUIC_REACTOR *rtor,
 
         ossl_quic_reactor_enter_blocking_section(rtor);
 
-        res = poll_two_descriptors(ossl_quic_reactor_get_poll_r(rtor),
-            net_read_desired,
-            ossl_quic_reactor_get_poll_w(rtor),
-            net_write_desired,
-            notifier_fd,
-            tick_deadline,
-            rtor->mutex);
+        if (rtor->have_poll_set && rtor->poll_set_synced)
+            res = poll_poll_set(&rtor->poll_set, tick_deadline, rtor->mutex);
+        else
+            res = poll_two_descriptors(ossl_quic_reactor_get_poll_r(rtor),
+                net_read_desired,
+                ossl_quic_reactor_get_poll_w(rtor),
+                net_write_desired,
+                notifier_fd,
+                tick_deadline,
+                rtor->mutex);
 
         /*
          * We have now exited the OS poller call. We may have
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -1432,14 +1432,79 @@ static int qrx_process_one_urxe(OSSL_QRX *qrx, QUIC_URXE *e)
     return 1;
 }
 
+/*
+ * Removes header protection in a single batch from the first packet of each
+ * datagram in the run of pending URXEs starting at e. Only datagrams starting
+ * with a 1-RTT packet are handled here, which is the common case during bulk
+ * transfer. Such packets are marked as having had header protection removed,
+ * so qrx_process_pkt() decodes their headers directly. Anything not handled
+ * here (including packets this fails for) goes through the normal path.
+ */
+static void qrx_remove_hp_batch(OSSL_QRX *qrx, QUIC_URXE *e)
+{
+    QUIC_HDR_PROT_OP ops[QUIC_HDR_PROT_BATCH_MAX];
+    QUIC_URXE *urxes[QUIC_HDR_PROT_BATCH_MAX];
+    QUIC_PKT_HDR hdr;
+    QUIC_PKT_HDR_PTRS ptrs;
+    OSSL_QRL_ENC_LEVEL *el;
+    PACKET pkt;
+    size_t i, num_ops = 0;
+
+    if (!qrx->allow_1rtt
+        || ossl_qrl_enc_level_set_have_el(&qrx->el_set,
+               QUIC_ENC_LEVEL_1RTT)
+            != 1)
+        return;
+
+    el = ossl_qrl_enc_level_set_get(&qrx->el_set, QUIC_ENC_LEVEL_1RTT, 1);
+    if (el == NULL)
+        return;
+
+    for (; e != NULL && num_ops < OSSL_NELEM(ops);
+        e = ossl_list_urxe_next(e)) {
+        if (e->processed != 0 || e->hpr_removed != 0
+            || e->data_len < QUIC_MIN_VALID_PKT_LEN_CRYPTO
+            || (ossl_quic_urxe_data(e)[0] & 0x80) != 0)
+            break;
+
+        if (!PACKET_buf_init(&pkt, ossl_quic_urxe_data(e), e->data_len)
+            || !ossl_quic_wire_decode_pkt_hdr(&pkt, qrx->short_conn_id_len,
+                1, 0, &hdr, &ptrs, NULL))
+            break;
+
+        ops[num_ops].sample = ptrs.raw_sample;
+        ops[num_ops].sample_len = ptrs.raw_sample_len;
+        ops[num_ops].first_byte = ptrs.raw_start;
+        ops[num_ops].pn_bytes = ptrs.raw_pn;
+        urxes[num_ops++] = e;
+    }
+
+    if (num_ops == 0)
+        return;
+
+    ERR_set_mark();
+    if (!ossl_quic_hdr_protector_decrypt_batch(&el->hpr, ops, num_ops)) {
+        ERR_pop_to_mark();
+        return;
+    }
+    ERR_clear_last_mark();
+
+    for (i = 0; i < num_ops; ++i)
+        pkt_mark(&urxes[i]->hpr_removed, 0);
+}
+
 /* Process any pending URXEs to generate pending RXEs. */
 static int qrx_process_pending_urxl(OSSL_QRX *qrx)
 {
     QUIC_URXE *e;
 
-    while ((e = ossl_list_urxe_head(&qrx->urx_pending)) != NULL)
+    while ((e = ossl_list_urxe_head(&qrx->urx_pending)) != NULL) {
+        if (e->hpr_removed == 0)
+            qrx_remove_hp_batch(qrx, e);
+
         if (!qrx_process_one_urxe(qrx, e))
             return 0;
+    }
 
     return 1;
 }
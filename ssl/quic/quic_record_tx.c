@@ -25,10 +25,30 @@
  */
 typedef struct txe_st TXE;
 
+/*
+ * Maximum number of packets in a TXE which can have their header protection
+ * deferred. Header protection is applied immediately to any further packets.
+ */
+#define TXE_MAX_DEFERRED_HP 4
+
+/*
+ * A packet in a TXE which has been encrypted but does not yet have header
+ * protection applied. Offsets are relative to the start of the TXE data, as a
+ * TXE under construction may be reallocated.
+ */
+typedef struct txe_hp_st {
+    uint32_t enc_level;
+    size_t start_off, pn_off, sample_off, sample_len;
+} TXE_HP;
+
 struct txe_st {
     OSSL_LIST_MEMBER(txe, TXE);
     size_t data_len, alloc_len;
 
+    /* Packets awaiting header protection. */
+    TXE_HP hp[TXE_MAX_DEFERRED_HP];
+    size_t num_hp;
+
     /*
      * Destination and local addresses, as applicable. Both of these are only
      * used if the family is not AF_UNSPEC.
@@ -98,6 +118,12 @@ struct ossl_qtx_st {
     TXE *cons;
     size_t cons_count; /* num packets */
 
+    /*
+     * Number of packets in all TXEs (including cons) which still need header
+     * protection applied. See qtx_apply_deferred_hp().
+     */
+    size_t deferred_hp_count;
+
     /*
      * Number of packets transmitted in this key epoch. Used to enforce AEAD
      * confidentiality limit.
@@ -187,6 +213,102 @@ void ossl_qtx_set_qlog_cb(OSSL_QTX *qtx, QLOG *(*get_qlog_cb)(void *arg),
     qtx->get_qlog_cb_arg = get_qlog_cb_arg;
 }
 
+/*
+ * Deferred Header Protection
+ * ==========================
+ *
+ * Header protection is applied to packets as late as possible, just before a
+ * datagram leaves the QTX, so that the masks for all queued packets at a given
+ * EL can be generated in a single batch.
+ */
+typedef struct qtx_hp_batch_st {
+    OSSL_QRL_ENC_LEVEL *el;
+    QUIC_HDR_PROT_OP ops[QUIC_HDR_PROT_BATCH_MAX];
+    size_t num_ops;
+    int ok;
+} QTX_HP_BATCH;
+
+static void qtx_hp_batch_flush(QTX_HP_BATCH *b)
+{
+    if (b->num_ops > 0
+        && !ossl_quic_hdr_protector_encrypt_batch(&b->el->hpr, b->ops,
+            b->num_ops))
+        b->ok = 0;
+
+    b->num_ops = 0;
+}
+
+/*
+ * Adds the packets in txe awaiting header protection at the EL of the batch to
+ * the batch and removes them from the TXE. Returns the number of packets
+ * added.
+ */
+static size_t qtx_hp_batch_add_txe(QTX_HP_BATCH *b, uint32_t enc_level,
+    TXE *txe)
+{
+    QUIC_HDR_PROT_OP *op;
+    unsigned char *data = txe_data(txe);
+    const TXE_HP *hp;
+    size_t i, j, n = 0;
+
+    for (i = 0, j = 0; i < txe->num_hp; ++i) {
+        hp = &txe->hp[i];
+        if (hp->enc_level != enc_level) {
+            txe->hp[j++] = *hp;
+            continue;
+        }
+
+        op = &b->ops[b->num_ops++];
+        op->sample = data + hp->sample_off;
+        op->sample_len = hp->sample_len;
+        op->first_byte = data + hp->start_off;
+        op->pn_bytes = data + hp->pn_off;
+        ++n;
+
+        if (b->num_ops == OSSL_NELEM(b->ops))
+            qtx_hp_batch_flush(b);
+    }
+
+    txe->num_hp = j;
+    return n;
+}
+
+/*
+ * Applies header protection to all packets which are still awaiting it.
+ * Returns 1 on success or 0 on failure.
+ */
+static int qtx_apply_deferred_hp(OSSL_QTX *qtx)
+{
+    QTX_HP_BATCH b;
+    TXE *txe;
+    uint32_t enc_level;
+    size_t n;
+
+    if (qtx->deferred_hp_count == 0)
+        return 1;
+
+    b.ok = 1;
+    for (enc_level = 0; enc_level < QUIC_ENC_LEVEL_NUM; ++enc_level) {
+        b.el = ossl_qrl_enc_level_set_get(&qtx->el_set, enc_level, 1);
+        b.num_ops = 0;
+        if (b.el == NULL)
+            continue;
+
+        n = 0;
+        for (txe = ossl_list_txe_head(&qtx->pending); txe != NULL;
+            txe = ossl_list_txe_next(txe))
+            n += qtx_hp_batch_add_txe(&b, enc_level, txe);
+
+        if (qtx->cons != NULL)
+            n += qtx_hp_batch_add_txe(&b, enc_level, qtx->cons);
+
+        qtx_hp_batch_flush(&b);
+        qtx->deferred_hp_count -= n;
+    }
+
+    return b.ok;
+}
+
 int ossl_qtx_provide_secret(OSSL_QTX *qtx,
     uint32_t enc_level,
     uint32_t suite_id,
@@ -214,6 +336,10 @@ int ossl_qtx_discard_enc_level(OSSL_QTX *qtx, uint32_t enc_level)
     if (enc_level >= QUIC_ENC_LEVEL_NUM)
         return 0;
 
+    /* Queued packets still need the header protection key of this EL. */
+    if (!qtx_apply_deferred_hp(qtx))
+        return 0;
+
     ossl_qrl_enc_level_set_discard(&qtx->el_set, enc_level);
     return 1;
 }
@@ -238,6 +364,7 @@ static TXE *qtx_alloc_txe(size_t alloc_len)
     ossl_list_txe_init_elem(txe);
     txe->alloc_len = alloc_len;
     txe->data_len = 0;
+    txe->num_hp = 0;
     return txe;
 }
 
@@ -265,6 +392,7 @@ static TXE *qtx_get_cons_txe(OSSL_QTX *qtx, size_t min_size)
         }
 
         txe->data_len = 0;
+        txe->num_hp = 0;
         qtx->cons = txe;
         qtx->cons_count = 0;
     }
@@ -471,6 +599,7 @@ static int qtx_encrypt_into_txe(OSSL_QTX *qtx, struct iovec_cur *cur, TXE *txe,
     unsigned char nonce[EVP_MAX_IV_LENGTH];
     size_t i;
     EVP_CIPHER_CTX *cctx = NULL;
+    TXE_HP *hp;
 
     /* We should not have been called if we do not have key material. */
     if (!ossl_assert(el != NULL)) {
@@ -561,9 +690,21 @@ static int qtx_encrypt_into_txe(OSSL_QTX *qtx, struct iovec_cur *cur, TXE *txe,
 
     txe->data_len += el->tag_len;
 
-    /* Apply header protection. */
-    if (!ossl_quic_hdr_protector_encrypt(&el->hpr, ptrs))
+    /*
+     * Apply header protection. This is deferred until the datagram is sent
+     * where possible, see qtx_apply_deferred_hp().
+     */
+    if (txe->num_hp < TXE_MAX_DEFERRED_HP) {
+        hp = &txe->hp[txe->num_hp++];
+        hp->enc_level = enc_level;
+        hp->start_off = ptrs->raw_start - txe_data(txe);
+        hp->pn_off = ptrs->raw_pn - txe_data(txe);
+        hp->sample_off = ptrs->raw_sample - txe_data(txe);
+        hp->sample_len = ptrs->raw_sample_len;
+        ++qtx->deferred_hp_count;
+    } else if (!ossl_quic_hdr_protector_encrypt(&el->hpr, ptrs)) {
         return 0;
+    }
 
     ++el->op_count;
     return 1;
@@ -909,7 +1050,11 @@ static void txe_to_msg(TXE *txe, BIO_MSG *msg)
         = BIO_ADDR_family(&txe->local) != AF_UNSPEC ? &txe->local : NULL;
 }
 
-#define MAX_MSGS_PER_SEND 32
+/*
+ * Large enough for a network BIO using segmentation offload to pass a full run
+ * of datagrams to the OS in a single segmented send.
+ */
+#define MAX_MSGS_PER_SEND 64
 
 int ossl_qtx_flush_net(OSSL_QTX *qtx)
 {
@@ -924,6 +1069,9 @@ int ossl_qtx_flush_net(OSSL_QTX *qtx)
     if (qtx->bio == NULL)
         return QTX_FLUSH_NET_RES_PERMANENT_FAIL;
 
+    if (!qtx_apply_deferred_hp(qtx))
+        return QTX_FLUSH_NET_RES_PERMANENT_FAIL;
+
     for (;;) {
         for (txe = ossl_list_txe_head(&qtx->pending), i = 0;
             txe != NULL && i < OSSL_NELEM(msg);
@@ -984,7 +1132,7 @@ int ossl_qtx_pop_net(OSSL_QTX *qtx, BIO_MSG *msg)
 {
     TXE *txe = ossl_list_txe_head(&qtx->pending);
 
-    if (txe == NULL)
+    if (txe == NULL || !qtx_apply_deferred_hp(qtx))
         return 0;
 
     txe_to_msg(txe, msg);
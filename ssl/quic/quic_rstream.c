@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -230,7 +230,7 @@ int ossl_quic_rstream_get_record(QUIC_RSTREAM *qrs,
 
 int ossl_quic_rstream_release_record(QUIC_RSTREAM *qrs, size_t read_len)
 {
-    uint64_t offset;
+    uint64_t offset, start = qrs->head_range.start;
 
     if (!ossl_sframe_list_is_head_locked(&qrs->fl))
         return 0;
@@ -252,13 +252,18 @@ int ossl_quic_rstream_release_record(QUIC_RSTREAM *qrs, size_t read_len)
     if (qrs->rxfc != NULL) {
         OSSL_TIME rtt = get_rtt(qrs);
 
-        if (!ossl_quic_rxfc_on_retire(qrs->rxfc, offset, rtt))
+        if (!ossl_quic_rxfc_on_retire(qrs->rxfc, offset - start, rtt))
             return 0;
     }
 
     return 1;
 }
 
+int ossl_quic_rstream_is_record_held(QUIC_RSTREAM *qrs)
+{
+    return ossl_sframe_list_is_head_locked(&qrs->fl);
+}
+
 static int write_at_ring_buf_cb(uint64_t logical_offset,
     const unsigned char *buf,
     size_t buf_len,
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -81,6 +81,7 @@ int ossl_sframe_list_insert(SFRAME_LIST *fl, UINT_RANGE *range,
     const unsigned char *data, int fin)
 {
     STREAM_FRAME *sf, *new_frame, *prev_frame, *next_frame;
+    UINT_RANGE trimmed;
 #ifndef NDEBUG
     uint64_t curr_end = fl->tail != NULL ? fl->tail->range.end
                                          : fl->offset;
@@ -90,6 +91,23 @@ int ossl_sframe_list_insert(SFRAME_LIST *fl, UINT_RANGE *range,
         && (!fl->fin || curr_end >= range->end));
 #endif
 
+    /*
+     * The data of a locked head frame is in use by the caller of
+     * ossl_sframe_list_lock_head(), so the frame must not be replaced by a
+     * frame which overlaps it. Only insert the part beyond the head frame.
+     */
+    if (fl->head_locked && fl->head != NULL
+        && range->start < fl->head->range.end) {
+        if (range->end <= fl->head->range.end)
+            goto end;
+
+        if (data != NULL)
+            data += (size_t)(fl->head->range.end - range->start);
+        trimmed.start = fl->head->range.end;
+        trimmed.end = range->end;
+        range = &trimmed;
+    }
+
     if (fl->offset >= range->end)
         goto end;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2023-2024 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -462,6 +462,13 @@ int ossl_quic_srtm_lookup(QUIC_SRTM *srtm,
     if (srtm->alloc_failed)
         return 0;
 
+    /*
+     * This is called for nearly every incoming datagram, so avoid blinding the
+     * token if there is nothing it could match.
+     */
+    if (lh_SRTM_ITEM_num_items(srtm->items_rev) == 0)
+        return 0;
+
     if (!srtm_compute_blinded(srtm, &key, token))
         return 0;
 
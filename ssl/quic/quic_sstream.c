@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -11,13 +11,41 @@
 #include "internal/uint_set.h"
 #include "internal/common.h"
 #include "internal/ring_buf.h"
+#include "internal/list.h"
+
+/*
+ * A range of stream data held in a buffer owned by the caller rather than in
+ * our ring buffer. See ossl_quic_sstream_append_ref().
+ */
+typedef struct qss_ref_st QSS_REF;
+
+struct qss_ref_st {
+    OSSL_LIST_MEMBER(qss_ref, QSS_REF);
+    uint64_t start; /* logical offset of the first byte */
+    const unsigned char *buf;
+    size_t len;
+    ossl_quic_sstream_ref_free_fn *free_cb;
+    void *free_cb_arg;
+};
+
+DEFINE_LIST_OF(qss_ref, QSS_REF);
 
 /*
  * ==================================================================
  * QUIC Send Stream
  */
 struct quic_sstream_st {
+    /*
+     * Stream data is held either in the ring buffer, which we own, or in
+     * buffers owned by the caller (refs). The ring buffer only holds the data
+     * which is not held in a ref, so the logical offsets used by the ring
+     * buffer are the logical stream offsets less the number of bytes before
+     * them which are held in refs. Refs are held in logical offset order.
+     */
     struct ring_buf ring_buf;
+    OSSL_LIST(qss_ref) refs;
+    uint64_t ref_bytes; /* total bytes ever appended by reference */
+    uint64_t culled_ref_bytes; /* bytes in refs already released */
 
     /*
      * Any logical byte in the stream is in one of these states:
@@ -46,7 +74,7 @@ struct quic_sstream_st {
     UINT_SET new_set, acked_set;
 
     /*
-     * The current size of the stream is ring_buf.head_offset. If
+     * The current size of the stream is ring_buf.head_offset + ref_bytes. If
      * have_final_size is true, this is also the final size of the stream.
      */
     unsigned int have_final_size : 1;
@@ -57,6 +85,51 @@ struct quic_sstream_st {
 
 static void qss_cull(QUIC_SSTREAM *qss);
 
+static ossl_inline uint64_t qss_size(const QUIC_SSTREAM *qss)
+{
+    return qss->ring_buf.head_offset + qss->ref_bytes;
+}
+
+/*
+ * Returns the first ref which holds any data at or after the given logical
+ * offset, or NULL if there is no such ref.
+ */
+static QSS_REF *qss_find_ref(const QUIC_SSTREAM *qss, uint64_t offset)
+{
+    QSS_REF *ref;
+
+    OSSL_LIST_FOREACH(ref, qss_ref, &qss->refs)
+        if (ref->start + ref->len > offset)
+            return ref;
+
+    return NULL;
+}
+
+/*
+ * Converts a logical stream offset, which must not lie inside a ref, to a ring
+ * buffer offset.
+ */
+static uint64_t qss_ring_offset(const QUIC_SSTREAM *qss, uint64_t offset)
+{
+    QSS_REF *ref;
+    uint64_t ring_offset = offset - qss->culled_ref_bytes;
+
+    OSSL_LIST_FOREACH(ref, qss_ref, &qss->refs) {
+        if (ref->start >= offset)
+            break;
+
+        ring_offset -= ref->len;
+    }
+
+    return ring_offset;
+}
+
+static void qss_ref_release(QSS_REF *ref)
+{
+    ref->free_cb(ref->buf, ref->len, ref->free_cb_arg);
+    OPENSSL_free(ref);
+}
+
 QUIC_SSTREAM *ossl_quic_sstream_new(size_t init_buf_size)
 {
     QUIC_SSTREAM *qss;
@@ -72,6 +145,7 @@ QUIC_SSTREAM *ossl_quic_sstream_new(size_t init_buf_size)
         return NULL;
     }
 
+    ossl_list_qss_ref_init(&qss->refs);
     ossl_uint_set_init(&qss->new_set);
     ossl_uint_set_init(&qss->acked_set);
     return qss;
@@ -79,9 +153,16 @@ QUIC_SSTREAM *ossl_quic_sstream_new(size_t init_buf_size)
 
 void ossl_quic_sstream_free(QUIC_SSTREAM *qss)
 {
+    QSS_REF *ref, *rnext;
+
     if (qss == NULL)
         return;
 
+    OSSL_LIST_FOREACH_DELSAFE(ref, rnext, qss_ref, &qss->refs) {
+        ossl_list_qss_ref_remove(&qss->refs, ref);
+        qss_ref_release(ref);
+    }
+
     ossl_uint_set_destroy(&qss->new_set);
     ossl_uint_set_destroy(&qss->acked_set);
     ring_buf_destroy(&qss->ring_buf, qss->cleanse);
@@ -95,9 +176,10 @@ int ossl_quic_sstream_get_stream_frame(QUIC_SSTREAM *qss,
     size_t *num_iov)
 {
     size_t num_iov_ = 0, src_len = 0, total_len = 0, i;
-    uint64_t max_len;
+    uint64_t max_len, ring_offset;
     const unsigned char *src = NULL;
     UINT_SET_ITEM *range = ossl_list_uint_set_head(&qss->new_set);
+    QSS_REF *ref;
 
     if (*num_iov < 2)
         return 0;
@@ -114,7 +196,7 @@ int ossl_quic_sstream_get_stream_frame(QUIC_SSTREAM *qss,
         if (!qss->have_final_size || qss->sent_final_size)
             return 0;
 
-        hdr->offset = qss->ring_buf.head_offset;
+        hdr->offset = qss_size(qss);
         hdr->len = 0;
         hdr->is_fin = 1;
         *num_iov = 0;
@@ -130,12 +212,31 @@ int ossl_quic_sstream_get_stream_frame(QUIC_SSTREAM *qss,
      */
     max_len = range->range.end - range->range.start + 1;
 
+    /*
+     * Data held by reference is returned directly from the caller's buffer.
+     * Otherwise, stop at the start of the next ref, if any.
+     */
+    ref = qss_find_ref(qss, range->range.start);
+    if (ref != NULL && ref->start <= range->range.start) {
+        total_len = (size_t)(ref->start + ref->len - range->range.start);
+        if (total_len > max_len)
+            total_len = (size_t)max_len;
+
+        iov[0].buf = ref->buf + (range->range.start - ref->start);
+        iov[0].buf_len = total_len;
+        num_iov_ = 1;
+        max_len = 0;
+    } else if (ref != NULL && ref->start - range->range.start < max_len) {
+        max_len = ref->start - range->range.start;
+    }
+
+    ring_offset = qss_ring_offset(qss, range->range.start);
+
     for (i = 0;; ++i) {
         if (total_len >= max_len)
             break;
 
-        if (!ring_buf_get_buf_at(&qss->ring_buf,
-                range->range.start + total_len,
+        if (!ring_buf_get_buf_at(&qss->ring_buf, ring_offset + total_len,
                 &src, &src_len))
             return 0;
 
@@ -157,7 +258,7 @@ int ossl_quic_sstream_get_stream_frame(QUIC_SSTREAM *qss,
     hdr->offset = range->range.start;
     hdr->len = total_len;
     hdr->is_fin = qss->have_final_size
-        && hdr->offset + hdr->len == qss->ring_buf.head_offset;
+        && hdr->offset + hdr->len == qss_size(qss);
 
     *num_iov = num_iov_;
     return 1;
@@ -174,7 +275,7 @@ int ossl_quic_sstream_has_pending(QUIC_SSTREAM *qss)
 
 uint64_t ossl_quic_sstream_get_cur_size(QUIC_SSTREAM *qss)
 {
-    return qss->ring_buf.head_offset;
+    return qss_size(qss);
 }
 
 int ossl_quic_sstream_mark_transmitted(QUIC_SSTREAM *qss,
@@ -199,7 +300,7 @@ int ossl_quic_sstream_mark_transmitted_fin(QUIC_SSTREAM *qss,
      * We do not really need final_size since we already know the size of the
      * stream, but this serves as a sanity check.
      */
-    if (!qss->have_final_size || final_size != qss->ring_buf.head_offset)
+    if (!qss->have_final_size || final_size != qss_size(qss))
         return 0;
 
     qss->sent_final_size = 1;
@@ -274,7 +375,7 @@ int ossl_quic_sstream_get_final_size(QUIC_SSTREAM *qss, uint64_t *final_size)
         return 0;
 
     if (final_size != NULL)
-        *final_size = qss->ring_buf.head_offset;
+        *final_size = qss_size(qss);
 
     return 1;
 }
@@ -287,6 +388,7 @@ int ossl_quic_sstream_append(QUIC_SSTREAM *qss,
     size_t l, consumed_ = 0;
     UINT_RANGE r;
     struct ring_buf old_ring_buf = qss->ring_buf;
+    uint64_t start = qss_size(qss);
 
     if (qss->have_final_size) {
         *consumed = 0;
@@ -299,10 +401,9 @@ int ossl_quic_sstream_append(QUIC_SSTREAM *qss,
      * such semantics. In particular, the buffer pointed to by buf is only
      * assumed to be valid for the duration of this call, therefore we must copy
      * the data here. We will later copy-and-encrypt the data during packet
-     * encryption, so this is a two-copy design. Supporting a one-copy design in
-     * the future will require applications to use a different kind of API.
-     * Supporting such changes in future will require corresponding enhancements
-     * to this code.
+     * encryption, so this is a two-copy design. Applications which can keep
+     * their buffer alive until the data is acknowledged can use the one-copy
+     * design provided by ossl_quic_sstream_append_ref() instead.
      */
     while (buf_len > 0) {
         l = ring_buf_push(&qss->ring_buf, buf, buf_len);
@@ -315,9 +416,9 @@ int ossl_quic_sstream_append(QUIC_SSTREAM *qss,
     }
 
     if (consumed_ > 0) {
-        r.start = old_ring_buf.head_offset;
+        r.start = start;
         r.end = r.start + consumed_ - 1;
-        assert(r.end + 1 == qss->ring_buf.head_offset);
+        assert(r.end + 1 == qss_size(qss));
         if (!ossl_uint_set_insert(&qss->new_set, &r)) {
             qss->ring_buf = old_ring_buf;
             *consumed = 0;
@@ -329,9 +430,45 @@ int ossl_quic_sstream_append(QUIC_SSTREAM *qss,
     return 1;
 }
 
+int ossl_quic_sstream_append_ref(QUIC_SSTREAM *qss,
+    const unsigned char *buf,
+    size_t buf_len,
+    ossl_quic_sstream_ref_free_fn *free_cb,
+    void *free_cb_arg)
+{
+    QSS_REF *ref;
+    UINT_RANGE r;
+
+    if (qss->have_final_size || buf_len == 0 || free_cb == NULL
+        || buf_len > MAX_OFFSET - qss_size(qss))
+        return 0;
+
+    if ((ref = OPENSSL_zalloc(sizeof(*ref))) == NULL)
+        return 0;
+
+    ref->start = qss_size(qss);
+    ref->buf = buf;
+    ref->len = buf_len;
+    ref->free_cb = free_cb;
+    ref->free_cb_arg = free_cb_arg;
+
+    r.start = ref->start;
+    r.end = r.start + buf_len - 1;
+    if (!ossl_uint_set_insert(&qss->new_set, &r)) {
+        OPENSSL_free(ref);
+        return 0;
+    }
+
+    ossl_list_qss_ref_insert_tail(&qss->refs, ref);
+    qss->ref_bytes += buf_len;
+    return 1;
+}
+
 static void qss_cull(QUIC_SSTREAM *qss)
 {
     UINT_SET_ITEM *h = ossl_list_uint_set_head(&qss->acked_set);
+    QSS_REF *ref;
+    uint64_t end, ring_end;
 
     /*
      * Potentially cull data from our ring buffer. This can happen once data has
@@ -349,9 +486,30 @@ static void qss_cull(QUIC_SSTREAM *qss)
      * We only need to check the first range entry in the integer set because we
      * can only cull contiguous areas at the start of the ring buffer anyway.
      */
-    if (h != NULL)
-        ring_buf_cpop_range(&qss->ring_buf, h->range.start, h->range.end,
-            qss->cleanse);
+    if (h == NULL || h->range.start != 0)
+        return;
+
+    end = h->range.end + 1;
+
+    /* Give back caller buffers which have been entirely acknowledged. */
+    while ((ref = ossl_list_qss_ref_head(&qss->refs)) != NULL
+        && ref->start + ref->len <= end) {
+        ossl_list_qss_ref_remove(&qss->refs, ref);
+        qss->culled_ref_bytes += ref->len;
+        qss_ref_release(ref);
+    }
+
+    /*
+     * If the acknowledged range ends inside a ref, the ring buffer data before
+     * the ref is what we can cull.
+     */
+    if (ref != NULL && ref->start < end)
+        end = ref->start;
+
+    ring_end = qss_ring_offset(qss, end);
+    if (ring_end > qss->ring_buf.ctail_offset)
+        ring_buf_cpop_range(&qss->ring_buf, qss->ring_buf.ctail_offset,
+            ring_end - 1, qss->cleanse);
 }
 
 int ossl_quic_sstream_set_buffer_size(QUIC_SSTREAM *qss, size_t num_bytes)
@@ -389,7 +547,7 @@ int ossl_quic_sstream_is_totally_acked(QUIC_SSTREAM *qss)
         return 0;
 
     r = ossl_list_uint_set_head(&qss->acked_set)->range;
-    cur_size = qss->ring_buf.head_offset;
+    cur_size = qss_size(qss);
 
     /*
      * The invariants of UINT_SET guarantee a single list element if we have a
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -637,9 +637,15 @@ int ossl_quic_stream_map_notify_reset_recv_part(QUIC_STREAM_MAP *qsm,
         /* RFC 9000 s. 3.3: No point sending STOP_SENDING if already reset. */
         qs->want_stop_sending = 0;
 
-        /* QUIC_RSTREAM is no longer needed */
-        ossl_quic_rstream_free(qs->rstream);
-        qs->rstream = NULL;
+        /*
+         * QUIC_RSTREAM is no longer needed, unless the application still holds
+         * a reference to data in it (see SSL_read_ref_ex()). In that case it is
+         * freed when the reference is released.
+         */
+        if (!ossl_quic_rstream_is_record_held(qs->rstream)) {
+            ossl_quic_rstream_free(qs->rstream);
+            qs->rstream = NULL;
+        }
 
         ossl_quic_stream_map_update_state(qsm, qs);
         return 1;
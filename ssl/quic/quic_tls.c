@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -593,7 +593,8 @@ static const OSSL_RECORD_METHOD quic_tls_record_method = {
     quic_get_max_record_overhead, /* Never called */
     quic_increment_sequence_ctr, /* Never called */
     quic_alloc_buffers,
-    quic_free_buffers
+    quic_free_buffers,
+    NULL
 };
 
 static int add_transport_params_cb(SSL *s, unsigned int ext_type,
@@ -835,6 +836,7 @@ int ossl_quic_tls_tick(QUIC_TLS *qtls)
         case SSL_ERROR_WANT_CLIENT_HELLO_CB:
         case SSL_ERROR_WANT_X509_LOOKUP:
         case SSL_ERROR_WANT_RETRY_VERIFY:
+        case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
             ERR_pop_to_mark();
             return 1;
 
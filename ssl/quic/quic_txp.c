@@ -24,6 +24,16 @@
 #define MIN_FRAME_SIZE_MAX_STREAMS_BIDI 2
 #define MIN_FRAME_SIZE_MAX_STREAMS_UNI 2
 
+/*
+ * Pacing burst size. The token bucket holds at most the larger of this many
+ * datagrams or the amount of data sent at the pacing rate during the pacing
+ * quantum. The quantum is chosen to match the millisecond resolution of the
+ * reactor's wait so that pacing never needs a finer-grained wakeup than a
+ * reactor can provide.
+ */
+#define TXP_PACING_BURST_DGRAMS 2
+#define TXP_PACING_QUANTUM_US 1000
+
 /*
  * Packet Archetypes
  * =================
@@ -98,6 +108,20 @@ struct ossl_quic_tx_packetiser_st {
     uint64_t closing_bytes_recv;
     uint64_t closing_bytes_xmit;
 
+    /*
+     * Internal state - pacing. The pacing rate is bound to the CC diagnostic
+     * output and is 0 if the CC does not provide one, in which case pacing is
+     * disabled. Pacing is implemented as a token bucket: pacing_credit is the
+     * number of bytes we may still send before we have to wait for the bucket
+     * to refill. It may go negative as we always allow a whole datagram to be
+     * sent once there is any credit at all.
+     */
+    uint64_t pacing_rate; /* bytes/s */
+    int64_t pacing_credit;
+    OSSL_TIME pacing_last; /* time of last credit refill */
+    uint64_t pacing_deferrals; /* number of times pacer held back data */
+    unsigned int pacing_blocked : 1;
+
     /* Internal state - packet assembly. */
     struct txp_el {
         unsigned char *scratch; /* scratch buffer for packet assembly */
@@ -452,6 +476,9 @@ static int txp_pkt_commit(OSSL_QUIC_TX_PACKETISER *txp, struct txp_pkt *pkt,
     uint32_t archetype, int *txpim_pkt_reffed);
 static uint32_t txp_determine_archetype(OSSL_QUIC_TX_PACKETISER *txp,
     uint64_t cc_limit);
+static int txp_pacing_bind(OSSL_QUIC_TX_PACKETISER *txp);
+static int txp_pacing_allows(OSSL_QUIC_TX_PACKETISER *txp, OSSL_TIME now);
+static int txp_has_paced_work(OSSL_QUIC_TX_PACKETISER *txp);
 
 /**
  * Sets the validated state of a QUIC TX packetiser.
@@ -573,9 +600,27 @@ OSSL_QUIC_TX_PACKETISER *ossl_quic_tx_packetiser_new(const OSSL_QUIC_TX_PACKETIS
         return NULL;
     }
 
+    if (!txp_pacing_bind(txp)) {
+        ossl_quic_fifd_cleanup(&txp->fifd);
+        OPENSSL_free(txp);
+        return NULL;
+    }
+
     return txp;
 }
 
+static void txp_pacing_unbind(OSSL_QUIC_TX_PACKETISER *txp)
+{
+    OSSL_PARAM params[2];
+
+    params[0] = OSSL_PARAM_construct_uint64(OSSL_CC_OPTION_CUR_PACING_RATE,
+        &txp->pacing_rate);
+    params[1] = OSSL_PARAM_construct_end();
+
+    txp->args.cc_method->unbind_diagnostics(txp->args.cc_data, params);
+    txp->pacing_rate = 0;
+}
+
 void ossl_quic_tx_packetiser_free(OSSL_QUIC_TX_PACKETISER *txp)
 {
     uint32_t enc_level;
@@ -584,6 +629,7 @@ void ossl_quic_tx_packetiser_free(OSSL_QUIC_TX_PACKETISER *txp)
         return;
 
     ossl_quic_tx_packetiser_set_initial_token(txp, NULL, 0, NULL, NULL);
+    txp_pacing_unbind(txp);
     ossl_quic_fifd_cleanup(&txp->fifd);
     OPENSSL_free(txp->conn_close_frame.reason);
 
@@ -720,6 +766,18 @@ int ossl_quic_tx_packetiser_set_ack_delay_exponent(OSSL_QUIC_TX_PACKETISER *txp,
     return 1;
 }
 
+void ossl_quic_tx_packetiser_set_cc(OSSL_QUIC_TX_PACKETISER *txp,
+    const OSSL_CC_METHOD *cc_method,
+    OSSL_CC_DATA *cc_data)
+{
+    txp_pacing_unbind(txp);
+    txp->args.cc_method = cc_method;
+    txp->args.cc_data = cc_data;
+
+    /* A CC which does not support pacing simply leaves it disabled. */
+    (void)txp_pacing_bind(txp);
+}
+
 void ossl_quic_tx_packetiser_set_ack_tx_cb(OSSL_QUIC_TX_PACKETISER *txp,
     void (*cb)(const OSSL_QUIC_FRAME_ACK *ack,
         uint32_t pn_space,
@@ -887,6 +945,23 @@ int ossl_quic_tx_packetiser_generate(OSSL_QUIC_TX_PACKETISER *txp,
      */
     ossl_qtx_finish_dgram(txp->args.qtx);
 
+    /*
+     * The pacer is applied on top of CC. If it is holding us back, we are
+     * limited in the same way as if we had run out of CC budget, so we can
+     * still send ACK-only packets and probes. Record when we first start
+     * holding back data so the deferral is visible in the statistics.
+     */
+    if (cc_limit > 0 && txp->pacing_rate > 0
+        && !txp_pacing_allows(txp, txp->args.now(txp->args.now_arg))) {
+        cc_limit = 0;
+        if (!txp->pacing_blocked && txp_has_paced_work(txp)) {
+            txp->pacing_blocked = 1;
+            ++txp->pacing_deferrals;
+        }
+    } else {
+        txp->pacing_blocked = 0;
+    }
+
     /* 1. Archetype Selection */
     archetype = txp_determine_archetype(txp, cc_limit);
 
@@ -1012,6 +1087,11 @@ int ossl_quic_tx_packetiser_generate(OSSL_QUIC_TX_PACKETISER *txp,
         rc = txp_pkt_commit(txp, &pkt[enc_level], archetype,
             &txpim_pkt_reffed);
         if (rc) {
+            if (txp->pacing_rate > 0
+                && archetype != TX_PACKETISER_ARCHETYPE_ACK_ONLY)
+                txp->pacing_credit
+                    -= (int64_t)pkt[enc_level].tpkt->ackm_pkt.num_bytes;
+
             status->sent_ack_eliciting
                 = status->sent_ack_eliciting
                 || pkt[enc_level].tpkt->ackm_pkt.is_ack_eliciting;
@@ -1430,6 +1510,101 @@ static uint32_t txp_determine_archetype(OSSL_QUIC_TX_PACKETISER *txp,
     return TX_PACKETISER_ARCHETYPE_NORMAL;
 }
 
+static int txp_pacing_bind(OSSL_QUIC_TX_PACKETISER *txp)
+{
+    OSSL_PARAM params[2];
+
+    txp->pacing_rate = 0;
+    txp->pacing_credit = 0;
+    txp->pacing_last = ossl_time_zero();
+    txp->pacing_blocked = 0;
+
+    params[0] = OSSL_PARAM_construct_uint64(OSSL_CC_OPTION_CUR_PACING_RATE,
+        &txp->pacing_rate);
+    params[1] = OSSL_PARAM_construct_end();
+
+    return txp->args.cc_method->bind_diagnostics(txp->args.cc_data, params);
+}
+
+static int64_t txp_pacing_burst(OSSL_QUIC_TX_PACKETISER *txp)
+{
+    uint64_t burst = txp->pacing_rate * TXP_PACING_QUANTUM_US
+        / (OSSL_TIME_SECOND / OSSL_TIME_US);
+    uint64_t min_burst = (uint64_t)TXP_PACING_BURST_DGRAMS * txp_get_mdpl(txp);
+
+    if (burst < min_burst)
+        burst = min_burst;
+
+    return (int64_t)burst;
+}
+
+/*
+ * Refills the pacing token bucket according to the time elapsed since the
+ * last refill and returns 1 if there is credit available to send another
+ * datagram.
+ */
+static int txp_pacing_allows(OSSL_QUIC_TX_PACKETISER *txp, OSSL_TIME now)
+{
+    int64_t burst = txp_pacing_burst(txp);
+    uint64_t elapsed_us, add;
+
+    if (ossl_time_compare(now, txp->pacing_last) > 0) {
+        elapsed_us = ossl_time2us(ossl_time_subtract(now, txp->pacing_last));
+
+        if (elapsed_us >= OSSL_TIME_SECOND / OSSL_TIME_US)
+            add = (uint64_t)burst;
+        else
+            add = txp->pacing_rate * elapsed_us
+                / (OSSL_TIME_SECOND / OSSL_TIME_US);
+
+        /*
+         * Only move the refill time forward when we actually add credit, so
+         * that frequent calls do not keep discarding sub-byte amounts.
+         */
+        if (add > 0) {
+            if (add > (uint64_t)burst
+                || txp->pacing_credit + (int64_t)add > burst)
+                txp->pacing_credit = burst;
+            else
+                txp->pacing_credit += (int64_t)add;
+
+            txp->pacing_last = now;
+        }
+    }
+
+    return txp->pacing_credit > 0;
+}
+
+/*
+ * Returns 1 if we have something to send which is subject to pacing, i.e.
+ * something which would cause a normal packet to be generated.
+ */
+static int txp_has_paced_work(OSSL_QUIC_TX_PACKETISER *txp)
+{
+    uint32_t enc_level, conn_close_enc_level = QUIC_ENC_LEVEL_NUM;
+
+    for (enc_level = QUIC_ENC_LEVEL_INITIAL;
+        enc_level < QUIC_ENC_LEVEL_NUM;
+        ++enc_level)
+        if (txp_should_try_staging(txp, enc_level,
+                TX_PACKETISER_ARCHETYPE_NORMAL, 1,
+                &conn_close_enc_level))
+            return 1;
+
+    return 0;
+}
+
+/* Returns the time at which the pacer will next allow a datagram to be sent. */
+static OSSL_TIME txp_pacing_release_time(OSSL_QUIC_TX_PACKETISER *txp)
+{
+    uint64_t need = (uint64_t)(1 - txp->pacing_credit);
+
+    return ossl_time_add(txp->pacing_last,
+        ossl_us2time((need * (OSSL_TIME_SECOND / OSSL_TIME_US)
+                         + txp->pacing_rate - 1)
+            / txp->pacing_rate));
+}
+
 static int txp_should_try_staging(OSSL_QUIC_TX_PACKETISER *txp,
     uint32_t enc_level,
     uint32_t archetype,
@@ -3222,6 +3397,16 @@ QUIC_PN ossl_quic_tx_packetiser_get_next_pn(OSSL_QUIC_TX_PACKETISER *txp,
     return txp->next_pn[pn_space];
 }
 
+uint64_t ossl_quic_tx_packetiser_get_pacing_rate(const OSSL_QUIC_TX_PACKETISER *txp)
+{
+    return txp->pacing_rate;
+}
+
+uint64_t ossl_quic_tx_packetiser_get_pacing_deferrals(const OSSL_QUIC_TX_PACKETISER *txp)
+{
+    return txp->pacing_deferrals;
+}
+
 OSSL_TIME ossl_quic_tx_packetiser_get_deadline(OSSL_QUIC_TX_PACKETISER *txp)
 {
     /*
@@ -3251,6 +3436,15 @@ OSSL_TIME ossl_quic_tx_packetiser_get_deadline(OSSL_QUIC_TX_PACKETISER *txp)
     if (txp->args.cc_method->get_tx_allowance(txp->args.cc_data) == 0)
         deadline = ossl_time_min(deadline,
             txp->args.cc_method->get_wakeup_deadline(txp->args.cc_data));
+    /*
+     * When will the pacer let us send more? This is folded into the channel's
+     * tick deadline and thus into the reactor's wait, so the paced release of
+     * the next datagram does not cost a wakeup of its own; we only report it
+     * if we actually have something waiting to be sent.
+     */
+    else if (txp->pacing_rate > 0 && txp->pacing_credit <= 0
+        && txp_has_paced_work(txp))
+        deadline = ossl_time_min(deadline, txp_pacing_release_time(txp));
 
     return deadline;
 }
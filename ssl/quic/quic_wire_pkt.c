@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -123,6 +123,30 @@ static int hdr_generate_mask(QUIC_HDR_PROTECTOR *hpr,
     return 1;
 }
 
+static void hdr_unapply_mask(const unsigned char *mask,
+    unsigned char *first_byte, unsigned char *pn_bytes)
+{
+    unsigned char pn_len, i;
+
+    *first_byte ^= mask[0] & ((*first_byte & 0x80) != 0 ? 0xf : 0x1f);
+    pn_len = (*first_byte & 0x3) + 1;
+
+    for (i = 0; i < pn_len; ++i)
+        pn_bytes[i] ^= mask[i + 1];
+}
+
+static void hdr_apply_mask(const unsigned char *mask,
+    unsigned char *first_byte, unsigned char *pn_bytes)
+{
+    unsigned char pn_len, i;
+
+    pn_len = (*first_byte & 0x3) + 1;
+    for (i = 0; i < pn_len; ++i)
+        pn_bytes[i] ^= mask[i + 1];
+
+    *first_byte ^= mask[0] & ((*first_byte & 0x80) != 0 ? 0xf : 0x1f);
+}
+
 int ossl_quic_hdr_protector_decrypt(QUIC_HDR_PROTECTOR *hpr,
     QUIC_PKT_HDR_PTRS *ptrs)
 {
@@ -139,17 +163,12 @@ int ossl_quic_hdr_protector_decrypt_fields(QUIC_HDR_PROTECTOR *hpr,
     unsigned char *first_byte,
     unsigned char *pn_bytes)
 {
-    unsigned char mask[5], pn_len, i;
+    unsigned char mask[5];
 
     if (!hdr_generate_mask(hpr, sample, sample_len, mask))
         return 0;
 
-    *first_byte ^= mask[0] & ((*first_byte & 0x80) != 0 ? 0xf : 0x1f);
-    pn_len = (*first_byte & 0x3) + 1;
-
-    for (i = 0; i < pn_len; ++i)
-        pn_bytes[i] ^= mask[i + 1];
-
+    hdr_unapply_mask(mask, first_byte, pn_bytes);
     return 1;
 }
 
@@ -169,16 +188,101 @@ int ossl_quic_hdr_protector_encrypt_fields(QUIC_HDR_PROTECTOR *hpr,
     unsigned char *first_byte,
     unsigned char *pn_bytes)
 {
-    unsigned char mask[5], pn_len, i;
+    unsigned char mask[5];
 
     if (!hdr_generate_mask(hpr, sample, sample_len, mask))
         return 0;
 
-    pn_len = (*first_byte & 0x3) + 1;
-    for (i = 0; i < pn_len; ++i)
-        pn_bytes[i] ^= mask[i + 1];
+    hdr_apply_mask(mask, first_byte, pn_bytes);
+    return 1;
+}
+
+/*
+ * Generates the masks for a batch of packets. For AES, the samples are gathered
+ * into a single buffer and encrypted in one cipher operation. ChaCha20 uses
+ * each sample as a counter and nonce, so a separate keystream is needed for
+ * every packet.
+ */
+static int hdr_generate_masks(QUIC_HDR_PROTECTOR *hpr,
+    const QUIC_HDR_PROT_OP *ops, size_t num_ops,
+    unsigned char (*masks)[5])
+{
+    unsigned char buf[QUIC_HDR_PROT_BATCH_MAX * 16];
+    size_t i;
+    int l = 0;
+
+    if (num_ops > QUIC_HDR_PROT_BATCH_MAX) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+
+    if (hpr->cipher_id != QUIC_HDR_PROT_CIPHER_AES_128
+        && hpr->cipher_id != QUIC_HDR_PROT_CIPHER_AES_256) {
+        for (i = 0; i < num_ops; ++i)
+            if (!hdr_generate_mask(hpr, ops[i].sample, ops[i].sample_len,
+                    masks[i]))
+                return 0;
+
+        return 1;
+    }
+
+    for (i = 0; i < num_ops; ++i) {
+        if (ops[i].sample_len < 16) {
+            ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+            return 0;
+        }
+
+        memcpy(buf + i * 16, ops[i].sample, 16);
+    }
+
+    /* ECB encrypts each block independently, so this can be done in place. */
+    if (!EVP_CipherInit_ex(hpr->cipher_ctx, NULL, NULL, NULL, NULL, 1)
+        || !EVP_CipherUpdate(hpr->cipher_ctx, buf, &l, buf,
+            (int)(num_ops * 16))) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_EVP_LIB);
+        return 0;
+    }
+
+    for (i = 0; i < num_ops; ++i) {
+#ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
+        memset(masks[i], 0, 5);
+#else
+        memcpy(masks[i], buf + i * 16, 5);
+#endif
+    }
+
+    return 1;
+}
+
+int ossl_quic_hdr_protector_decrypt_batch(QUIC_HDR_PROTECTOR *hpr,
+    const QUIC_HDR_PROT_OP *ops,
+    size_t num_ops)
+{
+    unsigned char masks[QUIC_HDR_PROT_BATCH_MAX][5];
+    size_t i;
+
+    if (!hdr_generate_masks(hpr, ops, num_ops, masks))
+        return 0;
+
+    for (i = 0; i < num_ops; ++i)
+        hdr_unapply_mask(masks[i], ops[i].first_byte, ops[i].pn_bytes);
+
+    return 1;
+}
+
+int ossl_quic_hdr_protector_encrypt_batch(QUIC_HDR_PROTECTOR *hpr,
+    const QUIC_HDR_PROT_OP *ops,
+    size_t num_ops)
+{
+    unsigned char masks[QUIC_HDR_PROT_BATCH_MAX][5];
+    size_t i;
+
+    if (!hdr_generate_masks(hpr, ops, num_ops, masks))
+        return 0;
+
+    for (i = 0; i < num_ops; ++i)
+        hdr_apply_mask(masks[i], ops[i].first_byte, ops[i].pn_bytes);
 
-    *first_byte ^= mask[0] & ((*first_byte & 0x80) != 0 ? 0xf : 0x1f);
     return 1;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2018-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -336,7 +336,7 @@ static int dtls_copy_rlayer_record(OSSL_RECORD_LAYER *rl, pitem *item)
 
     rdata = (DTLS_RLAYER_RECORD_DATA *)item->data;
 
-    ossl_tls_buffer_release(&rl->rbuf);
+    ossl_tls_buffer_release(rl, &rl->rbuf);
 
     rl->packet = rdata->packet;
     rl->packet_length = rdata->packet_length;
@@ -797,5 +797,6 @@ const OSSL_RECORD_METHOD ossl_dtls_record_method = {
     dtls_get_max_record_overhead,
     tls_increment_sequence_ctr,
     tls_alloc_buffers,
-    tls_free_buffers
+    tls_free_buffers,
+    NULL
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2018-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -14,6 +14,7 @@
 #include "../record_local.h"
 #include "recmethod_local.h"
 #include "internal/ktls.h"
+#include <sys/uio.h>
 
 static struct record_functions_st ossl_ktls_funcs;
 
@@ -294,6 +295,25 @@ static int ktls_set_crypto_state(OSSL_RECORD_LAYER *rl, int level,
     COMP_METHOD *comp)
 {
     ktls_crypto_info_t crypto_info;
+    int rekey, err = OSSL_RECORD_RETURN_NON_FATAL_ERR;
+
+    /*
+     * If the kernel already handles this direction we are changing the keys
+     * after a TLSv1.3 KeyUpdate. The kernel still has the old keys then, so
+     * we cannot fall back to another record layer if anything goes wrong.
+     */
+    rekey = rl->direction == OSSL_RECORD_DIRECTION_WRITE
+        ? BIO_get_ktls_send(rl->bio)
+        : BIO_get_ktls_recv(rl->bio);
+    if (rekey) {
+#ifdef OPENSSL_KTLS_TLS13_KEY_UPDATE
+        if (rl->version != TLS1_3_VERSION)
+            return OSSL_RECORD_RETURN_FATAL;
+        err = OSSL_RECORD_RETURN_FATAL;
+#else
+        return OSSL_RECORD_RETURN_FATAL;
+#endif
+    }
 
     /*
      * Check if we are suitable for KTLS. If not suitable we return
@@ -302,34 +322,34 @@ static int ktls_set_crypto_state(OSSL_RECORD_LAYER *rl, int level,
      */
 
     if (comp != NULL)
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        return err;
 
     /* ktls supports only the maximum fragment size */
     if (rl->max_frag_len != SSL3_RT_MAX_PLAIN_LENGTH)
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        return err;
 
     /* check that cipher is supported */
     if (!ktls_int_check_supported_cipher(rl, ciph, md, taglen))
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        return err;
 
     /* All future data will get encrypted by ktls. Flush the BIO or skip ktls */
     if (rl->direction == OSSL_RECORD_DIRECTION_WRITE) {
         if (BIO_flush(rl->bio) <= 0)
-            return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+            return err;
 
         /* KTLS does not support record padding */
         if (rl->padding != NULL || rl->block_padding > 0)
-            return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+            return err;
     }
 
     if (!ktls_configure_crypto(rl->libctx, rl->version, ciph, md, rl->sequence,
             &crypto_info,
             rl->direction == OSSL_RECORD_DIRECTION_WRITE,
             iv, ivlen, key, keylen, mackey, mackeylen))
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        return err;
 
     if (!BIO_set_ktls(rl->bio, &crypto_info, rl->direction))
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        return err;
 
     if (rl->direction == OSSL_RECORD_DIRECTION_WRITE && (rl->options & SSL_OP_ENABLE_KTLS_TX_ZEROCOPY_SENDFILE) != 0)
         /* Ignore errors. The application opts in to using the zerocopy
@@ -490,6 +510,98 @@ static int ktls_initialise_write_packets(OSSL_RECORD_LAYER *rl,
     return 1;
 }
 
+/* Most iov elements a record is written from directly */
+#define KTLS_MAX_IOV 16
+
+/*
+ * Application data from an iov is written straight to the socket with
+ * writev(), so that the kernel encrypts it from the application's buffers.
+ * Whatever the socket does not take at once is copied to an internal buffer
+ * and left for tls_retry_write_records(), like any other pending write.
+ */
+static int ktls_write_records(OSSL_RECORD_LAYER *rl,
+    OSSL_RECORD_TEMPLATE *templates,
+    size_t numtempl)
+{
+    OSSL_RECORD_TEMPLATE rest;
+    TLS_BUFFER *wb = &rl->wbuf[0];
+    struct iovec vec[KTLS_MAX_IOV];
+    size_t i, n, cnt = 0, off, left;
+    ossl_ssize_t sent = 0;
+    unsigned char *buf;
+    int fd;
+
+    if (templates[0].iov == NULL
+        || templates[0].type != SSL3_RT_APPLICATION_DATA)
+        return tls_write_records_default(rl, templates, numtempl);
+
+    if (!ossl_assert(numtempl == 1)) {
+        RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    /*
+     * Only write directly if there is no BIO between us and the socket which
+     * might hold data written earlier.
+     */
+    if (rl->bio != NULL && BIO_method_type(rl->bio) == BIO_TYPE_SOCKET
+        && BIO_get_fd(rl->bio, &fd) >= 0) {
+        off = templates[0].iovoff;
+        left = templates[0].buflen;
+        for (i = 0; i < templates[0].iovcnt && left > 0 && cnt < KTLS_MAX_IOV;
+            i++) {
+            if (templates[0].iov[i].iov_len <= off) {
+                off -= templates[0].iov[i].iov_len;
+                continue;
+            }
+            n = templates[0].iov[i].iov_len - off;
+            if (n > left)
+                n = left;
+            vec[cnt].iov_base = (unsigned char *)templates[0].iov[i].iov_base
+                + off;
+            vec[cnt++].iov_len = n;
+            left -= n;
+            off = 0;
+        }
+        if (left == 0) {
+            clear_sys_error();
+            sent = writev(fd, vec, (int)cnt);
+            if (sent < 0)
+                sent = 0;
+        }
+    }
+
+    /* Free any internal buffer allocated during a previous write retry */
+    if (!TLS_BUFFER_is_app_buffer(wb))
+        OPENSSL_free(TLS_BUFFER_get_buf(wb));
+    TLS_BUFFER_set_buf(wb, NULL);
+    TLS_BUFFER_set_app_buffer(wb, 0);
+    TLS_BUFFER_set_offset(wb, 0);
+    TLS_BUFFER_set_left(wb, 0);
+    wb->type = templates[0].type;
+
+    if ((size_t)sent == templates[0].buflen) {
+        /* All written, there is nothing for tls_retry_write_records() to do */
+        rl->numwpipes = 0;
+        return 1;
+    }
+
+    rest = templates[0];
+    rest.iovoff += sent;
+    rest.buflen -= sent;
+    if ((buf = OPENSSL_malloc(rest.buflen)) == NULL
+        || !tls_gather_template(&rest, buf)) {
+        OPENSSL_free(buf);
+        RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+    TLS_BUFFER_set_buf(wb, buf);
+    TLS_BUFFER_set_left(wb, rest.buflen);
+    rl->numwpipes = 1;
+
+    return 1;
+}
+
 static int ktls_prepare_record_header(OSSL_RECORD_LAYER *rl,
     WPACKET *thispkt,
     OSSL_RECORD_TEMPLATE *templ,
@@ -562,7 +674,7 @@ static struct record_functions_st ossl_ktls_funcs = {
     ktls_validate_record_header,
     ktls_post_process_record,
     tls_get_max_records_default,
-    tls_write_records_default,
+    ktls_write_records,
     ktls_allocate_write_buffers,
     ktls_initialise_write_packets,
     NULL,
@@ -598,5 +710,6 @@ const OSSL_RECORD_METHOD ossl_ktls_record_method = {
     NULL,
     tls_increment_sequence_ctr,
     ktls_alloc_buffers,
-    tls_free_buffers
+    tls_free_buffers,
+    NULL
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2024 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -264,6 +264,13 @@ struct ossl_record_layer_st {
     /* The number of records that have been released via tls_release_record */
     size_t num_released;
 
+    /*
+     * Caller supplied buffer that the next record may be decrypted into, see
+     * set_read_dest()
+     */
+    unsigned char *read_dest;
+    size_t read_dest_len;
+
     /* where we are when reading */
     int rstate;
 
@@ -363,6 +370,8 @@ struct ossl_record_layer_st {
     OSSL_FUNC_rlayer_msg_callback_fn *msg_callback;
     OSSL_FUNC_rlayer_security_fn *security;
     OSSL_FUNC_rlayer_padding_fn *padding;
+    OSSL_FUNC_rlayer_alloc_buffer_fn *alloc_buffer;
+    OSSL_FUNC_rlayer_free_buffer_fn *free_buffer;
 
     size_t max_pipelines;
 
@@ -409,6 +418,7 @@ int ossl_set_tls_provider_parameters(OSSL_RECORD_LAYER *rl,
 int tls_increment_sequence_ctr(OSSL_RECORD_LAYER *rl);
 int tls_alloc_buffers(OSSL_RECORD_LAYER *rl);
 int tls_free_buffers(OSSL_RECORD_LAYER *rl);
+void tls_set_read_dest(OSSL_RECORD_LAYER *rl, unsigned char *buf, size_t len);
 
 int tls_default_read_n(OSSL_RECORD_LAYER *rl, size_t n, size_t max, int extend,
     int clearold, size_t *readbytes);
@@ -513,6 +523,8 @@ int tls_post_encryption_processing_default(OSSL_RECORD_LAYER *rl,
     OSSL_RECORD_TEMPLATE *thistempl,
     WPACKET *thispkt,
     TLS_RL_RECORD *thiswr);
+int tls_gather_template(const OSSL_RECORD_TEMPLATE *templ,
+    unsigned char *out);
 int tls_write_records_default(OSSL_RECORD_LAYER *rl,
     OSSL_RECORD_TEMPLATE *templates,
     size_t numtempl);
@@ -531,6 +543,6 @@ int tls_write_records_default(OSSL_RECORD_LAYER *rl,
 #define TLS_BUFFER_set_app_buffer(b, l) ((b)->app_buffer = (l))
 #define TLS_BUFFER_is_app_buffer(b) ((b)->app_buffer)
 
-void ossl_tls_buffer_release(TLS_BUFFER *b);
+void ossl_tls_buffer_release(OSSL_RECORD_LAYER *rl, TLS_BUFFER *b);
 
 #endif /* !defined(OSSL_SSL_RECORD_METHODS_RECMETHOD_LOCAL_H) */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -84,9 +84,8 @@ end:
     return OSSL_RECORD_RETURN_SUCCESS;
 }
 
-static int tls13_cipher(OSSL_RECORD_LAYER *rl, TLS_RL_RECORD *recs,
-    size_t n_recs, int sending, SSL_MAC_BUF *mac,
-    size_t macsize)
+static int tls13_cipher_record(OSSL_RECORD_LAYER *rl, TLS_RL_RECORD *rec,
+    int sending)
 {
     EVP_CIPHER_CTX *enc_ctx;
     unsigned char recheader[SSL3_RT_HEADER_LENGTH];
@@ -96,18 +95,11 @@ static int tls13_cipher(OSSL_RECORD_LAYER *rl, TLS_RL_RECORD *recs,
     unsigned char *nonce;
     unsigned char *seq = rl->sequence;
     int lenu, lenf;
-    TLS_RL_RECORD *rec = &recs[0];
     WPACKET wpkt;
     const EVP_CIPHER *cipher;
     EVP_MAC_CTX *mac_ctx = NULL;
     int mode;
 
-    if (n_recs != 1) {
-        /* Should not happen */
-        RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
-        return 0;
-    }
-
     enc_ctx = rl->enc_ctx; /* enc_ctx is ignored when rl->mac_ctx != NULL */
     staticiv = rl->iv;
     nonce = rl->nonce;
@@ -216,7 +208,7 @@ static int tls13_cipher(OSSL_RECORD_LAYER *rl, TLS_RL_RECORD *recs,
     mode = EVP_CIPHER_get_mode(cipher);
 
     if (EVP_CipherInit_ex(enc_ctx, NULL, NULL, NULL, nonce, sending) <= 0
-        || (!sending && EVP_CIPHER_CTX_ctrl(enc_ctx, EVP_CTRL_AEAD_SET_TAG, (int)rl->taglen, rec->data + rec->length) <= 0)) {
+        || (!sending && EVP_CIPHER_CTX_ctrl(enc_ctx, EVP_CTRL_AEAD_SET_TAG, (int)rl->taglen, rec->input + rec->length) <= 0)) {
         RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
         return 0;
     }
@@ -253,6 +245,30 @@ static int tls13_cipher(OSSL_RECORD_LAYER *rl, TLS_RL_RECORD *recs,
     return 1;
 }
 
+static int tls13_cipher(OSSL_RECORD_LAYER *rl, TLS_RL_RECORD *recs,
+    size_t n_recs, int sending, SSL_MAC_BUF *mac,
+    size_t macsize)
+{
+    size_t i;
+
+    /*
+     * Records are read one at a time, but we may be asked to encrypt several
+     * consecutive application data records, see tls13_write_records().
+     */
+    if (n_recs == 0 || (!sending && n_recs != 1)) {
+        /* Should not happen */
+        RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    for (i = 0; i < n_recs; i++) {
+        if (!tls13_cipher_record(rl, &recs[i], sending))
+            return 0;
+    }
+
+    return 1;
+}
+
 static int tls13_validate_record_header(OSSL_RECORD_LAYER *rl,
     TLS_RL_RECORD *rec)
 {
@@ -410,6 +426,177 @@ static int tls13_add_record_padding(OSSL_RECORD_LAYER *rl,
     return 1;
 }
 
+/*
+ * The maximum number of application data records we encrypt and write in one
+ * go for a large write
+ */
+#define TLS13_MAX_WRITE_RECORDS 8
+
+/*
+ * Whether |numtempl| records can be written back to back into a single
+ * write buffer. That requires us to know up front exactly how long each of
+ * them will be, so this is only done for application data records of the
+ * same length with an AEAD cipher and no record padding.
+ */
+static int tls13_is_multi_record_write(OSSL_RECORD_LAYER *rl,
+    OSSL_RECORD_TEMPLATE *templates,
+    size_t numtempl)
+{
+    size_t i;
+
+    if (numtempl < 2
+        || numtempl > TLS13_MAX_WRITE_RECORDS
+        || rl->enc_ctx == NULL
+        || rl->mac_ctx != NULL
+        || rl->allow_plain_alerts
+        || rl->padding != NULL
+        || rl->block_padding > 0)
+        return 0;
+
+    for (i = 0; i < numtempl; i++) {
+        if (templates[i].type != SSL3_RT_APPLICATION_DATA
+            || templates[i].buflen != templates[0].buflen)
+            return 0;
+    }
+
+    return 1;
+}
+
+/* Length of each record written by a multi record write */
+static size_t tls13_multi_record_len(OSSL_RECORD_LAYER *rl,
+    OSSL_RECORD_TEMPLATE *templ)
+{
+    /* header, data, inner content type and AEAD tag */
+    return SSL3_RT_HEADER_LENGTH + templ->buflen + 1 + rl->taglen;
+}
+
+static size_t tls13_get_max_records(OSSL_RECORD_LAYER *rl, uint8_t type,
+    size_t len, size_t maxfrag,
+    size_t *preffrag)
+{
+    /*
+     * For large application data writes ask for as many full records as we
+     * have data for, so that they can be encrypted and written together.
+     */
+    if (type == SSL3_RT_APPLICATION_DATA
+        && len >= 2 * *preffrag
+        && rl->enc_ctx != NULL
+        && rl->mac_ctx == NULL
+        && !rl->allow_plain_alerts
+        && rl->padding == NULL
+        && rl->block_padding == 0) {
+        size_t n = len / *preffrag;
+
+        return n < TLS13_MAX_WRITE_RECORDS ? n : TLS13_MAX_WRITE_RECORDS;
+    }
+
+    return tls_get_max_records_default(rl, type, len, maxfrag, preffrag);
+}
+
+static int tls13_allocate_write_buffers(OSSL_RECORD_LAYER *rl,
+    OSSL_RECORD_TEMPLATE *templates,
+    size_t numtempl, size_t *prefix)
+{
+    size_t len, maxalign = 0;
+
+    if (!tls13_is_multi_record_write(rl, templates, numtempl))
+        return tls_allocate_write_buffers_default(rl, templates, numtempl,
+            prefix);
+
+#if defined(SSL3_ALIGN_PAYLOAD) && SSL3_ALIGN_PAYLOAD != 0
+    maxalign = SSL3_ALIGN_PAYLOAD - 1;
+#endif
+    /*
+     * One buffer for all the records. The space reserved for the encryption
+     * overhead of each record is only needed after the last one.
+     */
+    len = maxalign + numtempl * tls13_multi_record_len(rl, &templates[0])
+        + SSL3_RT_SEND_MAX_ENCRYPTED_OVERHEAD;
+
+    /*
+     * As for multiblock writes, this buffer is reallocated when we next do
+     * a write of a different size.
+     */
+    if (!tls_setup_write_buffer(rl, 1, len, 0)) {
+        /* RLAYERfatal() already called */
+        return 0;
+    }
+
+    return 1;
+}
+
+static int tls13_initialise_write_packets(OSSL_RECORD_LAYER *rl,
+    OSSL_RECORD_TEMPLATE *templates,
+    size_t numtempl,
+    OSSL_RECORD_TEMPLATE *prefixtempl,
+    WPACKET *pkt,
+    TLS_BUFFER *bufs,
+    size_t *wpinited)
+{
+    TLS_BUFFER *wb = &bufs[0];
+    size_t j, reclen, start, align = 0;
+
+    if (!tls13_is_multi_record_write(rl, templates, numtempl))
+        return tls_initialise_write_packets_default(rl, templates, numtempl,
+            prefixtempl, pkt, bufs,
+            wpinited);
+
+    wb->type = SSL3_RT_APPLICATION_DATA;
+
+#if defined(SSL3_ALIGN_PAYLOAD) && SSL3_ALIGN_PAYLOAD != 0
+    align = (size_t)TLS_BUFFER_get_buf(wb) + SSL3_RT_HEADER_LENGTH;
+    align = SSL3_ALIGN_PAYLOAD - 1 - ((align - 1) % SSL3_ALIGN_PAYLOAD);
+#endif
+    TLS_BUFFER_set_offset(wb, align);
+
+    /*
+     * Each record starts right where the previous one will end. Every packet
+     * may extend to the end of the buffer so that it has room to reserve the
+     * encryption overhead, but only the last one actually uses it.
+     */
+    reclen = tls13_multi_record_len(rl, &templates[0]);
+    for (j = 0; j < numtempl; j++) {
+        start = align + j * reclen;
+        if (!WPACKET_init_static_len(&pkt[j], TLS_BUFFER_get_buf(wb) + start,
+                TLS_BUFFER_get_len(wb) - start, 0)) {
+            RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+            return 0;
+        }
+        (*wpinited)++;
+    }
+
+    return 1;
+}
+
+static int tls13_write_records(OSSL_RECORD_LAYER *rl,
+    OSSL_RECORD_TEMPLATE *templates,
+    size_t numtempl)
+{
+    size_t j, reclen;
+
+    if (!tls_write_records_default(rl, templates, numtempl))
+        return 0;
+
+    if (!tls13_is_multi_record_write(rl, templates, numtempl))
+        return 1;
+
+    /*
+     * The records are back to back in the first write buffer. Check they came
+     * out the length we planned for, and send them all with a single write.
+     */
+    reclen = tls13_multi_record_len(rl, &templates[0]);
+    for (j = 0; j < numtempl; j++) {
+        if (!ossl_assert(TLS_BUFFER_get_left(&rl->wbuf[j]) == reclen)) {
+            RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+            return 0;
+        }
+        TLS_BUFFER_set_left(&rl->wbuf[j], 0);
+    }
+    TLS_BUFFER_set_left(&rl->wbuf[0], numtempl * reclen);
+
+    return 1;
+}
+
 const struct record_functions_st tls_1_3_funcs = {
     tls13_set_crypto_state,
     tls13_cipher,
@@ -419,10 +606,10 @@ const struct record_functions_st tls_1_3_funcs = {
     tls_get_more_records,
     tls13_validate_record_header,
     tls13_post_process_record,
-    tls_get_max_records_default,
-    tls_write_records_default,
-    tls_allocate_write_buffers_default,
-    tls_initialise_write_packets_default,
+    tls13_get_max_records,
+    tls13_write_records,
+    tls13_allocate_write_buffers,
+    tls13_initialise_write_packets,
     tls13_get_record_type,
     tls_prepare_record_header_default,
     tls13_add_record_padding,
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -575,6 +575,8 @@ int tls1_initialise_write_packets(OSSL_RECORD_LAYER *rl,
         prefixtempl->buf = NULL;
         prefixtempl->version = templates[0].version;
         prefixtempl->buflen = 0;
+        prefixtempl->iov = NULL;
+        prefixtempl->iovcnt = prefixtempl->iovoff = 0;
         prefixtempl->type = SSL3_RT_APPLICATION_DATA;
 
         wb = &bufs[0];
@@ -23,9 +23,31 @@
 
 static void tls_int_free(OSSL_RECORD_LAYER *rl);
 
-void ossl_tls_buffer_release(TLS_BUFFER *b)
+/*
+ * Record buffers are taken from libssl's buffer pool if it gave us the
+ * callbacks for that. They are always plain OPENSSL_malloc() allocations of
+ * at least the requested length, so they may also be freed with
+ * OPENSSL_free().
+ */
+static unsigned char *tls_buffer_alloc(OSSL_RECORD_LAYER *rl, size_t len)
+{
+    if (rl->alloc_buffer != NULL)
+        return rl->alloc_buffer(rl->cbarg, len);
+    return OPENSSL_malloc(len);
+}
+
+static void tls_buffer_free(OSSL_RECORD_LAYER *rl, unsigned char *buf,
+    size_t len)
+{
+    if (rl->free_buffer != NULL)
+        rl->free_buffer(rl->cbarg, buf, len);
+    else
+        OPENSSL_free(buf);
+}
+
+void ossl_tls_buffer_release(OSSL_RECORD_LAYER *rl, TLS_BUFFER *b)
 {
-    OPENSSL_free(b->buf);
+    tls_buffer_free(rl, b->buf, b->len);
     b->buf = NULL;
 }
 
@@ -133,7 +155,7 @@ static void tls_release_write_buffer_int(OSSL_RECORD_LAYER *rl, size_t start)
         if (TLS_BUFFER_is_app_buffer(wb))
             TLS_BUFFER_set_app_buffer(wb, 0);
         else
-            OPENSSL_free(wb->buf);
+            tls_buffer_free(rl, wb->buf, wb->len);
         wb->buf = NULL;
         pipes--;
     }
@@ -187,13 +209,13 @@ int tls_setup_write_buffer(OSSL_RECORD_LAYER *rl, size_t numwpipes,
             len = defltlen;
 
         if (thiswb->len != len) {
-            OPENSSL_free(thiswb->buf);
+            tls_buffer_free(rl, thiswb->buf, thiswb->len);
             thiswb->buf = NULL; /* force reallocation */
         }
 
         p = thiswb->buf;
         if (p == NULL) {
-            p = OPENSSL_malloc(len);
+            p = tls_buffer_alloc(rl, len);
             if (p == NULL) {
                 if (rl->numwpipes < currpipe)
                     rl->numwpipes = currpipe;
@@ -258,7 +280,7 @@ int tls_setup_read_buffer(OSSL_RECORD_LAYER *rl)
         if (b->default_len > len)
             len = b->default_len;
 
-        if ((p = OPENSSL_malloc(len)) == NULL) {
+        if ((p = tls_buffer_alloc(rl, len)) == NULL) {
             /*
              * We've got a malloc failure, and we're still initialising buffers.
              * We assume we're so doomed that we won't even be able to send an
@@ -281,8 +303,7 @@ static int tls_release_read_buffer(OSSL_RECORD_LAYER *rl)
     b = &rl->rbuf;
     if ((rl->options & SSL_OP_CLEANSE_PLAINTEXT) != 0)
         OPENSSL_cleanse(b->buf, b->len);
-    OPENSSL_free(b->buf);
-    b->buf = NULL;
+    ossl_tls_buffer_release(rl, b);
     rl->packet = NULL;
     rl->packet_length = 0;
     return 1;
@@ -758,6 +779,24 @@ int tls_get_more_records(OSSL_RECORD_LAYER *rl)
         }
     }
 
+    /*
+     * With a TLSv1.3 AEAD cipher a single record can be decrypted straight
+     * into the buffer offered by the caller, rather than in place. The
+     * plaintext (including the inner content type) is always shorter than
+     * the ciphertext, so that is what has to fit. We don't do this if the
+     * plaintext is to be cleansed on release as that would wipe the caller's
+     * copy.
+     */
+    if (rl->read_dest != NULL
+        && num_recs == 1
+        && rl->funcs == &tls_1_3_funcs
+        && rl->enc_ctx != NULL
+        && rl->mac_ctx == NULL
+        && rr[0].type == SSL3_RT_APPLICATION_DATA
+        && rr[0].length <= rl->read_dest_len
+        && (rl->options & SSL_OP_CLEANSE_PLAINTEXT) == 0)
+        rr[0].data = rl->read_dest;
+
     ERR_set_mark();
     enc_err = rl->funcs->cipher(rl, rr, num_recs, 0, macbufs, mac_size);
 
@@ -866,6 +905,18 @@ int tls_get_more_records(OSSL_RECORD_LAYER *rl)
             goto end;
         }
 
+        /*
+         * Only application data is handed back in the caller's buffer. Any
+         * other record is moved back to where its ciphertext was so that it
+         * stays valid beyond the current read call.
+         */
+        if (thisrr->data == rl->read_dest
+            && thisrr->type != SSL3_RT_APPLICATION_DATA) {
+            memcpy(thisrr->input, thisrr->data, thisrr->length);
+            OPENSSL_cleanse(thisrr->data, thisrr->length);
+            thisrr->data = thisrr->input;
+        }
+
         /*
          * Record overflow checking (e.g. checking if
          * thisrr->length > SSL3_RT_MAX_PLAIN_LENGTH) is the responsibility of
@@ -1298,6 +1349,13 @@ int tls_int_new_record_layer(OSSL_LIB_CTX *libctx, const char *propq, int vers,
                 break;
             case OSSL_FUNC_RLAYER_PADDING:
                 rl->padding = OSSL_FUNC_rlayer_padding(fns);
+                break;
+            case OSSL_FUNC_RLAYER_ALLOC_BUFFER:
+                rl->alloc_buffer = OSSL_FUNC_rlayer_alloc_buffer(fns);
+                break;
+            case OSSL_FUNC_RLAYER_FREE_BUFFER:
+                rl->free_buffer = OSSL_FUNC_rlayer_free_buffer(fns);
+                break;
             default:
                 /* Just ignore anything we don't understand */
                 break;
@@ -1389,7 +1447,7 @@ static void tls_int_free(OSSL_RECORD_LAYER *rl)
     BIO_free(rl->prev);
     BIO_free_all(rl->bio);
     BIO_free(rl->next);
-    ossl_tls_buffer_release(&rl->rbuf);
+    ossl_tls_buffer_release(rl, &rl->rbuf);
 
     tls_release_write_buffer(rl);
 
@@ -1686,6 +1744,33 @@ int tls_post_encryption_processing_default(OSSL_RECORD_LAYER *rl,
     return 1;
 }
 
+/*
+ * Copies the data of a template that uses an iov into |out|, which must have
+ * room for templ->buflen bytes. Returns 1 on success or 0 if the iov holds
+ * less data than the template says.
+ */
+int tls_gather_template(const OSSL_RECORD_TEMPLATE *templ,
+    unsigned char *out)
+{
+    size_t i, n, off = templ->iovoff, left = templ->buflen;
+
+    for (i = 0; i < templ->iovcnt && left > 0; i++) {
+        if (templ->iov[i].iov_len <= off) {
+            off -= templ->iov[i].iov_len;
+            continue;
+        }
+        n = templ->iov[i].iov_len - off;
+        if (n > left)
+            n = left;
+        memcpy(out, (unsigned char *)templ->iov[i].iov_base + off, n);
+        out += n;
+        left -= n;
+        off = 0;
+    }
+
+    return left == 0;
+}
+
 int tls_write_records_default(OSSL_RECORD_LAYER *rl,
     OSSL_RECORD_TEMPLATE *templates,
     size_t numtempl)
@@ -1761,13 +1846,39 @@ int tls_write_records_default(OSSL_RECORD_LAYER *rl,
 
         /* first we compress */
         if (rl->compctx != NULL) {
+            unsigned char *gathered = NULL;
+
+            /* The compressor needs its input in one piece */
+            if (thistempl->iov != NULL) {
+                if ((gathered = OPENSSL_malloc(thistempl->buflen)) == NULL
+                    || !tls_gather_template(thistempl, gathered)) {
+                    OPENSSL_free(gathered);
+                    RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+                    goto err;
+                }
+                TLS_RL_RECORD_set_input(thiswr, gathered);
+            }
             if (!tls_do_compress(rl, thiswr)
                 || !WPACKET_allocate_bytes(thispkt, thiswr->length, NULL)) {
+                OPENSSL_clear_free(gathered, thistempl->buflen);
                 RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, SSL_R_COMPRESSION_FAILURE);
                 goto err;
             }
+            OPENSSL_clear_free(gathered, thistempl->buflen);
         } else if (compressdata != NULL) {
-            if (!WPACKET_memcpy(thispkt, thiswr->input, thiswr->length)) {
+            unsigned char *data;
+
+            /*
+             * Copy the plaintext into the write buffer, where it is encrypted
+             * in place. Data from an iov is gathered straight into it.
+             */
+            if (thistempl->iov != NULL) {
+                if (!WPACKET_allocate_bytes(thispkt, thiswr->length, &data)
+                    || !tls_gather_template(thistempl, data)) {
+                    RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+                    goto err;
+                }
+            } else if (!WPACKET_memcpy(thispkt, thiswr->input, thiswr->length)) {
                 RLAYERfatal(rl, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
                 goto err;
             }
@@ -2128,6 +2239,12 @@ int tls_free_buffers(OSSL_RECORD_LAYER *rl)
     return tls_release_read_buffer(rl);
 }
 
+void tls_set_read_dest(OSSL_RECORD_LAYER *rl, unsigned char *buf, size_t len)
+{
+    rl->read_dest = buf;
+    rl->read_dest_len = buf != NULL ? len : 0;
+}
+
 const OSSL_RECORD_METHOD ossl_tls_record_method = {
     tls_new_record_layer,
     tls_free,
@@ -2153,5 +2270,6 @@ const OSSL_RECORD_METHOD ossl_tls_record_method = {
     NULL,
     tls_increment_sequence_ctr,
     tls_alloc_buffers,
-    tls_free_buffers
+    tls_free_buffers,
+    tls_set_read_dest
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -76,6 +76,10 @@ static int tls_write_records_multiblock_int(OSSL_RECORD_LAYER *rl,
     if (numtempl != 4 && numtempl != 8)
         return 0;
 
+    /* The stitched ciphers need the data in one contiguous buffer */
+    if (templates[0].iov != NULL)
+        return 0;
+
     /*
      * Check templates have contiguous buffers and are all the same type and
      * length
@@ -1,5 +1,5 @@
 /*
- * Copyright 2005-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2005-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -659,6 +659,8 @@ int do_dtls1_write(SSL_CONNECTION *sc, uint8_t type, const unsigned char *buf,
         tmpl.version = sc->version;
     tmpl.buf = buf;
     tmpl.buflen = len;
+    tmpl.iov = NULL;
+    tmpl.iovcnt = tmpl.iovoff = 0;
 
     ret = HANDLE_RLAYER_WRITE_RETURN(sc,
         sc->rlayer.wrlmethod->write_records(sc->rlayer.wrl, &tmpl, 1));
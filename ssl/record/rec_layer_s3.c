@@ -48,6 +48,13 @@ int RECORD_LAYER_clear(RECORD_LAYER *rl)
     rl->alert_count = 0;
     rl->num_recs = 0;
     rl->curr_rec = 0;
+    rl->read_ref_held = 0;
+    rl->dyn_rec_sent = 0;
+    rl->dyn_rec_last = ossl_time_zero();
+    rl->ktls_bytes_written = 0;
+    rl->ktls_bytes_read = 0;
+    rl->sw_bytes_written = 0;
+    rl->sw_bytes_read = 0;
 
     BIO_free(rl->rrlnext);
     rl->rrlnext = NULL;
@@ -260,14 +267,59 @@ static int tls_write_check_pending(SSL_CONNECTION *s, uint8_t type,
     return 1;
 }
 
+static void set_write_template(OSSL_RECORD_TEMPLATE *tmpl, uint8_t type,
+    unsigned int version, const unsigned char *buf,
+    const SSL_IOVEC *iov, size_t iovcnt,
+    size_t off, size_t len)
+{
+    tmpl->type = type;
+    tmpl->version = version;
+    tmpl->buflen = len;
+    if (iov != NULL) {
+        tmpl->buf = NULL;
+        tmpl->iov = iov;
+        tmpl->iovcnt = iovcnt;
+        tmpl->iovoff = off;
+    } else {
+        tmpl->buf = buf + off;
+        tmpl->iov = NULL;
+        tmpl->iovcnt = tmpl->iovoff = 0;
+    }
+}
+
 /*
- * Call this to write data in records of type 'type' It will return <= 0 if
- * not all data has been sent or non-blocking IO.
+ * Writes len bytes in records of type 'type', taken either from buf or, if
+ * iov is not NULL, gathered from the iovcnt elements of iov. In the latter
+ * case buf only identifies the write for the retry checks. It will return
+ * <= 0 if not all data has been sent or non-blocking IO.
  */
-int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
-    size_t *written)
+/*
+ * Count |len| bytes of application data as sent or received, depending on
+ * |writing|, by kernel TLS or by our own record layer.
+ */
+static void rlayer_count_app_data(SSL_CONNECTION *s, int writing, size_t len)
+{
+#ifndef OPENSSL_NO_KTLS
+    if (writing && s->rlayer.wrlmethod == &ossl_ktls_record_method) {
+        s->rlayer.ktls_bytes_written += len;
+        return;
+    }
+    if (!writing && s->rlayer.rrlmethod == &ossl_ktls_record_method) {
+        s->rlayer.ktls_bytes_read += len;
+        return;
+    }
+#endif
+    if (writing)
+        s->rlayer.sw_bytes_written += len;
+    else
+        s->rlayer.sw_bytes_read += len;
+}
+
+static int ssl3_write_bytes_int(SSL *ssl, uint8_t type,
+    const unsigned char *buf,
+    const SSL_IOVEC *iov, size_t iovcnt,
+    size_t len, size_t *written)
 {
-    const unsigned char *buf = buf_;
     size_t tot;
     size_t n, max_send_fragment, split_send_fragment, maxpipes;
     int i;
@@ -397,9 +449,34 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
         && s->hello_retry_request == SSL_HRR_NONE)
         recversion = TLS1_VERSION;
 
+    if (type == SSL3_RT_APPLICATION_DATA && s->rlayer.dyn_rec_size > 0) {
+        OSSL_TIME now = ossl_time_now();
+
+        /* Start with small records again after the connection was idle */
+        if (!ossl_time_is_zero(s->rlayer.dyn_rec_idle)
+            && !ossl_time_is_zero(s->rlayer.dyn_rec_last)
+            && ossl_time_compare(ossl_time_subtract(now, s->rlayer.dyn_rec_last),
+                   s->rlayer.dyn_rec_idle)
+                > 0)
+            s->rlayer.dyn_rec_sent = 0;
+        s->rlayer.dyn_rec_last = now;
+    }
+
     for (;;) {
         size_t tmppipelen, remain;
         size_t j, lensofar = 0;
+        size_t frag = split_send_fragment;
+
+        /*
+         * Until enough application data has been sent, keep the records small
+         * so that the peer can start processing each of them as soon as the
+         * first few segments arrive.
+         */
+        if (type == SSL3_RT_APPLICATION_DATA
+            && s->rlayer.dyn_rec_size > 0
+            && s->rlayer.dyn_rec_sent < s->rlayer.dyn_rec_ramp
+            && frag > s->rlayer.dyn_rec_size)
+            frag = s->rlayer.dyn_rec_size;
 
         /*
          * Ask the record layer how it would like to split the amount of data
@@ -407,7 +484,7 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
          */
         maxpipes = s->rlayer.wrlmethod->get_max_records(s->rlayer.wrl, type, n,
             max_send_fragment,
-            &split_send_fragment);
+            &frag);
         /*
          * If max_pipelines is 0 then this means "undefined" and we default to
          * whatever the record layer wants to do. Otherwise we use the smallest
@@ -420,24 +497,21 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
         if (maxpipes > SSL_MAX_PIPELINES)
             maxpipes = SSL_MAX_PIPELINES;
 
-        if (split_send_fragment > max_send_fragment) {
+        if (frag > max_send_fragment) {
             SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
             return -1;
         }
 
-        if (n / maxpipes >= split_send_fragment) {
+        if (n / maxpipes >= frag) {
             /*
              * We have enough data to completely fill all available
              * pipelines
              */
-            for (j = 0; j < maxpipes; j++) {
-                tmpls[j].type = type;
-                tmpls[j].version = recversion;
-                tmpls[j].buf = &(buf[tot]) + (j * split_send_fragment);
-                tmpls[j].buflen = split_send_fragment;
-            }
+            for (j = 0; j < maxpipes; j++)
+                set_write_template(&tmpls[j], type, recversion, buf, iov,
+                    iovcnt, tot + j * frag, frag);
             /* Remember how much data we are going to be sending */
-            s->rlayer.wpend_tot = maxpipes * split_send_fragment;
+            s->rlayer.wpend_tot = maxpipes * frag;
         } else {
             /* We can partially fill all available pipelines */
             tmppipelen = n / maxpipes;
@@ -449,10 +523,8 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
             if (remain > 0)
                 tmppipelen++;
             for (j = 0; j < maxpipes; j++) {
-                tmpls[j].type = type;
-                tmpls[j].version = recversion;
-                tmpls[j].buf = &(buf[tot]) + lensofar;
-                tmpls[j].buflen = tmppipelen;
+                set_write_template(&tmpls[j], type, recversion, buf, iov,
+                    iovcnt, tot + lensofar, tmppipelen);
                 lensofar += tmppipelen;
                 if (j + 1 == remain)
                     tmppipelen--;
@@ -463,6 +535,10 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
 
         i = HANDLE_RLAYER_WRITE_RETURN(s,
             s->rlayer.wrlmethod->write_records(s->rlayer.wrl, tmpls, maxpipes));
+        if (type == SSL3_RT_APPLICATION_DATA) {
+            s->rlayer.dyn_rec_sent += s->rlayer.wpend_tot;
+            rlayer_count_app_data(s, 1, s->rlayer.wpend_tot);
+        }
         if (i <= 0) {
             /* SSLfatal() already called if appropriate */
             s->rlayer.wnum = tot;
@@ -482,6 +558,27 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
     }
 }
 
+/*
+ * Call this to write data in records of type 'type' It will return <= 0 if
+ * not all data has been sent or non-blocking IO.
+ */
+int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf, size_t len,
+    size_t *written)
+{
+    return ssl3_write_bytes_int(ssl, type, buf, NULL, 0, len, written);
+}
+
+/*
+ * As ssl3_write_bytes() but gathers the len bytes to write from the iovcnt
+ * elements of iov. Retries must pass the same iov.
+ */
+int ssl3_writev_bytes(SSL *ssl, uint8_t type, const SSL_IOVEC *iov,
+    size_t iovcnt, size_t len, size_t *written)
+{
+    return ssl3_write_bytes_int(ssl, type, (const unsigned char *)iov, iov,
+        iovcnt, len, written);
+}
+
 int ossl_tls_handle_rlayer_return(SSL_CONNECTION *s, int writing, int ret,
     char *file, int line)
 {
@@ -588,6 +685,53 @@ int ssl_release_record(SSL_CONNECTION *s, TLS_RECORD *rr, size_t length)
     return 1;
 }
 
+/*
+ * Hand the application data at the head of the record layer to the caller
+ * without copying it. The caller must have peeked at it first, so that any
+ * handshake, alert or empty records in front of it have been processed.
+ */
+int ssl3_read_ref(SSL_CONNECTION *s, const unsigned char **buf,
+    size_t *readbytes)
+{
+    TLS_RECORD *rr;
+
+    if (!ossl_assert(s->rlayer.curr_rec < s->rlayer.num_recs)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+    rr = &s->rlayer.tlsrecs[s->rlayer.curr_rec];
+    if (!ossl_assert(rr->type == SSL3_RT_APPLICATION_DATA
+            && rr->length > 0)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    *buf = &(rr->data[rr->off]);
+    *readbytes = rr->length;
+    s->rlayer.read_ref_held = 1;
+
+    return 1;
+}
+
+int ssl3_read_ref_release(SSL_CONNECTION *s, size_t num)
+{
+    if (!s->rlayer.read_ref_held
+        || num > s->rlayer.tlsrecs[s->rlayer.curr_rec].length) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+
+    s->rlayer.read_ref_held = 0;
+
+    /* A length of 0 would release the whole record */
+    if (num > 0
+        && !ssl_release_record(s, &s->rlayer.tlsrecs[s->rlayer.curr_rec], num))
+        return 0;
+    rlayer_count_app_data(s, 0, num);
+
+    return 1;
+}
+
 /*-
  * Return up to 'len' payload bytes received in 'type' records.
  * 'type' is one of the following:
@@ -631,6 +775,12 @@ int ssl3_read_bytes(SSL *ssl, uint8_t type, uint8_t *recvd_type,
 
     is_tls13 = SSL_CONNECTION_IS_TLS13(s);
 
+    /* No reads are permitted until a held reference has been released. */
+    if (s->rlayer.read_ref_held) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
+        return -1;
+    }
+
     if ((type != 0
             && (type != SSL3_RT_APPLICATION_DATA)
             && (type != SSL3_RT_HANDSHAKE))
@@ -690,16 +840,29 @@ start:
      */
     /* get new records if necessary */
     if (s->rlayer.curr_rec >= s->rlayer.num_recs) {
+        /*
+         * If the whole of the next record can be returned by this call, let
+         * the record layer decrypt it straight into the caller's buffer.
+         */
+        int use_dest = type == SSL3_RT_APPLICATION_DATA && !peek && len > 0
+            && s->rlayer.rrlmethod->set_read_dest != NULL;
+
         s->rlayer.curr_rec = s->rlayer.num_recs = 0;
         do {
             rr = &s->rlayer.tlsrecs[s->rlayer.num_recs];
 
+            if (use_dest)
+                s->rlayer.rrlmethod->set_read_dest(s->rlayer.rrl, buf, len);
             ret = HANDLE_RLAYER_READ_RETURN(s,
                 s->rlayer.rrlmethod->read_record(s->rlayer.rrl,
                     &rr->rechandle,
                     &rr->version, &rr->type,
                     &rr->data, &rr->length,
                     NULL, NULL));
+            if (use_dest) {
+                s->rlayer.rrlmethod->set_read_dest(s->rlayer.rrl, NULL, 0);
+                use_dest = 0;
+            }
             if (ret <= 0) {
                 /* SSLfatal() already called if appropriate */
                 return ret;
@@ -795,7 +958,9 @@ start:
             else
                 n = len - totalbytes;
 
-            memcpy(buf, &(rr->data[rr->off]), n);
+            /* The record may already have been decrypted into |buf| */
+            if (&(rr->data[rr->off]) != buf)
+                memcpy(buf, &(rr->data[rr->off]), n);
             buf += n;
             if (peek) {
                 /* Mark any zero length record as consumed CVE-2016-6305 */
@@ -818,6 +983,8 @@ start:
             /* We must have read empty records. Get more data */
             goto start;
         }
+        if (type == SSL3_RT_APPLICATION_DATA && !peek)
+            rlayer_count_app_data(s, 0, totalbytes);
         *readbytes = totalbytes;
         return 1;
     }
@@ -1146,11 +1313,30 @@ static size_t rlayer_padding_wrapper(void *cbarg, int type, size_t len)
         s->rlayer.record_padding_arg);
 }
 
+static OSSL_FUNC_rlayer_alloc_buffer_fn rlayer_alloc_buffer_wrapper;
+static unsigned char *rlayer_alloc_buffer_wrapper(void *cbarg, size_t len)
+{
+    SSL_CONNECTION *s = cbarg;
+
+    return ssl_buf_pool_get(SSL_CONNECTION_GET_CTX(s)->buf_pool, len);
+}
+
+static OSSL_FUNC_rlayer_free_buffer_fn rlayer_free_buffer_wrapper;
+static void rlayer_free_buffer_wrapper(void *cbarg, unsigned char *buf,
+    size_t len)
+{
+    SSL_CONNECTION *s = cbarg;
+
+    ssl_buf_pool_put(SSL_CONNECTION_GET_CTX(s)->buf_pool, buf, len);
+}
+
 static const OSSL_DISPATCH rlayer_dispatch[] = {
     { OSSL_FUNC_RLAYER_SKIP_EARLY_DATA, (void (*)(void))ossl_statem_skip_early_data },
     { OSSL_FUNC_RLAYER_MSG_CALLBACK, (void (*)(void))rlayer_msg_callback_wrapper },
     { OSSL_FUNC_RLAYER_SECURITY, (void (*)(void))rlayer_security_wrapper },
     { OSSL_FUNC_RLAYER_PADDING, (void (*)(void))rlayer_padding_wrapper },
+    { OSSL_FUNC_RLAYER_ALLOC_BUFFER, (void (*)(void))rlayer_alloc_buffer_wrapper },
+    { OSSL_FUNC_RLAYER_FREE_BUFFER, (void (*)(void))rlayer_free_buffer_wrapper },
     OSSL_DISPATCH_END
 };
 
@@ -1418,6 +1604,11 @@ int ssl_set_new_record_layer(SSL_CONNECTION *s, int version,
                 if (s->rlayer.record_padding_cb == NULL)
                     continue;
                 break;
+            case OSSL_FUNC_RLAYER_ALLOC_BUFFER:
+            case OSSL_FUNC_RLAYER_FREE_BUFFER:
+                if (SSL_CONNECTION_GET_CTX(s)->buf_pool == NULL)
+                    continue;
+                break;
             default:
                 break;
             }
@@ -120,6 +120,24 @@ typedef struct record_layer_st {
     size_t block_padding;
     size_t hs_padding;
 
+    /*
+     * Dynamic record sizing, see SSL_set_dynamic_record_sizing(). Application
+     * data is sent in records of at most dyn_rec_size bytes until dyn_rec_sent
+     * reaches dyn_rec_ramp. The count restarts when no application data has
+     * been written for dyn_rec_idle since dyn_rec_last.
+     */
+    size_t dyn_rec_size;
+    size_t dyn_rec_ramp;
+    OSSL_TIME dyn_rec_idle;
+    size_t dyn_rec_sent;
+    OSSL_TIME dyn_rec_last;
+
+    /* Application data bytes sent and received with and without kernel TLS */
+    uint64_t ktls_bytes_written;
+    uint64_t ktls_bytes_read;
+    uint64_t sw_bytes_written;
+    uint64_t sw_bytes_read;
+
     /* How many records we have read from the record layer */
     size_t num_recs;
     /* The next record from the record layer that we need to process */
@@ -127,6 +145,17 @@ typedef struct record_layer_st {
     /* Record layer data to be processed */
     TLS_RECORD tlsrecs[SSL_MAX_PIPELINES];
 
+    /*
+     * Set while the application holds a reference to the data of the current
+     * record, see SSL_read_ref_ex(). No reads are allowed until it is released.
+     */
+    int read_ref_held;
+    /*
+     * Target of the one byte peek done by SSL_read_ref_ex(), which has to
+     * outlive the call if it is run in an async job
+     */
+    unsigned char read_ref_peek;
+
 } RECORD_LAYER;
 
 /*****************************************************************************
@@ -148,9 +177,14 @@ int RECORD_LAYER_write_pending(const RECORD_LAYER *rl);
 __owur size_t ssl3_pending(const SSL *s);
 __owur int ssl3_write_bytes(SSL *s, uint8_t type, const void *buf, size_t len,
     size_t *written);
+__owur int ssl3_writev_bytes(SSL *s, uint8_t type, const SSL_IOVEC *iov,
+    size_t iovcnt, size_t len, size_t *written);
 __owur int ssl3_read_bytes(SSL *s, uint8_t type, uint8_t *recvd_type,
     unsigned char *buf, size_t len, int peek,
     size_t *readbytes);
+__owur int ssl3_read_ref(SSL_CONNECTION *s, const unsigned char **buf,
+    size_t *readbytes);
+__owur int ssl3_read_ref_release(SSL_CONNECTION *s, size_t num);
 
 int DTLS_RECORD_LAYER_new(RECORD_LAYER *rl);
 void DTLS_RECORD_LAYER_free(RECORD_LAYER *rl);
@@ -194,5 +228,9 @@ OSSL_CORE_MAKE_FUNC(void, rlayer_msg_callback, (int write_p, int version, int co
 OSSL_CORE_MAKE_FUNC(int, rlayer_security, (void *cbarg, int op, int bits, int nid, void *other))
 #define OSSL_FUNC_RLAYER_PADDING 4
 OSSL_CORE_MAKE_FUNC(size_t, rlayer_padding, (void *cbarg, int type, size_t len))
+#define OSSL_FUNC_RLAYER_ALLOC_BUFFER 5
+OSSL_CORE_MAKE_FUNC(unsigned char *, rlayer_alloc_buffer, (void *cbarg, size_t len))
+#define OSSL_FUNC_RLAYER_FREE_BUFFER 6
+OSSL_CORE_MAKE_FUNC(void, rlayer_free_buffer, (void *cbarg, unsigned char *buf, size_t len))
 
 #endif /* !defined(OSSL_SSL_RECORD_RECORD_H) */
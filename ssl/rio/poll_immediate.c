@@ -1,5 +1,5 @@
 /*
- * Copyright 2024-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2024-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -63,7 +63,7 @@ static int poll_translate_ssl_quic(SSL *ssl,
     int *abort_blocking)
 {
     BIO_POLL_DESCRIPTOR rd, wd;
-    int fd1 = -1, fd2 = -1, fd_nfy = -1;
+    int fd1 = -1, fd2 = -1, fd_nfy = -1, fd_ps;
     int fd1_r = 0, fd1_w = 0, fd2_w = 0;
 
     if (SSL_net_read_desired(ssl)) {
@@ -111,13 +111,25 @@ static int poll_translate_ssl_quic(SSL *ssl,
         fd1_w = fd2_w;
     }
 
-    if (fd1 != -1)
-        if (!ossl_rio_poll_builder_add_fd(rpb, fd1, fd1_r, fd1_w))
-            return 0;
-
-    if (fd2 != -1 && fd2_w)
-        if (!ossl_rio_poll_builder_add_fd(rpb, fd2, /*r = */ 0, fd2_w))
+    /*
+     * If the QUIC domain keeps a persistent poll set, it already contains the
+     * network FDs with the events desired as well as the notifier FD, so a
+     * single FD covers all of them. All objects in the same domain share this
+     * FD, so it is only added to the poll builder once.
+     */
+    fd_ps = ossl_quic_get_poll_set_fd(ssl, fd1, fd2);
+    if (fd_ps != -1) {
+        if (!ossl_rio_poll_builder_add_fd(rpb, fd_ps, /*r = */ 1, /*w = */ 0))
             return 0;
+    } else {
+        if (fd1 != -1)
+            if (!ossl_rio_poll_builder_add_fd(rpb, fd1, fd1_r, fd1_w))
+                return 0;
+
+        if (fd2 != -1 && fd2_w)
+            if (!ossl_rio_poll_builder_add_fd(rpb, fd2, /*r = */ 0, fd2_w))
+                return 0;
+    }
 
     /*
      * Add the notifier FD for the QUIC domain this SSL object is a part of (if
@@ -130,7 +142,8 @@ static int poll_translate_ssl_quic(SSL *ssl,
     if (fd_nfy != -1) {
         uint64_t revents = 0;
 
-        if (!ossl_rio_poll_builder_add_fd(rpb, fd_nfy, /*r = */ 1, /*w = */ 0))
+        if (fd_ps == -1
+            && !ossl_rio_poll_builder_add_fd(rpb, fd_nfy, /*r = */ 1, /*w = */ 0))
             return 0;
 
         /* Tell QUIC domain we need to receive notifications. */
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <errno.h>
+#include <openssl/err.h>
+#include "internal/rio_poll_set.h"
+
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+int ossl_rio_poll_set_is_supported(void)
+{
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static void clear_slots(RIO_POLL_SET_SLOT *slots)
+{
+    size_t i;
+
+    for (i = 0; i < RIO_POLL_SET_NUM_SLOTS; ++i) {
+        slots[i].fd = -1;
+        slots[i].want_read = 0;
+        slots[i].want_write = 0;
+    }
+}
+
+int ossl_rio_poll_set_init(RIO_POLL_SET *ps)
+{
+    clear_slots(ps->slot);
+    clear_slots(ps->reg);
+    ps->num_reg = 0;
+
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+    ps->fd = epoll_create1(EPOLL_CLOEXEC);
+    if (ps->fd < 0) {
+        ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(),
+            "calling epoll_create1()");
+        return 0;
+    }
+
+    return 1;
+#else
+    ps->fd = -1;
+    ERR_raise_data(ERR_LIB_SSL, ERR_R_UNSUPPORTED,
+        "persistent poll sets are not supported on this platform");
+    return 0;
+#endif
+}
+
+void ossl_rio_poll_set_cleanup(RIO_POLL_SET *ps)
+{
+    if (ps == NULL || ps->fd < 0)
+        return;
+
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+    close(ps->fd);
+#endif
+    ps->fd = -1;
+}
+
+void ossl_rio_poll_set_set_slot(RIO_POLL_SET *ps, size_t slot, int fd,
+    int want_read, int want_write)
+{
+    if (!ossl_assert(slot < RIO_POLL_SET_NUM_SLOTS))
+        return;
+
+    ps->slot[slot].fd = fd;
+    ps->slot[slot].want_read = (fd >= 0 && want_read);
+    ps->slot[slot].want_write = (fd >= 0 && want_write);
+}
+
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+static int do_ctl(RIO_POLL_SET *ps, int op, const RIO_POLL_SET_SLOT *r)
+{
+    struct epoll_event ev = { 0 };
+
+    ev.events = (r->want_read ? EPOLLIN : 0) | (r->want_write ? EPOLLOUT : 0);
+    ev.data.fd = r->fd;
+
+    if (epoll_ctl(ps->fd, op, r->fd, &ev) == 0)
+        return 1;
+
+    /*
+     * Our view of the kernel state can be stale if a registered FD was closed
+     * (which removes it from the set) and its number was then reused.
+     */
+    if (op == EPOLL_CTL_MOD && errno == ENOENT)
+        return do_ctl(ps, EPOLL_CTL_ADD, r);
+    if (op == EPOLL_CTL_ADD && errno == EEXIST)
+        return do_ctl(ps, EPOLL_CTL_MOD, r);
+
+    ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(), "calling epoll_ctl()");
+    return 0;
+}
+#endif
+
+void ossl_rio_poll_set_forget_fd(RIO_POLL_SET *ps, int fd)
+{
+    size_t i;
+
+    if (fd < 0)
+        return;
+
+    for (i = 0; i < ps->num_reg; ++i)
+        if (ps->reg[i].fd == fd)
+            break;
+
+    if (i == ps->num_reg)
+        return;
+
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+    /* Failure just means the kernel has already forgotten the FD. */
+    (void)epoll_ctl(ps->fd, EPOLL_CTL_DEL, fd, NULL);
+#endif
+    ps->reg[i] = ps->reg[--ps->num_reg];
+    ps->reg[ps->num_reg].fd = -1;
+}
+
+int ossl_rio_poll_set_sync(RIO_POLL_SET *ps)
+{
+    RIO_POLL_SET_SLOT want[RIO_POLL_SET_NUM_SLOTS];
+    size_t num_want = 0, i, j;
+    int ok = 1;
+
+    /* Merge slots referring to the same FD. */
+    for (i = 0; i < RIO_POLL_SET_NUM_SLOTS; ++i) {
+        if (ps->slot[i].fd < 0)
+            continue;
+
+        for (j = 0; j < num_want; ++j)
+            if (want[j].fd == ps->slot[i].fd)
+                break;
+
+        if (j == num_want)
+            want[num_want++] = ps->slot[i];
+        else {
+            want[j].want_read |= ps->slot[i].want_read;
+            want[j].want_write |= ps->slot[i].want_write;
+        }
+    }
+
+    /* Unregister FDs which are no longer wanted. */
+    for (i = 0; i < ps->num_reg;) {
+        for (j = 0; j < num_want; ++j)
+            if (want[j].fd == ps->reg[i].fd)
+                break;
+
+        if (j == num_want)
+            ossl_rio_poll_set_forget_fd(ps, ps->reg[i].fd);
+        else
+            ++i;
+    }
+
+    /* Register new FDs and update the events of changed ones. */
+    for (j = 0; j < num_want; ++j) {
+        for (i = 0; i < ps->num_reg; ++i)
+            if (ps->reg[i].fd == want[j].fd)
+                break;
+
+        if (i < ps->num_reg
+            && ps->reg[i].want_read == want[j].want_read
+            && ps->reg[i].want_write == want[j].want_write)
+            continue;
+
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+        if (!do_ctl(ps, i < ps->num_reg ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+                &want[j])) {
+            ok = 0;
+            continue;
+        }
+#endif
+
+        if (i == ps->num_reg)
+            ++ps->num_reg;
+        ps->reg[i] = want[j];
+    }
+
+    return ok;
+}
+
+int ossl_rio_poll_set_wait(RIO_POLL_SET *ps, OSSL_TIME deadline)
+{
+#if defined(RIO_POLL_SET_METHOD_EPOLL)
+    struct epoll_event ev[RIO_POLL_SET_NUM_SLOTS];
+    int rc, timeout_ms;
+
+    do {
+        if (ossl_time_is_infinite(deadline))
+            timeout_ms = -1;
+        else
+            timeout_ms = ossl_time2ms(ossl_time_subtract(deadline,
+                ossl_time_now()));
+
+        /*
+         * Readiness is level-triggered, so nothing is consumed here; the
+         * caller finds out what is ready by performing I/O.
+         */
+        rc = epoll_wait(ps->fd, ev, OSSL_NELEM(ev), timeout_ms);
+    } while (rc == -1 && errno == EINTR);
+
+    return rc < 0 ? 0 : 1;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Record buffer pool shared by all the connections of an SSL_CTX. Buffers are
+ * kept on a free list per size class, with the classes being multiples of
+ * BUF_POOL_CLASS_SIZE bytes. A buffer taken from the pool is always allocated
+ * with the full size of its class, so that it can be returned to the same
+ * class given only the length which was asked for. Buffers larger than the
+ * largest class are not pooled.
+ *
+ * While a buffer is on a free list its first bytes hold the link to the next
+ * one.
+ */
+
+#include <openssl/crypto.h>
+#include "ssl_local.h"
+
+#define BUF_POOL_CLASS_SIZE 4096
+/* Large enough for eight full TLSv1.3 records written together */
+#define BUF_POOL_NUM_CLASSES 40
+
+typedef struct buf_pool_entry_st {
+    struct buf_pool_entry_st *next;
+} BUF_POOL_ENTRY;
+
+struct ssl_buf_pool_st {
+    CRYPTO_RWLOCK *lock;
+    size_t max_bufs;
+    size_t num_bufs;
+    BUF_POOL_ENTRY *free_list[BUF_POOL_NUM_CLASSES];
+};
+
+static size_t buf_pool_class(size_t len)
+{
+    return (len + BUF_POOL_CLASS_SIZE - 1) / BUF_POOL_CLASS_SIZE;
+}
+
+SSL_BUF_POOL *ssl_buf_pool_new(size_t max_bufs)
+{
+    SSL_BUF_POOL *pool = OPENSSL_zalloc(sizeof(*pool));
+
+    if (pool == NULL)
+        return NULL;
+    if ((pool->lock = CRYPTO_THREAD_lock_new()) == NULL) {
+        OPENSSL_free(pool);
+        return NULL;
+    }
+    pool->max_bufs = max_bufs;
+    return pool;
+}
+
+void ssl_buf_pool_free(SSL_BUF_POOL *pool)
+{
+    BUF_POOL_ENTRY *e;
+    size_t i;
+
+    if (pool == NULL)
+        return;
+
+    for (i = 0; i < BUF_POOL_NUM_CLASSES; i++) {
+        while ((e = pool->free_list[i]) != NULL) {
+            pool->free_list[i] = e->next;
+            OPENSSL_free(e);
+        }
+    }
+    CRYPTO_THREAD_lock_free(pool->lock);
+    OPENSSL_free(pool);
+}
+
+/*
+ * Get a buffer of at least |len| bytes from |pool|. The buffer must be given
+ * back with ssl_buf_pool_put() with the same |len|, or freed with
+ * OPENSSL_free().
+ */
+unsigned char *ssl_buf_pool_get(SSL_BUF_POOL *pool, size_t len)
+{
+    size_t cls = buf_pool_class(len);
+    BUF_POOL_ENTRY *e = NULL;
+
+    if (pool == NULL || cls == 0 || cls > BUF_POOL_NUM_CLASSES)
+        return OPENSSL_malloc(len);
+
+    if (CRYPTO_THREAD_write_lock(pool->lock)) {
+        if ((e = pool->free_list[cls - 1]) != NULL) {
+            pool->free_list[cls - 1] = e->next;
+            pool->num_bufs--;
+        }
+        CRYPTO_THREAD_unlock(pool->lock);
+    }
+    if (e != NULL)
+        return (unsigned char *)e;
+
+    return OPENSSL_malloc(cls * BUF_POOL_CLASS_SIZE);
+}
+
+/*
+ * Return |buf|, which was obtained from ssl_buf_pool_get() for |len| bytes,
+ * to |pool|. It is freed if the pool is full.
+ */
+void ssl_buf_pool_put(SSL_BUF_POOL *pool, unsigned char *buf, size_t len)
+{
+    size_t cls = buf_pool_class(len);
+    BUF_POOL_ENTRY *e = (BUF_POOL_ENTRY *)buf;
+
+    if (buf == NULL)
+        return;
+
+    if (pool != NULL && cls > 0 && cls <= BUF_POOL_NUM_CLASSES
+        && CRYPTO_THREAD_write_lock(pool->lock)) {
+        if (pool->num_bufs < pool->max_bufs) {
+            e->next = pool->free_list[cls - 1];
+            pool->free_list[cls - 1] = e;
+            pool->num_bufs++;
+            e = NULL;
+        }
+        CRYPTO_THREAD_unlock(pool->lock);
+    }
+    OPENSSL_free(e);
+}
+
+int SSL_CTX_set_buffer_pool(SSL_CTX *ctx, size_t max_buffers)
+{
+    SSL_BUF_POOL *pool = NULL;
+
+    if (max_buffers != 0 && (pool = ssl_buf_pool_new(max_buffers)) == NULL)
+        return 0;
+    ssl_buf_pool_free(ctx->buf_pool);
+    ctx->buf_pool = pool;
+    return 1;
+}
@@ -202,6 +202,9 @@ CERT *ssl_cert_dup(CERT *cert)
     ret->cert_cb = cert->cert_cb;
     ret->cert_cb_arg = cert->cert_cb_arg;
 
+    ret->pkey_cb = cert->pkey_cb;
+    ret->pkey_cb_arg = cert->pkey_cb_arg;
+
     if (cert->verify_store) {
         if (!X509_STORE_up_ref(cert->verify_store))
             goto err;
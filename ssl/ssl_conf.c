@@ -721,6 +721,50 @@ out:
     return rv;
 }
 
+static int cmd_DynamicRecordSizing(SSL_CONF_CTX *cctx, const char *value)
+{
+    int rv = 0;
+    unsigned long vals[3] = { 0, SSL_DYN_REC_DEFAULT_RAMP,
+        SSL_DYN_REC_DEFAULT_IDLE_MS };
+    char *copy = NULL, *p, *commap;
+    size_t i;
+
+    copy = OPENSSL_strdup(value);
+    if (copy == NULL)
+        goto out;
+    for (i = 0, p = copy; i < OSSL_NELEM(vals); i++, p = commap + 1) {
+        commap = strchr(p, ',');
+        if (commap != NULL)
+            *commap = '\0';
+        if (!OPENSSL_strtoul(p, NULL, 0, &vals[i]))
+            goto out;
+        if (commap == NULL)
+            break;
+    }
+    /* Too many values */
+    if (commap != NULL)
+        goto out;
+
+    /* As for RecordPadding, silently ignore this config option for QUIC */
+    if (cctx->ctx) {
+        if (SSL_CTX_is_quic(cctx->ctx))
+            rv = 1;
+        else
+            rv = SSL_CTX_set_dynamic_record_sizing(cctx->ctx, (size_t)vals[0],
+                (size_t)vals[1], (uint64_t)vals[2]);
+    }
+    if (cctx->ssl) {
+        if (SSL_is_quic(cctx->ssl))
+            rv = 1;
+        else
+            rv = SSL_set_dynamic_record_sizing(cctx->ssl, (size_t)vals[0],
+                (size_t)vals[1], (uint64_t)vals[2]);
+    }
+out:
+    OPENSSL_free(copy);
+    return rv;
+}
+
 static int cmd_NumTickets(SSL_CONF_CTX *cctx, const char *value)
 {
     int rv = 0;
@@ -840,6 +884,7 @@ static const ssl_conf_cmd_tbl ssl_conf_cmds[] = {
         SSL_CONF_FLAG_SERVER | SSL_CONF_FLAG_CERTIFICATE,
         SSL_CONF_TYPE_FILE),
     SSL_CONF_CMD_STRING(RecordPadding, "record_padding", 0),
+    SSL_CONF_CMD_STRING(DynamicRecordSizing, NULL, 0),
     SSL_CONF_CMD_STRING(NumTickets, "num_tickets", SSL_CONF_FLAG_SERVER),
 };
 
@@ -32,6 +32,7 @@
 #include "internal/ktls.h"
 #include "internal/to_hex.h"
 #include "internal/ssl_unwrap.h"
+#include "internal/rio_poll_set.h"
 #include "quic/quic_local.h"
 
 #ifndef OPENSSL_NO_SSLKEYLOG
@@ -39,6 +40,10 @@
 #include <fcntl.h>
 #endif
 
+#ifdef OPENSSL_SYS_UNIX
+#include <unistd.h>
+#endif
+
 static int ssl_undefined_function_3(SSL_CONNECTION *sc, unsigned char *r,
     unsigned char *s, size_t t, size_t *u)
 {
@@ -90,8 +95,12 @@ struct ssl_async_args {
     SSL *s;
     void *buf;
     size_t num;
+    /* Only for WRITEVFUNC */
+    const SSL_IOVEC *iov;
+    size_t iovcnt;
     enum { READFUNC,
         WRITEFUNC,
+        WRITEVFUNC,
         OTHERFUNC } type;
     union {
         int (*func_read)(SSL *, void *, size_t, size_t *);
@@ -788,6 +797,9 @@ SSL *ossl_ssl_connection_new_int(SSL_CTX *ctx, SSL *user_ssl,
     s->rlayer.record_padding_arg = ctx->record_padding_arg;
     s->rlayer.block_padding = ctx->block_padding;
     s->rlayer.hs_padding = ctx->hs_padding;
+    s->rlayer.dyn_rec_size = ctx->dyn_rec_size;
+    s->rlayer.dyn_rec_ramp = ctx->dyn_rec_ramp;
+    s->rlayer.dyn_rec_idle = ctx->dyn_rec_idle;
     s->sid_ctx_length = ctx->sid_ctx_length;
     if (!ossl_assert(s->sid_ctx_length <= sizeof(s->sid_ctx)))
         goto err;
@@ -1087,6 +1099,7 @@ int SSL_has_matching_session_id(const SSL *ssl, const unsigned char *id,
      * by this SSL.
      */
     SSL_SESSION r, *p;
+    SSL_SESS_SHARD *sh;
     const SSL_CONNECTION *sc = SSL_CONNECTION_FROM_CONST_SSL(ssl);
 
     if (sc == NULL || id_len > sizeof(r.session_id))
@@ -1096,10 +1109,11 @@ int SSL_has_matching_session_id(const SSL *ssl, const unsigned char *id,
     r.session_id_length = id_len;
     memcpy(r.session_id, id, id_len);
 
-    if (!CRYPTO_THREAD_read_lock(sc->session_ctx->lock))
+    sh = ssl_sess_get_shard(sc->session_ctx, &r);
+    if (!CRYPTO_THREAD_read_lock(sh->lock))
         return 0;
-    p = lh_SSL_SESSION_retrieve(sc->session_ctx->sessions, &r);
-    CRYPTO_THREAD_unlock(sc->session_ctx->lock);
+    p = lh_SSL_SESSION_retrieve(sh->sessions, &r);
+    CRYPTO_THREAD_unlock(sh->lock);
     return (p != NULL);
 }
 
@@ -2398,6 +2412,8 @@ static int ssl_io_intern(void *vargs)
         return args->f.func_read(s, buf, num, &sc->asyncrw);
     case WRITEFUNC:
         return args->f.func_write(s, buf, num, &sc->asyncrw);
+    case WRITEVFUNC:
+        return ssl3_writev(s, args->iov, args->iovcnt, num, &sc->asyncrw);
     case OTHERFUNC:
         return args->f.func_other(s);
     }
@@ -2658,8 +2674,13 @@ int SSL_peek_ex(SSL *s, void *buf, size_t num, size_t *readbytes)
     return ret;
 }
 
-int ssl_write_internal(SSL *s, const void *buf, size_t num,
-    uint64_t flags, size_t *written)
+/*
+ * Writes num bytes from buf or, if iov is not NULL, gathered from the iovcnt
+ * elements of iov. The latter is only supported for TLS.
+ */
+static int ssl_write_intern(SSL *s, const void *buf, const SSL_IOVEC *iov,
+    size_t iovcnt, size_t num, uint64_t flags,
+    size_t *written)
 {
     int ret;
     SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(s);
@@ -2711,20 +2732,35 @@ int ssl_write_internal(SSL *s, const void *buf, size_t num,
         args.s = s;
         args.buf = (void *)buf;
         args.num = num;
-        args.type = WRITEFUNC;
-        args.f.func_write = s->method->ssl_write;
+        args.iov = iov;
+        args.iovcnt = iovcnt;
+        if (iov != NULL) {
+            args.type = WRITEVFUNC;
+        } else {
+            args.type = WRITEFUNC;
+            args.f.func_write = s->method->ssl_write;
+        }
 
         ret = ssl_start_async_job(s, &args, ssl_io_intern);
         *written = sc->asyncrw;
         ssl_update_error_state(sc);
         return ret;
     } else {
-        ret = s->method->ssl_write(s, buf, num, written);
+        if (iov != NULL)
+            ret = ssl3_writev(s, iov, iovcnt, num, written);
+        else
+            ret = s->method->ssl_write(s, buf, num, written);
         ssl_update_error_state(sc);
         return ret;
     }
 }
 
+int ssl_write_internal(SSL *s, const void *buf, size_t num,
+    uint64_t flags, size_t *written)
+{
+    return ssl_write_intern(s, buf, NULL, 0, num, flags, written);
+}
+
 ossl_ssize_t SSL_sendfile(SSL *s, int fd, off_t offset, size_t size, int flags)
 {
     SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL_ONLY(s);
@@ -2793,6 +2829,8 @@ ossl_ssize_t SSL_sendfile(SSL *s, int fd, off_t offset, size_t size, int flags)
     if (ret < 0) {
         if (BIO_sock_should_retry(ret)) {
             BIO_set_retry_write(sc->wbio);
+            if (sbytes > 0)
+                sc->rlayer.ktls_bytes_written += sbytes;
             return (sbytes > 0 ? sbytes : ret);
         } else {
             ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(),
@@ -2802,10 +2840,142 @@ ossl_ssize_t SSL_sendfile(SSL *s, int fd, off_t offset, size_t size, int flags)
         return ret;
     }
     sc->rwstate = SSL_NOTHING;
+    sc->rlayer.ktls_bytes_written += sbytes;
     return sbytes;
 #endif
 }
 
+/*
+ * Read one record of application data with SSL_read_ex() and write it to
+ * |fd|. This is used when the data cannot be spliced from the socket.
+ */
+static ossl_ssize_t ssl_recvfile_copy(SSL *s, SSL_CONNECTION *sc, int fd,
+    off_t offset, size_t size)
+{
+#ifdef OPENSSL_SYS_UNIX
+    unsigned char *buf;
+    size_t readbytes, done = 0;
+    ossl_ssize_t ret;
+
+    if (size > SSL3_RT_MAX_PLAIN_LENGTH)
+        size = SSL3_RT_MAX_PLAIN_LENGTH;
+    if ((buf = OPENSSL_malloc(size)) == NULL)
+        return -1;
+
+    if (!SSL_read_ex(s, buf, size, &readbytes)) {
+        OPENSSL_free(buf);
+        return 0;
+    }
+
+    while (done < readbytes) {
+        clear_sys_error();
+        if (offset >= 0)
+            ret = pwrite(fd, buf + done, readbytes - done,
+                offset + (off_t)done);
+        else
+            ret = write(fd, buf + done, readbytes - done);
+        if (ret <= 0) {
+            if (ret < 0 && get_last_sys_error() == EINTR)
+                continue;
+            ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(),
+                "write to file descriptor failed");
+            sc->statem.error_state = ERROR_STATE_SYSCALL;
+            OPENSSL_clear_free(buf, size);
+            return -1;
+        }
+        done += ret;
+    }
+    OPENSSL_clear_free(buf, size);
+    return (ossl_ssize_t)done;
+#else
+    ERR_raise_data(ERR_LIB_SSL, ERR_R_UNSUPPORTED,
+        "can't write to a file descriptor on this platform");
+    sc->statem.error_state = ERROR_STATE_SSL;
+    return -1;
+#endif
+}
+
+ossl_ssize_t SSL_recvfile(SSL *s, int fd, off_t offset, size_t size, int flags)
+{
+    SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL_ONLY(s);
+#if !defined(OPENSSL_NO_KTLS) && !defined(OPENSSL_NO_KTLS_RX)
+    ossl_ssize_t rbytes;
+    int ret;
+#endif
+
+    if (sc == NULL)
+        return 0;
+
+    if (ssl_reset_error_state(sc) == 0)
+        return -1;
+
+    if (sc->handshake_func == NULL) {
+        ERR_raise(ERR_LIB_SSL, SSL_R_UNINITIALIZED);
+        sc->statem.error_state = ERROR_STATE_SSL;
+        return -1;
+    }
+
+#if !defined(OPENSSL_NO_KTLS) && !defined(OPENSSL_NO_KTLS_RX)
+    /*
+     * Records which have already been read into the record layer, records
+     * which are not application data and the end of the connection are
+     * handled by SSL_read_ex(). Everything else is spliced directly from the
+     * socket.
+     */
+    if (BIO_get_ktls_recv(sc->rbio)
+        && SSL_is_init_finished(s)
+        && !SSL_has_pending(s)
+        && (sc->shutdown & SSL_RECEIVED_SHUTDOWN) == 0) {
+        clear_sys_error();
+        ret = ktls_splice_read(SSL_get_rfd(s), fd,
+            offset >= 0 ? &offset : NULL, size, &rbytes);
+        BIO_clear_retry_flags(sc->rbio);
+        if (ret == 0 && rbytes > 0) {
+            sc->rwstate = SSL_NOTHING;
+            sc->rlayer.ktls_bytes_read += rbytes;
+            return rbytes;
+        }
+        if (ret == -1 && BIO_sock_should_retry(ret)) {
+            sc->rwstate = SSL_READING;
+            BIO_set_retry_read(sc->rbio);
+#ifdef EAGAIN
+            set_sys_error(EAGAIN);
+#endif
+            return -1;
+        }
+        if (ret == -2
+            || (ret == -1 && get_last_sys_error() != EINVAL
+                && get_last_sys_error() != EOPNOTSUPP)) {
+            ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(),
+                "ktls_splice_read failure");
+            sc->statem.error_state = ERROR_STATE_SYSCALL;
+            return -1;
+        }
+    }
+#endif
+
+    return ssl_recvfile_copy(s, sc, fd, offset, size);
+}
+
+int SSL_get_ktls_stats(const SSL *s, uint64_t *ktls_sent, uint64_t *sw_sent,
+    uint64_t *ktls_received, uint64_t *sw_received)
+{
+    const SSL_CONNECTION *sc = SSL_CONNECTION_FROM_CONST_SSL_ONLY(s);
+
+    if (sc == NULL)
+        return 0;
+
+    if (ktls_sent != NULL)
+        *ktls_sent = sc->rlayer.ktls_bytes_written;
+    if (sw_sent != NULL)
+        *sw_sent = sc->rlayer.sw_bytes_written;
+    if (ktls_received != NULL)
+        *ktls_received = sc->rlayer.ktls_bytes_read;
+    if (sw_received != NULL)
+        *sw_received = sc->rlayer.sw_bytes_read;
+    return 1;
+}
+
 int SSL_write(SSL *s, const void *buf, int num)
 {
     int ret;
@@ -2848,6 +3018,165 @@ int SSL_write_ex2(SSL *s, const void *buf, size_t num, uint64_t flags,
     return ret;
 }
 
+int SSL_read_ref_ex(SSL *s, const unsigned char **buf, size_t *readbytes)
+{
+    SSL_CONNECTION *sc;
+
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s))
+        return ossl_quic_read_ref(s, buf, readbytes);
+#endif
+
+    sc = SSL_CONNECTION_FROM_SSL_ONLY(s);
+    if (sc == NULL || SSL_CONNECTION_IS_DTLS(sc))
+        return 0;
+
+    *buf = NULL;
+
+    /*
+     * Peeking at the first byte drives the handshake and processes anything
+     * in front of the next application data, exactly as SSL_peek_ex() would.
+     * That data is then left in the current record for us to hand out.
+     */
+    if (ssl_peek_internal(s, &sc->rlayer.read_ref_peek, 1, readbytes) <= 0)
+        return 0;
+
+    return ssl3_read_ref(sc, buf, readbytes);
+}
+
+int SSL_read_ref_release(SSL *s, size_t num)
+{
+    SSL_CONNECTION *sc;
+
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s))
+        return ossl_quic_read_ref_release(s, num);
+#endif
+
+    sc = SSL_CONNECTION_FROM_SSL_ONLY(s);
+    if (sc == NULL || SSL_CONNECTION_IS_DTLS(sc))
+        return 0;
+
+    return ssl3_read_ref_release(sc, num);
+}
+
+int SSL_write_ref_ex(SSL *s, const void *buf, size_t num, uint64_t flags,
+    SSL_write_ref_release_cb_fn release_cb, void *arg,
+    size_t *written)
+{
+#ifndef OPENSSL_NO_QUIC
+    if (!IS_QUIC(s))
+        return 0;
+
+    return ossl_quic_write_ref(s, buf, num, flags, release_cb, arg, written);
+#else
+    return 0;
+#endif
+}
+
+int SSL_readv_ex(SSL *s, const SSL_IOVEC *iov, size_t iovcnt,
+    size_t *readbytes)
+{
+    size_t i, tot = 0, n;
+
+    for (i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0)
+            continue;
+        /*
+         * Only the first read may block or fail, the others just take what is
+         * already decrypted.
+         */
+        if (tot > 0 && SSL_pending(s) == 0)
+            break;
+        if (!SSL_read_ex(s, iov[i].iov_base, iov[i].iov_len, &n)) {
+            if (tot == 0)
+                return 0;
+            break;
+        }
+        tot += n;
+        if (n < iov[i].iov_len)
+            break;
+    }
+
+    *readbytes = tot;
+    return 1;
+}
+
+/*
+ * DTLS sends everything written in one call in one record, so for DTLS the
+ * data is gathered into a single buffer and written in the usual way.
+ */
+static int ssl_writev_copy(SSL *s, const SSL_IOVEC *iov, size_t iovcnt,
+    size_t num, size_t *written)
+{
+    unsigned char *buf, *p;
+    size_t i;
+    int ret;
+
+    if ((buf = OPENSSL_malloc(num > 0 ? num : 1)) == NULL)
+        return 0;
+    for (i = 0, p = buf; i < iovcnt; p += iov[i++].iov_len)
+        if (iov[i].iov_len > 0)
+            memcpy(p, iov[i].iov_base, iov[i].iov_len);
+    ret = ssl_write_internal(s, buf, num, 0, written);
+    OPENSSL_clear_free(buf, num);
+    return ret;
+}
+
+int SSL_writev_ex(SSL *s, const SSL_IOVEC *iov, size_t iovcnt,
+    size_t *written)
+{
+    SSL_CONNECTION *sc;
+    size_t i, num = 0;
+    int ret;
+
+    for (i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len > SIZE_MAX - num) {
+            ERR_raise(ERR_LIB_SSL, SSL_R_BAD_LENGTH);
+            return 0;
+        }
+        num += iov[i].iov_len;
+    }
+
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s)) {
+        size_t tot = 0, n;
+
+        /*
+         * The stream buffers the data anyway, so the fragments are simply
+         * written in turn. Stop at the first one which was not written in
+         * full, the caller retries with the rest.
+         */
+        for (i = 0; i < iovcnt; i++) {
+            if (iov[i].iov_len == 0)
+                continue;
+            if (!ossl_quic_write_flags(s, iov[i].iov_base, iov[i].iov_len, 0,
+                    &n)) {
+                if (tot == 0)
+                    return 0;
+                break;
+            }
+            tot += n;
+            if (n < iov[i].iov_len)
+                break;
+        }
+        *written = tot;
+        return 1;
+    }
+#endif
+
+    if ((sc = SSL_CONNECTION_FROM_SSL_ONLY(s)) == NULL)
+        return 0;
+    if (SSL_CONNECTION_IS_DTLS(sc))
+        ret = ssl_writev_copy(s, iov, iovcnt, num, written);
+    else
+        ret = ssl_write_intern(s, NULL, iov, iovcnt, num, 0, written);
+    if (ret < 0)
+        ret = 0;
+
+    return ret;
+}
+
 int SSL_write_early_data(SSL *s, const void *buf, size_t num, size_t *written)
 {
     int ret, early_data_state;
@@ -3295,7 +3624,10 @@ long SSL_callback_ctrl(SSL *s, int cmd, void (*fp)(void))
 
 LHASH_OF(SSL_SESSION) *SSL_CTX_sessions(SSL_CTX *ctx)
 {
-    return ctx->sessions;
+    /* A sharded cache has no single table to return. */
+    if (ctx->num_sess_shards != 1)
+        return NULL;
+    return ctx->sess_shards[0].sessions;
 }
 
 static int ssl_tsan_load(SSL_CTX *ctx, TSAN_QUALIFIER int *stat)
@@ -3361,9 +3693,29 @@ long SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
         return l;
     case SSL_CTRL_GET_SESS_CACHE_MODE:
         return ctx->session_cache_mode;
+    case SSL_CTRL_SET_SESS_CACHE_SHARDS: {
+        size_t num = 1;
+
+        if (larg < 1 || larg > SSL_SESS_CACHE_MAX_SHARDS) {
+            ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+            return 0;
+        }
+        if (ssl_sess_cache_number(ctx) != 0) {
+            ERR_raise(ERR_LIB_SSL, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
+            return 0;
+        }
+        while (num < (size_t)larg)
+            num <<= 1;
+        l = (long)ctx->num_sess_shards;
+        if (num != ctx->num_sess_shards && !ssl_sess_cache_new(ctx, num))
+            return 0;
+        return l;
+    }
+    case SSL_CTRL_GET_SESS_CACHE_SHARDS:
+        return (long)ctx->num_sess_shards;
 
     case SSL_CTRL_SESS_NUMBER:
-        return lh_SSL_SESSION_num_items(ctx->sessions);
+        return (long)ssl_sess_cache_number(ctx);
     case SSL_CTRL_SESS_CONNECT:
         return ssl_tsan_load(ctx, &ctx->stats.sess_connect);
     case SSL_CTRL_SESS_CONNECT_GOOD:
@@ -4107,38 +4459,6 @@ int SSL_export_keying_material_early(SSL *s, unsigned char *out, size_t olen,
         context, contextlen);
 }
 
-static unsigned long ssl_session_hash(const SSL_SESSION *a)
-{
-    const unsigned char *session_id = a->session_id;
-    unsigned long l;
-    unsigned char tmp_storage[4];
-
-    if (a->session_id_length < sizeof(tmp_storage)) {
-        memset(tmp_storage, 0, sizeof(tmp_storage));
-        memcpy(tmp_storage, a->session_id, a->session_id_length);
-        session_id = tmp_storage;
-    }
-
-    l = (unsigned long)((unsigned long)session_id[0]) | ((unsigned long)session_id[1] << 8L) | ((unsigned long)session_id[2] << 16L) | ((unsigned long)session_id[3] << 24L);
-    return l;
-}
-
-/*
- * NB: If this function (or indeed the hash function which uses a sort of
- * coarser function than this one) is changed, ensure
- * SSL_CTX_has_matching_session_id() is checked accordingly. It relies on
- * being able to construct an SSL_SESSION that will collide with any existing
- * session with a matching session ID.
- */
-static int ssl_session_cmp(const SSL_SESSION *a, const SSL_SESSION *b)
-{
-    if (a->ssl_version != b->ssl_version)
-        return 1;
-    if (a->session_id_length != b->session_id_length)
-        return 1;
-    return memcmp(a->session_id, b->session_id, a->session_id_length);
-}
-
 #ifndef OPENSSL_NO_SSLKEYLOG
 /**
  * @brief Static initialization for a one-time action to initialize the SSL key log.
@@ -4320,8 +4640,7 @@ SSL_CTX *SSL_CTX_new_ex(OSSL_LIB_CTX *libctx, const char *propq,
     ret->max_cert_list = SSL_MAX_CERT_LIST_DEFAULT;
     ret->verify_mode = SSL_VERIFY_NONE;
 
-    ret->sessions = lh_SSL_SESSION_new(ssl_session_hash, ssl_session_cmp);
-    if (ret->sessions == NULL) {
+    if (!ssl_sess_cache_new(ret, 1)) {
         ERR_raise(ERR_LIB_SSL, ERR_R_CRYPTO_LIB);
         goto err;
     }
@@ -4624,7 +4943,7 @@ void SSL_CTX_free(SSL_CTX *a)
      * free ex_data, then finally free the cache.
      * (See ticket [openssl.org #212].)
      */
-    if (a->sessions != NULL)
+    if (a->sess_shards != NULL)
         SSL_CTX_flush_sessions_ex(a, 0);
 
     EVP_MAC_free(a->hmac);
@@ -4635,7 +4954,9 @@ void SSL_CTX_free(SSL_CTX *a)
 #endif
 
     CRYPTO_free_ex_data(CRYPTO_EX_INDEX_SSL_CTX, a, &a->ex_data);
-    lh_SSL_SESSION_free(a->sessions);
+    ssl_sess_cache_free(a);
+    ssl_shm_sess_cache_free(a->shm_sess_cache);
+    ssl_buf_pool_free(a->buf_pool);
     X509_STORE_free(a->cert_store);
 #ifndef OPENSSL_NO_CT
     CTLOG_STORE_free(a->ctlog_store);
@@ -4808,6 +5129,24 @@ void SSL_set_cert_cb(SSL *s, int (*cb)(SSL *ssl, void *arg), void *arg)
     ssl_cert_set_cert_cb(sc->cert, cb, arg);
 }
 
+void SSL_CTX_set_private_key_cb(SSL_CTX *ctx, SSL_private_key_cb_fn cb,
+    void *arg)
+{
+    ctx->cert->pkey_cb = cb;
+    ctx->cert->pkey_cb_arg = arg;
+}
+
+void SSL_set_private_key_cb(SSL *s, SSL_private_key_cb_fn cb, void *arg)
+{
+    SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(s);
+
+    if (sc == NULL)
+        return;
+
+    sc->cert->pkey_cb = cb;
+    sc->cert->pkey_cb_arg = arg;
+}
+
 void ssl_set_masks(SSL_CONNECTION *s)
 {
     CERT *c = s->cert;
@@ -5019,6 +5358,19 @@ void ssl_update_cache(SSL_CONNECTION *s, int mode)
                     s->session))
                 SSL_SESSION_free(s->session);
         }
+
+        /*
+         * Add the session to the shared session cache. Only sessions which
+         * are looked up by ID on the server are stored there, and not those
+         * allowing early data: replay protection relies on such a session
+         * being removed from the cache of the one process that saw it.
+         */
+        if (s->session_ctx->shm_sess_cache != NULL && s->server
+            && (!SSL_CONNECTION_IS_TLS13(s)
+                || (s->options & SSL_OP_NO_TICKET) != 0)
+            && s->session->ext.max_early_data == 0)
+            (void)ssl_shm_sess_cache_add(s->session_ctx->shm_sess_cache,
+                s->session);
     }
 
     /* auto flush every 255 connections */
@@ -5172,6 +5524,8 @@ int ossl_ssl_get_error(const SSL *s, int i, int check_err)
         return SSL_ERROR_WANT_ASYNC_JOB;
     if (SSL_want_client_hello_cb(s))
         return SSL_ERROR_WANT_CLIENT_HELLO_CB;
+    if (SSL_want_private_key_operation(s))
+        return SSL_ERROR_WANT_PRIVATE_KEY_OPERATION;
 
     if ((sc->shutdown & SSL_RECEIVED_SHUTDOWN) && (sc->s3.warn_alert == SSL_AD_CLOSE_NOTIFY))
         return SSL_ERROR_ZERO_RETURN;
@@ -6317,6 +6671,43 @@ int SSL_set_block_padding(SSL *ssl, size_t block_size)
     return SSL_set_block_padding_ex(ssl, block_size, block_size);
 }
 
+int SSL_CTX_set_dynamic_record_sizing(SSL_CTX *ctx, size_t initial_size,
+    size_t ramp_bytes, uint64_t idle_ms)
+{
+    if (IS_QUIC_CTX(ctx) && initial_size > 0)
+        return 0;
+
+    if (initial_size != 0
+        && (initial_size < SSL_DYN_REC_MIN_SIZE
+            || initial_size > SSL3_RT_MAX_PLAIN_LENGTH))
+        return 0;
+
+    ctx->dyn_rec_size = initial_size;
+    ctx->dyn_rec_ramp = ramp_bytes;
+    ctx->dyn_rec_idle = ossl_ms2time(idle_ms);
+    return 1;
+}
+
+int SSL_set_dynamic_record_sizing(SSL *ssl, size_t initial_size,
+    size_t ramp_bytes, uint64_t idle_ms)
+{
+    SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(ssl);
+
+    if (sc == NULL || (IS_QUIC(ssl) && initial_size > 0))
+        return 0;
+
+    if (initial_size != 0
+        && (initial_size < SSL_DYN_REC_MIN_SIZE
+            || initial_size > SSL3_RT_MAX_PLAIN_LENGTH))
+        return 0;
+
+    sc->rlayer.dyn_rec_size = initial_size;
+    sc->rlayer.dyn_rec_ramp = ramp_bytes;
+    sc->rlayer.dyn_rec_idle = ossl_ms2time(idle_ms);
+    sc->rlayer.dyn_rec_sent = 0;
+    return 1;
+}
+
 int SSL_set_num_tickets(SSL *s, size_t num_tickets)
 {
     SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(s);
@@ -8340,6 +8731,14 @@ int ossl_adjust_domain_flags(uint64_t domain_flags, uint64_t *p_domain_flags)
     }
 #endif
 
+#ifndef RIO_POLL_SET_METHOD_EPOLL
+    if ((domain_flags & SSL_DOMAIN_FLAG_EPOLL) != 0) {
+        ERR_raise_data(ERR_LIB_SSL, ERR_R_UNSUPPORTED,
+            "epoll not available on this platform");
+        return 0;
+    }
+#endif
+
     *p_domain_flags = domain_flags;
     return 1;
 }
@@ -302,6 +302,15 @@
 #define GET_MAX_FRAGMENT_LENGTH(session) \
     (512U << (session->ext.max_fragment_len_mode - 1))
 
+/*
+ * Limits and defaults for dynamic record sizing. The default initial record
+ * size leaves room for the TLS record overhead in a typical TCP segment.
+ */
+#define SSL_DYN_REC_MIN_SIZE 512
+#define SSL_DYN_REC_DEFAULT_SIZE 1369
+#define SSL_DYN_REC_DEFAULT_RAMP (1024 * 1024)
+#define SSL_DYN_REC_DEFAULT_IDLE_MS 1000
+
 #define SSL_READ_ETM(s) (s->s3.flags & TLS1_FLAGS_ENCRYPT_THEN_MAC_READ)
 #define SSL_WRITE_ETM(s) (s->s3.flags & TLS1_FLAGS_ENCRYPT_THEN_MAC_WRITE)
 
@@ -575,11 +584,13 @@ struct ssl_session_st {
     unsigned char *ticket_appdata;
     size_t ticket_appdata_len;
     uint32_t flags;
-    SSL_CTX *owner;
+    /* The session cache shard this session is in, if any. */
+    struct ssl_sess_shard_st *owner;
 
     /*
      * These are used to make removal of session-ids more efficient and to
-     * implement a maximum cache size. Access requires protection of ctx->lock.
+     * implement a maximum cache size. Access requires protection of the lock
+     * of the owning shard.
      */
     struct ssl_session_st *prev, *next;
     CRYPTO_REF_COUNT references;
@@ -816,6 +827,31 @@ typedef struct {
 #define OPENSSL_HAVE_TLS1PRF
 #endif
 
+/* Upper limit on the number of shards of the internal session cache. */
+#define SSL_SESS_CACHE_MAX_SHARDS 256
+
+/*
+ * One part of the internal session cache. Sessions are assigned to a shard by
+ * a hash of their session ID, and each shard is locked independently so that
+ * lookups and insertions in different shards do not contend.
+ */
+typedef struct ssl_sess_shard_st {
+    CRYPTO_RWLOCK *lock;
+    LHASH_OF(SSL_SESSION) *sessions;
+    /*
+     * Sessions in this shard ordered by timeout, latest first. Sessions are
+     * evicted from the tail.
+     */
+    struct ssl_session_st *session_cache_head;
+    struct ssl_session_st *session_cache_tail;
+} SSL_SESS_SHARD;
+
+/* Cross-process session cache in shared memory, see ssl_sess_shm.c. */
+typedef struct ssl_shm_sess_cache_st SSL_SHM_SESS_CACHE;
+
+/* Pool of record buffers, see ssl_buf_pool.c. */
+typedef struct ssl_buf_pool_st SSL_BUF_POOL;
+
 struct ssl_ctx_st {
     OSSL_LIB_CTX *libctx;
 
@@ -826,7 +862,23 @@ struct ssl_ctx_st {
     /* TLSv1.3 specific ciphersuites */
     STACK_OF(SSL_CIPHER) *tls13_ciphersuites;
     struct x509_store_st /* X509_STORE */ *cert_store;
-    LHASH_OF(SSL_SESSION) *sessions;
+    /*
+     * The internal session cache, split into num_sess_shards shards. There is
+     * a single shard unless configured otherwise with
+     * SSL_CTX_sess_set_cache_shards(). Always a power of two.
+     */
+    SSL_SESS_SHARD *sess_shards;
+    size_t num_sess_shards;
+    /*
+     * Session cache shared with other processes, set with
+     * SSL_CTX_set_shared_session_cache(). NULL if there is none.
+     */
+    SSL_SHM_SESS_CACHE *shm_sess_cache;
+    /*
+     * Pool the record layers take their buffers from, set with
+     * SSL_CTX_set_buffer_pool(). NULL if there is none.
+     */
+    SSL_BUF_POOL *buf_pool;
     EVP_MAC *hmac;
     EVP_MD *sha256;
     EVP_CIPHER *tktenc;
@@ -838,8 +890,6 @@ struct ssl_ctx_st {
      * SSL_SESSION_CACHE_MAX_SIZE_DEFAULT. 0 is unlimited.
      */
     size_t session_cache_size;
-    struct ssl_session_st *session_cache_head;
-    struct ssl_session_st *session_cache_tail;
     /*
      * This can have one of 2 values, ored together, SSL_SESS_CACHE_CLIENT,
      * SSL_SESS_CACHE_SERVER, Default is SSL_SESSION_CACHE_SERVER, which
@@ -1156,6 +1206,11 @@ struct ssl_ctx_st {
     size_t block_padding;
     size_t hs_padding;
 
+    /* Dynamic record sizing */
+    size_t dyn_rec_size;
+    size_t dyn_rec_ramp;
+    OSSL_TIME dyn_rec_idle;
+
     /* Session ticket appdata */
     SSL_CTX_generate_session_ticket_fn generate_ticket_cb;
     SSL_CTX_decrypt_session_ticket_fn decrypt_ticket_cb;
@@ -1414,6 +1469,12 @@ struct ssl_connection_st {
             const struct sigalg_lookup_st *sigalg;
             /* Pointer to certificate we use */
             CERT_PKEY *cert;
+            /*
+             * Set while the private key callback is being retried, so that
+             * the message to be signed is constructed again with the same key
+             * exchange values.
+             */
+            int sig_retry;
             /*
              * signature algorithms peer reports: e.g. supported signature
              * algorithms extension for server or as part of a certificate
@@ -2190,6 +2251,9 @@ typedef struct cert_st {
      */
     int (*cert_cb)(SSL *ssl, void *arg);
     void *cert_cb_arg;
+    /* Callback to sign handshake messages instead of using the private key */
+    SSL_private_key_cb_fn pkey_cb;
+    void *pkey_cb_arg;
     /*
      * Optional X509_STORE for chain building or certificate validation If
      * NULL the parent SSL_CTX store is used instead.
@@ -2489,6 +2553,22 @@ __owur SSL_SESSION *lookup_sess_in_cache(SSL_CONNECTION *s,
     const unsigned char *sess_id,
     size_t sess_id_len);
 __owur int ssl_get_prev_session(SSL_CONNECTION *s, CLIENTHELLO_MSG *hello);
+__owur int ssl_sess_cache_new(SSL_CTX *ctx, size_t num_shards);
+void ssl_sess_cache_free(SSL_CTX *ctx);
+size_t ssl_sess_cache_number(const SSL_CTX *ctx);
+SSL_SESS_SHARD *ssl_sess_get_shard(SSL_CTX *ctx, const SSL_SESSION *s);
+SSL_SHM_SESS_CACHE *ssl_shm_sess_cache_new(size_t num_slots,
+    size_t max_sess_len);
+void ssl_shm_sess_cache_free(SSL_SHM_SESS_CACHE *c);
+int ssl_shm_sess_cache_add(SSL_SHM_SESS_CACHE *c, const SSL_SESSION *sess);
+SSL_SESSION *ssl_shm_sess_cache_get(SSL_SHM_SESS_CACHE *c, SSL_CTX *ctx,
+    const unsigned char *id, size_t id_len);
+void ssl_shm_sess_cache_remove(SSL_SHM_SESS_CACHE *c, const unsigned char *id,
+    size_t id_len);
+SSL_BUF_POOL *ssl_buf_pool_new(size_t max_bufs);
+void ssl_buf_pool_free(SSL_BUF_POOL *pool);
+unsigned char *ssl_buf_pool_get(SSL_BUF_POOL *pool, size_t len);
+void ssl_buf_pool_put(SSL_BUF_POOL *pool, unsigned char *buf, size_t len);
 __owur SSL_SESSION *ssl_session_dup(const SSL_SESSION *src, int ticket);
 __owur int ssl_cipher_id_cmp(const SSL_CIPHER *a, const SSL_CIPHER *b);
 DECLARE_OBJ_BSEARCH_GLOBAL_CMP_FN(SSL_CIPHER, SSL_CIPHER, ssl_cipher_id);
@@ -2624,6 +2704,8 @@ void ssl3_free(SSL *s);
 __owur int ssl3_read(SSL *s, void *buf, size_t len, size_t *readbytes);
 __owur int ssl3_peek(SSL *s, void *buf, size_t len, size_t *readbytes);
 __owur int ssl3_write(SSL *s, const void *buf, size_t len, size_t *written);
+__owur int ssl3_writev(SSL *s, const SSL_IOVEC *iov, size_t iovcnt,
+    size_t len, size_t *written);
 __owur int ssl3_shutdown(SSL *s);
 int ssl3_clear(SSL *s);
 __owur long ssl3_ctrl(SSL *s, int cmd, long larg, void *parg);
@@ -3055,6 +3137,6 @@ long ossl_ctrl_internal(SSL *s, int cmd, long larg, void *parg, int no_quic);
 
 /* Total mask of domain flags supported on a QUIC SSL_CTX. */
 #define OSSL_QUIC_SUPPORTED_DOMAIN_FLAGS \
-    (SSL_DOMAIN_FLAG_SINGLE_THREAD | SSL_DOMAIN_FLAG_MULTI_THREAD | SSL_DOMAIN_FLAG_THREAD_ASSISTED | SSL_DOMAIN_FLAG_BLOCKING | SSL_DOMAIN_FLAG_LEGACY_BLOCKING)
+    (SSL_DOMAIN_FLAG_SINGLE_THREAD | SSL_DOMAIN_FLAG_MULTI_THREAD | SSL_DOMAIN_FLAG_THREAD_ASSISTED | SSL_DOMAIN_FLAG_BLOCKING | SSL_DOMAIN_FLAG_LEGACY_BLOCKING | SSL_DOMAIN_FLAG_EPOLL)
 
 #endif
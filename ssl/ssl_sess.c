@@ -16,13 +16,14 @@
 #include <openssl/rand.h>
 #include "internal/refcount.h"
 #include "internal/cryptlib.h"
+#include "internal/hashfunc.h"
 #include "internal/ssl_unwrap.h"
 #include "ssl_local.h"
 #include "statem/statem_local.h"
 
-static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s);
-static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s);
-static SSL_SESSION *remove_session_locked(SSL_CTX *ctx, SSL_SESSION *c);
+static void SSL_SESSION_list_remove(SSL_SESS_SHARD *sh, SSL_SESSION *s);
+static void SSL_SESSION_list_add(SSL_SESS_SHARD *sh, SSL_SESSION *s);
+static SSL_SESSION *remove_session_locked(SSL_SESS_SHARD *sh, SSL_SESSION *c);
 
 DEFINE_STACK_OF(SSL_SESSION)
 
@@ -40,6 +41,123 @@ __owur static ossl_inline int timeoutcmp(SSL_SESSION *a, SSL_SESSION *b)
     return ossl_time_compare(a->calc_timeout, b->calc_timeout);
 }
 
+static unsigned long ssl_session_hash(const SSL_SESSION *a)
+{
+    const unsigned char *session_id = a->session_id;
+    unsigned long l;
+    unsigned char tmp_storage[4];
+
+    if (a->session_id_length < sizeof(tmp_storage)) {
+        memset(tmp_storage, 0, sizeof(tmp_storage));
+        memcpy(tmp_storage, a->session_id, a->session_id_length);
+        session_id = tmp_storage;
+    }
+
+    l = (unsigned long)((unsigned long)session_id[0]) | ((unsigned long)session_id[1] << 8L) | ((unsigned long)session_id[2] << 16L) | ((unsigned long)session_id[3] << 24L);
+    return l;
+}
+
+/*
+ * NB: If this function (or indeed the hash function which uses a sort of
+ * coarser function than this one) is changed, ensure
+ * SSL_CTX_has_matching_session_id() is checked accordingly. It relies on
+ * being able to construct an SSL_SESSION that will collide with any existing
+ * session with a matching session ID.
+ */
+static int ssl_session_cmp(const SSL_SESSION *a, const SSL_SESSION *b)
+{
+    if (a->ssl_version != b->ssl_version)
+        return 1;
+    if (a->session_id_length != b->session_id_length)
+        return 1;
+    return memcmp(a->session_id, b->session_id, a->session_id_length);
+}
+
+static void sess_shards_free(SSL_SESS_SHARD *shards, size_t num)
+{
+    size_t i;
+
+    if (shards == NULL)
+        return;
+
+    for (i = 0; i < num; i++) {
+        lh_SSL_SESSION_free(shards[i].sessions);
+        CRYPTO_THREAD_lock_free(shards[i].lock);
+    }
+    OPENSSL_free(shards);
+}
+
+/*
+ * Replaces the internal session cache of ctx, which must be empty, with a new
+ * one of num shards.
+ */
+int ssl_sess_cache_new(SSL_CTX *ctx, size_t num)
+{
+    SSL_SESS_SHARD *shards;
+    size_t i;
+
+    if ((shards = OPENSSL_calloc(num, sizeof(*shards))) == NULL)
+        return 0;
+
+    for (i = 0; i < num; i++) {
+        shards[i].sessions = lh_SSL_SESSION_new(ssl_session_hash,
+            ssl_session_cmp);
+        shards[i].lock = CRYPTO_THREAD_lock_new();
+        if (shards[i].sessions == NULL || shards[i].lock == NULL) {
+            sess_shards_free(shards, num);
+            return 0;
+        }
+    }
+
+    sess_shards_free(ctx->sess_shards, ctx->num_sess_shards);
+    ctx->sess_shards = shards;
+    ctx->num_sess_shards = num;
+    return 1;
+}
+
+void ssl_sess_cache_free(SSL_CTX *ctx)
+{
+    sess_shards_free(ctx->sess_shards, ctx->num_sess_shards);
+    ctx->sess_shards = NULL;
+    ctx->num_sess_shards = 0;
+}
+
+size_t ssl_sess_cache_number(const SSL_CTX *ctx)
+{
+    size_t i, n = 0;
+
+    for (i = 0; i < ctx->num_sess_shards; i++)
+        n += lh_SSL_SESSION_num_items(ctx->sess_shards[i].sessions);
+    return n;
+}
+
+/*
+ * Returns the shard of the internal session cache of ctx which holds sessions
+ * with the session ID of s. The shard is chosen using a different hash from
+ * the one used within each shard, so that sessions remain evenly spread over
+ * the buckets of every shard.
+ */
+SSL_SESS_SHARD *ssl_sess_get_shard(SSL_CTX *ctx, const SSL_SESSION *s)
+{
+    uint64_t h;
+
+    if (ctx->num_sess_shards == 1)
+        return &ctx->sess_shards[0];
+
+    h = ossl_fnv1a_hash((uint8_t *)s->session_id, s->session_id_length);
+    return &ctx->sess_shards[h & (ctx->num_sess_shards - 1)];
+}
+
+/*
+ * The cache size limit applies to each shard in proportion, so the number of
+ * cached sessions may slightly exceed it when the shards are unevenly filled.
+ */
+static size_t sess_shard_cache_size(const SSL_CTX *ctx)
+{
+    return (ctx->session_cache_size + ctx->num_sess_shards - 1)
+        / ctx->num_sess_shards;
+}
+
 /*
  * Calculates effective timeout
  * Locking must be done by the caller of this function
@@ -506,6 +624,7 @@ SSL_SESSION *lookup_sess_in_cache(SSL_CONNECTION *s,
             & SSL_SESS_CACHE_NO_INTERNAL_LOOKUP)
         == 0) {
         SSL_SESSION data;
+        SSL_SESS_SHARD *sh;
 
         data.ssl_version = s->version;
         if (!ossl_assert(sess_id_len <= SSL_MAX_SSL_SESSION_ID_LENGTH))
@@ -514,21 +633,35 @@ SSL_SESSION *lookup_sess_in_cache(SSL_CONNECTION *s,
         memcpy(data.session_id, sess_id, sess_id_len);
         data.session_id_length = sess_id_len;
 
-        if (!CRYPTO_THREAD_read_lock(s->session_ctx->lock))
+        sh = ssl_sess_get_shard(s->session_ctx, &data);
+        if (!CRYPTO_THREAD_read_lock(sh->lock))
             return NULL;
-        ret = lh_SSL_SESSION_retrieve(s->session_ctx->sessions, &data);
+        ret = lh_SSL_SESSION_retrieve(sh->sessions, &data);
         if (ret != NULL) {
             /* don't allow other threads to steal it: */
             if (!SSL_SESSION_up_ref(ret)) {
-                CRYPTO_THREAD_unlock(s->session_ctx->lock);
+                CRYPTO_THREAD_unlock(sh->lock);
                 return NULL;
             }
         }
-        CRYPTO_THREAD_unlock(s->session_ctx->lock);
+        CRYPTO_THREAD_unlock(sh->lock);
         if (ret == NULL)
             ssl_tsan_counter(s->session_ctx, &s->session_ctx->stats.sess_miss);
     }
 
+    if (ret == NULL && s->session_ctx->shm_sess_cache != NULL) {
+        ret = ssl_shm_sess_cache_get(s->session_ctx->shm_sess_cache,
+            s->session_ctx, sess_id, sess_id_len);
+        if (ret != NULL) {
+            ssl_tsan_counter(s->session_ctx,
+                &s->session_ctx->stats.sess_cb_hit);
+            if ((s->session_ctx->session_cache_mode
+                    & SSL_SESS_CACHE_NO_INTERNAL_STORE)
+                == 0)
+                (void)SSL_CTX_add_session(s->session_ctx, ret);
+        }
+    }
+
     if (ret == NULL && s->session_ctx->get_session_cb != NULL) {
         int copy = 1;
 
@@ -764,6 +897,8 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
 {
     int ret = 0;
     SSL_SESSION *s;
+    SSL_SESS_SHARD *sh = ssl_sess_get_shard(ctx, c);
+    size_t max;
 
     /*
      * add just 1 reference count for the SSL_CTX's session cache even though
@@ -776,20 +911,20 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
      * if session c is in already in cache, we take back the increment later
      */
 
-    if (!CRYPTO_THREAD_write_lock(ctx->lock)) {
+    if (!CRYPTO_THREAD_write_lock(sh->lock)) {
         SSL_SESSION_free(c);
         return 0;
     }
-    s = lh_SSL_SESSION_insert(ctx->sessions, c);
+    s = lh_SSL_SESSION_insert(sh->sessions, c);
 
     /*
      * s != NULL iff we already had a session with the given PID. In this
      * case, s == c should hold (then we did not really modify
-     * ctx->sessions), or we're in trouble.
+     * sh->sessions), or we're in trouble.
      */
     if (s != NULL && s != c) {
         /* We *are* in trouble ... */
-        SSL_SESSION_list_remove(ctx, s);
+        SSL_SESSION_list_remove(sh, s);
         SSL_SESSION_free(s);
         /*
          * ... so pretend the other session did not exist in cache (we cannot
@@ -798,7 +933,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
          * obtain the same session from an external cache)
          */
         s = NULL;
-    } else if (s == NULL && lh_SSL_SESSION_retrieve(ctx->sessions, c) == NULL) {
+    } else if (s == NULL && lh_SSL_SESSION_retrieve(sh->sessions, c) == NULL) {
         /* s == NULL can also mean OOM error in lh_SSL_SESSION_insert ... */
 
         /*
@@ -830,9 +965,10 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
 
         ret = 1;
 
-        if (SSL_CTX_sess_get_cache_size(ctx) > 0) {
-            while (SSL_CTX_sess_number(ctx) >= SSL_CTX_sess_get_cache_size(ctx)) {
-                SSL_SESSION *r = remove_session_locked(ctx, ctx->session_cache_tail);
+        max = sess_shard_cache_size(ctx);
+        if (max > 0) {
+            while (lh_SSL_SESSION_num_items(sh->sessions) >= max) {
+                SSL_SESSION *r = remove_session_locked(sh, sh->session_cache_tail);
 
                 if (r == NULL)
                     break;
@@ -842,7 +978,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
             }
         }
 
-        SSL_SESSION_list_add(ctx, c);
+        SSL_SESSION_list_add(sh, c);
     }
 
     if (s != NULL) {
@@ -854,7 +990,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
         SSL_SESSION_free(s); /* s == c */
         ret = 0;
     }
-    CRYPTO_THREAD_unlock(ctx->lock);
+    CRYPTO_THREAD_unlock(sh->lock);
 
     while (evicted_head != NULL) {
         SSL_SESSION *next = evicted_head->next;
@@ -872,13 +1008,15 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
 int SSL_CTX_remove_session(SSL_CTX *ctx, SSL_SESSION *c)
 {
     SSL_SESSION *r;
+    SSL_SESS_SHARD *sh;
 
     if (c == NULL || c->session_id_length == 0)
         return 0;
-    if (!CRYPTO_THREAD_write_lock(ctx->lock))
+    sh = ssl_sess_get_shard(ctx, c);
+    if (!CRYPTO_THREAD_write_lock(sh->lock))
         return 0;
-    r = remove_session_locked(ctx, c);
-    CRYPTO_THREAD_unlock(ctx->lock);
+    r = remove_session_locked(sh, c);
+    CRYPTO_THREAD_unlock(sh->lock);
 
     /*
      * The callback is invoked even when the session is not in the internal
@@ -886,24 +1024,27 @@ int SSL_CTX_remove_session(SSL_CTX *ctx, SSL_SESSION *c)
      */
     if (ctx->remove_session_cb != NULL)
         ctx->remove_session_cb(ctx, c);
+    if (ctx->shm_sess_cache != NULL)
+        ssl_shm_sess_cache_remove(ctx->shm_sess_cache, c->session_id,
+            c->session_id_length);
     SSL_SESSION_free(r);
     return r != NULL;
 }
 
 /*
- * Removes c from the session cache. Caller must hold ctx->lock.
+ * Removes c from the session cache shard sh. Caller must hold sh->lock.
  * Returns the removed session (caller must invoke remove_session_cb and
  * SSL_SESSION_free), or NULL if not found.
  */
-static SSL_SESSION *remove_session_locked(SSL_CTX *ctx, SSL_SESSION *c)
+static SSL_SESSION *remove_session_locked(SSL_SESS_SHARD *sh, SSL_SESSION *c)
 {
     SSL_SESSION *r = NULL;
 
     if (c != NULL && c->session_id_length != 0) {
-        r = lh_SSL_SESSION_retrieve(ctx->sessions, c);
+        r = lh_SSL_SESSION_retrieve(sh->sessions, c);
         if (r != NULL) {
-            r = lh_SSL_SESSION_delete(ctx->sessions, r);
-            SSL_SESSION_list_remove(ctx, r);
+            r = lh_SSL_SESSION_delete(sh->sessions, r);
+            SSL_SESSION_list_remove(sh, r);
         }
         c->not_resumable = 1;
     }
@@ -1274,39 +1415,45 @@ void SSL_CTX_flush_sessions_ex(SSL_CTX *s, time_t t)
 {
     STACK_OF(SSL_SESSION) *sk;
     SSL_SESSION *current;
+    SSL_SESS_SHARD *sh;
     unsigned long i;
+    size_t n;
     const OSSL_TIME timeout = ossl_time_from_time_t(t);
 
-    if (!CRYPTO_THREAD_write_lock(s->lock))
-        return;
-
     sk = sk_SSL_SESSION_new_null();
-    i = lh_SSL_SESSION_get_down_load(s->sessions);
-    lh_SSL_SESSION_set_down_load(s->sessions, 0);
 
-    /*
-     * Iterate over the list from the back (oldest), and stop
-     * when a session can no longer be removed.
-     * Collect removed sessions on a stack to be processed outside the lock,
-     * so that remove_session_cb is never invoked while holding ctx->lock.
-     * If the stack failed to create, or a push fails, free the session
-     * immediately (without invoking the callback).
-     */
-    while (s->session_cache_tail != NULL) {
-        current = s->session_cache_tail;
-        if (t == 0 || sess_timedout(timeout, current)) {
-            lh_SSL_SESSION_delete(s->sessions, current);
-            SSL_SESSION_list_remove(s, current);
-            current->not_resumable = 1;
-            if (sk == NULL || !sk_SSL_SESSION_push(sk, current))
-                SSL_SESSION_free(current);
-        } else {
-            break;
+    for (n = 0; n < s->num_sess_shards; n++) {
+        sh = &s->sess_shards[n];
+        if (!CRYPTO_THREAD_write_lock(sh->lock))
+            continue;
+
+        i = lh_SSL_SESSION_get_down_load(sh->sessions);
+        lh_SSL_SESSION_set_down_load(sh->sessions, 0);
+
+        /*
+         * Iterate over the list from the back (oldest), and stop
+         * when a session can no longer be removed.
+         * Collect removed sessions on a stack to be processed outside the
+         * lock, so that remove_session_cb is never invoked while holding
+         * sh->lock. If the stack failed to create, or a push fails, free the
+         * session immediately (without invoking the callback).
+         */
+        while (sh->session_cache_tail != NULL) {
+            current = sh->session_cache_tail;
+            if (t == 0 || sess_timedout(timeout, current)) {
+                lh_SSL_SESSION_delete(sh->sessions, current);
+                SSL_SESSION_list_remove(sh, current);
+                current->not_resumable = 1;
+                if (sk == NULL || !sk_SSL_SESSION_push(sk, current))
+                    SSL_SESSION_free(current);
+            } else {
+                break;
+            }
         }
-    }
 
-    lh_SSL_SESSION_set_down_load(s->sessions, i);
-    CRYPTO_THREAD_unlock(s->lock);
+        lh_SSL_SESSION_set_down_load(sh->sessions, i);
+        CRYPTO_THREAD_unlock(sh->lock);
+    }
 
     while (sk_SSL_SESSION_num(sk) > 0) {
         current = sk_SSL_SESSION_pop(sk);
@@ -1326,27 +1473,27 @@ int ssl_clear_bad_session(SSL_CONNECTION *s)
         return 0;
 }
 
-/* locked by SSL_CTX in the calling function */
-static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s)
+/* locked by the shard in the calling function */
+static void SSL_SESSION_list_remove(SSL_SESS_SHARD *sh, SSL_SESSION *s)
 {
     if ((s->next == NULL) || (s->prev == NULL))
         return;
 
-    if (s->next == (SSL_SESSION *)&(ctx->session_cache_tail)) {
+    if (s->next == (SSL_SESSION *)&(sh->session_cache_tail)) {
         /* last element in list */
-        if (s->prev == (SSL_SESSION *)&(ctx->session_cache_head)) {
+        if (s->prev == (SSL_SESSION *)&(sh->session_cache_head)) {
             /* only one element in list */
-            ctx->session_cache_head = NULL;
-            ctx->session_cache_tail = NULL;
+            sh->session_cache_head = NULL;
+            sh->session_cache_tail = NULL;
         } else {
-            ctx->session_cache_tail = s->prev;
-            s->prev->next = (SSL_SESSION *)&(ctx->session_cache_tail);
+            sh->session_cache_tail = s->prev;
+            s->prev->next = (SSL_SESSION *)&(sh->session_cache_tail);
         }
     } else {
-        if (s->prev == (SSL_SESSION *)&(ctx->session_cache_head)) {
+        if (s->prev == (SSL_SESSION *)&(sh->session_cache_head)) {
             /* first element in list */
-            ctx->session_cache_head = s->next;
-            s->next->prev = (SSL_SESSION *)&(ctx->session_cache_head);
+            sh->session_cache_head = s->next;
+            s->next->prev = (SSL_SESSION *)&(sh->session_cache_head);
         } else {
             /* middle of list */
             s->next->prev = s->prev;
@@ -1357,41 +1504,41 @@ static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s)
     s->owner = NULL;
 }
 
-static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s)
+static void SSL_SESSION_list_add(SSL_SESS_SHARD *sh, SSL_SESSION *s)
 {
     SSL_SESSION *next;
 
     if ((s->next != NULL) && (s->prev != NULL))
-        SSL_SESSION_list_remove(ctx, s);
+        SSL_SESSION_list_remove(sh, s);
 
-    if (ctx->session_cache_head == NULL) {
-        ctx->session_cache_head = s;
-        ctx->session_cache_tail = s;
-        s->prev = (SSL_SESSION *)&(ctx->session_cache_head);
-        s->next = (SSL_SESSION *)&(ctx->session_cache_tail);
+    if (sh->session_cache_head == NULL) {
+        sh->session_cache_head = s;
+        sh->session_cache_tail = s;
+        s->prev = (SSL_SESSION *)&(sh->session_cache_head);
+        s->next = (SSL_SESSION *)&(sh->session_cache_tail);
     } else {
-        if (timeoutcmp(s, ctx->session_cache_head) >= 0) {
+        if (timeoutcmp(s, sh->session_cache_head) >= 0) {
             /*
              * if we timeout after (or the same time as) the first
              * session, put us first - usual case
              */
-            s->next = ctx->session_cache_head;
+            s->next = sh->session_cache_head;
             s->next->prev = s;
-            s->prev = (SSL_SESSION *)&(ctx->session_cache_head);
-            ctx->session_cache_head = s;
-        } else if (timeoutcmp(s, ctx->session_cache_tail) < 0) {
+            s->prev = (SSL_SESSION *)&(sh->session_cache_head);
+            sh->session_cache_head = s;
+        } else if (timeoutcmp(s, sh->session_cache_tail) < 0) {
             /* if we timeout before the last session, put us last */
-            s->prev = ctx->session_cache_tail;
+            s->prev = sh->session_cache_tail;
             s->prev->next = s;
-            s->next = (SSL_SESSION *)&(ctx->session_cache_tail);
-            ctx->session_cache_tail = s;
+            s->next = (SSL_SESSION *)&(sh->session_cache_tail);
+            sh->session_cache_tail = s;
         } else {
             /*
              * we timeout somewhere in-between - if there is only
              * one session in the cache it will be caught above
              */
-            next = ctx->session_cache_head->next;
-            while (next != (SSL_SESSION *)&(ctx->session_cache_tail)) {
+            next = sh->session_cache_head->next;
+            while (next != (SSL_SESSION *)&(sh->session_cache_tail)) {
                 if (timeoutcmp(s, next) >= 0) {
                     s->next = next;
                     s->prev = next->prev;
@@ -1403,7 +1550,7 @@ static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s)
             }
         }
     }
-    s->owner = ctx;
+    s->owner = sh;
 }
 
 void SSL_CTX_sess_set_new_cb(SSL_CTX *ctx,
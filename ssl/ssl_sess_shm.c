@@ -0,0 +1,357 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Shared memory session cache. Sessions are stored DER encoded in a fixed
+ * size table in an anonymous shared mapping, so that all processes forked
+ * from the one which created it see the same cache.
+ *
+ * The table is divided into buckets of SHM_SESS_WAYS slots and a session
+ * can only live in the bucket selected by the hash of its session ID. Each
+ * slot is protected by a sequence counter which is odd while the slot is
+ * being written. Writers claim a slot by moving its counter from even to odd
+ * with a compare and swap and never wait; if the slot is busy the session is
+ * simply not cached. Readers take no lock at all: they copy the slot and
+ * retry if the counter changed underneath them.
+ *
+ * A process which dies while writing a slot leaves it busy for good. That
+ * only loses the slot and is not worth a recovery protocol for a cache.
+ */
+
+#include <string.h>
+#include <time.h>
+#include <openssl/err.h>
+#include "internal/e_os.h"
+#include "internal/hashfunc.h"
+#include "ssl_local.h"
+
+#if defined(OPENSSL_SYS_UNIX) && defined(__GNUC__) \
+    && defined(__ATOMIC_ACQUIRE) && !defined(BROKEN_CLANG_ATOMICS)
+#include <sys/mman.h>
+#if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
+#define MAP_ANON MAP_ANONYMOUS
+#endif
+#if defined(MAP_ANON) && defined(MAP_SHARED)
+#define IMPLEMENTED
+#endif
+#endif
+
+#define SHM_SESS_WAYS 4
+#define SHM_SESS_DEFAULT_LEN 2048
+#define SHM_SESS_READ_RETRIES 4
+
+#ifdef IMPLEMENTED
+
+typedef struct {
+    uint32_t seq;
+    uint32_t der_len;
+    int64_t expiry;
+    unsigned char id_len;
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+} SHM_SESS_SLOT;
+
+/* The encoded session follows the slot header, suitably aligned. */
+#define SHM_SESS_SLOT_HDR_LEN ((sizeof(SHM_SESS_SLOT) + 7) & ~(size_t)7)
+
+struct ssl_shm_sess_cache_st {
+    unsigned char *map;
+    size_t map_size;
+    size_t num_buckets;
+    size_t slot_size;
+    size_t max_der_len;
+};
+
+static ossl_inline SHM_SESS_SLOT *shm_slot(SSL_SHM_SESS_CACHE *c, size_t i)
+{
+    return (SHM_SESS_SLOT *)(c->map + i * c->slot_size);
+}
+
+static ossl_inline unsigned char *shm_slot_der(SHM_SESS_SLOT *slot)
+{
+    return (unsigned char *)slot + SHM_SESS_SLOT_HDR_LEN;
+}
+
+static size_t shm_bucket(SSL_SHM_SESS_CACHE *c, const unsigned char *id,
+    size_t id_len)
+{
+    return (size_t)(ossl_fnv1a_hash((uint8_t *)id, id_len) % c->num_buckets)
+        * SHM_SESS_WAYS;
+}
+
+static ossl_inline uint32_t shm_seq_load(SHM_SESS_SLOT *slot)
+{
+    return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+}
+
+/* Claims the slot for writing if its counter is still |seq|. */
+static ossl_inline int shm_slot_claim(SHM_SESS_SLOT *slot, uint32_t seq)
+{
+    if ((seq & 1) != 0)
+        return 0;
+    return __atomic_compare_exchange_n(&slot->seq, &seq, seq + 1, 0,
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static ossl_inline void shm_slot_release(SHM_SESS_SLOT *slot, uint32_t seq)
+{
+    __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static ossl_inline int shm_slot_matches(SHM_SESS_SLOT *slot,
+    const unsigned char *id, size_t id_len)
+{
+    return slot->id_len == id_len && memcmp(slot->id, id, id_len) == 0;
+}
+
+SSL_SHM_SESS_CACHE *ssl_shm_sess_cache_new(size_t num_slots,
+    size_t max_sess_len)
+{
+    SSL_SHM_SESS_CACHE *c;
+    size_t num_buckets, slot_size;
+    void *map;
+
+    if (max_sess_len == 0)
+        max_sess_len = SHM_SESS_DEFAULT_LEN;
+    num_buckets = (num_slots + SHM_SESS_WAYS - 1) / SHM_SESS_WAYS;
+    if (num_slots == 0 || max_sess_len > UINT32_MAX
+        || max_sess_len > SIZE_MAX - SHM_SESS_SLOT_HDR_LEN - 63) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return NULL;
+    }
+    /* Keep slots on separate cache lines. */
+    slot_size = (SHM_SESS_SLOT_HDR_LEN + max_sess_len + 63) & ~(size_t)63;
+    if (num_buckets > SIZE_MAX / SHM_SESS_WAYS / slot_size) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    if ((c = OPENSSL_zalloc(sizeof(*c))) == NULL)
+        return NULL;
+    c->num_buckets = num_buckets;
+    c->slot_size = slot_size;
+    c->max_der_len = max_sess_len;
+    c->map_size = num_buckets * SHM_SESS_WAYS * slot_size;
+
+    map = mmap(NULL, c->map_size, PROT_READ | PROT_WRITE,
+        MAP_ANON | MAP_SHARED, -1, 0);
+    if (map == MAP_FAILED) {
+        ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(), "calling mmap()");
+        OPENSSL_free(c);
+        return NULL;
+    }
+#ifdef MADV_DONTDUMP
+    /* The cache holds master secrets, keep it out of core dumps. */
+    (void)madvise(map, c->map_size, MADV_DONTDUMP);
+#endif
+    c->map = map;
+    return c;
+}
+
+void ssl_shm_sess_cache_free(SSL_SHM_SESS_CACHE *c)
+{
+    if (c == NULL)
+        return;
+    /*
+     * Other processes may still be using the mapping, so it is only unmapped
+     * and not cleared.
+     */
+    munmap(c->map, c->map_size);
+    OPENSSL_free(c);
+}
+
+int ssl_shm_sess_cache_add(SSL_SHM_SESS_CACHE *c, const SSL_SESSION *sess)
+{
+    size_t i, first, victim = SIZE_MAX;
+    uint32_t victim_seq = 0;
+    int64_t now = (int64_t)time(NULL), victim_expiry = INT64_MAX;
+    SHM_SESS_SLOT *slot;
+    unsigned char *p;
+    int der_len;
+
+    if (sess->session_id_length == 0
+        || sess->session_id_length > SSL_MAX_SSL_SESSION_ID_LENGTH)
+        return 0;
+    der_len = i2d_SSL_SESSION(sess, NULL);
+    if (der_len <= 0 || (size_t)der_len > c->max_der_len)
+        return 0;
+
+    /*
+     * Pick a slot in the bucket: one already holding this session if there
+     * is one, otherwise the one which expires first, free slots counting as
+     * already expired. The slots are examined without claiming them, so this
+     * is only a hint and the choice is checked again by the claim below.
+     */
+    first = shm_bucket(c, sess->session_id, sess->session_id_length);
+    for (i = first; i < first + SHM_SESS_WAYS; i++) {
+        uint32_t seq;
+        int64_t expiry;
+
+        slot = shm_slot(c, i);
+        seq = shm_seq_load(slot);
+        if ((seq & 1) != 0)
+            continue;
+        if (shm_slot_matches(slot, sess->session_id,
+                sess->session_id_length)) {
+            victim = i;
+            victim_seq = seq;
+            break;
+        }
+        expiry = slot->id_len == 0 ? INT64_MIN : slot->expiry;
+        if (expiry < now)
+            expiry = INT64_MIN;
+        if (victim == SIZE_MAX || expiry < victim_expiry) {
+            victim = i;
+            victim_seq = seq;
+            victim_expiry = expiry;
+        }
+    }
+    if (victim == SIZE_MAX)
+        return 0;
+
+    slot = shm_slot(c, victim);
+    if (!shm_slot_claim(slot, victim_seq))
+        return 0;
+
+    p = shm_slot_der(slot);
+    if (i2d_SSL_SESSION(sess, &p) != der_len) {
+        slot->id_len = 0;
+        shm_slot_release(slot, victim_seq);
+        return 0;
+    }
+    slot->der_len = (uint32_t)der_len;
+    slot->expiry = (int64_t)ossl_time_to_time_t(sess->calc_timeout);
+    slot->id_len = (unsigned char)sess->session_id_length;
+    memcpy(slot->id, sess->session_id, sess->session_id_length);
+    shm_slot_release(slot, victim_seq);
+    return 1;
+}
+
+SSL_SESSION *ssl_shm_sess_cache_get(SSL_SHM_SESS_CACHE *c, SSL_CTX *ctx,
+    const unsigned char *id, size_t id_len)
+{
+    size_t i, first;
+    int retries = SHM_SESS_READ_RETRIES;
+    unsigned char *buf = NULL;
+    const unsigned char *p;
+    SSL_SESSION *ret = NULL;
+
+    if (id_len == 0 || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+        return NULL;
+
+    first = shm_bucket(c, id, id_len);
+    for (i = first; i < first + SHM_SESS_WAYS; i++) {
+        SHM_SESS_SLOT *slot = shm_slot(c, i);
+        uint32_t seq, der_len;
+        int64_t expiry;
+
+    again:
+        seq = shm_seq_load(slot);
+        if ((seq & 1) != 0 || !shm_slot_matches(slot, id, id_len))
+            continue;
+        der_len = slot->der_len;
+        expiry = slot->expiry;
+        if (der_len == 0 || der_len > c->max_der_len)
+            continue;
+        if (buf == NULL
+            && (buf = OPENSSL_malloc(c->max_der_len)) == NULL)
+            return NULL;
+        memcpy(buf, shm_slot_der(slot), der_len);
+
+        /* Order the copy before the second read of the counter. */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) {
+            if (retries-- > 0)
+                goto again;
+            break;
+        }
+        if (expiry < (int64_t)time(NULL))
+            break;
+
+        p = buf;
+        ret = d2i_SSL_SESSION_ex(NULL, &p, der_len, ctx->libctx, ctx->propq);
+        if (ret != NULL
+            && (ret->session_id_length != id_len
+                || memcmp(ret->session_id, id, id_len) != 0)) {
+            SSL_SESSION_free(ret);
+            ret = NULL;
+        }
+        break;
+    }
+
+    OPENSSL_clear_free(buf, c->max_der_len);
+    return ret;
+}
+
+void ssl_shm_sess_cache_remove(SSL_SHM_SESS_CACHE *c, const unsigned char *id,
+    size_t id_len)
+{
+    size_t i, first;
+
+    if (id_len == 0 || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+        return;
+
+    first = shm_bucket(c, id, id_len);
+    for (i = first; i < first + SHM_SESS_WAYS; i++) {
+        SHM_SESS_SLOT *slot = shm_slot(c, i);
+        uint32_t seq = shm_seq_load(slot);
+
+        if (!shm_slot_matches(slot, id, id_len) || !shm_slot_claim(slot, seq))
+            continue;
+        /* Check again now that nobody else can change the slot. */
+        if (shm_slot_matches(slot, id, id_len)) {
+            slot->id_len = 0;
+            slot->der_len = 0;
+        }
+        shm_slot_release(slot, seq);
+    }
+}
+
+#else
+
+SSL_SHM_SESS_CACHE *ssl_shm_sess_cache_new(size_t num_slots,
+    size_t max_sess_len)
+{
+    ERR_raise(ERR_LIB_SSL, ERR_R_UNSUPPORTED);
+    return NULL;
+}
+
+void ssl_shm_sess_cache_free(SSL_SHM_SESS_CACHE *c)
+{
+}
+
+int ssl_shm_sess_cache_add(SSL_SHM_SESS_CACHE *c, const SSL_SESSION *sess)
+{
+    return 0;
+}
+
+SSL_SESSION *ssl_shm_sess_cache_get(SSL_SHM_SESS_CACHE *c, SSL_CTX *ctx,
+    const unsigned char *id, size_t id_len)
+{
+    return NULL;
+}
+
+void ssl_shm_sess_cache_remove(SSL_SHM_SESS_CACHE *c, const unsigned char *id,
+    size_t id_len)
+{
+}
+
+#endif
+
+int SSL_CTX_set_shared_session_cache(SSL_CTX *ctx, size_t num_slots,
+    size_t max_sess_len)
+{
+    SSL_SHM_SESS_CACHE *c = NULL;
+
+    if (num_slots != 0
+        && (c = ssl_shm_sess_cache_new(num_slots, max_sess_len)) == NULL)
+        return 0;
+    ssl_shm_sess_cache_free(ctx->shm_sess_cache);
+    ctx->shm_sess_cache = c;
+    return 1;
+}
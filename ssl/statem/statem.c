@@ -786,6 +786,9 @@ static void init_write_state_machine(SSL_CONNECTION *s)
  * |      WRITE_STATE_PRE_WORK -----> [SUB_STATE_END_HANDSHAKE]
  * |             |
  * |             v
+ * |     WRITE_STATE_CONSTRUCT
+ * |             |
+ * |             v
  * |       WRITE_STATE_SEND
  * |             |
  * |             v
@@ -800,6 +803,11 @@ static void init_write_state_machine(SSL_CONNECTION *s)
  * which case control returns to the calling application. When this function
  * is recalled we will resume in the same state where we left off.
  *
+ * WRITE_STATE_CONSTRUCT constructs the message. If constructing it has to wait
+ * for the application, e.g. for a signature from the private key callback,
+ * control returns to the calling application and the message is constructed
+ * again from the start when this function is recalled.
+ *
  * WRITE_STATE_SEND sends the message and performs any work to be done after
  * sending.
  *
@@ -874,7 +882,7 @@ static SUB_STATE_RETURN write_state_machine(SSL_CONNECTION *s)
                 return SUB_STATE_ERROR;
 
             case WORK_FINISHED_CONTINUE:
-                st->write_state = WRITE_STATE_SEND;
+                st->write_state = WRITE_STATE_CONSTRUCT;
                 break;
 
             case WORK_FINISHED_SWAP:
@@ -883,6 +891,9 @@ static SUB_STATE_RETURN write_state_machine(SSL_CONNECTION *s)
             case WORK_FINISHED_STOP:
                 return SUB_STATE_END_HANDSHAKE;
             }
+            /* Fall through */
+
+        case WRITE_STATE_CONSTRUCT:
             if (!get_construct_message_f(s, &confunc, &mt)) {
                 /* SSLfatal() already called */
                 return SUB_STATE_ERROR;
@@ -916,6 +927,16 @@ static SUB_STATE_RETURN write_state_machine(SSL_CONNECTION *s)
                     st->write_state = WRITE_STATE_POST_WORK;
                     st->write_state_work = WORK_MORE_A;
                     break;
+                } else if (tmpret == CON_FUNC_RETRY) {
+                    /*
+                     * The construction function is waiting for the
+                     * application. Discard what has been constructed so far
+                     * and start again when we are called next.
+                     */
+                    WPACKET_cleanup(&pkt);
+                    if (SSL_CONNECTION_IS_DTLS(s))
+                        s->d1->next_handshake_write_seq--;
+                    return SUB_STATE_ERROR;
                 } /* else success */
             }
             if (!ssl_close_construct_packet(s, &pkt, mt)
@@ -924,6 +945,7 @@ static SUB_STATE_RETURN write_state_machine(SSL_CONNECTION *s)
                 SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
                 return SUB_STATE_ERROR;
             }
+            st->write_state = WRITE_STATE_SEND;
 
             /* Fall through */
 
@@ -311,6 +311,60 @@ static int get_cert_verify_tbs_data(SSL_CONNECTION *s, unsigned char *tls13tbs,
     return 1;
 }
 
+/*
+ * Sign |tbs| with the application's private key callback for the signature
+ * algorithm |lu|, and add the signature to |pkt| prefixed with its length.
+ * |pkey| is the key of the certificate in use; it is only used to find the
+ * maximum size of the signature. Returns CON_FUNC_RETRY if the callback asked
+ * to be called again, in which case the message is constructed again from the
+ * start and the callback gets the same data to sign.
+ */
+CON_FUNC_RETURN tls_construct_signature_cb(SSL_CONNECTION *s, WPACKET *pkt,
+    const SIGALG_LOOKUP *lu,
+    EVP_PKEY *pkey, const unsigned char *tbs,
+    size_t tbslen)
+{
+    unsigned char *sig1, *sig2;
+    size_t siglen, sigsize;
+    int ret;
+
+    if ((ret = EVP_PKEY_get_size(pkey)) <= 0) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_EVP_LIB);
+        return CON_FUNC_ERROR;
+    }
+    sigsize = siglen = (size_t)ret;
+
+    if (!WPACKET_sub_reserve_bytes_u16(pkt, sigsize, &sig1)) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+        return CON_FUNC_ERROR;
+    }
+
+    ret = s->cert->pkey_cb(SSL_CONNECTION_GET_USER_SSL(s), lu->sigalg,
+        tbs, tbslen, sig1, &siglen, sigsize,
+        s->cert->pkey_cb_arg);
+    if (ret == SSL_PRIVATE_KEY_RETRY) {
+        s->rwstate = SSL_PRIVATE_KEY_OPERATION;
+        s->s3.tmp.sig_retry = 1;
+        return CON_FUNC_RETRY;
+    }
+    if (s->rwstate == SSL_PRIVATE_KEY_OPERATION)
+        s->rwstate = SSL_NOTHING;
+    s->s3.tmp.sig_retry = 0;
+
+    if (ret != SSL_PRIVATE_KEY_SUCCESS) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, SSL_R_CALLBACK_FAILED);
+        return CON_FUNC_ERROR;
+    }
+    if (siglen > sigsize
+        || !WPACKET_sub_allocate_bytes_u16(pkt, siglen, &sig2)
+        || sig1 != sig2) {
+        SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
+        return CON_FUNC_ERROR;
+    }
+
+    return CON_FUNC_SUCCESS;
+}
+
 CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
 {
     EVP_PKEY *pkey = NULL;
@@ -324,6 +378,7 @@ CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
     const SIGALG_LOOKUP *lu = s->s3.tmp.sigalg;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
     OSSL_PARAM params[3], *p = params;
+    CON_FUNC_RETURN ret = CON_FUNC_ERROR;
 
     if (lu == NULL || s->s3.tmp.cert == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
@@ -353,6 +408,15 @@ CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
         goto err;
     }
 
+    if (s->cert->pkey_cb != NULL) {
+        ret = tls_construct_signature_cb(s, pkt, lu, pkey, hdata, hdatalen);
+        if (ret != CON_FUNC_SUCCESS) {
+            /* SSLfatal() already called or retry requested */
+            goto err;
+        }
+        goto done;
+    }
+
     /*
      * To avoid problems with older RSA providers we must also pass the digest
      * name when passing any other parameters.
@@ -412,19 +476,19 @@ CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
         goto err;
     }
 
+done:
     /* Digest cached records and discard handshake buffer */
     if (!ssl3_digest_cached_records(s, 0)) {
         /* SSLfatal() already called */
+        ret = CON_FUNC_ERROR;
         goto err;
     }
 
-    OPENSSL_free(sig);
-    EVP_MD_CTX_free(mctx);
-    return CON_FUNC_SUCCESS;
+    ret = CON_FUNC_SUCCESS;
 err:
     OPENSSL_free(sig);
     EVP_MD_CTX_free(mctx);
-    return CON_FUNC_ERROR;
+    return ret;
 }
 
 MSG_PROCESS_RETURN tls_process_cert_verify(SSL_CONNECTION *s, PACKET *pkt)
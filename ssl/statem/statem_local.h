@@ -138,6 +138,10 @@ __owur CON_FUNC_RETURN dtls_construct_change_cipher_spec(SSL_CONNECTION *s,
 
 __owur CON_FUNC_RETURN tls_construct_finished(SSL_CONNECTION *s, WPACKET *pkt);
 __owur CON_FUNC_RETURN tls_construct_key_update(SSL_CONNECTION *s, WPACKET *pkt);
+__owur CON_FUNC_RETURN tls_construct_signature_cb(SSL_CONNECTION *s,
+    WPACKET *pkt, const SIGALG_LOOKUP *lu,
+    EVP_PKEY *pkey, const unsigned char *tbs,
+    size_t tbslen);
 __owur MSG_PROCESS_RETURN tls_process_key_update(SSL_CONNECTION *s,
     PACKET *pkt);
 __owur WORK_STATE tls_finish_handshake(SSL_CONNECTION *s, WORK_STATE wst,
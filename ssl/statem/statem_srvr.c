@@ -2899,12 +2899,14 @@ CON_FUNC_RETURN tls_construct_server_key_exchange(SSL_CONNECTION *s,
                 /* Cache the group used in the SSL_SESSION */
                 s->session->kex_group = group_id;
 
-                s->s3.tmp.pkey = ssl_generate_pkey_group(s, group_id);
+                /* Keep the key from before signing was retried */
+                if (!s->s3.tmp.sig_retry)
+                    s->s3.tmp.pkey = ssl_generate_pkey_group(s, group_id);
                 if (s->s3.tmp.pkey == NULL) {
                     SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
                     goto err;
                 }
-            } else {
+            } else if (!s->s3.tmp.sig_retry) {
 
                 if (s->cert->dh_tmp_auto) {
                     pkdh = ssl_get_auto_dh(s);
@@ -2964,7 +2966,7 @@ CON_FUNC_RETURN tls_construct_server_key_exchange(SSL_CONNECTION *s,
             }
         } else if (type & (SSL_kECDHE | SSL_kECDHEPSK)) {
 
-            if (s->s3.tmp.pkey != NULL) {
+            if (s->s3.tmp.pkey != NULL && !s->s3.tmp.sig_retry) {
                 SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
                 goto err;
             }
@@ -2979,8 +2981,12 @@ CON_FUNC_RETURN tls_construct_server_key_exchange(SSL_CONNECTION *s,
             }
             /* Cache the group used in the SSL_SESSION */
             s->session->kex_group = group_id;
-            /* Generate a new key for this curve */
-            s->s3.tmp.pkey = ssl_generate_pkey_group(s, group_id);
+            /*
+             * Generate a new key for this curve, unless we already did so
+             * before signing was retried
+             */
+            if (!s->s3.tmp.sig_retry)
+                s->s3.tmp.pkey = ssl_generate_pkey_group(s, group_id);
             if (s->s3.tmp.pkey == NULL) {
                 /* SSLfatal() already called */
                 goto err;
@@ -3129,28 +3135,38 @@ CON_FUNC_RETURN tls_construct_server_key_exchange(SSL_CONNECTION *s,
             goto err;
         }
 
+        tbslen = construct_key_exchange_tbs(s, &tbs,
+            s->init_buf->data + paramoffset,
+            paramlen);
+        if (tbslen == 0) {
+            /* SSLfatal() already called */
+            goto err;
+        }
+
+        if (s->cert->pkey_cb != NULL) {
+            /* SSLfatal() already called if appropriate */
+            ret = tls_construct_signature_cb(s, pkt, lu, pkey, tbs, tbslen);
+            OPENSSL_free(tbs);
+            goto err;
+        }
+
         if (EVP_DigestSignInit_ex(md_ctx, &pctx,
                 md == NULL ? NULL : EVP_MD_get0_name(md),
                 sctx->libctx, sctx->propq, pkey,
                 NULL)
             <= 0) {
+            OPENSSL_free(tbs);
             SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
             goto err;
         }
         if (lu->sig == EVP_PKEY_RSA_PSS) {
             if (EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) <= 0
                 || EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, RSA_PSS_SALTLEN_DIGEST) <= 0) {
+                OPENSSL_free(tbs);
                 SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_EVP_LIB);
                 goto err;
             }
         }
-        tbslen = construct_key_exchange_tbs(s, &tbs,
-            s->init_buf->data + paramoffset,
-            paramlen);
-        if (tbslen == 0) {
-            /* SSLfatal() already called */
-            goto err;
-        }
 
         if (EVP_DigestSign(md_ctx, NULL, &siglen, tbs, tbslen) <= 0
             || !WPACKET_sub_reserve_bytes_u16(pkt, siglen, &sigbytes1)
@@ -452,6 +452,118 @@ static int test_bio_dgram(int idx)
         bio_dgram_cases[idx].local);
 }
 
+/*
+ * Sends a mixture of equally and unequally sized datagrams with segmentation
+ * offload enabled on the sender and receive coalescing enabled on the
+ * receiver, and checks that exactly the datagrams sent are received.
+ */
+static const size_t seg_test_lens[] = {
+    1200, 1200, 1200, 1200, 1200, 700, 1200, 1200, 1000, 1200, 0, 1200, 1200
+};
+
+static int test_bio_dgram_segmentation(void)
+{
+    int testresult = 0;
+    BIO *b1 = NULL, *b2 = NULL;
+    int fd1 = -1, fd2 = -1;
+    BIO_ADDR *addr1 = NULL, *addr2 = NULL, *peer = NULL;
+    struct in_addr ina;
+    union BIO_sock_info_u info1 = { 0 }, info2 = { 0 };
+    static unsigned char tx_buf[OSSL_NELEM(seg_test_lens)][1500];
+    static unsigned char rx_buf[OSSL_NELEM(seg_test_lens)][1500];
+    BIO_MSG tx_msg[OSSL_NELEM(seg_test_lens)], rx_msg[OSSL_NELEM(seg_test_lens)];
+    size_t i, num_processed = 0;
+
+    ina.s_addr = htonl(0x7f000001UL);
+
+    if (!TEST_ptr(addr1 = BIO_ADDR_new())
+        || !TEST_ptr(addr2 = BIO_ADDR_new())
+        || !TEST_ptr(peer = BIO_ADDR_new())
+        || !TEST_true(BIO_ADDR_rawmake(addr1, AF_INET, &ina, sizeof(ina), 0))
+        || !TEST_true(BIO_ADDR_rawmake(addr2, AF_INET, &ina, sizeof(ina), 0)))
+        goto err;
+
+    fd1 = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0);
+    fd2 = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0);
+    if (!TEST_int_ge(fd1, 0) || !TEST_int_ge(fd2, 0))
+        goto err;
+
+    if (BIO_bind(fd1, addr1, 0) <= 0 || BIO_bind(fd2, addr2, 0) <= 0) {
+        testresult = TEST_skip("BIO_bind() failed");
+        goto err;
+    }
+
+    info1.addr = addr1;
+    info2.addr = addr2;
+    if (!TEST_int_gt(BIO_sock_info(fd1, BIO_SOCK_INFO_ADDRESS, &info1), 0)
+        || !TEST_int_gt(BIO_sock_info(fd2, BIO_SOCK_INFO_ADDRESS, &info2), 0))
+        goto err;
+
+    if (!TEST_ptr(b1 = BIO_new_dgram(fd1, 0))
+        || !TEST_ptr(b2 = BIO_new_dgram(fd2, 0)))
+        goto err;
+
+    if (!BIO_dgram_set_tx_segmentation(b1, 1)
+        || !BIO_dgram_set_rx_coalescing(b2, 1)) {
+        testresult = TEST_skip("UDP segmentation offload not supported");
+        goto err;
+    }
+
+    if (!TEST_int_eq(BIO_dgram_get_tx_segmentation(b1), 1)
+        || !TEST_int_eq(BIO_dgram_get_rx_coalescing(b2), 1))
+        goto err;
+
+    for (i = 0; i < OSSL_NELEM(seg_test_lens); ++i) {
+        memset(tx_buf[i], (int)i + 1, sizeof(tx_buf[i]));
+        tx_msg[i].data = tx_buf[i];
+        tx_msg[i].data_len = seg_test_lens[i];
+        tx_msg[i].peer = addr2;
+        tx_msg[i].local = NULL;
+        tx_msg[i].flags = 0;
+
+        rx_msg[i].data = rx_buf[i];
+        rx_msg[i].data_len = sizeof(rx_buf[i]);
+        rx_msg[i].peer = peer;
+        rx_msg[i].local = NULL;
+        rx_msg[i].flags = 0;
+    }
+
+    if (!TEST_true(do_sendmmsg(b1, tx_msg, OSSL_NELEM(tx_msg), 0,
+            &num_processed))
+        || !TEST_size_t_eq(num_processed, OSSL_NELEM(tx_msg)))
+        goto err;
+
+    /* Receive in small batches so that some segments must be held. */
+    for (i = 0; i < OSSL_NELEM(rx_msg); i += num_processed)
+        if (!TEST_true(BIO_recvmmsg(b2, rx_msg + i, sizeof(BIO_MSG),
+                OSSL_NELEM(rx_msg) - i < 3 ? OSSL_NELEM(rx_msg) - i : 3,
+                0, &num_processed))
+            || !TEST_size_t_gt(num_processed, 0))
+            goto err;
+
+    for (i = 0; i < OSSL_NELEM(rx_msg); ++i)
+        if (!TEST_mem_eq(rx_msg[i].data, rx_msg[i].data_len,
+                tx_msg[i].data, tx_msg[i].data_len))
+            goto err;
+
+    if (!TEST_int_eq(compare_addr(peer, addr1), 1)
+        || !TEST_size_t_eq(BIO_ctrl_pending(b2), 0))
+        goto err;
+
+    testresult = 1;
+err:
+    BIO_free(b1);
+    BIO_free(b2);
+    if (fd1 >= 0)
+        BIO_closesocket(fd1);
+    if (fd2 >= 0)
+        BIO_closesocket(fd2);
+    BIO_ADDR_free(addr1);
+    BIO_ADDR_free(addr2);
+    BIO_ADDR_free(peer);
+    return testresult;
+}
+
 #if !defined(OPENSSL_NO_CHACHA)
 static int random_data(const uint32_t *key, uint8_t *data, size_t data_len, size_t offset)
 {
@@ -803,6 +915,7 @@ int setup_tests(void)
 
 #if !defined(OPENSSL_NO_DGRAM) && !defined(OPENSSL_NO_SOCK)
     ADD_ALL_TESTS(test_bio_dgram, OSSL_NELEM(bio_dgram_cases));
+    ADD_TEST(test_bio_dgram_segmentation);
 #if !defined(OPENSSL_NO_CHACHA)
     ADD_ALL_TESTS(test_bio_dgram_pair, 3);
 #endif
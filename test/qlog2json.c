@@ -0,0 +1,55 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Converts a binary qlog file (written with OSSL_QLOG_FORMAT=binary) to the
+ * standard JSON-SEQ format.
+ *
+ * Usage: qlog2json [infile.bqlog [outfile.sqlog]]
+ */
+#include <stdio.h>
+#include <openssl/bio.h>
+#include "internal/qlog.h"
+
+int main(int argc, char **argv)
+{
+    BIO *in = NULL, *out = NULL;
+    int ret = 1;
+
+    if (argc > 3) {
+        fprintf(stderr, "usage: %s [infile [outfile]]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc > 1)
+        in = BIO_new_file(argv[1], "rb");
+    else
+        in = BIO_new_fp(stdin, BIO_NOCLOSE);
+
+    if (argc > 2)
+        out = BIO_new_file(argv[2], "wb");
+    else
+        out = BIO_new_fp(stdout, BIO_NOCLOSE);
+
+    if (in == NULL || out == NULL) {
+        fprintf(stderr, "%s: cannot open input or output\n", argv[0]);
+        goto err;
+    }
+
+    if (!ossl_qlog_bin_to_json(in, out)) {
+        fprintf(stderr, "%s: input is not a valid binary qlog file\n", argv[0]);
+        goto err;
+    }
+
+    ret = 0;
+err:
+    BIO_free(in);
+    BIO_free(out);
+    return ret;
+}
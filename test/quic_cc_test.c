@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -477,17 +477,304 @@ err:
     return testresult;
 }
 
+/*
+ * Bottleneck Link Simulation
+ * ==========================
+ *
+ * A more realistic network model than the one above: a single bottleneck link
+ * with a fixed rate, a FIFO buffer of limited size in front of it and a fixed
+ * propagation delay, optionally with random loss. Packets which would overflow
+ * the buffer are dropped. The sender always has data to send and honours the
+ * pacing rate if the congestion controller exposes one. We measure the goodput
+ * achieved and the queueing delay caused by each congestion controller.
+ */
+typedef struct link_pkt_st {
+    /* The time at which the packet was sent. */
+    OSSL_TIME tx_time;
+
+    /* The time at which the sender learns of acknowledgement or loss. */
+    OSSL_TIME determination_time;
+
+    /* 1 if the packet will be successfully delivered, 0 if it is to be lost. */
+    int success;
+
+    /* Size of simulated packet in bytes. */
+    size_t size;
+
+    /* pqueue internal index. */
+    size_t idx;
+} LINK_PKT;
+
+DEFINE_PRIORITY_QUEUE_OF(LINK_PKT);
+
+static int link_pkt_cmp(const void *av, const void *bv)
+{
+    const LINK_PKT *a = av;
+    const LINK_PKT *b = bv;
+
+    return ossl_time_compare(a->determination_time, b->determination_time);
+}
+
+struct link_params {
+    const char *name;
+    uint64_t rate; /* bytes/s */
+    uint64_t rtt; /* ms, propagation only */
+    uint64_t buf; /* bytes */
+    uint32_t loss_ppm; /* random loss, parts per million */
+    uint64_t duration; /* s */
+
+    /*
+     * For each controller, the lower bound on link utilisation in percent and
+     * the upper bound on mean queueing delay in ms (0 if not checked).
+     */
+    uint32_t min_util[3];
+    uint32_t max_qdelay[3];
+};
+
+struct link_sim {
+    const OSSL_CC_METHOD *ccm;
+    OSSL_CC_DATA *cc;
+    const struct link_params *lp;
+
+    /* The time at which the bottleneck will have sent everything queued. */
+    OSSL_TIME link_free;
+    uint32_t rand_state;
+    PRIORITY_QUEUE_OF(LINK_PKT) * pkts;
+
+    uint64_t total_acked, total_lost; /* bytes */
+    uint64_t qdelay_sum, qdelay_max, qdelay_count; /* us */
+};
+
+static void link_sim_cleanup(struct link_sim *s)
+{
+    ossl_pqueue_LINK_PKT_pop_free(s->pkts, do_free);
+}
+
+/* A fixed LCG so that runs are reproducible. */
+static uint32_t link_sim_rand(struct link_sim *s)
+{
+    s->rand_state = s->rand_state * 1103515245 + 12345;
+    return s->rand_state >> 8;
+}
+
+static int link_sim_send(struct link_sim *s, size_t sz)
+{
+    const struct link_params *lp = s->lp;
+    LINK_PKT *pkt = OPENSSL_zalloc(sizeof(*pkt));
+    OSSL_TIME start, qdelay, rtt = ossl_ms2time(lp->rtt);
+    OSSL_TIME loss_delay = ossl_time_add(rtt, ossl_time_divide(rtt, 8));
+
+    if (!TEST_ptr(pkt))
+        return 0;
+
+    start = ossl_time_max(fake_time, s->link_free);
+    qdelay = ossl_time_subtract(start, fake_time);
+
+    pkt->tx_time = fake_time;
+    pkt->size = sz;
+
+    if (ossl_time2ticks(qdelay) / 1000 * lp->rate / 1000000 + sz > lp->buf) {
+        /* Tail drop; detected once later packets are acknowledged. */
+        pkt->success = 0;
+        pkt->determination_time
+            = ossl_time_add(fake_time, ossl_time_add(qdelay, loss_delay));
+    } else {
+        s->link_free = ossl_time_add(start,
+            ossl_ticks2time(sz * OSSL_TIME_SECOND / lp->rate));
+
+        s->qdelay_sum += ossl_time2us(qdelay);
+        if (ossl_time2us(qdelay) > s->qdelay_max)
+            s->qdelay_max = ossl_time2us(qdelay);
+        ++s->qdelay_count;
+
+        pkt->success = (link_sim_rand(s) % 1000000 >= lp->loss_ppm);
+        pkt->determination_time = ossl_time_add(s->link_free,
+            pkt->success ? rtt : loss_delay);
+    }
+
+    if (!TEST_true(s->ccm->on_data_sent(s->cc, sz))
+        || !TEST_true(ossl_pqueue_LINK_PKT_push(s->pkts, pkt, &pkt->idx))) {
+        OPENSSL_free(pkt);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* Processes all events which have come due. */
+static int link_sim_process(struct link_sim *s)
+{
+    LINK_PKT *pkt;
+    OSSL_CC_ACK_INFO ack_info;
+    OSSL_CC_LOSS_INFO loss_info;
+
+    while ((pkt = ossl_pqueue_LINK_PKT_peek(s->pkts)) != NULL
+        && ossl_time_compare(pkt->determination_time, fake_time) <= 0) {
+        ossl_pqueue_LINK_PKT_pop(s->pkts);
+
+        if (pkt->success) {
+            ack_info.tx_time = pkt->tx_time;
+            ack_info.tx_size = pkt->size;
+            s->total_acked += pkt->size;
+
+            if (!TEST_true(s->ccm->on_data_acked(s->cc, &ack_info)))
+                goto err;
+        } else {
+            loss_info.tx_time = pkt->tx_time;
+            loss_info.tx_size = pkt->size;
+            s->total_lost += pkt->size;
+
+            if (!TEST_true(s->ccm->on_data_lost(s->cc, &loss_info))
+                || !TEST_true(s->ccm->on_data_lost_finished(s->cc, 0)))
+                goto err;
+        }
+
+        OPENSSL_free(pkt);
+    }
+
+    return 1;
+
+err:
+    OPENSSL_free(pkt);
+    return 0;
+}
+
+static const OSSL_CC_METHOD *cc_methods[] = {
+    &ossl_cc_newreno_method,
+    &ossl_cc_cubic_method,
+    &ossl_cc_bbr_method,
+};
+
+static const char *cc_method_names[] = {
+    "newreno",
+    "cubic",
+    "bbr",
+};
+
+static const struct link_params link_params[] = {
+    /* 100 Mbit/s, 100 ms, one BDP of buffer. */
+    { "long fat pipe", 12500000, 100, 1250000, 0, 20,
+        { 85, 85, 85 }, { 0, 0, 20 } },
+    /* As above with 0.1% random loss. */
+    { "lossy", 12500000, 100, 1250000, 1000, 20,
+        { 3, 5, 85 }, { 0, 0, 20 } },
+    /* 10 Mbit/s, 40 ms, eight BDPs of buffer. */
+    { "bufferbloat", 1250000, 40, 400000, 0, 20,
+        { 90, 90, 90 }, { 0, 0, 20 } },
+};
+
+static int test_link_sim(int idx)
+{
+    int testresult = 0, have_sim = 0;
+    const struct link_params *lp = &link_params[idx / OSSL_NELEM(cc_methods)];
+    size_t ccm_idx = idx % OSSL_NELEM(cc_methods);
+    const OSSL_CC_METHOD *ccm = cc_methods[ccm_idx];
+    OSSL_CC_DATA *cc = NULL;
+    size_t mdpl = 1472;
+    uint64_t allowance, pacing_rate = 0, goodput, util, mean_qdelay;
+    OSSL_TIME end, next_send, wake;
+    LINK_PKT *pkt;
+    struct link_sim sim = { 0 };
+    OSSL_PARAM params[2];
+
+    fake_time = TIME_BASE;
+    end = ossl_time_add(fake_time, ossl_seconds2time(lp->duration));
+    next_send = fake_time;
+
+    if (!TEST_ptr(cc = ccm->new(fake_now, NULL)))
+        goto err;
+
+    params[0] = OSSL_PARAM_construct_size_t(OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+        &mdpl);
+    params[1] = OSSL_PARAM_construct_end();
+    if (!TEST_true(ccm->set_input_params(cc, params)))
+        goto err;
+
+    params[0] = OSSL_PARAM_construct_uint64(OSSL_CC_OPTION_CUR_PACING_RATE,
+        &pacing_rate);
+    if (!TEST_true(ccm->bind_diagnostics(cc, params)))
+        goto err;
+
+    sim.ccm = ccm;
+    sim.cc = cc;
+    sim.lp = lp;
+    sim.link_free = fake_time;
+    sim.rand_state = 1;
+    if (!TEST_ptr(sim.pkts = ossl_pqueue_LINK_PKT_new(link_pkt_cmp)))
+        goto err;
+
+    have_sim = 1;
+
+    while (ossl_time_compare(fake_time, end) < 0) {
+        if (!link_sim_process(&sim))
+            goto err;
+
+        allowance = ccm->get_tx_allowance(cc);
+        if (allowance >= mdpl
+            && (pacing_rate == 0 || ossl_time_compare(fake_time, next_send) >= 0)) {
+            if (!link_sim_send(&sim, mdpl))
+                goto err;
+
+            if (pacing_rate > 0)
+                next_send = ossl_time_add(ossl_time_max(next_send, fake_time),
+                    ossl_ticks2time(mdpl * OSSL_TIME_SECOND / pacing_rate));
+            continue;
+        }
+
+        /* Skip to the next event or the next pacing slot. */
+        pkt = ossl_pqueue_LINK_PKT_peek(sim.pkts);
+        wake = pkt != NULL ? pkt->determination_time : ossl_time_infinite();
+        if (allowance >= mdpl)
+            wake = ossl_time_min(wake, next_send);
+
+        if (!TEST_false(ossl_time_is_infinite(wake)))
+            goto err;
+
+        fake_time = ossl_time_max(fake_time, wake);
+    }
+
+    goodput = sim.total_acked / lp->duration;
+    util = goodput * 100 / lp->rate;
+    mean_qdelay = sim.qdelay_count > 0 ? sim.qdelay_sum / sim.qdelay_count : 0;
+
+    TEST_info("%s, %s: goodput %llu kB/s (%llu%%), lost %llu kB, "
+              "queueing delay mean %llu ms, max %llu ms",
+        lp->name, cc_method_names[ccm_idx],
+        (unsigned long long)(goodput / 1000),
+        (unsigned long long)util,
+        (unsigned long long)(sim.total_lost / 1000),
+        (unsigned long long)(mean_qdelay / 1000),
+        (unsigned long long)(sim.qdelay_max / 1000));
+
+    if (!TEST_uint64_t_ge(util, lp->min_util[ccm_idx]))
+        goto err;
+
+    if (lp->max_qdelay[ccm_idx] != 0
+        && !TEST_uint64_t_le(mean_qdelay / 1000, lp->max_qdelay[ccm_idx]))
+        goto err;
+
+    testresult = 1;
+err:
+    if (have_sim)
+        link_sim_cleanup(&sim);
+
+    if (cc != NULL)
+        ccm->free(cc);
+
+    return testresult;
+}
+
 /*
  * Sanity Test
  * ===========
  *
  * Basic test of the congestion control APIs.
  */
-static int test_sanity(void)
+static int test_sanity(int idx)
 {
     int testresult = 0;
     OSSL_CC_DATA *cc = NULL;
-    const OSSL_CC_METHOD *ccm = &ossl_cc_newreno_method;
+    const OSSL_CC_METHOD *ccm = cc_methods[idx];
     OSSL_CC_LOSS_INFO loss_info = { 0 };
     OSSL_CC_ACK_INFO ack_info = { 0 };
     uint64_t allowance, allowance2;
@@ -627,6 +914,8 @@ int setup_tests(void)
 #endif
 
     ADD_TEST(test_simulate);
-    ADD_TEST(test_sanity);
+    ADD_ALL_TESTS(test_sanity, OSSL_NELEM(cc_methods));
+    ADD_ALL_TESTS(test_link_sim,
+        OSSL_NELEM(link_params) * OSSL_NELEM(cc_methods));
     return 1;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2023-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -99,8 +99,122 @@ err:
     return testresult;
 }
 
+static int test_lcidm_shard(void)
+{
+    int testresult = 0, i;
+    QUIC_LCIDM *lcidm = NULL, *lcidm0 = NULL;
+    QUIC_CONN_ID lcid;
+    OSSL_QUIC_FRAME_NEW_CONN_ID ncid_frame;
+    void *opaque = NULL;
+
+    if (!TEST_ptr(lcidm0 = ossl_quic_lcidm_new(NULL, 0))
+        || !TEST_false(ossl_quic_lcidm_set_shard(lcidm0, 1))
+        || !TEST_ptr(lcidm = ossl_quic_lcidm_new(NULL, 8))
+        || !TEST_int_eq(ossl_quic_lcidm_get_shard(lcidm), -1)
+        || !TEST_false(ossl_quic_lcidm_set_shard(lcidm, 256))
+        || !TEST_false(ossl_quic_lcidm_set_shard(lcidm, -2))
+        || !TEST_true(ossl_quic_lcidm_set_shard(lcidm, 0xa5))
+        || !TEST_int_eq(ossl_quic_lcidm_get_shard(lcidm), 0xa5))
+        goto err;
+
+    if (!TEST_true(ossl_quic_lcidm_generate_initial(lcidm, ptrs + 0, &lcid))
+        || !TEST_uint_eq(lcid.id_len, 8)
+        || !TEST_uint_eq(lcid.id[0], 0xa5)
+        || !TEST_true(ossl_quic_lcidm_lookup(lcidm, &lcid, NULL, &opaque))
+        || !TEST_ptr_eq(opaque, ptrs + 0))
+        goto err;
+
+    for (i = 0; i < 16; ++i)
+        if (!TEST_true(ossl_quic_lcidm_generate(lcidm, ptrs + 0, &ncid_frame))
+            || !TEST_uint_eq(ncid_frame.conn_id.id[0], 0xa5))
+            goto err;
+
+    if (!TEST_true(ossl_quic_lcidm_get_unused_cid(lcidm, &lcid))
+        || !TEST_uint_eq(lcid.id[0], 0xa5))
+        goto err;
+
+    testresult = 1;
+err:
+    ossl_quic_lcidm_free(lcidm);
+    ossl_quic_lcidm_free(lcidm0);
+    return testresult;
+}
+
+/*
+ * Enough LCIDs to force the index to grow and shrink repeatedly, with
+ * deletions from the middle of probe clusters.
+ */
+#define MANY_LCIDS 2000
+
+static void make_cid(QUIC_CONN_ID *cid, size_t i)
+{
+    memset(cid, 0, sizeof(*cid));
+    cid->id_len = 8;
+    cid->id[0] = (unsigned char)(i >> 8);
+    cid->id[1] = (unsigned char)i;
+}
+
+static int test_lcidm_many(void)
+{
+    int testresult = 0;
+    QUIC_LCIDM *lcidm;
+    QUIC_CONN_ID cid;
+    void *opaque = NULL;
+    uint64_t seq_num = 0;
+    size_t i;
+
+    if (!TEST_ptr(lcidm = ossl_quic_lcidm_new(NULL, 8)))
+        goto err;
+
+    for (i = 0; i < MANY_LCIDS; ++i) {
+        make_cid(&cid, i);
+        if (!TEST_true(ossl_quic_lcidm_debug_add(lcidm, ptrs + i % 8, &cid, i)))
+            goto err;
+    }
+
+    for (i = 0; i < MANY_LCIDS; ++i) {
+        make_cid(&cid, i);
+        if (!TEST_true(ossl_quic_lcidm_lookup(lcidm, &cid, &seq_num, &opaque))
+            || !TEST_uint64_t_eq(seq_num, i)
+            || !TEST_ptr_eq(opaque, ptrs + i % 8))
+            goto err;
+    }
+
+    for (i = 0; i < MANY_LCIDS; i += 3) {
+        make_cid(&cid, i);
+        if (!TEST_true(ossl_quic_lcidm_debug_remove(lcidm, &cid)))
+            goto err;
+    }
+
+    for (i = 0; i < MANY_LCIDS; ++i) {
+        make_cid(&cid, i);
+        if (!TEST_int_eq(ossl_quic_lcidm_lookup(lcidm, &cid, &seq_num, NULL),
+                i % 3 != 0)
+            || (i % 3 != 0 && !TEST_uint64_t_eq(seq_num, i)))
+            goto err;
+    }
+
+    for (i = 0; i < 7; ++i)
+        if (!TEST_true(ossl_quic_lcidm_cull(lcidm, ptrs + i)))
+            goto err;
+
+    for (i = 0; i < MANY_LCIDS; ++i) {
+        make_cid(&cid, i);
+        if (!TEST_int_eq(ossl_quic_lcidm_lookup(lcidm, &cid, NULL, NULL),
+                i % 8 == 7 && i % 3 != 0))
+            goto err;
+    }
+
+    testresult = 1;
+err:
+    ossl_quic_lcidm_free(lcidm);
+    return testresult;
+}
+
 int setup_tests(void)
 {
     ADD_TEST(test_lcidm);
+    ADD_TEST(test_lcidm_shard);
+    ADD_TEST(test_lcidm_many);
     return 1;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2024 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2024-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -8,6 +8,7 @@
  */
 
 #include "internal/qlog.h"
+#include "internal/qlog_bin.h"
 #include "testutil.h"
 
 /*
@@ -74,12 +75,50 @@ static OSSL_TIME now(void *arg)
     return t;
 }
 
-static int test_qlog(void)
+static QLOG_WRITER *writer;
+
+static QLOG_WRITER *get_writer(void *arg)
+{
+    return writer;
+}
+
+/*
+ * Converts the binary qlog output in bio to JSON-SEQ, replacing the contents
+ * of bio.
+ */
+static int convert_bin(BIO *bio)
+{
+    BIO *json = NULL;
+    char *buf = NULL;
+    long buf_len;
+    int ok = 0;
+
+    if (!TEST_ptr(json = BIO_new(BIO_s_mem()))
+        || !TEST_true(ossl_qlog_bin_to_json(bio, json)))
+        goto err;
+
+    buf_len = BIO_get_mem_data(json, &buf);
+    if (!TEST_int_eq(BIO_reset(bio), 1)
+        || !TEST_int_eq(BIO_write(bio, buf, (int)buf_len), (int)buf_len))
+        goto err;
+
+    ok = 1;
+err:
+    BIO_free(json);
+    return ok;
+}
+
+/*
+ * idx 0: JSON-SEQ output
+ * idx 1: binary output written synchronously, converted to JSON-SEQ
+ * idx 2: binary output written by a background writer, converted to JSON-SEQ
+ */
+static int test_qlog(int idx)
 {
     int testresult = 0;
     QLOG_TRACE_INFO qti = { 0 };
-    QLOG *qlog;
-    BIO *bio;
+    QLOG *qlog = NULL;
+    BIO *bio = NULL;
     char *buf = NULL;
     size_t buf_len = 0;
 
@@ -93,18 +132,29 @@ static int test_qlog(void)
     qti.override_process_id = 123;
     qti.now_cb = now;
     qti.override_impl_name = "OpenSSL/x.y.z";
+    qti.get_writer_cb = get_writer;
+
+    if (idx == 2 && !TEST_ptr(writer = ossl_qlog_writer_new()))
+        goto err;
 
     if (!TEST_ptr(qlog = ossl_qlog_new(&qti)))
         goto err;
 
+    if (idx > 0
+        && !TEST_true(ossl_qlog_set_format(qlog, QLOG_FORMAT_BINARY)))
+        goto err;
+
     if (!TEST_true(ossl_qlog_set_event_type_enabled(qlog, QLOG_EVENT_TYPE_transport_packet_sent, 1)))
         goto err;
 
-    if (!TEST_ptr(bio = BIO_new(BIO_s_mem())))
+    if (!TEST_ptr(bio = BIO_new(BIO_s_mem()))
+        || !TEST_true(BIO_up_ref(bio)))
         goto err;
 
-    if (!TEST_true(ossl_qlog_set_sink_bio(qlog, bio)))
+    if (!TEST_true(ossl_qlog_set_sink_bio(qlog, bio))) {
+        BIO_free(bio);
         goto err;
+    }
 
     QLOG_EVENT_BEGIN(qlog, transport, packet_sent)
     QLOG_STR("field1", "foo");
@@ -138,6 +188,13 @@ static int test_qlog(void)
     if (!TEST_true(ossl_qlog_flush(qlog)))
         goto err;
 
+    /* The format cannot be changed once output has started. */
+    if (!TEST_false(ossl_qlog_set_format(qlog, QLOG_FORMAT_JSON_SEQ)))
+        goto err;
+
+    if (idx > 0 && !convert_bin(bio))
+        goto err;
+
     buf_len = BIO_get_mem_data(bio, &buf);
     if (!TEST_size_t_gt(buf_len, 0))
         goto err;
@@ -148,6 +205,152 @@ static int test_qlog(void)
     testresult = 1;
 err:
     ossl_qlog_free(qlog);
+    BIO_free(bio);
+    ossl_qlog_writer_free(writer);
+    writer = NULL;
+    return testresult;
+}
+
+#define NUM_STRESS_EVENTS 4000
+
+static OSSL_TIME fixed_now(void *arg)
+{
+    return ossl_ms2time(1000);
+}
+
+static void stress_events(QLOG *qlog, int with_oversize)
+{
+    static unsigned char big[QLOG_BIN_RING_SIZE];
+    char name[16];
+    int i;
+
+    for (i = 0; i < NUM_STRESS_EVENTS; ++i) {
+        /* Not representable in the ring; dropped from binary output. */
+        if (with_oversize && i == NUM_STRESS_EVENTS / 2) {
+            QLOG_EVENT_BEGIN(qlog, transport, packet_sent)
+            QLOG_STR("new_key", "lost with the event");
+            QLOG_BIN("big", big, sizeof(big));
+            QLOG_EVENT_END()
+        }
+
+        BIO_snprintf(name, sizeof(name), "key%d", i % 100);
+
+        QLOG_EVENT_BEGIN(qlog, transport, packet_sent)
+        QLOG_U64("seq", i);
+        QLOG_I64("neg", -i);
+        QLOG_BEGIN("header")
+        QLOG_STR(name, "value");
+        QLOG_BIN("data", &i, sizeof(i));
+        QLOG_END()
+        QLOG_EVENT_END()
+
+        QLOG_EVENT_BEGIN(qlog, transport, packet_received)
+        QLOG_BEGIN_ARRAY("frames")
+        QLOG_BOOL(NULL, i % 2);
+        QLOG_END_ARRAY()
+        QLOG_EVENT_END()
+    }
+}
+
+static int write_stress_log(int format, BIO *bio)
+{
+    QLOG_TRACE_INFO qti = { 0 };
+    QLOG *qlog;
+    int ok = 0;
+
+    qti.odcid.id_len = 1;
+    qti.odcid.id[0] = 0x55;
+    qti.override_process_id = 123;
+    qti.override_impl_name = "OpenSSL/x.y.z";
+    qti.now_cb = fixed_now;
+    qti.get_writer_cb = get_writer;
+
+    if (!TEST_ptr(qlog = ossl_qlog_new(&qti)))
+        return 0;
+
+    if (!TEST_true(ossl_qlog_set_filter(qlog, "*"))
+        || !TEST_true(ossl_qlog_set_format(qlog, format))
+        || !TEST_true(BIO_up_ref(bio)))
+        goto err;
+
+    if (!TEST_true(ossl_qlog_set_sink_bio(qlog, bio))) {
+        BIO_free(bio);
+        goto err;
+    }
+
+    stress_events(qlog, format == QLOG_FORMAT_BINARY);
+    ok = 1;
+err:
+    ossl_qlog_free(qlog);
+    return ok;
+}
+
+/*
+ * Write enough binary output to wrap the ring many times, including an event
+ * too big for the ring, and check it converts to the same output as JSON-SEQ.
+ */
+static int test_qlog_binary_stress(void)
+{
+    int testresult = 0;
+    BIO *json = NULL, *bin = NULL;
+    char *json_out, *bin_out;
+    long json_len, bin_len;
+
+    if (!TEST_ptr(writer = ossl_qlog_writer_new())
+        || !TEST_ptr(json = BIO_new(BIO_s_mem()))
+        || !TEST_ptr(bin = BIO_new(BIO_s_mem()))
+        || !write_stress_log(QLOG_FORMAT_JSON_SEQ, json)
+        || !write_stress_log(QLOG_FORMAT_BINARY, bin)
+        || !convert_bin(bin))
+        goto err;
+
+    json_len = BIO_get_mem_data(json, &json_out);
+    bin_len = BIO_get_mem_data(bin, &bin_out);
+    if (!TEST_long_gt(json_len, QLOG_BIN_RING_SIZE)
+        || !TEST_mem_eq(bin_out, bin_len, json_out, json_len))
+        goto err;
+
+    testresult = 1;
+err:
+    BIO_free(json);
+    BIO_free(bin);
+    ossl_qlog_writer_free(writer);
+    writer = NULL;
+    return testresult;
+}
+
+static int test_qlog_bin_malformed(void)
+{
+    static const unsigned char bad_magic[] = { 'O', 'Q', 'L', 'X', 1 };
+    static const unsigned char no_header[] = {
+        'O', 'Q', 'L', 'B', 1,
+        0, 0, 0, 10, QLOG_BIN_REC_EVENT, 0, 0, 0, 0, 0, 0, 0, 0, 1
+    };
+    static const unsigned char truncated[] = {
+        'O', 'Q', 'L', 'B', 1, 0, 0, 0, 10, QLOG_BIN_REC_EVENT
+    };
+    int testresult = 0;
+    BIO *in = NULL, *out = NULL;
+
+    if (!TEST_ptr(out = BIO_new(BIO_s_mem()))
+        || !TEST_ptr(in = BIO_new_mem_buf(bad_magic, sizeof(bad_magic)))
+        || !TEST_false(ossl_qlog_bin_to_json(in, out)))
+        goto err;
+
+    BIO_free(in);
+    if (!TEST_ptr(in = BIO_new_mem_buf(no_header, sizeof(no_header)))
+        || !TEST_false(ossl_qlog_bin_to_json(in, out)))
+        goto err;
+
+    BIO_free(in);
+    if (!TEST_ptr(in = BIO_new_mem_buf(truncated, sizeof(truncated)))
+        || !TEST_false(ossl_qlog_bin_to_json(in, out)))
+        goto err;
+
+    testresult = 1;
+err:
+    BIO_free(in);
+    BIO_free(out);
     return testresult;
 }
 
@@ -242,7 +445,9 @@ err:
 
 int setup_tests(void)
 {
-    ADD_TEST(test_qlog);
+    ADD_ALL_TESTS(test_qlog, 3);
+    ADD_TEST(test_qlog_binary_stress);
+    ADD_TEST(test_qlog_bin_malformed);
     ADD_ALL_TESTS(test_qlog_filter, OSSL_NELEM(filters));
     return 1;
 }
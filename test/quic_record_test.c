@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -7,6 +7,7 @@
  * https://www.openssl.org/source/license.html
  */
 
+#include <openssl/rand.h>
 #include "internal/quic_record_rx.h"
 #include "internal/quic_rx_depack.h"
 #include "internal/quic_record_tx.h"
@@ -3172,6 +3173,92 @@ static int test_wire_pkt_hdr(int idx)
     return test_wire_pkt_hdr_inner(tidx, repeat, cipher);
 }
 
+/*
+ * Batched header protection must give the same result as protecting each
+ * packet individually.
+ */
+#define HPR_BATCH_PKT_LEN 40
+
+static int test_hdr_prot_batch(int cipher)
+{
+    int testresult = 0, have_hpr = 0;
+    QUIC_HDR_PROTECTOR hpr = { 0 };
+    QUIC_HDR_PROT_OP ops[QUIC_HDR_PROT_BATCH_MAX];
+    unsigned char hpr_key[32] = { 0xb0, 0xb1, 0xb2, 0xb3 };
+    unsigned char orig[QUIC_HDR_PROT_BATCH_MAX][HPR_BATCH_PKT_LEN];
+    unsigned char single[QUIC_HDR_PROT_BATCH_MAX][HPR_BATCH_PKT_LEN];
+    unsigned char batch[QUIC_HDR_PROT_BATCH_MAX][HPR_BATCH_PKT_LEN];
+    uint32_t hpr_cipher_id;
+    size_t hpr_key_len, i;
+
+    switch (cipher) {
+    case 0:
+        hpr_cipher_id = QUIC_HDR_PROT_CIPHER_AES_128;
+        hpr_key_len = 16;
+        break;
+    case 1:
+        hpr_cipher_id = QUIC_HDR_PROT_CIPHER_AES_256;
+        hpr_key_len = 32;
+        break;
+    default:
+#if !defined(OPENSSL_NO_CHACHA) && !defined(OPENSSL_NO_POLY1305)
+        hpr_cipher_id = QUIC_HDR_PROT_CIPHER_CHACHA;
+        hpr_key_len = 32;
+        break;
+#else
+        return TEST_skip("ChaCha20 not supported");
+#endif
+    }
+
+    if (!TEST_true(ossl_quic_hdr_protector_init(&hpr, NULL, NULL,
+            hpr_cipher_id, hpr_key, hpr_key_len)))
+        goto err;
+
+    have_hpr = 1;
+
+    /* Short header packets with a 4-byte PN at offset 1, sample at 5. */
+    for (i = 0; i < QUIC_HDR_PROT_BATCH_MAX; ++i) {
+        if (!TEST_int_eq(RAND_bytes(orig[i], sizeof(orig[i])), 1))
+            goto err;
+
+        orig[i][0] = (orig[i][0] & ~0x80) | 0x40 | 0x03;
+        memcpy(single[i], orig[i], sizeof(orig[i]));
+        memcpy(batch[i], orig[i], sizeof(orig[i]));
+
+        if (!TEST_true(ossl_quic_hdr_protector_encrypt_fields(&hpr,
+                single[i] + 5, sizeof(single[i]) - 5,
+                single[i], single[i] + 1)))
+            goto err;
+
+        ops[i].sample = batch[i] + 5;
+        ops[i].sample_len = sizeof(batch[i]) - 5;
+        ops[i].first_byte = batch[i];
+        ops[i].pn_bytes = batch[i] + 1;
+    }
+
+    if (!TEST_true(ossl_quic_hdr_protector_encrypt_batch(&hpr, ops,
+            OSSL_NELEM(ops)))
+        || !TEST_mem_eq(batch, sizeof(batch), single, sizeof(single)))
+        goto err;
+
+    if (!TEST_true(ossl_quic_hdr_protector_decrypt_batch(&hpr, ops,
+            OSSL_NELEM(ops)))
+        || !TEST_mem_eq(batch, sizeof(batch), orig, sizeof(orig)))
+        goto err;
+
+    /* Batches larger than the maximum are rejected without modifying data. */
+    if (!TEST_false(ossl_quic_hdr_protector_encrypt_batch(&hpr, ops,
+            OSSL_NELEM(ops) + 1))
+        || !TEST_mem_eq(batch, sizeof(batch), orig, sizeof(orig)))
+        goto err;
+
+    testresult = 1;
+err:
+    if (have_hpr)
+        ossl_quic_hdr_protector_cleanup(&hpr);
+    return testresult;
+}
+
 /* TX Tests */
 #define TX_TEST_OP_END 0 /* end of script */
 #define TX_TEST_OP_WRITE 1 /* write packet */
@@ -3927,6 +4014,7 @@ int setup_tests(void)
      * and otherwise random test ordering will cause itt to randomly fail.
      */
     ADD_ALL_TESTS(test_wire_pkt_hdr, NUM_WIRE_PKT_HDR_TESTS + 1);
+    ADD_ALL_TESTS(test_hdr_prot_batch, HPR_CIPHER_COUNT);
     ADD_ALL_TESTS(test_tx_script, OSSL_NELEM(tx_scripts));
     ADD_MFAIL_NO_CHECK_TEST(test_qrx_multipkt_alloc_failure);
     return 1;
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -37,6 +37,8 @@ static const unsigned char data_1[] = {
     0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f
 };
 
+static const unsigned char simple_data[] = "Hello world! And thank you for all the fish!";
+
 static int test_sstream_simple(void)
 {
     int testresult = 0;
@@ -337,6 +339,118 @@ err:
     ossl_quic_sstream_free(sstream);
     return testresult;
 }
+static size_t ref_free_calls;
+static const void *ref_free_buf;
+static size_t ref_free_len;
+
+static void ref_free_cb(const void *buf, size_t buf_len, void *arg)
+{
+    ++ref_free_calls;
+    ref_free_buf = buf;
+    ref_free_len = buf_len;
+    *(int *)arg = 1;
+}
+
+static int test_sstream_ref(void)
+{
+    int testresult = 0, freed = 0;
+    QUIC_SSTREAM *sstream = NULL;
+    OSSL_QUIC_FRAME_STREAM hdr;
+    OSSL_QTX_IOVEC iov[2];
+    size_t num_iov = 0, wr = 0;
+
+    ref_free_calls = 0;
+
+    if (!TEST_ptr(sstream = ossl_quic_sstream_new(8192)))
+        goto err;
+
+    /* Copied, referenced and copied data */
+    if (!TEST_true(ossl_quic_sstream_append(sstream, simple_data, 4, &wr))
+        || !TEST_size_t_eq(wr, 4)
+        || !TEST_true(ossl_quic_sstream_append_ref(sstream, data_1,
+            sizeof(data_1),
+            ref_free_cb, &freed))
+        || !TEST_true(ossl_quic_sstream_append(sstream, simple_data + 4, 4,
+            &wr))
+        || !TEST_size_t_eq(wr, 4)
+        || !TEST_size_t_eq(ossl_quic_sstream_get_buffer_used(sstream), 8))
+        goto err;
+
+    /* The first frame stops where the referenced data starts */
+    num_iov = OSSL_NELEM(iov);
+    if (!TEST_true(ossl_quic_sstream_get_stream_frame(sstream, 0, &hdr, iov,
+            &num_iov))
+        || !TEST_uint64_t_eq(hdr.offset, 0)
+        || !TEST_uint64_t_eq(hdr.len, 4)
+        || !TEST_true(compare_iov(simple_data, 4, iov, num_iov))
+        || !TEST_true(ossl_quic_sstream_mark_transmitted(sstream, 0, 3)))
+        goto err;
+
+    /* The referenced data is served directly from the caller's buffer */
+    num_iov = OSSL_NELEM(iov);
+    if (!TEST_true(ossl_quic_sstream_get_stream_frame(sstream, 0, &hdr, iov,
+            &num_iov))
+        || !TEST_uint64_t_eq(hdr.offset, 4)
+        || !TEST_uint64_t_eq(hdr.len, sizeof(data_1))
+        || !TEST_size_t_eq(num_iov, 1)
+        || !TEST_ptr_eq(iov[0].buf, data_1)
+        || !TEST_true(ossl_quic_sstream_mark_transmitted(sstream, 4, 19)))
+        goto err;
+
+    num_iov = OSSL_NELEM(iov);
+    if (!TEST_true(ossl_quic_sstream_get_stream_frame(sstream, 0, &hdr, iov,
+            &num_iov))
+        || !TEST_uint64_t_eq(hdr.offset, 20)
+        || !TEST_uint64_t_eq(hdr.len, 4)
+        || !TEST_true(compare_iov(simple_data + 4, 4, iov, num_iov))
+        || !TEST_true(ossl_quic_sstream_mark_transmitted(sstream, 20, 23)))
+        goto err;
+
+    /* Partial acknowledgement of the referenced data does not release it */
+    if (!TEST_true(ossl_quic_sstream_mark_acked(sstream, 0, 10))
+        || !TEST_size_t_eq(ref_free_calls, 0)
+        || !TEST_size_t_eq(ossl_quic_sstream_get_buffer_used(sstream), 4))
+        goto err;
+
+    /* Lost referenced data can be retransmitted */
+    if (!TEST_true(ossl_quic_sstream_mark_lost(sstream, 11, 19)))
+        goto err;
+
+    num_iov = OSSL_NELEM(iov);
+    if (!TEST_true(ossl_quic_sstream_get_stream_frame(sstream, 0, &hdr, iov,
+            &num_iov))
+        || !TEST_uint64_t_eq(hdr.offset, 11)
+        || !TEST_uint64_t_eq(hdr.len, 9)
+        || !TEST_true(compare_iov(data_1 + 7, 9, iov, num_iov))
+        || !TEST_true(ossl_quic_sstream_mark_transmitted(sstream, 11, 19)))
+        goto err;
+
+    if (!TEST_true(ossl_quic_sstream_mark_acked(sstream, 11, 23))
+        || !TEST_size_t_eq(ref_free_calls, 1)
+        || !TEST_true(freed)
+        || !TEST_ptr_eq(ref_free_buf, data_1)
+        || !TEST_size_t_eq(ref_free_len, sizeof(data_1))
+        || !TEST_size_t_eq(ossl_quic_sstream_get_buffer_used(sstream), 0))
+        goto err;
+
+    /* Unacknowledged referenced data is released when the stream is freed */
+    freed = 0;
+    if (!TEST_true(ossl_quic_sstream_append_ref(sstream, data_1,
+            sizeof(data_1),
+            ref_free_cb, &freed)))
+        goto err;
+
+    ossl_quic_sstream_free(sstream);
+    sstream = NULL;
+    if (!TEST_size_t_eq(ref_free_calls, 2)
+        || !TEST_true(freed))
+        goto err;
+
+    testresult = 1;
+err:
+    ossl_quic_sstream_free(sstream);
+    return testresult;
+}
 
 static int test_single_copy_read(QUIC_RSTREAM *qrs,
     unsigned char *buf, size_t size,
@@ -370,8 +484,6 @@ static int test_single_copy_read(QUIC_RSTREAM *qrs,
     return 1;
 }
 
-static const unsigned char simple_data[] = "Hello world! And thank you for all the fish!";
-
 static int test_rstream_simple(int idx)
 {
     QUIC_RSTREAM *rstream = NULL;
@@ -472,6 +584,53 @@ err:
     return ret;
 }
 
+/*
+ * Data queued while a record is held must not disturb the held record, even if
+ * it overlaps it.
+ */
+static int test_rstream_held_record(void)
+{
+    QUIC_RSTREAM *rstream = NULL;
+    int ret = 0, fin = 0;
+    unsigned char held[10];
+    const unsigned char *record = NULL;
+    size_t rec_len = 0;
+
+    memcpy(held, simple_data, sizeof(held));
+
+    if (!TEST_ptr(rstream = ossl_quic_rstream_new(NULL, NULL, 0))
+        || !TEST_true(ossl_quic_rstream_queue_data(rstream, NULL, 0,
+            held, sizeof(held), 0))
+        || !TEST_false(ossl_quic_rstream_is_record_held(rstream))
+        || !TEST_true(ossl_quic_rstream_get_record(rstream, &record, &rec_len,
+            &fin))
+        || !TEST_true(ossl_quic_rstream_is_record_held(rstream))
+        || !TEST_ptr_eq(record, held)
+        || !TEST_size_t_eq(rec_len, sizeof(held))
+        || !TEST_true(ossl_quic_rstream_queue_data(rstream, NULL, 0,
+            simple_data, sizeof(simple_data), 1))
+        || !TEST_true(ossl_quic_rstream_release_record(rstream, 4))
+        || !TEST_false(ossl_quic_rstream_is_record_held(rstream))
+        || !TEST_true(ossl_quic_rstream_get_record(rstream, &record, &rec_len,
+            &fin))
+        || !TEST_false(fin)
+        || !TEST_ptr_eq(record, held + 4)
+        || !TEST_size_t_eq(rec_len, sizeof(held) - 4)
+        || !TEST_true(ossl_quic_rstream_release_record(rstream, SIZE_MAX))
+        || !TEST_true(ossl_quic_rstream_get_record(rstream, &record, &rec_len,
+            &fin))
+        || !TEST_true(fin)
+        || !TEST_mem_eq(record, rec_len, simple_data + sizeof(held),
+            sizeof(simple_data) - sizeof(held))
+        || !TEST_true(ossl_quic_rstream_release_record(rstream, SIZE_MAX)))
+        goto err;
+
+    ret = 1;
+err:
+    ossl_quic_rstream_free(rstream);
+    return ret;
+}
+
 static int test_rstream_random(int idx)
 {
     unsigned char *bulk_data = NULL;
@@ -598,8 +757,10 @@ err:
 int setup_tests(void)
 {
     ADD_TEST(test_sstream_simple);
+    ADD_TEST(test_sstream_ref);
     ADD_ALL_TESTS(test_sstream_bulk, 100);
     ADD_ALL_TESTS(test_rstream_simple, 4);
+    ADD_TEST(test_rstream_held_record);
     ADD_ALL_TESTS(test_rstream_random, 100);
     return 1;
 }
@@ -3818,6 +3818,198 @@ end:
     return ret;
 }
 
+static int test_cc_algorithm(int idx)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientquic = NULL, *listener = NULL;
+    QUIC_TSERVER *qtserv = NULL;
+    unsigned char msg[] = "cc test";
+    unsigned char buf[sizeof(msg)];
+    size_t numbytes = 0;
+    uint64_t v;
+    int ret = 0;
+
+    if (!TEST_ptr(cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method()))
+        || !TEST_ptr(sctx = create_server_ctx()))
+        goto end;
+
+    /* A listener passes its setting on to the connections it accepts. */
+    if (!TEST_ptr(listener = SSL_new_listener(sctx, 0))
+        || !TEST_true(SSL_get_generic_value_uint(listener,
+            SSL_VALUE_QUIC_CC_ALGORITHM, &v))
+        || !TEST_uint64_t_eq(v, SSL_VALUE_QUIC_CC_ALGORITHM_NEWRENO)
+        || !TEST_true(SSL_set_generic_value_uint(listener,
+            SSL_VALUE_QUIC_CC_ALGORITHM, idx))
+        || !TEST_true(SSL_get_generic_value_uint(listener,
+            SSL_VALUE_QUIC_CC_ALGORITHM, &v))
+        || !TEST_uint64_t_eq(v, idx))
+        goto end;
+
+    if (!TEST_true(qtest_create_quic_objects(libctx, cctx, NULL,
+            cert, privkey, 0,
+            &qtserv, &clientquic,
+            NULL, NULL)))
+        goto end;
+
+    if (!TEST_false(SSL_set_generic_value_uint(clientquic,
+            SSL_VALUE_QUIC_CC_ALGORITHM, 3))
+        || !TEST_true(SSL_set_generic_value_uint(clientquic,
+            SSL_VALUE_QUIC_CC_ALGORITHM, idx))
+        || !TEST_true(SSL_get_generic_value_uint(clientquic,
+            SSL_VALUE_QUIC_CC_ALGORITHM, &v))
+        || !TEST_uint64_t_eq(v, idx))
+        goto end;
+
+    if (!TEST_true(qtest_create_quic_connection(qtserv, clientquic)))
+        goto end;
+
+    /* The algorithm cannot be changed once the connection has started. */
+    if (!TEST_false(SSL_set_generic_value_uint(clientquic,
+            SSL_VALUE_QUIC_CC_ALGORITHM, SSL_VALUE_QUIC_CC_ALGORITHM_NEWRENO))
+        || !TEST_true(SSL_get_generic_value_uint(clientquic,
+            SSL_VALUE_QUIC_CC_ALGORITHM, &v))
+        || !TEST_uint64_t_eq(v, idx))
+        goto end;
+
+    ERR_clear_error();
+
+    if (!TEST_true(SSL_write_ex(clientquic, msg, sizeof(msg), &numbytes))
+        || !TEST_size_t_eq(numbytes, sizeof(msg)))
+        goto end;
+
+    ossl_quic_tserver_tick(qtserv);
+    if (!TEST_true(ossl_quic_tserver_read(qtserv, 0, buf, sizeof(buf),
+            &numbytes))
+        || !TEST_mem_eq(buf, numbytes, msg, sizeof(msg)))
+        goto end;
+
+    /* Only BBR provides a pacing rate, the other algorithms are not paced. */
+    if (!TEST_true(SSL_get_generic_value_uint(clientquic,
+            SSL_VALUE_QUIC_PACING_RATE, &v)))
+        goto end;
+
+    if (idx == SSL_VALUE_QUIC_CC_ALGORITHM_BBR) {
+        if (!TEST_uint64_t_gt(v, 0))
+            goto end;
+    } else {
+        if (!TEST_uint64_t_eq(v, 0)
+            || !TEST_true(SSL_get_generic_value_uint(clientquic,
+                SSL_VALUE_QUIC_PACING_DEFERRALS, &v))
+            || !TEST_uint64_t_eq(v, 0))
+            goto end;
+    }
+
+    /* Pacing statistics are per connection. */
+    if (!TEST_false(SSL_get_generic_value_uint(listener,
+            SSL_VALUE_QUIC_PACING_RATE, &v)))
+        goto end;
+
+    ret = 1;
+end:
+    ossl_quic_tserver_free(qtserv);
+    SSL_free(clientquic);
+    SSL_free(listener);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+    return ret;
+}
+
+static int write_ref_released;
+
+static void write_ref_release_cb(const void *buf, size_t num, void *arg)
+{
+    if (buf == arg && num == sizeof("zero-copy write"))
+        ++write_ref_released;
+}
+
+static int test_read_write_ref(void)
+{
+    SSL_CTX *cctx = NULL;
+    SSL *clientquic = NULL;
+    QUIC_TSERVER *qtserv = NULL;
+    static const unsigned char msg[] = "zero-copy write";
+    static const unsigned char reply[] = "zero-copy read";
+    unsigned char buf[sizeof(msg)];
+    const unsigned char *ref = NULL;
+    size_t numbytes = 0, total = 0, readbytes = 0;
+    int i, ret = 0;
+
+    write_ref_released = 0;
+
+    if (!TEST_ptr(cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method()))
+        || !TEST_true(qtest_create_quic_objects(libctx, cctx, NULL,
+            cert, privkey, 0,
+            &qtserv, &clientquic,
+            NULL, NULL))
+        || !TEST_true(qtest_create_quic_connection(qtserv, clientquic)))
+        goto end;
+
+    /* A release callback is mandatory */
+    if (!TEST_false(SSL_write_ref_ex(clientquic, msg, sizeof(msg), 0, NULL,
+            (void *)msg, &numbytes))
+        || !TEST_true(SSL_write_ref_ex(clientquic, msg, sizeof(msg), 0,
+            write_ref_release_cb, (void *)msg,
+            &numbytes))
+        || !TEST_size_t_eq(numbytes, sizeof(msg)))
+        goto end;
+
+    ossl_quic_tserver_tick(qtserv);
+    if (!TEST_true(ossl_quic_tserver_read(qtserv, 0, buf, sizeof(buf),
+            &numbytes))
+        || !TEST_mem_eq(buf, numbytes, msg, sizeof(msg))
+        || !TEST_true(ossl_quic_tserver_write(qtserv, 0, reply, sizeof(reply),
+            &numbytes))
+        || !TEST_size_t_eq(numbytes, sizeof(reply)))
+        goto end;
+
+    /*
+     * Receive the reply without copying it. Any held reference must be
+     * released before the stream can be read again.
+     */
+    for (i = 0; i < 1000 && total < sizeof(reply); i++) {
+        ossl_quic_tserver_tick(qtserv);
+        if (!SSL_read_ref_ex(clientquic, &ref, &numbytes)) {
+            if (!TEST_int_eq(SSL_get_error(clientquic, 0), SSL_ERROR_WANT_READ))
+                goto end;
+            OSSL_sleep(1);
+            continue;
+        }
+
+        if (!TEST_size_t_gt(numbytes, 0)
+            || !TEST_size_t_le(total + numbytes, sizeof(reply))
+            || !TEST_mem_eq(ref, numbytes, reply + total, numbytes)
+            || !TEST_false(SSL_read_ex(clientquic, buf, sizeof(buf),
+                &readbytes))
+            || !TEST_false(SSL_read_ref_release(clientquic, numbytes + 1))
+            || !TEST_true(SSL_read_ref_release(clientquic, numbytes)))
+            goto end;
+
+        total += numbytes;
+        ERR_clear_error();
+    }
+
+    if (!TEST_size_t_eq(total, sizeof(reply))
+        || !TEST_false(SSL_read_ref_release(clientquic, 0)))
+        goto end;
+
+    /* The written buffer is released once the server has acknowledged it */
+    for (i = 0; i < 1000 && write_ref_released == 0; i++) {
+        ossl_quic_tserver_tick(qtserv);
+        SSL_handle_events(clientquic);
+        OSSL_sleep(1);
+    }
+
+    if (!TEST_int_eq(write_ref_released, 1))
+        goto end;
+
+    ret = 1;
+end:
+    ossl_quic_tserver_free(qtserv);
+    SSL_free(clientquic);
+    SSL_CTX_free(cctx);
+    return ret;
+}
+
 static int test_ssl_new_mfail(void)
 {
     int ret = 0;
@@ -3964,6 +4156,430 @@ end:
     return testresult;
 }
 
+#define NUM_OFFLOAD_CLIENTS 4
+#define OFFLOAD_STEPS 5000
+/*
+ * Complete several handshakes on a listener which may run handshake steps on
+ * worker threads. Connections are only accepted once their client has finished
+ * connecting, so that the server side of the handshake runs while the
+ * connections are still waiting in the accept queue.
+ */
+static int test_handshake_offload(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *listener = NULL, *clients[NUM_OFFLOAD_CLIENTS] = { NULL };
+    SSL *servers[NUM_OFFLOAD_CLIENTS] = { NULL };
+    static const unsigned char msg[] = "offload test";
+    unsigned char buf[sizeof(msg)];
+    size_t numbytes = 0;
+    unsigned int i, step;
+    uint64_t v;
+    int testresult = 0;
+    BIO *bio;
+
+    if (!TEST_true(create_quic_ctx_pair(libctx, &cctx, &sctx, cert, privkey))
+        || !TEST_true(create_quic_conn_objects(cctx, sctx, &clients[0],
+            &listener)))
+        goto end;
+
+    if (!TEST_true(SSL_get_generic_value_uint(listener,
+            SSL_VALUE_QUIC_HANDSHAKE_THREADS, &v))
+        || !TEST_uint64_t_eq(v, 0)
+        || !TEST_true(SSL_set_generic_value_uint(listener,
+            SSL_VALUE_QUIC_HANDSHAKE_THREADS, 2))
+        || !TEST_true(SSL_get_generic_value_uint(listener,
+            SSL_VALUE_QUIC_HANDSHAKE_THREADS, &v))
+        || !TEST_uint64_t_eq(v, 2)
+        || !TEST_false(SSL_set_generic_value_uint(clients[0],
+            SSL_VALUE_QUIC_HANDSHAKE_THREADS, 2))
+        || !TEST_true(SSL_listen(listener)))
+        goto end;
+
+    if (!TEST_ptr(bio = SSL_get_rbio(clients[0])))
+        goto end;
+
+    for (i = 1; i < NUM_OFFLOAD_CLIENTS; i++)
+        if (!TEST_ptr(clients[i] = create_quic_client(cctx, bio)))
+            goto end;
+
+    if (!TEST_true(SSL_set_blocking_mode(clients[0], 0)))
+        goto end;
+
+    /*
+     * The clients share a BIO, so only drive one of them at a time. Each
+     * connection is accepted once its client has finished connecting.
+     */
+    for (i = 0; i < NUM_OFFLOAD_CLIENTS; i++) {
+        for (step = 0; step < OFFLOAD_STEPS; step++) {
+            if (SSL_connect(clients[i]) == 1)
+                break;
+            if (!TEST_int_eq(SSL_get_error(clients[i], 0), SSL_ERROR_WANT_READ))
+                goto end;
+            SSL_handle_events(listener);
+            OSSL_sleep(1);
+        }
+
+        for (; servers[i] == NULL && step < OFFLOAD_STEPS; step++) {
+            SSL_handle_events(listener);
+            servers[i] = SSL_accept_connection(listener, 0);
+        }
+
+        if (!TEST_ptr(servers[i]))
+            goto end;
+    }
+
+    /* The setting belongs to the listener only. */
+    if (!TEST_false(SSL_get_generic_value_uint(servers[0],
+            SSL_VALUE_QUIC_HANDSHAKE_THREADS, &v)))
+        goto end;
+
+    if (!TEST_true(SSL_write_ex(clients[0], msg, sizeof(msg), &numbytes))
+        || !TEST_size_t_eq(numbytes, sizeof(msg)))
+        goto end;
+
+    for (step = 0; step < OFFLOAD_STEPS; step++) {
+        SSL_handle_events(clients[0]);
+        SSL_handle_events(listener);
+        if (SSL_read_ex(servers[0], buf, sizeof(buf), &numbytes))
+            break;
+        if (!TEST_int_eq(SSL_get_error(servers[0], 0), SSL_ERROR_WANT_READ))
+            goto end;
+    }
+
+    if (!TEST_mem_eq(buf, numbytes, msg, sizeof(msg)))
+        goto end;
+
+    testresult = 1;
+end:
+    for (i = 0; i < NUM_OFFLOAD_CLIENTS; i++) {
+        SSL_free(servers[i]);
+        SSL_free(clients[i]);
+    }
+    SSL_free(listener);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+#define NUM_SHARDS 2
+#define NUM_SHARD_CLIENTS 8
+#define SHARD_STEPS 5000
+/*
+ * Create NUM_SHARDS listeners in separate domains, each on its own UDP socket,
+ * with all sockets sharing one address via SO_REUSEPORT. Check that every
+ * client connection is completed by exactly one of the listeners, which
+ * requires the kernel to steer each connection's packets to the right socket.
+ */
+static int test_cid_sharding(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *domain[NUM_SHARDS] = { NULL }, *listener[NUM_SHARDS] = { NULL };
+    SSL *client[NUM_SHARD_CLIENTS] = { NULL };
+    SSL *server[NUM_SHARD_CLIENTS] = { NULL };
+    BIO *bio;
+    BIO_ADDR *addr = NULL;
+    union BIO_sock_info_u info;
+    struct in_addr ina;
+    size_t i, j, num_server = 0, num_done, readbytes;
+    unsigned char buf[1], seen[NUM_SHARD_CLIENTS] = { 0 };
+    uint64_t v;
+    int fd, step, testresult = 0;
+
+    ina.s_addr = htonl(0x7f000001);
+    if (!TEST_ptr(sctx = create_server_ctx())
+        || !TEST_ptr(cctx = create_client_ctx())
+        || !TEST_ptr(addr = create_addr(&ina, 0)))
+        goto err;
+
+    for (i = 0; i < NUM_SHARDS; ++i) {
+        if (!TEST_int_ge(fd = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0),
+                0))
+            goto err;
+
+        ERR_set_mark();
+        if (!BIO_bind(fd, addr, BIO_SOCK_REUSEPORT)) {
+            ERR_pop_to_mark();
+            BIO_closesocket(fd);
+            testresult = TEST_skip("SO_REUSEPORT not supported");
+            goto err;
+        }
+        ERR_clear_last_mark();
+
+        info.addr = addr;
+        if (i == 0 && !TEST_true(BIO_sock_info(fd, BIO_SOCK_INFO_ADDRESS, &info))) {
+            BIO_closesocket(fd);
+            goto err;
+        }
+
+        if (!TEST_ptr(bio = BIO_new_dgram(fd, BIO_CLOSE))) {
+            BIO_closesocket(fd);
+            goto err;
+        }
+
+        if (!TEST_ptr(domain[i] = SSL_new_domain(sctx, 0))
+            || !TEST_ptr(listener[i] = SSL_new_listener_from(domain[i], 0))) {
+            BIO_free(bio);
+            goto err;
+        }
+        SSL_set_bio(listener[i], bio, bio);
+
+        if (!TEST_true(SSL_set_generic_value_uint(listener[i],
+                SSL_VALUE_QUIC_CID_SHARD_COUNT, NUM_SHARDS))
+            || !TEST_true(SSL_set_generic_value_uint(listener[i],
+                SSL_VALUE_QUIC_CID_SHARD_ID, i))
+            || !TEST_true(SSL_get_generic_value_uint(listener[i],
+                SSL_VALUE_QUIC_CID_SHARD_ID, &v))
+            || !TEST_uint64_t_eq(v, i)
+            || !TEST_false(SSL_set_generic_value_uint(listener[i],
+                SSL_VALUE_QUIC_CID_SHARD_COUNT, 257)))
+            goto err;
+    }
+
+    for (i = 0; i < NUM_SHARDS; ++i) {
+        ERR_set_mark();
+        if (!SSL_listen(listener[i])) {
+            ERR_pop_to_mark();
+            testresult = TEST_skip("QUIC CID steering not supported");
+            goto err;
+        }
+        ERR_clear_last_mark();
+
+        if (!TEST_false(SSL_set_generic_value_uint(listener[i],
+                SSL_VALUE_QUIC_CID_SHARD_ID, 0)))
+            goto err;
+    }
+
+    for (i = 0; i < NUM_SHARD_CLIENTS; ++i) {
+        if (!TEST_ptr(client[i] = SSL_new(cctx))
+            || !TEST_int_ge(fd = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP,
+                                BIO_SOCK_NONBLOCK),
+                0))
+            goto err;
+
+        if (!TEST_true(SSL_set_fd(client[i], fd))) {
+            BIO_closesocket(fd);
+            goto err;
+        }
+        (void)BIO_set_close(SSL_get_rbio(client[i]), BIO_CLOSE);
+
+        if (!TEST_true(SSL_set_blocking_mode(client[i], 0))
+            || !TEST_true(qc_init(client[i], addr)))
+            goto err;
+    }
+
+    for (step = 0; step < SHARD_STEPS; ++step) {
+        num_done = 0;
+        for (i = 0; i < NUM_SHARD_CLIENTS; ++i)
+            if (SSL_connect(client[i]) == 1)
+                ++num_done;
+
+        for (j = 0; j < NUM_SHARDS; ++j) {
+            SSL_handle_events(listener[j]);
+            while (num_server < NUM_SHARD_CLIENTS
+                   && (server[num_server]
+                       = SSL_accept_connection(listener[j],
+                           SSL_ACCEPT_CONNECTION_NO_BLOCK))
+                       != NULL)
+                if (!TEST_true(SSL_set_blocking_mode(server[num_server++], 0)))
+                    goto err;
+        }
+
+        if (num_done == NUM_SHARD_CLIENTS)
+            break;
+        OSSL_sleep(1);
+    }
+
+    if (!TEST_size_t_eq(num_done, NUM_SHARD_CLIENTS)
+        || !TEST_size_t_eq(num_server, NUM_SHARD_CLIENTS))
+        goto err;
+
+    /* Each client sends its index; every server connection gets one. */
+    for (i = 0; i < NUM_SHARD_CLIENTS; ++i) {
+        buf[0] = (unsigned char)i;
+        if (!TEST_true(SSL_write_ex(client[i], buf, 1, &readbytes)))
+            goto err;
+    }
+
+    for (step = 0, num_done = 0;
+         step < SHARD_STEPS && num_done < NUM_SHARD_CLIENTS; ++step) {
+        for (i = 0; i < NUM_SHARD_CLIENTS; ++i)
+            SSL_handle_events(client[i]);
+
+        for (j = 0; j < NUM_SHARDS; ++j)
+            SSL_handle_events(listener[j]);
+
+        for (i = 0; i < NUM_SHARD_CLIENTS; ++i) {
+            if (server[i] == NULL
+                || !SSL_read_ex(server[i], buf, 1, &readbytes))
+                continue;
+
+            if (!TEST_size_t_lt(buf[0], NUM_SHARD_CLIENTS)
+                || !TEST_false(seen[buf[0]]))
+                goto err;
+            seen[buf[0]] = 1;
+            ++num_done;
+        }
+        OSSL_sleep(1);
+    }
+
+    if (!TEST_size_t_eq(num_done, NUM_SHARD_CLIENTS))
+        goto err;
+
+    testresult = 1;
+err:
+    for (i = 0; i < NUM_SHARD_CLIENTS; ++i) {
+        SSL_free(server[i]);
+        SSL_free(client[i]);
+    }
+    for (i = 0; i < NUM_SHARDS; ++i) {
+        SSL_free(listener[i]);
+        SSL_free(domain[i]);
+    }
+    BIO_ADDR_free(addr);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+    return testresult;
+}
+
+/*
+ * Run a server in a domain which uses a persistent epoll set and check that
+ * SSL_poll() on its listener and connection wakes up when the socket becomes
+ * readable, i.e. that the set tracks the listener's socket.
+ */
+static int test_epoll_domain(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *domain = NULL, *listener = NULL, *client = NULL, *server = NULL;
+    BIO *bio;
+    BIO_ADDR *addr = NULL;
+    union BIO_sock_info_u info;
+    struct in_addr ina;
+    SSL_POLL_ITEM item;
+    struct timeval tv;
+    size_t result_count, written, readbytes;
+    unsigned char buf[1];
+    uint64_t domain_flags;
+    int fd, step, connected = 0, testresult = 0;
+
+    ina.s_addr = htonl(0x7f000001);
+    if (!TEST_ptr(sctx = create_server_ctx())
+        || !TEST_ptr(cctx = create_client_ctx())
+        || !TEST_ptr(addr = create_addr(&ina, 0)))
+        goto err;
+
+    ERR_set_mark();
+    domain = SSL_new_domain(sctx, SSL_DOMAIN_FLAG_MULTI_THREAD
+            | SSL_DOMAIN_FLAG_BLOCKING
+            | SSL_DOMAIN_FLAG_EPOLL);
+    if (domain == NULL) {
+        ERR_pop_to_mark();
+        testresult = TEST_skip("epoll not supported");
+        goto err;
+    }
+    ERR_clear_last_mark();
+
+    if (!TEST_true(SSL_get_domain_flags(domain, &domain_flags))
+        || !TEST_uint64_t_ne(domain_flags & SSL_DOMAIN_FLAG_EPOLL, 0)
+        || !TEST_ptr(listener = SSL_new_listener_from(domain, 0))
+        || !TEST_int_ge(fd = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0),
+            0))
+        goto err;
+
+    info.addr = addr;
+    if (!TEST_true(BIO_bind(fd, addr, 0))
+        || !TEST_true(BIO_sock_info(fd, BIO_SOCK_INFO_ADDRESS, &info))
+        || !TEST_ptr(bio = BIO_new_dgram(fd, BIO_CLOSE))) {
+        BIO_closesocket(fd);
+        goto err;
+    }
+
+    SSL_set_bio(listener, bio, bio);
+    if (!TEST_true(SSL_listen(listener))
+        || !TEST_ptr(client = SSL_new(cctx))
+        || !TEST_int_ge(fd = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP,
+                            BIO_SOCK_NONBLOCK),
+            0))
+        goto err;
+
+    if (!TEST_true(SSL_set_fd(client, fd))) {
+        BIO_closesocket(fd);
+        goto err;
+    }
+    (void)BIO_set_close(SSL_get_rbio(client), BIO_CLOSE);
+
+    if (!TEST_true(SSL_set_blocking_mode(client, 0))
+        || !TEST_true(qc_init(client, addr)))
+        goto err;
+
+    /*
+     * The client only sends when SSL_connect() is called, so the server has to
+     * block in SSL_poll() until the client's datagrams arrive.
+     */
+    for (step = 0; step < 1000 && (!connected || server == NULL); ++step) {
+        connected = (SSL_connect(client) == 1);
+
+        if (server == NULL) {
+            item.desc = SSL_as_poll_descriptor(listener);
+            item.events = SSL_POLL_EVENT_IC;
+            item.revents = 0;
+        } else {
+            item.desc = SSL_as_poll_descriptor(server);
+            item.events = SSL_POLL_EVENT_ISB;
+            item.revents = 0;
+        }
+        tv.tv_sec = 0;
+        tv.tv_usec = 10000;
+        if (!TEST_true(SSL_poll(&item, 1, sizeof(item), &tv, 0,
+                &result_count)))
+            goto err;
+
+        if (server == NULL
+            && (server = SSL_accept_connection(listener,
+                    SSL_ACCEPT_CONNECTION_NO_BLOCK))
+                != NULL
+            && !TEST_true(SSL_set_blocking_mode(server, 0)))
+            goto err;
+    }
+
+    if (!TEST_true(connected)
+        || !TEST_ptr(server)
+        || !TEST_true(SSL_write_ex(client, "x", 1, &written)))
+        goto err;
+
+    /*
+     * The datagram opening the client's stream is waiting in the listener's socket, which must be part of
+     * the domain's poll set.
+     */
+    if (!TEST_int_ge(fd = ossl_quic_get_poll_set_fd(server, -1, -1), 0)
+        || !TEST_int_eq(BIO_socket_wait(fd, 1, time(NULL) + 10), 1))
+        goto err;
+
+    item.desc = SSL_as_poll_descriptor(server);
+    item.events = SSL_POLL_EVENT_ISB;
+    item.revents = 0;
+    tv.tv_sec = 10;
+    tv.tv_usec = 0;
+    if (!TEST_true(SSL_poll(&item, 1, sizeof(item), &tv, 0, &result_count))
+        || !TEST_size_t_eq(result_count, 1)
+        || !TEST_uint64_t_eq(item.revents, SSL_POLL_EVENT_ISB)
+        || !TEST_true(SSL_read_ex(server, buf, sizeof(buf), &readbytes))
+        || !TEST_size_t_eq(readbytes, 1)
+        || !TEST_int_eq(buf[0], 'x'))
+        goto err;
+
+    testresult = 1;
+err:
+    SSL_free(server);
+    SSL_free(client);
+    SSL_free(listener);
+    SSL_free(domain);
+    BIO_ADDR_free(addr);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+    return testresult;
+}
+
 /***********************************************************************************/
 OPT_TEST_DECLARE_USAGE("provider config certsdir datadir\n")
 
@@ -4078,8 +4694,13 @@ int setup_tests(void)
     ADD_MFAIL_NO_CHECK_TEST(test_quic_handshake_multipkt_mfail);
     ADD_TEST(test_ech);
     ADD_TEST(test_quic_resize_txe);
+    ADD_ALL_TESTS(test_cc_algorithm, 3);
+    ADD_TEST(test_read_write_ref);
     ADD_MFAIL_TEST(test_ssl_new_mfail);
     ADD_TEST(test_pending_limit);
+    ADD_TEST(test_handshake_offload);
+    ADD_TEST(test_cid_sharding);
+    ADD_TEST(test_epoll_domain);
 
     return 1;
 err:
@@ -44,6 +44,14 @@
 #include "../ssl/ssl_local.h"
 #include "../ssl/record/methods/recmethod_local.h"
 #include "filterprov.h"
+#include "threadstest.h"
+
+#if defined(OPENSSL_SYS_UNIX)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #undef OSSL_NO_USABLE_TLS1_3
 #if defined(OPENSSL_NO_TLS1_3) \
@@ -9243,6 +9251,204 @@ end:
     return testresult;
 }
 
+/*
+ * Test SSL_writev_ex() and SSL_readv_ex()
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ * Test 2: TLSv1.3 with records spanning the iov elements
+ * Test 3: DTLS
+ */
+static int test_writev_readv(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    static unsigned char body[20000], in[sizeof(body) + 64];
+    unsigned char hdr[] = "HTTP/1.1 200 OK\r\n\r\n", trailer[] = "done";
+    SSL_IOVEC wiov[4], riov[2];
+    size_t i, bodylen, total, tot, first, written, readbytes;
+    int testresult = 0;
+
+    for (i = 0; i < sizeof(body); i++)
+        body[i] = (unsigned char)(i % 251);
+
+    if (tst < 3) {
+#ifdef OPENSSL_NO_TLS1_2
+        if (tst == 0)
+            return 1;
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+        if (tst > 0)
+            return 1;
+#endif
+        if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                TLS_client_method(), TLS1_VERSION,
+                tst == 0 ? TLS1_2_VERSION : TLS1_3_VERSION,
+                &sctx, &cctx, cert, privkey)))
+            goto end;
+        bodylen = sizeof(body);
+    } else {
+#if !defined(OPENSSL_NO_DTLS) && !defined(OPENSSL_NO_DTLS1_2)
+        if (!TEST_true(create_ssl_ctx_pair(libctx, DTLS_server_method(),
+                DTLS_client_method(), DTLS1_2_VERSION, 0,
+                &sctx, &cctx, cert, privkey)))
+            goto end;
+        /* It all has to fit in one record */
+        bodylen = 1000;
+#else
+        return 1;
+#endif
+    }
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE)))
+        goto end;
+
+    if (tst == 2 && !TEST_true(SSL_set_max_send_fragment(clientssl, 512)))
+        goto end;
+
+    wiov[0].iov_base = hdr;
+    wiov[0].iov_len = sizeof(hdr) - 1;
+    wiov[1].iov_base = NULL;
+    wiov[1].iov_len = 0;
+    wiov[2].iov_base = body;
+    wiov[2].iov_len = bodylen;
+    wiov[3].iov_base = trailer;
+    wiov[3].iov_len = sizeof(trailer) - 1;
+    total = wiov[0].iov_len + bodylen + wiov[3].iov_len;
+
+    if (!TEST_true(SSL_writev_ex(clientssl, wiov, OSSL_NELEM(wiov), &written))
+        || !TEST_size_t_eq(written, total))
+        goto end;
+
+    /*
+     * Read into a small buffer followed by a large one. Data already
+     * decrypted carries on into the second buffer.
+     */
+    for (tot = 0; tot < total; tot += readbytes) {
+        first = total - tot < 7 ? total - tot : 7;
+        riov[0].iov_base = in + tot;
+        riov[0].iov_len = first;
+        riov[1].iov_base = in + tot + first;
+        riov[1].iov_len = total - tot - first;
+        if (!TEST_true(SSL_readv_ex(serverssl, riov, 2, &readbytes))
+            || !TEST_size_t_gt(readbytes, 0)
+            || (tot == 0 && !TEST_size_t_gt(readbytes, first)))
+            goto end;
+    }
+
+    if (!TEST_mem_eq(in, wiov[0].iov_len, hdr, wiov[0].iov_len)
+        || !TEST_mem_eq(in + wiov[0].iov_len, bodylen, body, bodylen)
+        || !TEST_mem_eq(in + wiov[0].iov_len + bodylen, wiov[3].iov_len,
+            trailer, wiov[3].iov_len))
+        goto end;
+
+    testresult = 1;
+
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * Test SSL_read_ref_ex()/SSL_read_ref_release() over TLS, and reads with a
+ * buffer large enough for the record layer to decrypt into it directly.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ */
+static int test_read_ref(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    static unsigned char body[5000], in[sizeof(body) + 64];
+    const char msg[] = "hello world";
+    const unsigned char *ref;
+    size_t i, written, readbytes;
+    int testresult = 0;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return 1;
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (tst == 1)
+        return 1;
+#endif
+
+    for (i = 0; i < sizeof(body); i++)
+        body[i] = (unsigned char)(i % 251);
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), TLS1_VERSION,
+            tst == 0 ? TLS1_2_VERSION : TLS1_3_VERSION,
+            &sctx, &cctx, cert, privkey))
+        || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE)))
+        goto end;
+
+    if (!TEST_true(SSL_write_ex(clientssl, msg, strlen(msg), &written))
+        || !TEST_true(SSL_read_ref_ex(serverssl, &ref, &readbytes))
+        || !TEST_mem_eq(ref, readbytes, msg, strlen(msg)))
+        goto end;
+
+    /* No reads are allowed while the reference is held */
+    if (!TEST_false(SSL_read_ex(serverssl, in, sizeof(in), &readbytes))
+        || !TEST_false(SSL_read_ref_ex(serverssl, &ref, &readbytes)))
+        goto end;
+    ERR_clear_error();
+
+    /* Only consume part of the data. The rest is returned again. */
+    if (!TEST_false(SSL_read_ref_release(serverssl, strlen(msg) + 1))
+        || !TEST_true(SSL_read_ref_release(serverssl, 6))
+        || !TEST_size_t_eq(SSL_pending(serverssl), strlen(msg) - 6)
+        || !TEST_true(SSL_read_ref_ex(serverssl, &ref, &readbytes))
+        || !TEST_mem_eq(ref, readbytes, msg + 6, strlen(msg) - 6)
+        || !TEST_true(SSL_read_ref_release(serverssl, readbytes))
+        || !TEST_false(SSL_read_ref_release(serverssl, 0)))
+        goto end;
+    ERR_clear_error();
+
+    /*
+     * In TLSv1.3 the client has not read the session tickets yet. Queue a key
+     * update too, so that the large read below has to deal with handshake
+     * records decrypted into the caller's buffer.
+     */
+    if (tst == 1
+        && !TEST_true(SSL_key_update(serverssl, SSL_KEY_UPDATE_REQUESTED)))
+        goto end;
+
+    if (!TEST_true(SSL_write_ex(serverssl, body, sizeof(body), &written))
+        || !TEST_true(SSL_read_ex(clientssl, in, sizeof(in), &readbytes))
+        || !TEST_mem_eq(in, readbytes, body, sizeof(body)))
+        goto end;
+
+    /* A small read leaves the rest of the record to be read from the buffer */
+    if (!TEST_true(SSL_write_ex(clientssl, body, sizeof(body), &written))
+        || !TEST_true(SSL_read_ex(serverssl, in, 10, &readbytes))
+        || !TEST_size_t_eq(readbytes, 10)
+        || !TEST_true(SSL_read_ex(serverssl, in + 10, sizeof(in) - 10,
+            &readbytes))
+        || !TEST_mem_eq(in, readbytes + 10, body, sizeof(body)))
+        goto end;
+
+    testresult = 1;
+
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 static struct {
     unsigned int maxprot;
     const char *clntciphers;
@@ -10511,6 +10717,145 @@ end:
     return testresult;
 }
 
+static int pkcb_calls;
+static int pkcb_fail;
+static int pkcb_sigalg;
+
+/*
+ * Private key callback which asks to be called again the first time, and
+ * then signs with the key in |arg|
+ */
+static int private_key_cb(SSL *s, int sigalg, const unsigned char *tbs,
+    size_t tbslen, unsigned char *sig, size_t *siglen,
+    size_t sigsize, void *arg)
+{
+    EVP_MD_CTX *mctx = NULL;
+    EVP_PKEY_CTX *pctx = NULL;
+    int ret = SSL_PRIVATE_KEY_FAILURE;
+
+    if (pkcb_fail)
+        return SSL_PRIVATE_KEY_FAILURE;
+    if (pkcb_calls++ == 0)
+        return SSL_PRIVATE_KEY_RETRY;
+
+    pkcb_sigalg = sigalg;
+    *siglen = sigsize;
+    if ((mctx = EVP_MD_CTX_new()) != NULL
+        && EVP_DigestSignInit_ex(mctx, &pctx, "SHA256", libctx, NULL, arg,
+               NULL)
+            > 0
+        && (sigalg != TLSEXT_SIGALG_rsa_pss_rsae_sha256
+            || (EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) > 0
+                && EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx,
+                       RSA_PSS_SALTLEN_DIGEST)
+                    > 0))
+        && EVP_DigestSign(mctx, sig, siglen, tbs, tbslen) > 0)
+        ret = SSL_PRIVATE_KEY_SUCCESS;
+    EVP_MD_CTX_free(mctx);
+
+    return ret;
+}
+
+/*
+ * Test the private key callback. The key configured for the certificate only
+ * holds the public key.
+ * Test 0: TLSv1.2 ServerKeyExchange
+ * Test 1: TLSv1.3 server CertificateVerify
+ * Test 2: TLSv1.3 client CertificateVerify
+ * Test 3: DTLSv1.2 ServerKeyExchange
+ * Test 4: The callback fails
+ */
+static int test_private_key_cb(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL, *signctx;
+    SSL *clientssl = NULL, *serverssl = NULL, *signssl;
+    X509 *x509 = NULL;
+    EVP_PKEY *pkey = NULL, *pubkey = NULL;
+    int tls13 = tst == 1 || tst == 2 || tst == 4;
+    int version = tst == 3 ? DTLS1_2_VERSION
+                           : tls13 ? TLS1_3_VERSION : TLS1_2_VERSION;
+    const char *sigalgs = tls13 ? "rsa_pss_rsae_sha256" : "RSA+SHA256";
+    int testresult = 0;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return TEST_skip("TLSv1.2 is disabled");
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (tls13)
+        return TEST_skip("TLSv1.3 is disabled");
+#endif
+#if defined(OPENSSL_NO_DTLS1_2) || defined(OPENSSL_NO_SOCK)
+    if (tst == 3)
+        return TEST_skip("DTLSv1.2 is disabled");
+#endif
+
+    pkcb_calls = 0;
+    pkcb_fail = tst == 4;
+    pkcb_sigalg = -1;
+
+    if (!TEST_ptr(x509 = load_cert_pem(cert, libctx))
+        || !TEST_ptr(pkey = load_pkey_pem(privkey, libctx))
+        || !TEST_ptr(pubkey = X509_get_pubkey(x509)))
+        goto end;
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx,
+            tst == 3 ? DTLS_server_method() : TLS_server_method(),
+            tst == 3 ? DTLS_client_method() : TLS_client_method(),
+            version, version, &sctx, &cctx,
+            tst == 2 ? cert : NULL, tst == 2 ? privkey : NULL))
+        || !TEST_true(SSL_CTX_set1_sigalgs_list(cctx, sigalgs))
+        || !TEST_true(SSL_CTX_set1_sigalgs_list(sctx, sigalgs)))
+        goto end;
+
+    signctx = tst == 2 ? cctx : sctx;
+    if (!TEST_int_eq(SSL_CTX_use_certificate(signctx, x509), 1)
+        || !TEST_int_eq(SSL_CTX_use_PrivateKey(signctx, pubkey), 1))
+        goto end;
+    if (tst == 2)
+        SSL_CTX_set_verify(sctx,
+            SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT,
+            verify_cb);
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL)))
+        goto end;
+    signssl = tst == 2 ? clientssl : serverssl;
+    SSL_set_private_key_cb(signssl, private_key_cb, pkey);
+
+    if (tst == 4) {
+        if (!TEST_false(create_ssl_connection(serverssl, clientssl,
+                SSL_ERROR_NONE)))
+            goto end;
+        testresult = 1;
+        goto end;
+    }
+
+    /* The handshake stops until the callback is called again */
+    if (!TEST_false(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_WANT_PRIVATE_KEY_OPERATION))
+        || !TEST_true(SSL_want_private_key_operation(signssl))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE))
+        || !TEST_int_eq(pkcb_calls, 2)
+        || !TEST_int_eq(pkcb_sigalg, tls13 ? TLSEXT_SIGALG_rsa_pss_rsae_sha256
+                                           : TLSEXT_SIGALG_rsa_pkcs1_sha256))
+        goto end;
+
+    testresult = 1;
+
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+    X509_free(x509);
+    EVP_PKEY_free(pkey);
+    EVP_PKEY_free(pubkey);
+
+    return testresult;
+}
+
 #if !defined(OPENSSL_NO_TLS1_2) || !defined(OSSL_NO_USABLE_TLS1_3)
 /*
  * Test setting certificate authorities on both client and server.
@@ -10746,71 +11091,467 @@ end:
 }
 #endif /* OPENSSL_NO_TLS1_2 */
 
-static int test_session_timeout(int test)
+#ifndef OSSL_NO_USABLE_TLS1_3
+#define MULTI_RECORD_FRAGSIZE 512
+
+/*
+ * Test large TLSv1.3 writes which are encrypted and written several records
+ * at a time. With SSL_MODE_ENABLE_PARTIAL_WRITE a write returns after the
+ * first batch of records, which tells us how many were written together.
+ * Test 0: Up to 8 records in one go
+ * Test 1: Max pipelines of 2 limits it to 2 records
+ * Test 2: Block padding means the records are written one by one
+ */
+static int test_tls13_multi_record_write(int tst)
 {
-    /*
-     * Test session ordering and timeout
-     * Can't explicitly test performance of the new code,
-     * but can test to see if the ordering of the sessions
-     * are correct, and they are removed as expected
-     */
-    SSL_SESSION *early = NULL;
-    SSL_SESSION *middle = NULL;
-    SSL_SESSION *late = NULL;
-    SSL_CTX *ctx;
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    unsigned char msg[MULTI_RECORD_FRAGSIZE * 9 + 100];
+    unsigned char buf[sizeof(msg)];
+    size_t i, readbytes, written, expected, tot;
     int testresult = 0;
-    time_t now = time(NULL);
-#define TIMEOUT 10
-
-    if (!TEST_ptr(ctx = SSL_CTX_new_ex(libctx, NULL, TLS_method()))
-        || !TEST_ptr(early = SSL_SESSION_new())
-        || !TEST_ptr(middle = SSL_SESSION_new())
-        || !TEST_ptr(late = SSL_SESSION_new()))
-        goto end;
 
-    /* assign unique session ids */
-    early->session_id_length = SSL3_SSL_SESSION_ID_LENGTH;
-    memset(early->session_id, 1, SSL3_SSL_SESSION_ID_LENGTH);
-    middle->session_id_length = SSL3_SSL_SESSION_ID_LENGTH;
-    memset(middle->session_id, 2, SSL3_SSL_SESSION_ID_LENGTH);
-    late->session_id_length = SSL3_SSL_SESSION_ID_LENGTH;
-    memset(late->session_id, 3, SSL3_SSL_SESSION_ID_LENGTH);
+    for (i = 0; i < sizeof(msg); i++)
+        msg[i] = (unsigned char)(i % 251);
 
-    if (!TEST_int_eq(SSL_CTX_add_session(ctx, early), 1)
-        || !TEST_int_eq(SSL_CTX_add_session(ctx, middle), 1)
-        || !TEST_int_eq(SSL_CTX_add_session(ctx, late), 1))
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), TLS1_3_VERSION,
+            TLS1_3_VERSION, &sctx, &cctx, cert,
+            privkey))
+        || !TEST_true(SSL_CTX_set_max_send_fragment(sctx, MULTI_RECORD_FRAGSIZE))
+        || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL)))
         goto end;
 
-    /* Make sure they are all added */
-    if (!TEST_ptr(early->prev)
-        || !TEST_ptr(middle->prev)
-        || !TEST_ptr(late->prev))
-        goto end;
+    switch (tst) {
+    case 0:
+        expected = 8 * MULTI_RECORD_FRAGSIZE;
+        break;
+    case 1:
+        if (!TEST_true(SSL_set_max_pipelines(serverssl, 2)))
+            goto end;
+        expected = 2 * MULTI_RECORD_FRAGSIZE;
+        break;
+    default:
+        if (!TEST_true(SSL_set_block_padding(serverssl, 64)))
+            goto end;
+        expected = MULTI_RECORD_FRAGSIZE;
+        break;
+    }
 
-    if (!TEST_time_t_ne(SSL_SESSION_set_time_ex(early, now - 10), 0)
-        || !TEST_time_t_ne(SSL_SESSION_set_time_ex(middle, now), 0)
-        || !TEST_time_t_ne(SSL_SESSION_set_time_ex(late, now + 10), 0))
+    if (!TEST_true(create_ssl_connection(serverssl, clientssl, SSL_ERROR_NONE)))
         goto end;
 
-    if (!TEST_int_ne(SSL_SESSION_set_timeout(early, TIMEOUT), 0)
-        || !TEST_int_ne(SSL_SESSION_set_timeout(middle, TIMEOUT), 0)
-        || !TEST_int_ne(SSL_SESSION_set_timeout(late, TIMEOUT), 0))
-        goto end;
+    SSL_set_mode(serverssl, SSL_MODE_ENABLE_PARTIAL_WRITE);
 
-    /* Make sure they are all still there */
-    if (!TEST_ptr(early->prev)
-        || !TEST_ptr(middle->prev)
-        || !TEST_ptr(late->prev))
+    if (!TEST_true(SSL_write_ex(serverssl, msg, sizeof(msg), &written))
+        || !TEST_size_t_eq(written, expected))
         goto end;
 
-    /* Make sure they are in the expected order */
-    if (!TEST_ptr_eq(late->next, middle)
-        || !TEST_ptr_eq(middle->next, early)
-        || !TEST_ptr_eq(early->prev, middle)
-        || !TEST_ptr_eq(middle->prev, late))
+    for (tot = written; tot < sizeof(msg); tot += written) {
+        if (!TEST_true(SSL_write_ex(serverssl, msg + tot, sizeof(msg) - tot,
+                &written)))
+            goto end;
+    }
+
+    for (tot = 0; tot < sizeof(msg); tot += readbytes) {
+        if (!TEST_true(SSL_read_ex(clientssl, buf + tot, sizeof(buf) - tot,
+                &readbytes))
+            || !TEST_size_t_le(readbytes, MULTI_RECORD_FRAGSIZE))
+            goto end;
+    }
+    if (!TEST_mem_eq(msg, sizeof(msg), buf, sizeof(buf)))
         goto end;
 
-    /* This should remove "early" */
+    testresult = 1;
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif /* OSSL_NO_USABLE_TLS1_3 */
+
+#define DYN_REC_SIZE 600
+#define DYN_REC_RAMP 3000
+
+/*
+ * Write a message of DYN_REC_RAMP * 3 bytes and check that the first
+ * nsmall records received have DYN_REC_SIZE bytes and the rest are larger.
+ */
+static int dyn_rec_write_and_check(SSL *serverssl, SSL *clientssl,
+    size_t nsmall)
+{
+    unsigned char msg[DYN_REC_RAMP * 3], buf[sizeof(msg)];
+    size_t i, written, readbytes, tot;
+
+    for (i = 0; i < sizeof(msg); i++)
+        msg[i] = (unsigned char)(i % 251);
+
+    if (!TEST_true(SSL_write_ex(serverssl, msg, sizeof(msg), &written))
+        || !TEST_size_t_eq(written, sizeof(msg)))
+        return 0;
+
+    for (i = 0, tot = 0; tot < sizeof(msg); i++, tot += readbytes) {
+        if (!TEST_true(SSL_read_ex(clientssl, buf + tot, sizeof(buf) - tot,
+                &readbytes)))
+            return 0;
+        if (i < nsmall) {
+            if (!TEST_size_t_eq(readbytes, DYN_REC_SIZE))
+                return 0;
+        } else if (!TEST_size_t_gt(readbytes, DYN_REC_SIZE)) {
+            return 0;
+        }
+    }
+
+    return TEST_mem_eq(msg, sizeof(msg), buf, tot);
+}
+
+/*
+ * Test dynamic record sizing
+ * Test 0: TLSv1.2, configured on the SSL_CTX
+ * Test 1: TLSv1.3, configured on the SSL
+ * Test 2: TLSv1.3, configured with SSL_CONF, small records again after idle
+ */
+static int test_dynamic_record_sizing(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    SSL_CONF_CTX *confctx = NULL;
+    int version = tst == 0 ? TLS1_2_VERSION : TLS1_3_VERSION;
+    size_t nsmall = DYN_REC_RAMP / DYN_REC_SIZE;
+    int testresult = 0;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return TEST_skip("TLSv1.2 is disabled");
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (tst > 0)
+        return TEST_skip("TLSv1.3 is disabled");
+#endif
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), version, version,
+            &sctx, &cctx, cert, privkey)))
+        goto end;
+
+    /* Out of range sizes are rejected */
+    if (!TEST_false(SSL_CTX_set_dynamic_record_sizing(sctx, 511, 0, 0))
+        || !TEST_false(SSL_CTX_set_dynamic_record_sizing(sctx,
+            SSL3_RT_MAX_PLAIN_LENGTH + 1, 0, 0)))
+        goto end;
+
+    if (tst == 0) {
+        if (!TEST_true(SSL_CTX_set_dynamic_record_sizing(sctx, DYN_REC_SIZE,
+                DYN_REC_RAMP, 0)))
+            goto end;
+    } else if (tst == 2) {
+        if (!TEST_ptr(confctx = SSL_CONF_CTX_new()))
+            goto end;
+        SSL_CONF_CTX_set_flags(confctx, SSL_CONF_FLAG_FILE | SSL_CONF_FLAG_SERVER);
+        SSL_CONF_CTX_set_ssl_ctx(confctx, sctx);
+        if (!TEST_int_eq(SSL_CONF_cmd(confctx, "DynamicRecordSizing",
+                             "600,3000,1,2"),
+                0)
+            || !TEST_int_eq(SSL_CONF_cmd(confctx, "DynamicRecordSizing",
+                                "600,3000,1"),
+                2))
+            goto end;
+    }
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL)))
+        goto end;
+
+    if (tst == 1
+        && !TEST_true(SSL_set_dynamic_record_sizing(serverssl, DYN_REC_SIZE,
+            DYN_REC_RAMP, 0)))
+        goto end;
+
+    /* Write one record at a time so that the records are easy to count */
+    if (!TEST_true(SSL_set_max_pipelines(serverssl, 1))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE)))
+        goto end;
+
+    if (!dyn_rec_write_and_check(serverssl, clientssl, nsmall))
+        goto end;
+
+    /*
+     * After the ramp all records are full size, unless the connection has
+     * been idle for longer than the configured timeout.
+     */
+    if (tst == 2)
+        OSSL_sleep(50);
+    else
+        nsmall = 0;
+    if (!dyn_rec_write_and_check(serverssl, clientssl, nsmall))
+        goto end;
+
+    testresult = 1;
+end:
+    SSL_CONF_CTX_free(confctx);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * Test that application data handled without kernel TLS is counted by
+ * SSL_get_ktls_stats()
+ */
+static int test_ktls_stats(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    unsigned char msg[1000], buf[sizeof(msg)];
+    uint64_t ktls_sent, sw_sent, ktls_received, sw_received;
+    size_t written, readbytes;
+    int testresult = 0;
+
+    memset(msg, 'A', sizeof(msg));
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), TLS1_VERSION, 0,
+            &sctx, &cctx, cert, privkey))
+        || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE)))
+        goto end;
+
+    /* Peeked data is only counted when it is read */
+    if (!TEST_true(SSL_write_ex(clientssl, msg, sizeof(msg), &written))
+        || !TEST_true(SSL_peek_ex(serverssl, buf, 10, &readbytes))
+        || !TEST_true(SSL_get_ktls_stats(serverssl, NULL, NULL, NULL,
+            &sw_received))
+        || !TEST_uint64_t_eq(sw_received, 0)
+        || !TEST_true(SSL_read_ex(serverssl, buf, sizeof(buf), &readbytes))
+        || !TEST_size_t_eq(readbytes, sizeof(msg))
+        || !TEST_true(SSL_write_ex(serverssl, msg, 100, &written))
+        || !TEST_true(SSL_read_ex(clientssl, buf, sizeof(buf), &readbytes)))
+        goto end;
+
+    if (!TEST_true(SSL_get_ktls_stats(clientssl, &ktls_sent, &sw_sent,
+            &ktls_received, &sw_received))
+        || !TEST_uint64_t_eq(ktls_sent, 0)
+        || !TEST_uint64_t_eq(sw_sent, sizeof(msg))
+        || !TEST_uint64_t_eq(ktls_received, 0)
+        || !TEST_uint64_t_eq(sw_received, 100)
+        || !TEST_true(SSL_get_ktls_stats(serverssl, &ktls_sent, &sw_sent,
+            &ktls_received, &sw_received))
+        || !TEST_uint64_t_eq(ktls_sent, 0)
+        || !TEST_uint64_t_eq(sw_sent, 100)
+        || !TEST_uint64_t_eq(ktls_received, 0)
+        || !TEST_uint64_t_eq(sw_received, sizeof(msg)))
+        goto end;
+
+    testresult = 1;
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+#if defined(OPENSSL_SYS_UNIX)
+#define RECVFILE_SZ 5000
+#define RECVFILE_OFF 100
+
+/*
+ * Test SSL_recvfile()
+ * Test 0: Data copied to a pipe
+ * Test 1: Data copied to a file at an offset
+ * Test 2: Data spliced from a KTLS socket to a file at an offset
+ */
+static int test_recvfile(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    unsigned char msg[RECVFILE_SZ], buf[RECVFILE_SZ];
+    int cfd = -1, sfd = -1, fd[2] = { -1, -1 }, dst;
+    off_t off = tst == 0 ? -1 : RECVFILE_OFF;
+    uint64_t ktls_received, sw_received;
+    size_t i, written, tot;
+    ossl_ssize_t ret;
+    int testresult = 0;
+
+    for (i = 0; i < sizeof(msg); i++)
+        msg[i] = (unsigned char)(i % 251);
+
+    if (tst == 2) {
+#if defined(OPENSSL_NO_SOCK) || defined(OPENSSL_NO_KTLS) \
+    || defined(OPENSSL_NO_KTLS_RX) || defined(OSSL_NO_USABLE_TLS1_3)
+        return TEST_skip("KTLS receive is not supported");
+#else
+        if (!TEST_true(create_test_sockets(&cfd, &sfd, SOCK_STREAM, NULL)))
+            goto end;
+        if (!ktls_chk_platform(cfd)) {
+            testresult = TEST_skip("Kernel does not support KTLS");
+            goto end;
+        }
+#endif
+    }
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), TLS1_VERSION, 0,
+            &sctx, &cctx, cert, privkey)))
+        goto end;
+
+    if (tst == 2) {
+        if (!TEST_true(create_ssl_objects2(sctx, cctx, &serverssl, &clientssl,
+                sfd, cfd))
+            || !TEST_true(SSL_set_options(clientssl, SSL_OP_ENABLE_KTLS)))
+            goto end;
+    } else if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                   &clientssl, NULL, NULL))) {
+        goto end;
+    }
+
+    if (!TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE)))
+        goto end;
+
+    if (tst == 2 && !BIO_get_ktls_recv(SSL_get_rbio(clientssl))) {
+        testresult = TEST_skip("Failed to enable KTLS for receiving");
+        goto end;
+    }
+
+    if (tst == 0) {
+        if (!TEST_int_eq(pipe(fd), 0))
+            goto end;
+        dst = fd[1];
+    } else {
+        fd[0] = open(tmpfilename, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (!TEST_int_ge(fd[0], 0))
+            goto end;
+        dst = fd[0];
+    }
+
+    if (!TEST_true(SSL_write_ex(serverssl, msg, sizeof(msg), &written))
+        || !TEST_size_t_eq(written, sizeof(msg)))
+        goto end;
+
+    for (tot = 0; tot < sizeof(msg); tot += ret) {
+        ret = SSL_recvfile(clientssl, dst, off < 0 ? -1 : off + (off_t)tot,
+            sizeof(msg) - tot, 0);
+        if (ret <= 0) {
+            if (!TEST_int_eq(SSL_get_error(clientssl, (int)ret),
+                    SSL_ERROR_WANT_READ))
+                goto end;
+            ret = 0;
+        }
+    }
+
+    if (tst == 0) {
+        for (tot = 0; tot < sizeof(buf); tot += ret)
+            if (!TEST_int_gt(ret = read(fd[0], buf + tot, sizeof(buf) - tot), 0))
+                goto end;
+    } else if (!TEST_int_eq(pread(fd[0], buf, sizeof(buf), RECVFILE_OFF),
+                   sizeof(buf))) {
+        goto end;
+    }
+    if (!TEST_mem_eq(msg, sizeof(msg), buf, sizeof(buf)))
+        goto end;
+
+    if (!TEST_true(SSL_get_ktls_stats(clientssl, NULL, NULL, &ktls_received,
+            &sw_received))
+        || !TEST_uint64_t_eq(tst == 2 ? ktls_received : sw_received,
+            sizeof(msg)))
+        goto end;
+
+    testresult = 1;
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+    if (cfd != -1)
+        close(cfd);
+    if (sfd != -1)
+        close(sfd);
+    if (fd[0] != -1)
+        close(fd[0]);
+    if (fd[1] != -1)
+        close(fd[1]);
+
+    return testresult;
+}
+#endif
+
+static int test_session_timeout(int test)
+{
+    /*
+     * Test session ordering and timeout
+     * Can't explicitly test performance of the new code,
+     * but can test to see if the ordering of the sessions
+     * are correct, and they are removed as expected
+     */
+    SSL_SESSION *early = NULL;
+    SSL_SESSION *middle = NULL;
+    SSL_SESSION *late = NULL;
+    SSL_CTX *ctx;
+    int testresult = 0;
+    time_t now = time(NULL);
+#define TIMEOUT 10
+
+    if (!TEST_ptr(ctx = SSL_CTX_new_ex(libctx, NULL, TLS_method()))
+        || !TEST_ptr(early = SSL_SESSION_new())
+        || !TEST_ptr(middle = SSL_SESSION_new())
+        || !TEST_ptr(late = SSL_SESSION_new()))
+        goto end;
+
+    /* assign unique session ids */
+    early->session_id_length = SSL3_SSL_SESSION_ID_LENGTH;
+    memset(early->session_id, 1, SSL3_SSL_SESSION_ID_LENGTH);
+    middle->session_id_length = SSL3_SSL_SESSION_ID_LENGTH;
+    memset(middle->session_id, 2, SSL3_SSL_SESSION_ID_LENGTH);
+    late->session_id_length = SSL3_SSL_SESSION_ID_LENGTH;
+    memset(late->session_id, 3, SSL3_SSL_SESSION_ID_LENGTH);
+
+    if (!TEST_int_eq(SSL_CTX_add_session(ctx, early), 1)
+        || !TEST_int_eq(SSL_CTX_add_session(ctx, middle), 1)
+        || !TEST_int_eq(SSL_CTX_add_session(ctx, late), 1))
+        goto end;
+
+    /* Make sure they are all added */
+    if (!TEST_ptr(early->prev)
+        || !TEST_ptr(middle->prev)
+        || !TEST_ptr(late->prev))
+        goto end;
+
+    if (!TEST_time_t_ne(SSL_SESSION_set_time_ex(early, now - 10), 0)
+        || !TEST_time_t_ne(SSL_SESSION_set_time_ex(middle, now), 0)
+        || !TEST_time_t_ne(SSL_SESSION_set_time_ex(late, now + 10), 0))
+        goto end;
+
+    if (!TEST_int_ne(SSL_SESSION_set_timeout(early, TIMEOUT), 0)
+        || !TEST_int_ne(SSL_SESSION_set_timeout(middle, TIMEOUT), 0)
+        || !TEST_int_ne(SSL_SESSION_set_timeout(late, TIMEOUT), 0))
+        goto end;
+
+    /* Make sure they are all still there */
+    if (!TEST_ptr(early->prev)
+        || !TEST_ptr(middle->prev)
+        || !TEST_ptr(late->prev))
+        goto end;
+
+    /* Make sure they are in the expected order */
+    if (!TEST_ptr_eq(late->next, middle)
+        || !TEST_ptr_eq(middle->next, early)
+        || !TEST_ptr_eq(early->prev, middle)
+        || !TEST_ptr_eq(middle->prev, late))
+        goto end;
+
+    /* This should remove "early" */
     SSL_CTX_flush_sessions_ex(ctx, now + TIMEOUT - 1);
     if (!TEST_ptr_null(early->prev)
         || !TEST_ptr(middle->prev)
@@ -10992,6 +11733,289 @@ end:
 }
 #endif /* !defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2) */
 
+#define SHARD_TEST_THREADS 4
+#define SHARD_TEST_SESSIONS 500
+
+static SSL_CTX *shard_ctx = NULL;
+static int shard_test_failed = 0;
+static int shard_test_remove = 0;
+
+/*
+ * Adds sessions to the cache of shard_ctx, checks they can be found and, if
+ * shard_test_remove is set, removes every other one again.
+ */
+static void shard_cache_worker(void)
+{
+    SSL *ssl = SSL_new(shard_ctx);
+    SSL_SESSION *sess;
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    int i;
+
+    if (ssl == NULL) {
+        shard_test_failed = 1;
+        return;
+    }
+
+    for (i = 0; i < SHARD_TEST_SESSIONS; i++) {
+        if ((sess = SSL_SESSION_new()) == NULL
+            || RAND_bytes_ex(libctx, id, sizeof(id), 0) <= 0
+            || !SSL_SESSION_set1_id(sess, id, sizeof(id))
+            || !SSL_SESSION_set_protocol_version(sess, SSL_version(ssl))
+            || !SSL_CTX_add_session(shard_ctx, sess)
+            || !SSL_has_matching_session_id(ssl, id, sizeof(id))
+            || (shard_test_remove && i % 2 == 0
+                && !SSL_CTX_remove_session(shard_ctx, sess)))
+            shard_test_failed = 1;
+        SSL_SESSION_free(sess);
+    }
+    SSL_free(ssl);
+}
+
+/*
+ * Test the internal session cache when split into shards: configuration,
+ * resumption, concurrent use from several threads, and the size limit.
+ */
+static int test_session_cache_shards(void)
+{
+    SSL_CTX *sctx = NULL, *cctx = NULL;
+    SSL *serverssl = NULL, *clientssl = NULL;
+    SSL_SESSION *sess = NULL;
+    thread_t threads[SHARD_TEST_THREADS];
+    size_t i;
+    int testresult = 0;
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), TLS1_VERSION, 0,
+            &sctx, &cctx, cert, privkey)))
+        goto end;
+
+    /* The number of shards is rounded up to a power of two. */
+    if (!TEST_long_eq(SSL_CTX_sess_get_cache_shards(sctx), 1)
+        || !TEST_ptr(SSL_CTX_sessions(sctx))
+        || !TEST_long_eq(SSL_CTX_sess_set_cache_shards(sctx, 5), 1)
+        || !TEST_long_eq(SSL_CTX_sess_get_cache_shards(sctx), 8)
+        || !TEST_long_eq(SSL_CTX_sess_set_cache_shards(sctx, 0), 0)
+        || !TEST_long_eq(SSL_CTX_sess_set_cache_shards(sctx, 257), 0)
+        || !TEST_long_eq(SSL_CTX_sess_get_cache_shards(sctx), 8)
+        || !TEST_ptr_null(SSL_CTX_sessions(sctx)))
+        goto end;
+
+    /* Sessions in a sharded cache can be resumed. */
+    if (!TEST_true(SSL_CTX_set_options(sctx, SSL_OP_NO_TICKET))
+        || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE))
+        || !TEST_ptr(sess = SSL_get1_session(clientssl))
+        || !TEST_long_gt(SSL_CTX_sess_number(sctx), 0))
+        goto end;
+
+    SSL_shutdown(clientssl);
+    SSL_shutdown(serverssl);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    serverssl = clientssl = NULL;
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL))
+        || !TEST_true(SSL_set_session(clientssl, sess))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE))
+        || !TEST_true(SSL_session_reused(clientssl)))
+        goto end;
+
+    /* The number of shards cannot be changed while the cache is in use. */
+    if (!TEST_long_eq(SSL_CTX_sess_set_cache_shards(sctx, 2), 0))
+        goto end;
+
+    SSL_CTX_flush_sessions_ex(sctx, 0);
+    if (!TEST_long_eq(SSL_CTX_sess_number(sctx), 0))
+        goto end;
+
+    /* Concurrent use from several threads. */
+    shard_ctx = sctx;
+    shard_test_failed = 0;
+    shard_test_remove = 1;
+    SSL_CTX_sess_set_cache_size(sctx, 0);
+    for (i = 0; i < OSSL_NELEM(threads); i++)
+        if (!TEST_true(run_thread(&threads[i], shard_cache_worker)))
+            goto end;
+    for (i = 0; i < OSSL_NELEM(threads); i++)
+        if (!TEST_true(wait_for_thread(threads[i])))
+            goto end;
+    if (!TEST_false(shard_test_failed)
+        || !TEST_long_eq(SSL_CTX_sess_number(sctx),
+            SHARD_TEST_THREADS * SHARD_TEST_SESSIONS / 2))
+        goto end;
+
+    /* The size limit is shared out between the shards. */
+    SSL_CTX_flush_sessions_ex(sctx, 0);
+    SSL_CTX_sess_set_cache_size(sctx, 64);
+    shard_test_remove = 0;
+    shard_cache_worker();
+    if (!TEST_false(shard_test_failed)
+        || !TEST_long_le(SSL_CTX_sess_number(sctx), 64)
+        || !TEST_long_ge(SSL_CTX_sess_number(sctx), 32))
+        goto end;
+
+    testresult = 1;
+
+end:
+    shard_ctx = NULL;
+    SSL_SESSION_free(sess);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * Makes a connection, resuming |in| if it is not NULL. Returns the session of
+ * the client in |*out| if |out| is not NULL.
+ */
+static int shm_cache_connect(SSL_CTX *sctx, SSL_CTX *cctx, SSL_SESSION *in,
+    SSL_SESSION **out, int *reused)
+{
+    SSL *serverssl = NULL, *clientssl = NULL;
+    int ret = 0;
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+            NULL, NULL))
+        || (in != NULL && !TEST_true(SSL_set_session(clientssl, in)))
+        || !TEST_true(create_ssl_connection(serverssl, clientssl,
+            SSL_ERROR_NONE))
+        || (out != NULL && !TEST_ptr(*out = SSL_get1_session(clientssl))))
+        goto end;
+    *reused = SSL_session_reused(clientssl);
+    SSL_shutdown(clientssl);
+    SSL_shutdown(serverssl);
+    ret = 1;
+
+end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    return ret;
+}
+
+/*
+ * Test the shared memory session cache. The internal cache is disabled, so
+ * that sessions can only be resumed through the shared one.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3 with stateful tickets
+ */
+static int test_shared_session_cache(int tst)
+{
+    SSL_CTX *sctx = NULL, *cctx = NULL;
+    SSL_SESSION *sess = NULL;
+    int reused = 0, testresult = 0;
+#if defined(OPENSSL_SYS_UNIX)
+    int fd[2], status;
+    pid_t pid;
+    unsigned char der[4096];
+    const unsigned char *p = der;
+    ssize_t der_len;
+#endif
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return 1;
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (tst == 1)
+        return 1;
+#endif
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+            TLS_client_method(), TLS1_VERSION,
+            tst == 0 ? TLS1_2_VERSION : TLS1_3_VERSION,
+            &sctx, &cctx, cert, privkey)))
+        goto end;
+
+    SSL_CTX_set_options(sctx, SSL_OP_NO_TICKET);
+    SSL_CTX_set_session_cache_mode(sctx,
+        SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+    if (!SSL_CTX_set_shared_session_cache(sctx, 64, 0)) {
+        /* Not supported on this platform */
+        testresult = 1;
+        goto end;
+    }
+
+    /* Sessions can be resumed through the shared cache alone. */
+    if (!TEST_true(shm_cache_connect(sctx, cctx, NULL, &sess, &reused))
+        || !TEST_false(reused)
+        || !TEST_long_eq(SSL_CTX_sess_number(sctx), 0)
+        || !TEST_true(shm_cache_connect(sctx, cctx, sess, NULL, &reused))
+        || !TEST_true(reused)
+        || !TEST_long_eq(SSL_CTX_sess_cb_hits(sctx), 1))
+        goto end;
+
+    /* Removed sessions cannot be resumed anymore. */
+    if (!TEST_false(SSL_CTX_remove_session(sctx, sess))
+        || !TEST_true(shm_cache_connect(sctx, cctx, sess, NULL, &reused))
+        || !TEST_false(reused))
+        goto end;
+    SSL_SESSION_free(sess);
+    sess = NULL;
+
+#if defined(OPENSSL_SYS_UNIX)
+    /*
+     * A session created in a child process can be resumed in the parent. The
+     * child passes the session of its client back through a pipe.
+     */
+    if (!TEST_int_ge(pipe(fd), 0))
+        goto end;
+    if (!TEST_int_ge(pid = fork(), 0)) {
+        close(fd[0]);
+        close(fd[1]);
+        goto end;
+    }
+    if (pid == 0) {
+        unsigned char *q = der;
+        int len, ok;
+
+        close(fd[0]);
+        ok = shm_cache_connect(sctx, cctx, NULL, &sess, &reused)
+            && (len = i2d_SSL_SESSION(sess, NULL)) > 0
+            && len <= (int)sizeof(der)
+            && i2d_SSL_SESSION(sess, &q) == len
+            && write(fd[1], der, len) == len;
+        close(fd[1]);
+        _exit(ok ? 0 : 1);
+    }
+    close(fd[1]);
+    der_len = read(fd[0], der, sizeof(der));
+    close(fd[0]);
+    if (!TEST_int_eq(waitpid(pid, &status, 0), pid)
+        || !TEST_int_eq(status, 0)
+        || !TEST_int_gt((int)der_len, 0)
+        || !TEST_ptr(sess = d2i_SSL_SESSION_ex(NULL, &p, (long)der_len,
+                         libctx, NULL))
+        || !TEST_true(shm_cache_connect(sctx, cctx, sess, NULL, &reused))
+        || !TEST_true(reused)
+        || !TEST_long_eq(SSL_CTX_sess_cb_hits(sctx), 2))
+        goto end;
+#endif
+
+    /* Disabling the shared cache stops resumption. */
+    if (!TEST_true(SSL_CTX_set_shared_session_cache(sctx, 0, 0)))
+        goto end;
+    if (sess != NULL
+        && (!TEST_true(shm_cache_connect(sctx, cctx, sess, NULL, &reused))
+            || !TEST_false(reused)))
+        goto end;
+
+    testresult = 1;
+
+end:
+    SSL_SESSION_free(sess);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 /*
  * Test 0: Client sets servername and server acknowledges it (TLSv1.2)
  * Test 1: Client sets servername and server does not acknowledge it (TLSv1.2)
@@ -13627,6 +14651,13 @@ static int test_data_retry(void)
     if (!TEST_true(SSL_set_max_send_fragment(clientssl, 512)))
         goto end;
 
+    /*
+     * This test counts on each record being written separately, so don't let
+     * full records be written together
+     */
+    if (!TEST_true(SSL_set_max_pipelines(clientssl, 1)))
+        goto end;
+
     tmp = SSL_get_wbio(clientssl);
     if (!TEST_ptr(tmp))
         goto end;
@@ -15727,6 +16758,8 @@ int setup_tests(void)
     ADD_ALL_TESTS(test_info_callback, 6);
 #endif
     ADD_ALL_TESTS(test_ssl_pending, 2);
+    ADD_ALL_TESTS(test_writev_readv, 4);
+    ADD_ALL_TESTS(test_read_ref, 2);
     ADD_ALL_TESTS(test_ssl_get_shared_ciphers, OSSL_NELEM(shared_ciphers_data));
     ADD_ALL_TESTS(test_ticket_callbacks, 20);
     ADD_TEST(test_ticket_abort_session_leak);
@@ -15736,9 +16769,18 @@ int setup_tests(void)
     ADD_ALL_TESTS(test_incorrect_shutdown, 2);
     ADD_ALL_TESTS(test_cert_cb, 6);
     ADD_ALL_TESTS(test_client_cert_cb, 2);
+    ADD_ALL_TESTS(test_private_key_cb, 5);
     ADD_ALL_TESTS(test_ca_names, 3);
 #ifndef OPENSSL_NO_TLS1_2
     ADD_ALL_TESTS(test_multiblock_write, OSSL_NELEM(multiblock_cipherlist_data));
+#endif
+#ifndef OSSL_NO_USABLE_TLS1_3
+    ADD_ALL_TESTS(test_tls13_multi_record_write, 3);
+#endif
+    ADD_ALL_TESTS(test_dynamic_record_sizing, 3);
+    ADD_TEST(test_ktls_stats);
+#if defined(OPENSSL_SYS_UNIX)
+    ADD_ALL_TESTS(test_recvfile, 3);
 #endif
     ADD_ALL_TESTS(test_servername, 10);
     ADD_TEST(test_unknown_sigalgs_groups);
@@ -15779,6 +16821,8 @@ int setup_tests(void)
 #if !defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2)
     ADD_ALL_TESTS(test_session_cache_overflow, 4);
 #endif
+    ADD_TEST(test_session_cache_shards);
+    ADD_ALL_TESTS(test_shared_session_cache, 2);
     ADD_TEST(test_load_dhfile);
 #ifndef OSSL_NO_USABLE_TLS1_3
     ADD_TEST(test_read_ahead_key_change);
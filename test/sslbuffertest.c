@@ -1,5 +1,5 @@
 /*
- * Copyright 2016-2025 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2016-2026 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -260,6 +260,78 @@ end:
     return result;
 }
 
+/*
+ * Test that buffers released by one connection are reused by another one when
+ * the SSL_CTX has a buffer pool.
+ */
+static int test_buffer_pool(void)
+{
+    int result = 0;
+    SSL *serverssl1 = NULL, *clientssl1 = NULL;
+    SSL *serverssl2 = NULL, *clientssl2 = NULL;
+    SSL_CONNECTION *sc1, *sc2;
+    const unsigned char *rbuf, *wbuf, *newrbuf, *newwbuf;
+    const char testdata[] = "Test data";
+    char buf[sizeof(testdata)];
+    size_t written, readbytes;
+
+    if (!TEST_true(SSL_CTX_set_buffer_pool(serverctx, 100))
+        || !TEST_true(create_ssl_objects(serverctx, clientctx, &serverssl1,
+            &clientssl1, NULL, NULL))
+        || !TEST_true(create_ssl_objects(serverctx, clientctx, &serverssl2,
+            &clientssl2, NULL, NULL))
+        || !TEST_true(SSL_set_mode(serverssl1, SSL_MODE_RELEASE_BUFFERS))
+        || !TEST_true(create_ssl_connection(serverssl1, clientssl1,
+            SSL_ERROR_NONE))
+        || !TEST_true(create_ssl_connection(serverssl2, clientssl2,
+            SSL_ERROR_NONE))
+        || !TEST_ptr(sc1 = SSL_CONNECTION_FROM_SSL(serverssl1))
+        || !TEST_ptr(sc2 = SSL_CONNECTION_FROM_SSL(serverssl2))
+        || !TEST_true(SSL_alloc_buffers(serverssl1))
+        || !TEST_true(SSL_alloc_buffers(serverssl2))
+        || !TEST_true(checkbuffers(serverssl1, 1)))
+        goto end;
+
+    rbuf = sc1->rlayer.rrl->rbuf.buf;
+    wbuf = sc1->rlayer.wrl->wbuf[0].buf;
+
+    /* The buffers of the first connection are the last ones in the pool */
+    if (!TEST_true(SSL_free_buffers(serverssl2))
+        || !TEST_true(SSL_free_buffers(serverssl1))
+        || !TEST_true(checkbuffers(serverssl1, 0))
+        || !TEST_true(SSL_alloc_buffers(serverssl2))
+        || !TEST_true(checkbuffers(serverssl2, 1)))
+        goto end;
+
+    newrbuf = sc2->rlayer.rrl->rbuf.buf;
+    newwbuf = sc2->rlayer.wrl->wbuf[0].buf;
+    if (!TEST_true((newrbuf == rbuf && newwbuf == wbuf)
+            || (newrbuf == wbuf && newwbuf == rbuf)))
+        goto end;
+
+    /* With SSL_MODE_RELEASE_BUFFERS the buffers are only held while in use */
+    if (!TEST_true(SSL_write_ex(clientssl1, testdata, sizeof(testdata),
+            &written))
+        || !TEST_true(SSL_read_ex(serverssl1, buf, sizeof(buf), &readbytes))
+        || !TEST_mem_eq(buf, readbytes, testdata, sizeof(testdata))
+        || !TEST_true(SSL_write_ex(serverssl1, testdata, sizeof(testdata),
+            &written))
+        || !TEST_true(SSL_read_ex(clientssl1, buf, sizeof(buf), &readbytes))
+        || !TEST_mem_eq(buf, readbytes, testdata, sizeof(testdata))
+        || !TEST_true(checkbuffers(serverssl1, 0)))
+        goto end;
+
+    result = 1;
+end:
+    SSL_free(clientssl1);
+    SSL_free(serverssl1);
+    SSL_free(clientssl2);
+    SSL_free(serverssl2);
+    if (!TEST_true(SSL_CTX_set_buffer_pool(serverctx, 0)))
+        result = 0;
+    return result;
+}
+
 OPT_TEST_DECLARE_USAGE("certfile privkeyfile\n")
 
 int setup_tests(void)
@@ -284,6 +356,7 @@ int setup_tests(void)
 
     ADD_ALL_TESTS(test_func, 9);
     ADD_ALL_TESTS(test_free_buffers, 4);
+    ADD_TEST(test_buffer_pool);
     return 1;
 }
 
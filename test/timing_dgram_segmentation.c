@@ -0,0 +1,226 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Loopback benchmark for BIO_s_datagram() UDP segmentation offload and receive
+ * coalescing. Sends a stream of equally sized datagrams between two loopback
+ * sockets using BIO_sendmmsg()/BIO_recvmmsg(), first with both features
+ * disabled and then with both enabled, and reports datagrams per second and
+ * the number of BIO calls made on each side.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include "internal/e_os.h"
+#include "internal/sockets.h"
+#include "internal/time.h"
+
+#if !defined(OPENSSL_NO_DGRAM) && !defined(OPENSSL_NO_SOCK) \
+    && defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+
+#define BATCH 64
+
+static char *prog;
+
+struct bench_result {
+    size_t sent, received, send_calls, recv_calls;
+    OSSL_TIME elapsed;
+};
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: %s [flags]\n", prog);
+    fprintf(stderr, "  -c #  Number of datagrams to send (default 200000)\n");
+    fprintf(stderr, "  -s #  Datagram payload size (default 1200)\n");
+    exit(EXIT_FAILURE);
+}
+
+static int make_pair(BIO **tx, BIO **rx, BIO_ADDR *rx_addr)
+{
+    BIO_ADDR *tx_addr = BIO_ADDR_new();
+    struct in_addr ina;
+    union BIO_sock_info_u info;
+    int fd1, fd2, ok = 0;
+
+    ina.s_addr = htonl(0x7f000001UL);
+    fd1 = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0);
+    fd2 = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0);
+    if (tx_addr == NULL || fd1 < 0 || fd2 < 0
+        || !BIO_ADDR_rawmake(tx_addr, AF_INET, &ina, sizeof(ina), 0)
+        || !BIO_ADDR_rawmake(rx_addr, AF_INET, &ina, sizeof(ina), 0)
+        || !BIO_bind(fd1, tx_addr, 0) || !BIO_bind(fd2, rx_addr, 0))
+        goto err;
+
+    info.addr = rx_addr;
+    if (!BIO_sock_info(fd2, BIO_SOCK_INFO_ADDRESS, &info))
+        goto err;
+
+    if ((*tx = BIO_new_dgram(fd1, BIO_CLOSE)) == NULL)
+        goto err;
+    fd1 = -1;
+    if ((*rx = BIO_new_dgram(fd2, BIO_CLOSE)) == NULL)
+        goto err;
+    fd2 = -1;
+
+    /* Never block forever if a datagram is dropped. */
+    BIO_set_nbio(*rx, 1);
+    ok = 1;
+err:
+    if (fd1 >= 0)
+        BIO_closesocket(fd1);
+    if (fd2 >= 0)
+        BIO_closesocket(fd2);
+    BIO_ADDR_free(tx_addr);
+    return ok;
+}
+
+static int run(int offload, size_t count, size_t size,
+    struct bench_result *res)
+{
+    BIO *tx = NULL, *rx = NULL;
+    BIO_ADDR *rx_addr = BIO_ADDR_new();
+    BIO_MSG msg[BATCH];
+    unsigned char *txbuf = NULL, *rxbuf = NULL;
+    size_t i, n, want, done;
+    OSSL_TIME start;
+    int ok = 0;
+
+    memset(res, 0, sizeof(*res));
+    if (rx_addr == NULL || !make_pair(&tx, &rx, rx_addr))
+        goto err;
+
+    if (offload
+        && (!BIO_dgram_set_tx_segmentation(tx, 1)
+            || !BIO_dgram_set_rx_coalescing(rx, 1))) {
+        fprintf(stderr, "%s: segmentation offload not supported\n", prog);
+        goto err;
+    }
+
+    txbuf = OPENSSL_zalloc(size);
+    rxbuf = OPENSSL_malloc(BATCH * size);
+    if (txbuf == NULL || rxbuf == NULL)
+        goto err;
+
+    start = ossl_time_now();
+    while (res->sent < count) {
+        want = count - res->sent < BATCH ? count - res->sent : BATCH;
+
+        for (i = 0; i < want; ++i) {
+            msg[i].data = txbuf;
+            msg[i].data_len = size;
+            msg[i].peer = rx_addr;
+            msg[i].local = NULL;
+            msg[i].flags = 0;
+        }
+
+        for (done = 0; done < want; done += n) {
+            ++res->send_calls;
+            if (!BIO_sendmmsg(tx, msg + done, sizeof(BIO_MSG), want - done,
+                    0, &n))
+                goto err;
+        }
+        res->sent += want;
+
+        /* Loopback delivery is synchronous; drain what was just sent. */
+        for (done = 0; done < want; done += n) {
+            for (i = 0; i < want - done; ++i) {
+                msg[i].data = rxbuf + i * size;
+                msg[i].data_len = size;
+                msg[i].peer = NULL;
+                msg[i].local = NULL;
+                msg[i].flags = 0;
+            }
+
+            ++res->recv_calls;
+            ERR_set_mark();
+            if (!BIO_recvmmsg(rx, msg, sizeof(BIO_MSG), want - done, 0, &n)) {
+                /* Dropped by the kernel; do not wait for it. */
+                ERR_pop_to_mark();
+                break;
+            }
+            ERR_clear_last_mark();
+            res->received += n;
+        }
+    }
+    res->elapsed = ossl_time_subtract(ossl_time_now(), start);
+    ok = 1;
+err:
+    if (!ok)
+        ERR_print_errors_fp(stderr);
+    OPENSSL_free(txbuf);
+    OPENSSL_free(rxbuf);
+    BIO_free(tx);
+    BIO_free(rx);
+    BIO_ADDR_free(rx_addr);
+    return ok;
+}
+
+static void report(const char *name, const struct bench_result *res)
+{
+    uint64_t us = ossl_time2us(res->elapsed);
+
+    if (us == 0)
+        us = 1;
+    printf("%-10s %10zu sent %10zu received %12.0f dgram/s"
+           " %8zu send calls %8zu recv calls\n",
+        name, res->sent, res->received,
+        (double)res->received * 1000000.0 / (double)us,
+        res->send_calls, res->recv_calls);
+}
+
+int main(int argc, char **argv)
+{
+    struct bench_result plain, offload;
+    size_t count = 200000, size = 1200;
+    unsigned long ul;
+    int i;
+
+    prog = argv[0];
+    while ((i = getopt(argc, argv, "c:s:")) != EOF) {
+        switch (i) {
+        case 'c':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul) || ul == 0)
+                usage();
+            count = ul;
+            break;
+        case 's':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul) || ul == 0
+                || ul > 65507)
+                usage();
+            size = ul;
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+
+    if (!run(0, count, size, &plain))
+        return EXIT_FAILURE;
+    report("plain", &plain);
+
+    if (!run(1, count, size, &offload))
+        return EXIT_FAILURE;
+    report("offload", &offload);
+
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+    fprintf(stderr, "%s: not supported on this platform\n", argv[0]);
+    return EXIT_SUCCESS;
+}
+
+#endif
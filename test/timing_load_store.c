@@ -0,0 +1,263 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Startup benchmark for the X509_STORE lookup methods. Takes a PEM bundle of
+ * CA certificates, writes it out as a hashed directory and as a certificate
+ * index, and then repeatedly creates a store with X509_LOOKUP_file(),
+ * X509_LOOKUP_hash_dir() and X509_LOOKUP_index(), looks up a number of
+ * subjects in it, and frees it again. This is what every worker process of
+ * a server does on startup. Reports the average time per store.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <openssl/x509_vfy.h>
+#include <openssl/err.h>
+#include "internal/e_os.h"
+#include "internal/time.h"
+
+#if defined(OPENSSL_SYS_UNIX) && defined(_POSIX_VERSION) \
+    && _POSIX_VERSION >= 200809L
+
+static char *prog;
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: %s [flags] bundle.pem\n", prog);
+    fprintf(stderr, "  -n #  Number of stores to create (default 100)\n");
+    fprintf(stderr, "  -l #  Subjects to look up in each store (default 1)\n");
+    exit(EXIT_FAILURE);
+}
+
+static STACK_OF(X509) *load_bundle(const char *file)
+{
+    STACK_OF(X509) *certs = sk_X509_new_null();
+    BIO *in = BIO_new_file(file, "r");
+    X509 *x;
+
+    if (certs == NULL || in == NULL)
+        goto err;
+    while ((x = PEM_read_bio_X509(in, NULL, NULL, NULL)) != NULL) {
+        if (!sk_X509_push(certs, x)) {
+            X509_free(x);
+            goto err;
+        }
+    }
+    ERR_clear_error();
+    BIO_free(in);
+    if (sk_X509_num(certs) == 0) {
+        fprintf(stderr, "%s: no certificates in %s\n", prog, file);
+        sk_X509_free(certs);
+        return NULL;
+    }
+    return certs;
+
+err:
+    ERR_print_errors_fp(stderr);
+    BIO_free(in);
+    OSSL_STACK_OF_X509_free(certs);
+    return NULL;
+}
+
+/* Writes each certificate to |dir| under the name X509_LOOKUP_hash_dir uses */
+static int write_hash_dir(const char *dir, STACK_OF(X509) *certs,
+    char ***names)
+{
+    int i, j, n = sk_X509_num(certs);
+    char path[1024];
+
+    if ((*names = OPENSSL_zalloc(sizeof(**names) * (n + 1))) == NULL)
+        return 0;
+    for (i = 0; i < n; i++) {
+        X509 *x = sk_X509_value(certs, i);
+        unsigned long h = X509_subject_name_hash(x);
+        BIO *out;
+
+        for (j = 0;; j++) {
+            BIO_snprintf(path, sizeof(path), "%s/%08lx.%d", dir, h, j);
+            if (access(path, F_OK) != 0)
+                break;
+        }
+        if ((out = BIO_new_file(path, "w")) == NULL
+            || !PEM_write_bio_X509(out, x)) {
+            BIO_free(out);
+            return 0;
+        }
+        BIO_free(out);
+        if (((*names)[i] = OPENSSL_strdup(path)) == NULL)
+            return 0;
+    }
+    return 1;
+}
+
+static int write_index(const char *file, STACK_OF(X509) *certs)
+{
+    BIO *out = BIO_new_file(file, "wb");
+    int ok = out != NULL && X509_write_cert_index(out, certs);
+
+    BIO_free(out);
+    return ok;
+}
+
+enum method {
+    M_FILE,
+    M_DIR,
+    M_INDEX
+};
+
+static X509_STORE *make_store(enum method m, const char *arg)
+{
+    X509_STORE *store = X509_STORE_new();
+    X509_LOOKUP *lu;
+    int ok = 0;
+
+    if (store == NULL)
+        return NULL;
+    switch (m) {
+    case M_FILE:
+        ok = (lu = X509_STORE_add_lookup(store, X509_LOOKUP_file())) != NULL
+            && X509_LOOKUP_load_file(lu, arg, X509_FILETYPE_PEM) > 0;
+        break;
+    case M_DIR:
+        ok = (lu = X509_STORE_add_lookup(store, X509_LOOKUP_hash_dir())) != NULL
+            && X509_LOOKUP_add_dir(lu, arg, X509_FILETYPE_PEM);
+        break;
+    case M_INDEX:
+        ok = (lu = X509_STORE_add_lookup(store, X509_LOOKUP_index())) != NULL
+            && X509_LOOKUP_load_index(lu, arg);
+        break;
+    }
+    if (!ok) {
+        X509_STORE_free(store);
+        return NULL;
+    }
+    return store;
+}
+
+static int run(const char *name, enum method m, const char *arg,
+    STACK_OF(X509) *certs, size_t stores, size_t lookups)
+{
+    X509_STORE_CTX *ctx = X509_STORE_CTX_new();
+    OSSL_TIME start, elapsed;
+    size_t i, j, found = 0;
+    uint64_t us;
+
+    if (ctx == NULL)
+        return 0;
+    start = ossl_time_now();
+    for (i = 0; i < stores; i++) {
+        X509_STORE *store = make_store(m, arg);
+
+        if (store == NULL || !X509_STORE_CTX_init(ctx, store, NULL, NULL)) {
+            ERR_print_errors_fp(stderr);
+            X509_STORE_free(store);
+            X509_STORE_CTX_free(ctx);
+            return 0;
+        }
+        for (j = 0; j < lookups; j++) {
+            X509 *x = sk_X509_value(certs, (int)(j % sk_X509_num(certs)));
+            X509_OBJECT *obj;
+
+            obj = X509_STORE_CTX_get_obj_by_subject(ctx, X509_LU_X509,
+                X509_get_subject_name(x));
+            if (obj != NULL)
+                found++;
+            X509_OBJECT_free(obj);
+        }
+        X509_STORE_CTX_cleanup(ctx);
+        X509_STORE_free(store);
+    }
+    elapsed = ossl_time_subtract(ossl_time_now(), start);
+    X509_STORE_CTX_free(ctx);
+
+    us = ossl_time2us(elapsed);
+    printf("%-6s %10.1f us/store %8zu of %zu lookups found\n", name,
+        (double)us / (double)stores, found, stores * lookups);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    STACK_OF(X509) *certs = NULL;
+    char dir[] = "timing_load_store.XXXXXX";
+    char index_f[sizeof(dir) + 16] = "";
+    char **names = NULL;
+    size_t stores = 100, lookups = 1;
+    unsigned long ul;
+    int i, ret = EXIT_FAILURE;
+
+    prog = argv[0];
+    while ((i = getopt(argc, argv, "n:l:")) != EOF) {
+        switch (i) {
+        case 'n':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul) || ul == 0)
+                usage();
+            stores = ul;
+            break;
+        case 'l':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul))
+                usage();
+            lookups = ul;
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+    if (optind != argc - 1)
+        usage();
+
+    if ((certs = load_bundle(argv[optind])) == NULL)
+        return EXIT_FAILURE;
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        goto end;
+    }
+    BIO_snprintf(index_f, sizeof(index_f), "%s/ca.idx", dir);
+    if (!write_hash_dir(dir, certs, &names) || !write_index(index_f, certs)) {
+        ERR_print_errors_fp(stderr);
+        goto end;
+    }
+
+    printf("%d certificates, %zu stores, %zu lookups per store\n",
+        sk_X509_num(certs), stores, lookups);
+    if (run("file", M_FILE, argv[optind], certs, stores, lookups)
+        && run("dir", M_DIR, dir, certs, stores, lookups)
+        && run("index", M_INDEX, index_f, certs, stores, lookups))
+        ret = EXIT_SUCCESS;
+
+end:
+    if (names != NULL) {
+        for (i = 0; names[i] != NULL; i++) {
+            remove(names[i]);
+            OPENSSL_free(names[i]);
+        }
+        OPENSSL_free(names);
+    }
+    if (index_f[0] != '\0') {
+        remove(index_f);
+        rmdir(dir);
+    }
+    OSSL_STACK_OF_X509_free(certs);
+    return ret;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+    fprintf(stderr, "%s: not supported on this platform\n", argv[0]);
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2026 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Scaling benchmark for SSL_poll(). Creates N QUIC client connections, each
+ * with its own UDP socket and QUIC domain, which try to connect to a loopback
+ * socket nobody reads from, and measures how long an SSL_poll() call over all
+ * of them takes beyond its timeout when nothing becomes ready. This is repeated
+ * for N = 10, 100, 1000 and 10000, with the default poll(2) based backend and
+ * with SSL_DOMAIN_FLAG_EPOLL.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/ssl.h>
+#include <openssl/quic.h>
+#include <openssl/err.h>
+#include "internal/e_os.h"
+#include "internal/sockets.h"
+#include "internal/time.h"
+
+#if !defined(OPENSSL_NO_QUIC) && !defined(OPENSSL_NO_SOCK) \
+    && defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+#include <sys/resource.h>
+
+/* Descriptors per connection: UDP socket, notifier pair, epoll instance. */
+#define FDS_PER_CONN 4
+#define FDS_RESERVED 64
+
+static char *prog;
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: %s [flags]\n", prog);
+    fprintf(stderr, "  -n #  Largest number of objects (default 10000)\n");
+    fprintf(stderr, "  -t #  SSL_poll() timeout in microseconds (default 1000)\n");
+    fprintf(stderr, "  -T #  Time to spend on each measurement in ms (default 1000)\n");
+    exit(EXIT_FAILURE);
+}
+
+static size_t max_conns_for_fd_limit(void)
+{
+    struct rlimit rl;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0)
+        return 0;
+
+    /* Use as many descriptors as we are allowed to. */
+    if (rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &rl) != 0)
+            (void)getrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    if (rl.rlim_cur == RLIM_INFINITY)
+        return (size_t)-1;
+    if (rl.rlim_cur <= FDS_RESERVED)
+        return 0;
+
+    return (size_t)(rl.rlim_cur - FDS_RESERVED) / FDS_PER_CONN;
+}
+
+static int make_sink(BIO_ADDR *addr)
+{
+    struct in_addr ina;
+    union BIO_sock_info_u info;
+    int fd;
+
+    ina.s_addr = htonl(0x7f000001UL);
+    if (!BIO_ADDR_rawmake(addr, AF_INET, &ina, sizeof(ina), 0))
+        return -1;
+
+    if ((fd = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0)) < 0)
+        return -1;
+
+    info.addr = addr;
+    if (!BIO_bind(fd, addr, 0)
+        || !BIO_sock_info(fd, BIO_SOCK_INFO_ADDRESS, &info)) {
+        BIO_closesocket(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static SSL *new_conn(SSL_CTX *ctx, const BIO_ADDR *peer)
+{
+    static const unsigned char alpn[] = { 5, 'b', 'e', 'n', 'c', 'h' };
+    SSL *ssl;
+    int fd;
+
+    if ((ssl = SSL_new(ctx)) == NULL)
+        return NULL;
+
+    if ((fd = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP,
+             BIO_SOCK_NONBLOCK))
+        < 0)
+        goto err;
+
+    if (!SSL_set_fd(ssl, fd)) {
+        BIO_closesocket(fd);
+        goto err;
+    }
+    (void)BIO_set_close(SSL_get_rbio(ssl), BIO_CLOSE);
+
+    if (!SSL_set_blocking_mode(ssl, 0)
+        || !SSL_set1_initial_peer_addr(ssl, peer)
+        || SSL_set_alpn_protos(ssl, alpn, sizeof(alpn)) != 0)
+        goto err;
+
+    /*
+     * Send the first Initial packet so that every connection has state. This
+     * cannot complete as nobody answers.
+     */
+    if (SSL_connect(ssl) == 1)
+        goto err;
+    return ssl;
+
+err:
+    SSL_free(ssl);
+    return NULL;
+}
+
+/*
+ * Returns the average time an SSL_poll() call over num objects takes beyond
+ * timeout_us, in microseconds, or a negative value on error.
+ */
+static double run(int use_epoll, size_t num, uint64_t timeout_us,
+    uint64_t budget_ms, const BIO_ADDR *peer)
+{
+    SSL_CTX *ctx = NULL;
+    SSL **conns = NULL;
+    SSL_POLL_ITEM *items = NULL;
+    struct timeval tv;
+    size_t i, calls = 0, result_count;
+    uint64_t flags = SSL_DOMAIN_FLAG_MULTI_THREAD | SSL_DOMAIN_FLAG_BLOCKING;
+    OSSL_TIME start, elapsed, budget = ossl_ms2time(budget_ms);
+    double ret = -1;
+
+    if (use_epoll)
+        flags |= SSL_DOMAIN_FLAG_EPOLL;
+
+    if ((ctx = SSL_CTX_new(OSSL_QUIC_client_method())) == NULL
+        || !SSL_CTX_set_domain_flags(ctx, flags))
+        goto err;
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
+
+    conns = OPENSSL_zalloc(num * sizeof(*conns));
+    items = OPENSSL_zalloc(num * sizeof(*items));
+    if (conns == NULL || items == NULL)
+        goto err;
+
+    for (i = 0; i < num; ++i) {
+        if ((conns[i] = new_conn(ctx, peer)) == NULL)
+            goto err;
+
+        items[i].desc = SSL_as_poll_descriptor(conns[i]);
+        items[i].events = SSL_POLL_EVENT_EC;
+    }
+
+    start = ossl_time_now();
+    do {
+        tv.tv_sec = (long)(timeout_us / 1000000);
+        tv.tv_usec = (long)(timeout_us % 1000000);
+        if (!SSL_poll(items, num, sizeof(*items), &tv, 0, &result_count))
+            goto err;
+        ++calls;
+        elapsed = ossl_time_subtract(ossl_time_now(), start);
+    } while (ossl_time_compare(elapsed, budget) < 0);
+
+    ret = (double)ossl_time2us(elapsed) / (double)calls - (double)timeout_us;
+    if (ret < 0)
+        ret = 0;
+err:
+    if (conns != NULL)
+        for (i = 0; i < num; ++i)
+            SSL_free(conns[i]);
+    OPENSSL_free(conns);
+    OPENSSL_free(items);
+    SSL_CTX_free(ctx);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t sizes[] = { 10, 100, 1000, 10000 };
+    size_t max_num = 10000, max_fd_num, num, i;
+    uint64_t timeout_us = 1000, budget_ms = 1000;
+    unsigned long ul;
+    BIO_ADDR *peer = NULL;
+    double t_poll, t_epoll;
+    int sink = -1, ret = EXIT_FAILURE, c;
+
+    prog = argv[0];
+    while ((c = getopt(argc, argv, "n:t:T:")) != EOF) {
+        switch (c) {
+        case 'n':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul) || ul == 0)
+                usage();
+            max_num = ul;
+            break;
+        case 't':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul) || ul == 0)
+                usage();
+            timeout_us = ul;
+            break;
+        case 'T':
+            if (!OPENSSL_strtoul(optarg, NULL, 10, &ul) || ul == 0)
+                usage();
+            budget_ms = ul;
+            break;
+        default:
+            usage();
+            break;
+        }
+    }
+
+    max_fd_num = max_conns_for_fd_limit();
+    if ((peer = BIO_ADDR_new()) == NULL || (sink = make_sink(peer)) < 0)
+        goto err;
+
+    printf("%8s %16s %16s\n", "objects", "poll (us/call)", "epoll (us/call)");
+    for (i = 0; i < OSSL_NELEM(sizes) && sizes[i] <= max_num; ++i) {
+        num = sizes[i];
+        if (num > max_fd_num) {
+            printf("%8zu skipped: descriptor limit allows %zu objects\n",
+                num, max_fd_num);
+            break;
+        }
+
+        if ((t_poll = run(0, num, timeout_us, budget_ms, peer)) < 0)
+            goto err;
+
+        ERR_set_mark();
+        t_epoll = run(1, num, timeout_us, budget_ms, peer);
+        ERR_pop_to_mark();
+
+        if (t_epoll < 0)
+            printf("%8zu %16.1f %16s\n", num, t_poll, "unsupported");
+        else
+            printf("%8zu %16.1f %16.1f\n", num, t_poll, t_epoll);
+    }
+
+    ret = EXIT_SUCCESS;
+err:
+    if (ret != EXIT_SUCCESS)
+        ERR_print_errors_fp(stderr);
+    if (sink >= 0)
+        BIO_closesocket(sink);
+    BIO_ADDR_free(peer);
+    return ret;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+    fprintf(stderr, "%s: not supported on this platform\n", argv[0]);
+    return EXIT_SUCCESS;
+}
+
+#endif
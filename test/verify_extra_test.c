@@ -766,6 +766,222 @@ static int test_purpose_any(void)
     return do_test_purpose(X509_PURPOSE_ANY, 1);
 }
 
+static int do_verify_cached(X509_STORE *store, X509 *eecert,
+    STACK_OF(X509) *untrusted, int purpose, const char *host,
+    int expected)
+{
+    X509_STORE_CTX *ctx = X509_STORE_CTX_new();
+    int testresult = 0;
+
+    if (!TEST_ptr(ctx)
+        || !TEST_true(X509_STORE_CTX_init(ctx, store, eecert, untrusted))
+        || !TEST_true(X509_STORE_CTX_set_purpose(ctx, purpose)))
+        goto err;
+    if (host != NULL
+        && !TEST_true(X509_VERIFY_PARAM_set1_host(X509_STORE_CTX_get0_param(ctx),
+            host, 0)))
+        goto err;
+
+    if (!TEST_int_eq(X509_verify_cert(ctx), expected))
+        goto err;
+    if (expected == 1
+        && (!TEST_int_eq(sk_X509_num(X509_STORE_CTX_get0_chain(ctx)), 3)
+            || !TEST_ptr_eq(sk_X509_value(X509_STORE_CTX_get0_chain(ctx), 0),
+                eecert)))
+        goto err;
+
+    testresult = 1;
+err:
+    X509_STORE_CTX_free(ctx);
+    return testresult;
+}
+
+static int test_verify_cache(void)
+{
+    X509 *eecert = load_cert_from_file(ee_cert);
+    X509 *untrcert = load_cert_from_file(ca_cert);
+    X509 *trcert = load_cert_from_file(sroot_cert);
+    STACK_OF(X509) *untrusted = sk_X509_new_null();
+    X509_STORE *store = X509_STORE_new();
+    uint64_t hits, misses;
+    size_t entries;
+    int testresult = 0;
+
+    if (!TEST_ptr(eecert)
+        || !TEST_ptr(untrcert)
+        || !TEST_ptr(trcert)
+        || !TEST_ptr(untrusted)
+        || !TEST_ptr(store)
+        || !TEST_true(sk_X509_push(untrusted, untrcert)))
+        goto err;
+    untrcert = NULL;
+    if (!TEST_true(X509_STORE_add_cert(store, trcert))
+        || !TEST_true(X509_STORE_set_verify_cache_size(store, 10)))
+        goto err;
+
+    /* The first verification fills the cache, the second one hits it */
+    if (!do_verify_cached(store, eecert, untrusted, X509_PURPOSE_SSL_SERVER,
+            NULL, 1)
+        || !TEST_true(X509_STORE_get_verify_cache_stats(store, &hits, &misses,
+            &entries))
+        || !TEST_uint64_t_eq(hits, 0)
+        || !TEST_uint64_t_eq(misses, 1)
+        || !TEST_size_t_eq(entries, 1)
+        || !do_verify_cached(store, eecert, untrusted, X509_PURPOSE_SSL_SERVER,
+            NULL, 1)
+        || !TEST_true(X509_STORE_get_verify_cache_stats(store, &hits, &misses,
+            &entries))
+        || !TEST_uint64_t_eq(hits, 1)
+        || !TEST_uint64_t_eq(misses, 1))
+        goto err;
+
+    /* A different purpose is a different key and fails as usual */
+    if (!do_verify_cached(store, eecert, untrusted, X509_PURPOSE_SSL_CLIENT,
+            NULL, 0)
+        || !TEST_true(X509_STORE_get_verify_cache_stats(store, &hits, &misses,
+            &entries))
+        || !TEST_uint64_t_eq(hits, 1)
+        || !TEST_uint64_t_eq(misses, 2)
+        || !TEST_size_t_eq(entries, 1))
+        goto err;
+
+    /* The peer identity is still checked on a hit */
+    if (!do_verify_cached(store, eecert, untrusted, X509_PURPOSE_SSL_SERVER,
+            "no-such-host.example", 0)
+        || !TEST_true(X509_STORE_get_verify_cache_stats(store, &hits, NULL,
+            NULL))
+        || !TEST_uint64_t_eq(hits, 2))
+        goto err;
+
+    /* Adding to the store empties the cache */
+    if (!TEST_true(X509_STORE_add_cert(store, sk_X509_value(untrusted, 0)))
+        || !TEST_true(X509_STORE_get_verify_cache_stats(store, NULL, NULL,
+            &entries))
+        || !TEST_size_t_eq(entries, 0))
+        goto err;
+
+    testresult = 1;
+err:
+    OSSL_STACK_OF_X509_free(untrusted);
+    X509_STORE_free(store);
+    X509_free(eecert);
+    X509_free(untrcert);
+    X509_free(trcert);
+    return testresult;
+}
+
+static int test_x509_verify_cached(void)
+{
+    X509 *eecert = load_cert_from_file(ee_cert);
+    X509 *cacert = load_cert_from_file(ca_cert);
+    X509 *cacert2 = load_cert_from_file(ca_cert);
+    EVP_PKEY *pkey;
+    int testresult = 0;
+
+    if (!TEST_ptr(eecert)
+        || !TEST_ptr(cacert)
+        || !TEST_ptr(cacert2)
+        || !TEST_ptr(pkey = X509_get0_pubkey(cacert)))
+        goto err;
+
+    /* The second verification is answered from the certificate */
+    if (!TEST_int_eq(X509_verify(eecert, pkey), 1)
+        || !TEST_int_eq(X509_verify(eecert, pkey), 1)
+        /* An equal key in another object gives the same result */
+        || !TEST_int_eq(X509_verify(eecert, X509_get0_pubkey(cacert2)), 1)
+        /* Another key is not taken for the remembered one */
+        || !TEST_int_le(X509_verify(eecert, X509_get0_pubkey(eecert)), 0))
+        goto err;
+
+    /* A modified certificate is verified again */
+    if (!TEST_true(X509_set_subject_name(eecert,
+            X509_get_issuer_name(eecert)))
+        || !TEST_int_le(X509_verify(eecert, pkey), 0))
+        goto err;
+
+    testresult = 1;
+err:
+    X509_free(eecert);
+    X509_free(cacert);
+    X509_free(cacert2);
+    return testresult;
+}
+
+static int test_lookup_index(void)
+{
+    const char *index_f = "verify_extra_test.idx";
+    X509 *eecert = load_cert_from_file(ee_cert);
+    X509 *cacert = load_cert_from_file(ca_cert);
+    X509 *rootcert = load_cert_from_file(sroot_cert);
+    X509 *othercert = load_cert_from_file(root_f);
+    STACK_OF(X509) *certs = sk_X509_new_null();
+    X509_STORE *store = X509_STORE_new();
+    X509_STORE_CTX *ctx = X509_STORE_CTX_new();
+    X509_LOOKUP *lookup;
+    STACK_OF(X509_OBJECT) *objs = NULL;
+    BIO *bio = NULL, *mem = NULL;
+    char *data;
+    int testresult = 0;
+
+    if (!TEST_ptr(eecert)
+        || !TEST_ptr(cacert)
+        || !TEST_ptr(rootcert)
+        || !TEST_ptr(othercert)
+        || !TEST_ptr(certs)
+        || !TEST_ptr(store)
+        || !TEST_ptr(ctx)
+        || !TEST_true(sk_X509_push(certs, othercert))
+        || !TEST_true(sk_X509_push(certs, rootcert))
+        || !TEST_true(sk_X509_push(certs, cacert))
+        || !TEST_ptr(bio = BIO_new_file(index_f, "wb"))
+        || !TEST_true(X509_write_cert_index(bio, certs)))
+        goto err;
+    BIO_free(bio);
+    bio = NULL;
+
+    /* The issuers of the chain are found in the index */
+    if (!TEST_ptr(lookup = X509_STORE_add_lookup(store, X509_LOOKUP_index()))
+        || !TEST_true(X509_LOOKUP_load_index(lookup, index_f))
+        || !TEST_true(X509_STORE_CTX_init(ctx, store, eecert, NULL))
+        || !TEST_int_eq(X509_verify_cert(ctx), 1)
+        || !TEST_int_eq(sk_X509_num(X509_STORE_CTX_get0_chain(ctx)), 3)
+        || !TEST_int_eq(X509_cmp(sk_X509_value(X509_STORE_CTX_get0_chain(ctx),
+            2), rootcert), 0))
+        goto err;
+
+    /* Only the certificates which were looked up have been parsed */
+    if (!TEST_ptr(objs = X509_STORE_get1_objects(store))
+        || !TEST_int_eq(sk_X509_OBJECT_num(objs), 2))
+        goto err;
+
+    /* A truncated index is rejected */
+    if (!TEST_ptr(mem = BIO_new(BIO_s_mem()))
+        || !TEST_true(X509_write_cert_index(mem, certs))
+        || !TEST_long_gt(BIO_get_mem_data(mem, &data), 40)
+        || !TEST_ptr(bio = BIO_new_file(index_f, "wb"))
+        || !TEST_int_eq(BIO_write(bio, data, 40), 40))
+        goto err;
+    BIO_free(bio);
+    bio = NULL;
+    if (!TEST_false(X509_LOOKUP_load_index(lookup, index_f)))
+        goto err;
+
+    testresult = 1;
+err:
+    BIO_free(bio);
+    BIO_free(mem);
+    remove(index_f);
+    sk_X509_OBJECT_pop_free(objs, X509_OBJECT_free);
+    X509_STORE_CTX_free(ctx);
+    X509_STORE_free(store);
+    sk_X509_free(certs);
+    X509_free(eecert);
+    X509_free(cacert);
+    X509_free(rootcert);
+    X509_free(othercert);
+    return testresult;
+}
+
 OPT_TEST_DECLARE_USAGE("certs-dir\n")
 
 int setup_tests(void)
@@ -798,6 +1014,9 @@ int setup_tests(void)
     ADD_TEST(test_purpose_ssl_client);
     ADD_TEST(test_purpose_ssl_server);
     ADD_TEST(test_purpose_any);
+    ADD_TEST(test_verify_cache);
+    ADD_TEST(test_x509_verify_cached);
+    ADD_TEST(test_lookup_index);
     ADD_TEST(test_multiname_selfsigned);
     ADD_TEST(test_vpm_input_validation);
     return 1;